@@ -1,20 +1,246 @@
 #include "common/IDebugLog.h"
 #include <share.h>
 #include "common/IFileStream.h"
+#include "common/ICriticalSection.h"
 #include <shlobj.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
 
 std::FILE			* IDebugLog::logFile = NULL;
 char				IDebugLog::sourceBuf[16] = { 0 };
 char				IDebugLog::headerText[16] = { 0 };
-char				IDebugLog::formatBuf[8192] = { 0 };
 int					IDebugLog::indentLevel = 0;
 int					IDebugLog::rightMargin = 0;
-int					IDebugLog::cursorPos = 0;
 int					IDebugLog::inBlock = 0;
 bool				IDebugLog::autoFlush = true;
 IDebugLog::LogLevel	IDebugLog::logLevel = IDebugLog::kLevel_DebugMessage;
 IDebugLog::LogLevel	IDebugLog::printLevel = IDebugLog::kLevel_Message;
 
+// formatting state is per-thread so that callers on different threads never share a buffer
+static thread_local char	formatBuf[8192];	//!< temp buffer used for formatted messages
+static thread_local int		cursorPos = 0;		//!< current cursor position
+
+namespace AsyncLog
+{
+	// pending line of a thread in async mode, queued whole by NewLine; every thread's is registered so that switching
+	// back to synchronous writes can write out lines that were started but not finished yet
+	struct LineBuffer
+	{
+		std::string	text;
+
+		LineBuffer();
+		~LineBuffer();
+	};
+
+	static ICriticalSection				s_lineBufsLock;
+	static std::vector<LineBuffer *>	s_lineBufs;
+
+	LineBuffer::LineBuffer()
+	{
+		ScopedLock lock(s_lineBufsLock);
+		s_lineBufs.push_back(this);
+	}
+
+	LineBuffer::~LineBuffer()
+	{
+		ScopedLock lock(s_lineBufsLock);
+		s_lineBufs.erase(std::find(s_lineBufs.begin(), s_lineBufs.end(), this));
+	}
+
+	// bounded multi-producer, single-consumer ring of fixed-size slots (Vyukov-style sequence numbers)
+	// a line larger than one slot takes several consecutive slots, reserved with a single CAS so
+	// lines written concurrently from different threads are never interleaved
+	enum
+	{
+		kSlotDataSize =	248,
+		kNumSlots =		4096,	// must be a power of two, ~1MB total
+		kSlotMask =		kNumSlots - 1,
+		kBatchSize =	0x10000,
+		kIdleWaitMS =	20,
+	};
+
+	struct Slot
+	{
+		std::atomic<UInt32>	sequence;
+		UInt32				length;
+		char				data[kSlotDataSize];
+	};
+
+	static Slot					s_slots[kNumSlots];
+	static std::atomic<UInt32>	s_enqueuePos = 0;
+	static UInt32				s_dequeuePos = 0;		// owned by whoever holds s_consumerLock
+	static std::atomic<bool>	s_consumerLock = false;
+	static std::atomic<UInt32>	s_dropped = 0;
+	static std::atomic<UInt32>	s_totalDropped = 0;
+	static std::atomic<bool>	s_enabled = false;
+	static std::atomic<bool>	s_disabling = false;	// set while SetAsync(false) writes out what is queued
+	static std::atomic<UInt32>	s_producers = 0;		// threads writing to the ring or their line buffer
+	static std::atomic<bool>	s_stopRequested = false;
+	static HANDLE				s_thread = NULL;
+	static HANDLE				s_wakeEvent = NULL;
+	static std::FILE			* s_file = NULL;
+	static char					s_batch[kBatchSize];
+	static LPTOP_LEVEL_EXCEPTION_FILTER s_prevExceptionFilter = NULL;
+
+	// true if the calling thread is to append to its line buffer, which it then has to follow with EndProduce; false
+	// once async mode is off, after whatever was queued or pending before has been written out
+	static bool BeginProduce()
+	{
+		s_producers++;
+		if (s_enabled)
+			return true;
+		s_producers--;
+		while (s_disabling)
+			Sleep(0);
+		return false;
+	}
+
+	static void EndProduce()
+	{
+		s_producers--;
+	}
+
+	static void Init()
+	{
+		for (UInt32 i = 0; i < kNumSlots; i++)
+			s_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	static bool Enqueue(const char * buf, UInt32 length)
+	{
+		if (!length)
+			return true;
+
+		UInt32 numSlots = (length + kSlotDataSize - 1) / kSlotDataSize;
+		if (numSlots > kNumSlots)
+		{
+			numSlots = kNumSlots;
+			length = kNumSlots * kSlotDataSize;
+		}
+
+		UInt32 pos = s_enqueuePos.load(std::memory_order_relaxed);
+		while (true)
+		{
+			// the consumer frees slots in order, so if the last slot we need is free all the ones before it are as well
+			const UInt32 lastPos = pos + numSlots - 1;
+			const UInt32 seq = s_slots[lastPos & kSlotMask].sequence.load(std::memory_order_acquire);
+			const SInt32 diff = (SInt32)(seq - lastPos);
+			if (diff == 0)
+			{
+				if (s_enqueuePos.compare_exchange_weak(pos, pos + numSlots, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+			{
+				// full, never block the caller
+				s_dropped.fetch_add(1, std::memory_order_relaxed);
+				s_totalDropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else
+				pos = s_enqueuePos.load(std::memory_order_relaxed);
+		}
+
+		for (UInt32 i = 0; i < numSlots; i++)
+		{
+			Slot & slot = s_slots[(pos + i) & kSlotMask];
+			const UInt32 chunk = (length > kSlotDataSize) ? kSlotDataSize : length;
+			memcpy(slot.data, buf, chunk);
+			slot.length = chunk;
+			slot.sequence.store(pos + i + 1, std::memory_order_release);
+			buf += chunk;
+			length -= chunk;
+		}
+
+		// wake the writer early if the ring is getting full
+		if (((pos + numSlots) & (kNumSlots / 2 - 1)) < numSlots)
+			SetEvent(s_wakeEvent);
+
+		return true;
+	}
+
+	static bool TryLockConsumer(UInt32 spins)
+	{
+		bool expected = false;
+		while (!s_consumerLock.compare_exchange_weak(expected, true, std::memory_order_acquire))
+		{
+			expected = false;
+			if (!spins--)
+				return false;
+			Sleep(0);
+		}
+		return true;
+	}
+
+	static void UnlockConsumer()
+	{
+		s_consumerLock.store(false, std::memory_order_release);
+	}
+
+	// caller must own the consumer side (or be the only thread left alive)
+	static void Drain(std::FILE * file)
+	{
+		UInt32 batchLen = 0;
+
+		if (UInt32 dropped = s_dropped.exchange(0, std::memory_order_relaxed))
+			batchLen = sprintf_s(s_batch, sizeof(s_batch), "[IDebugLog] %u message(s) dropped, log buffer was full\n", dropped);
+
+		while (true)
+		{
+			Slot & slot = s_slots[s_dequeuePos & kSlotMask];
+			const UInt32 seq = slot.sequence.load(std::memory_order_acquire);
+			if ((SInt32)(seq - (s_dequeuePos + 1)) < 0)
+				break;
+
+			if (batchLen + slot.length > sizeof(s_batch))
+			{
+				fwrite(s_batch, 1, batchLen, file);
+				batchLen = 0;
+			}
+			memcpy(s_batch + batchLen, slot.data, slot.length);
+			batchLen += slot.length;
+
+			slot.sequence.store(s_dequeuePos + kNumSlots, std::memory_order_release);
+			s_dequeuePos++;
+		}
+
+		if (batchLen)
+		{
+			fwrite(s_batch, 1, batchLen, file);
+			fflush(file);
+		}
+	}
+
+	static UInt32 WINAPI WriterProc(void * param)
+	{
+		std::FILE * file = (std::FILE *)param;
+		while (!s_stopRequested.load(std::memory_order_acquire))
+		{
+			WaitForSingleObject(s_wakeEvent, kIdleWaitMS);
+			if (TryLockConsumer(0))
+			{
+				Drain(file);
+				UnlockConsumer();
+			}
+		}
+		return 0;
+	}
+
+	static LONG WINAPI CrashFilter(EXCEPTION_POINTERS * info)
+	{
+		// the writer may have been stopped mid-drain by whatever crashed; racing it is better than losing the log
+		bool locked = TryLockConsumer(1000);
+		Drain(s_file);
+		if (locked)
+			UnlockConsumer();
+		return s_prevExceptionFilter ? s_prevExceptionFilter(info) : EXCEPTION_CONTINUE_SEARCH;
+	}
+}
+
+static thread_local AsyncLog::LineBuffer	lineBuf;	//!< pending line in async mode
+
 IDebugLog::IDebugLog()
 {
 	//
@@ -27,6 +253,29 @@ IDebugLog::IDebugLog(const char * name)
 
 IDebugLog::~IDebugLog()
 {
+	if(AsyncLog::s_enabled)
+	{
+		// the writer thread may already have been terminated by process shutdown, or be unable to exit while the
+		// loader lock is held, so only wait for it briefly
+		AsyncLog::s_stopRequested = true;
+		SetEvent(AsyncLog::s_wakeEvent);
+		bool exited = WaitForSingleObject(AsyncLog::s_thread, AsyncLog::kIdleWaitMS * 5) == WAIT_OBJECT_0;
+
+		// the consumer lock is kept, a writer that is still running must not touch the file once it is closed
+		if(AsyncLog::TryLockConsumer(1000))
+			AsyncLog::Drain(logFile);
+		AsyncLog::s_enabled = false;
+
+		CloseHandle(AsyncLog::s_thread);
+		AsyncLog::s_thread = NULL;
+		// a thread still waiting on the event keeps it
+		if(exited)
+		{
+			CloseHandle(AsyncLog::s_wakeEvent);
+			AsyncLog::s_wakeEvent = NULL;
+		}
+	}
+
 	if(logFile)
 		fclose(logFile);
 }
@@ -128,7 +377,13 @@ void IDebugLog::Log(LogLevel level, const char * fmt, va_list args)
 		vsprintf_s(formatBuf, sizeof(formatBuf), fmt, args);
 
 	if(log)
+	{
 		Message(formatBuf);
+
+		// we are probably about to go down, make sure this reaches the disk
+		if(level == kLevel_FatalError)
+			Flush();
+	}
 	
 	if(print)
 		printf("%s\n", formatBuf);
@@ -204,6 +459,118 @@ void IDebugLog::SetAutoFlush(bool inAutoFlush)
 	autoFlush = inAutoFlush;
 }
 
+/**
+ *	Enable/disable asynchronous writing
+ *	
+ *	While enabled, lines are queued into a bounded ring buffer and written out by a
+ *	background thread. If the ring is full, lines are dropped rather than blocking the
+ *	caller and the number dropped is written to the log once there is room again.
+ *	Turning it off writes out everything queued and the unfinished lines of other
+ *	threads before any thread writes synchronously again.
+ *	
+ *	@param inAsync async state
+ */
+void IDebugLog::SetAsync(bool inAsync)
+{
+	if(inAsync == AsyncLog::s_enabled)
+		return;
+
+	if(inAsync)
+	{
+		if(!logFile)
+			return;
+
+		AsyncLog::Init();
+		AsyncLog::s_stopRequested = false;
+		AsyncLog::s_wakeEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+		AsyncLog::s_thread = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE)AsyncLog::WriterProc, logFile, 0, NULL);
+		if(!AsyncLog::s_thread)
+		{
+			CloseHandle(AsyncLog::s_wakeEvent);
+			AsyncLog::s_wakeEvent = NULL;
+			return;
+		}
+
+		AsyncLog::s_file = logFile;
+		AsyncLog::s_prevExceptionFilter = SetUnhandledExceptionFilter(AsyncLog::CrashFilter);
+		AsyncLog::s_enabled = true;
+	}
+	else
+	{
+		// threads that already chose async mode finish their line first, the others wait until everything queued
+		// before is written
+		AsyncLog::s_disabling = true;
+		AsyncLog::s_enabled = false;
+		while(AsyncLog::s_producers)
+			Sleep(0);
+
+		AsyncLog::s_stopRequested = true;
+		SetEvent(AsyncLog::s_wakeEvent);
+		WaitForSingleObject(AsyncLog::s_thread, INFINITE);
+		CloseHandle(AsyncLog::s_thread);
+		CloseHandle(AsyncLog::s_wakeEvent);
+		AsyncLog::s_thread = NULL;
+		AsyncLog::s_wakeEvent = NULL;
+
+		// Flush may be draining on another thread
+		while(!AsyncLog::TryLockConsumer(1000))
+			;
+		AsyncLog::Drain(logFile);
+		AsyncLog::UnlockConsumer();
+
+		// lines other threads have started without finishing; the rest of each follows synchronously
+		{
+			ScopedLock lock(AsyncLog::s_lineBufsLock);
+			for(AsyncLog::LineBuffer * pending : AsyncLog::s_lineBufs)
+			{
+				fwrite(pending->text.data(), 1, pending->text.size(), logFile);
+				pending->text.clear();
+			}
+		}
+		fflush(logFile);
+
+		AsyncLog::s_disabling = false;
+	}
+}
+
+bool IDebugLog::IsAsync(void)
+{
+	return AsyncLog::s_enabled;
+}
+
+/**
+ *	Write out everything queued so far
+ *	
+ *	Safe to call from any thread. If the writer thread is busy draining for longer than
+ *	the wait, what it has not written yet is left to it.
+ */
+void IDebugLog::Flush(void)
+{
+	if(!logFile)
+		return;
+
+	if(!AsyncLog::s_enabled)
+	{
+		fflush(logFile);
+		return;
+	}
+
+	// only the crash filter drains without the lock
+	if(AsyncLog::TryLockConsumer(1000))
+	{
+		AsyncLog::Drain(logFile);
+		AsyncLog::UnlockConsumer();
+	}
+}
+
+/**
+ *	Returns the number of lines dropped because the async ring buffer was full
+ */
+UInt32 IDebugLog::GetDroppedCount(void)
+{
+	return AsyncLog::s_totalDropped;
+}
+
 /**
  *	Print spaces to the log
  *	
@@ -220,12 +587,12 @@ void IDebugLog::PrintSpaces(int numSpaces)
 			if(numSpaces >= TabSize())
 			{
 				numSpaces -= TabSize();
-				fputc('\t', logFile);
+				Output('\t');
 			}
 			else
 			{
 				numSpaces--;
-				fputc(' ', logFile);
+				Output(' ');
 			}
 		}
 	}
@@ -240,9 +607,17 @@ void IDebugLog::PrintText(const char * buf)
 {
 	if(logFile)
 	{
-		fputs(buf, logFile);
-		if(autoFlush)
-			fflush(logFile);
+		if(AsyncLog::BeginProduce())
+		{
+			lineBuf.text.append(buf);
+			AsyncLog::EndProduce();
+		}
+		else
+		{
+			fputs(buf, logFile);
+			if(autoFlush)
+				fflush(logFile);
+		}
 	}
 
 	const char	* traverse = buf;
@@ -264,15 +639,47 @@ void IDebugLog::NewLine(void)
 {
 	if(logFile)
 	{
-		fputc('\n', logFile);
+		if(AsyncLog::BeginProduce())
+		{
+			lineBuf.text.push_back('\n');
+			AsyncLog::Enqueue(lineBuf.text.data(), lineBuf.text.size());
+			lineBuf.text.clear();
+			AsyncLog::EndProduce();
+		}
+		else
+		{
+			fputc('\n', logFile);
 
-		if(autoFlush)
-			fflush(logFile);
+			if(autoFlush)
+				fflush(logFile);
+		}
 	}
 
 	cursorPos = 0;
 }
 
+/**
+ *	Appends raw text to the current line
+ *	
+ *	In async mode the line is accumulated per-thread and queued as a whole by NewLine.
+ */
+void IDebugLog::Output(const char * buf, UInt32 length)
+{
+	if(!AsyncLog::BeginProduce())
+	{
+		fwrite(buf, 1, length, logFile);
+		return;
+	}
+
+	lineBuf.text.append(buf, length);
+	AsyncLog::EndProduce();
+}
+
+void IDebugLog::Output(char c)
+{
+	Output(&c, 1);
+}
+
 /**
  *	Prints spaces to align the cursor to the requested position
  *	
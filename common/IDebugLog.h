@@ -7,6 +7,9 @@
  *	
  *	This class supports prefix blocks describing the source of the log event.
  *	It also allows logical blocks and outlining.\n
+ *
+ *	In async mode each thread formats its lines into its own buffer and hands them
+ *	to a lock-free ring which a background thread drains to disk in batches.
  */
 class IDebugLog
 {
@@ -45,6 +48,11 @@ class IDebugLog
 
 		static void			SetAutoFlush(bool inAutoFlush);
 
+		static void			SetAsync(bool inAsync);
+		static bool			IsAsync(void);
+		static void			Flush(void);
+		static UInt32		GetDroppedCount(void);
+
 		static void			SetLogLevel(LogLevel in)	{ logLevel = in; }
 		static void			SetPrintLevel(LogLevel in)	{ printLevel = in; }
 
@@ -53,6 +61,9 @@ class IDebugLog
 		static void			PrintText(const char * buf);
 		static void			NewLine(void);
 
+		static void			Output(const char * buf, UInt32 length);
+		static void			Output(char c);
+
 		static void			SeekCursor(int position);
 
 		static int			TabSize(void);
@@ -62,11 +73,9 @@ class IDebugLog
 
 		static char			sourceBuf[16];		//!< name of current source, used in prefix
 		static char			headerText[16];		//!< current text to use as line prefix
-		static char			formatBuf[8192];	//!< temp buffer used for formatted messages
 
 		static int			indentLevel;		//!< the current indentation level (in tabs)
 		static int			rightMargin;		//!< the column at which text should be wrapped
-		static int			cursorPos;			//!< current cursor position
 		static int			inBlock;			//!< are we in a block?
 
 		static bool			autoFlush;			//!< automatically flush the file after writing
@@ -1,4 +1,5 @@
 #include "algMath.h"
+#include <xmmintrin.h>
 
 #define DEGTORAD 0.01745329252f
 #define RADTODEG 57.2957795131f
@@ -192,4 +193,175 @@ Euler fromQuat( Quat q, int actorFlag, int funcFlag )
 		out.heading		= -atan2f( 2.0f * q.x*q.y - 2.0f * q.w*q.z , sqw + sqx - sqy - sqz ) * RADTODEG;
 		return out;
 	}
-}
\ No newline at end of file
+}
+
+///////////////////////////////////////////
+///			Batch kernels
+///////////////////////////////////////////
+
+// Operations are done in the same order as the scalar versions so results are bit-identical.
+// Elements that don't fill a whole SSE register are handed to the scalar versions.
+
+void V3NormalizeBatch( float *x, float *y, float *z, UInt32 count )
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps( 1.0f );
+	UInt32 i = 0;
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		__m128 vx = _mm_loadu_ps( x + i );
+		__m128 vy = _mm_loadu_ps( y + i );
+		__m128 vz = _mm_loadu_ps( z + i );
+		__m128 len = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( vx, vx ), _mm_mul_ps( vy, vy ) ), _mm_mul_ps( vz, vz ) ) );
+		__m128 inv = _mm_and_ps( _mm_div_ps( one, len ), _mm_cmpgt_ps( len, zero ) );
+		_mm_storeu_ps( x + i, _mm_mul_ps( vx, inv ) );
+		_mm_storeu_ps( y + i, _mm_mul_ps( vy, inv ) );
+		_mm_storeu_ps( z + i, _mm_mul_ps( vz, inv ) );
+	}
+	for ( ; i < count; i++ )
+	{
+		Vector3 v( x[i], y[i], z[i] );
+		V3Normalize( v );
+		x[i] = v.x;
+		y[i] = v.y;
+		z[i] = v.z;
+	}
+}
+
+void V3CrossproductBatch( const float *ax, const float *ay, const float *az,
+						  const float *bx, const float *by, const float *bz,
+						  float *ox, float *oy, float *oz, UInt32 count )
+{
+	UInt32 i = 0;
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		__m128 vax = _mm_loadu_ps( ax + i ), vay = _mm_loadu_ps( ay + i ), vaz = _mm_loadu_ps( az + i );
+		__m128 vbx = _mm_loadu_ps( bx + i ), vby = _mm_loadu_ps( by + i ), vbz = _mm_loadu_ps( bz + i );
+		_mm_storeu_ps( ox + i, _mm_sub_ps( _mm_mul_ps( vby, vaz ), _mm_mul_ps( vbz, vay ) ) );
+		_mm_storeu_ps( oy + i, _mm_sub_ps( _mm_mul_ps( vbz, vax ), _mm_mul_ps( vbx, vaz ) ) );
+		_mm_storeu_ps( oz + i, _mm_sub_ps( _mm_mul_ps( vbx, vay ), _mm_mul_ps( vby, vax ) ) );
+	}
+	for ( ; i < count; i++ )
+	{
+		Vector3 out = V3Crossproduct( Vector3( ax[i], ay[i], az[i] ), Vector3( bx[i], by[i], bz[i] ) );
+		ox[i] = out.x;
+		oy[i] = out.y;
+		oz[i] = out.z;
+	}
+}
+
+static __forceinline __m128 LoadQuatComponent( const float *p, UInt32 i, UInt32 qStride )
+{
+	return qStride ? _mm_loadu_ps( p + i ) : _mm_set1_ps( *p );
+}
+
+void QMultQuatVector3Batch( const float *qw, const float *qx, const float *qy, const float *qz, UInt32 qStride,
+							const float *vx, const float *vy, const float *vz,
+							float *ox, float *oy, float *oz, UInt32 count )
+{
+	const __m128 two = _mm_set1_ps( 2.0f );
+	const __m128 signBit = _mm_set1_ps( -0.0f );
+	UInt32 i = 0;
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		__m128 w = LoadQuatComponent( qw, i, qStride ), x = LoadQuatComponent( qx, i, qStride );
+		__m128 y = LoadQuatComponent( qy, i, qStride ), z = LoadQuatComponent( qz, i, qStride );
+		__m128 px = _mm_loadu_ps( vx + i ), py = _mm_loadu_ps( vy + i ), pz = _mm_loadu_ps( vz + i );
+
+		__m128 t2 = _mm_mul_ps( w, x );
+		__m128 t3 = _mm_mul_ps( w, y );
+		__m128 t4 = _mm_mul_ps( w, z );
+		__m128 t5 = _mm_xor_ps( _mm_mul_ps( x, x ), signBit );
+		__m128 t6 = _mm_mul_ps( x, y );
+		__m128 t7 = _mm_mul_ps( x, z );
+		__m128 t8 = _mm_xor_ps( _mm_mul_ps( y, y ), signBit );
+		__m128 t9 = _mm_mul_ps( y, z );
+		__m128 t10 = _mm_xor_ps( _mm_mul_ps( z, z ), signBit );
+
+		__m128 rx = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_add_ps( t8, t10 ), px ), _mm_mul_ps( _mm_add_ps( t6, t4 ), py ) ), _mm_mul_ps( _mm_sub_ps( t7, t3 ), pz ) );
+		__m128 ry = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_sub_ps( t6, t4 ), px ), _mm_mul_ps( _mm_add_ps( t5, t10 ), py ) ), _mm_mul_ps( _mm_add_ps( t9, t2 ), pz ) );
+		__m128 rz = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_add_ps( t7, t3 ), px ), _mm_mul_ps( _mm_sub_ps( t9, t2 ), py ) ), _mm_mul_ps( _mm_add_ps( t5, t8 ), pz ) );
+
+		_mm_storeu_ps( ox + i, _mm_add_ps( _mm_mul_ps( two, rx ), px ) );
+		_mm_storeu_ps( oy + i, _mm_add_ps( _mm_mul_ps( two, ry ), py ) );
+		_mm_storeu_ps( oz + i, _mm_add_ps( _mm_mul_ps( two, rz ), pz ) );
+	}
+	for ( ; i < count; i++ )
+	{
+		const UInt32 qi = qStride ? i : 0;
+		Quat q( qw[qi], qx[qi], qy[qi], qz[qi] );
+		Vector3 v( vx[i], vy[i], vz[i] );
+		Vector3 out = q * v;
+		ox[i] = out.x;
+		oy[i] = out.y;
+		oz[i] = out.z;
+	}
+}
+
+void QInterpolateBatch( const float *q1[4], const float *q2[4], float t, int slerpFlag, float *out[4], UInt32 count )
+{
+	UInt32 i = 0;
+	if ( !slerpFlag )
+	{
+		const __m128 vt = _mm_set1_ps( t );
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps( 1.0f );
+		const __m128 signBit = _mm_set1_ps( -0.0f );
+		for ( ; i + 4 <= count; i += 4 )
+		{
+			__m128 a[4], b[4];
+			for ( UInt32 c = 0; c < 4; c++ )
+			{
+				a[c] = _mm_loadu_ps( q1[c] + i );
+				b[c] = _mm_loadu_ps( q2[c] + i );
+			}
+			__m128 cosHalfTheta = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( a[0], b[0] ), _mm_mul_ps( a[1], b[1] ) ), _mm_mul_ps( a[2], b[2] ) ), _mm_mul_ps( a[3], b[3] ) );
+			// flip q1 where the dot product is negative
+			__m128 flip = _mm_and_ps( _mm_cmplt_ps( cosHalfTheta, zero ), signBit );
+			__m128 r[4];
+			for ( UInt32 c = 0; c < 4; c++ )
+			{
+				a[c] = _mm_xor_ps( a[c], flip );
+				r[c] = _mm_add_ps( a[c], _mm_mul_ps( _mm_sub_ps( b[c], a[c] ), vt ) );
+			}
+			__m128 len = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( r[0], r[0] ), _mm_mul_ps( r[1], r[1] ) ), _mm_mul_ps( r[2], r[2] ) ), _mm_mul_ps( r[3], r[3] ) ) );
+			__m128 inv = _mm_and_ps( _mm_div_ps( one, len ), _mm_cmpgt_ps( len, zero ) );
+			for ( UInt32 c = 0; c < 4; c++ )
+				_mm_storeu_ps( out[c] + i, _mm_mul_ps( r[c], inv ) );
+		}
+	}
+	// slerp is dominated by acos/sin, which SSE has no instructions for
+	for ( ; i < count; i++ )
+	{
+		Quat a( q1[0][i], q1[1][i], q1[2][i], q1[3][i] );
+		Quat b( q2[0][i], q2[1][i], q2[2][i], q2[3][i] );
+		Quat r = slerpFlag ? slerp( a, b, t ) : nlerp( a, b, t );
+		out[0][i] = r.w;
+		out[1][i] = r.x;
+		out[2][i] = r.y;
+		out[3][i] = r.z;
+	}
+}
+
+void QFromEulerBatch( const float *e[3], int actorFlag, float *out[4], UInt32 count )
+{
+	for ( UInt32 i = 0; i < count; i++ )
+	{
+		Quat r = fromEuler( Euler( e[0][i], e[1][i], e[2][i] ), actorFlag );
+		out[0][i] = r.w;
+		out[1][i] = r.x;
+		out[2][i] = r.y;
+		out[3][i] = r.z;
+	}
+}
+
+void QToEulerBatch( const float *q[4], int actorFlag, float *out[3], UInt32 count )
+{
+	for ( UInt32 i = 0; i < count; i++ )
+	{
+		Euler r = fromQuat( Quat( q[0][i], q[1][i], q[2][i], q[3][i] ), actorFlag, 1 );
+		out[0][i] = r.elevation;
+		out[1][i] = r.bank;
+		out[2][i] = r.heading;
+	}
+}
@@ -9,4 +9,19 @@ Quat fromAxisAngle( Vector3 axis, float angle );
 Quat nlerp( Quat q1, Quat q2, float t );
 Quat slerp( Quat q1, Quat q2, float t );
 
-Euler fromQuat( Quat q, int actorFlag, int funcFlag );
\ No newline at end of file
+Euler fromQuat( Quat q, int actorFlag, int funcFlag );
+
+// Batch versions operating on structure-of-arrays data (one array per component), four elements at a time.
+// Each produces exactly the same values as calling its single-element counterpart once per element.
+// Output arrays may alias the inputs.
+void V3NormalizeBatch( float *x, float *y, float *z, UInt32 count );
+void V3CrossproductBatch( const float *ax, const float *ay, const float *az,
+						  const float *bx, const float *by, const float *bz,
+						  float *ox, float *oy, float *oz, UInt32 count );
+// qStride is 0 to rotate every vector by the same quaternion, 1 to use one quaternion per vector
+void QMultQuatVector3Batch( const float *qw, const float *qx, const float *qy, const float *qz, UInt32 qStride,
+							const float *vx, const float *vy, const float *vz,
+							float *ox, float *oy, float *oz, UInt32 count );
+void QInterpolateBatch( const float *q1[4], const float *q2[4], float t, int slerpFlag, float *out[4], UInt32 count );
+void QFromEulerBatch( const float *e[3], int actorFlag, float *out[4], UInt32 count );
+void QToEulerBatch( const float *q[4], int actorFlag, float *out[3], UInt32 count );
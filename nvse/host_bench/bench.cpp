@@ -0,0 +1,1694 @@
+// Host-side micro benchmarks for the containers in nvse/containers.h, the cosave buffer and plugin saves
+// (SerializationTask, SavePlugins), interned string storage (InternedString), substring search (SubStringSearcher),
+// inline array element strings (ArrayData), the UI component path cache (TilePathCache), the dynamic cast cache
+// (DynamicCastCache), the GetRefs spatial index (RefSpatialIndex), the ref lookups of ExtractArgsEx
+// (ExtractArgsPlanScope), stand-ins for the UDF call path's lookups (UserFunctionManager), full against delta cosaves
+// of variables (VarMap, ChangedVarIDs), inventory enumeration (GetContainerItems), the number storage of packed arrays,
+// shared between copies and slices (PackedNumbers), and the Algohol batch kernels against their scalar functions
+// (algMath).
+// Builds with GCC or Clang on Linux, see CMakeLists.txt in this directory.
+//
+// Usage: nvse_host_bench [filter] [-n <elements>] [-r <repeats>]
+// Every benchmark is run <repeats> times with the same fixed-seed input and the fastest run is reported, so results
+// are comparable between builds on the same machine. Only benchmarks whose name contains <filter> are run.
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GameRTTI.h"
+#include "GameUI.h"
+#include "InternedString.h"
+#include "MemoizedMap.h"
+#include "PackedNumbers.h"
+#include "RefSpatialIndex.h"
+#include "Serialization.h"
+#include "SubStringSearcher.h"
+#include "TilePathCache.h"
+#include "host_algohol.h"
+#include "host_arrays.h"
+#include "host_cells.h"
+#include "host_inventory.h"
+#include "host_rtti.h"
+#include "host_scripts.h"
+#include "host_strmap.h"
+#include "host_vars.h"
+
+namespace
+{
+	// Stand-in for ArrayElement (ArrayVar.h) with the same 24-byte layout: type tag, owning array and a value union.
+	// ArrayVar and StringVar themselves need the game headers and do not build on the host.
+	struct ElementStandIn
+	{
+		UInt8		dataType;
+		UInt8		pad[3];
+		UInt32		owningArray;
+		union
+		{
+			double	num;
+			UInt32	formID;
+			char	*str;
+			UInt32	arrID;
+		};
+		UInt64		reserved;
+
+		bool operator<(const ElementStandIn& rhs) const {return num < rhs.num;}
+		bool operator>(const ElementStandIn& rhs) const {return num > rhs.num;}
+	};
+	static_assert(sizeof(ElementStandIn) == 24);
+
+	UInt32 g_numElements = 10000;
+	UInt32 g_numRepeats = 5;
+	volatile UInt64 g_sink = 0;	// keeps results alive so the optimizer does not drop the measured work
+
+	struct Inputs
+	{
+		std::vector<UInt32>			ints;		// distinct, shuffled
+		std::vector<double>			numbers;	// distinct, shuffled
+		std::vector<std::string>	strings;	// distinct, shuffled, mixed case like editor IDs and string map keys
+
+		void Build(UInt32 count)
+		{
+			std::mt19937 rng(0x4E565345);
+			ints.resize(count);
+			for (UInt32 idx = 0; idx < count; idx++)
+				ints[idx] = idx * 2654435761U;
+			std::shuffle(ints.begin(), ints.end(), rng);
+			numbers.resize(count);
+			for (UInt32 idx = 0; idx < count; idx++)
+				numbers[idx] = (double)ints[idx] * 0.5;
+			static const char *kPrefixes[] = {"NVDLC", "Vault", "xNVSE", "aaQuest", "MS", "VMS", "Key", "Note"};
+			strings.resize(count);
+			for (UInt32 idx = 0; idx < count; idx++)
+				strings[idx] = std::string(kPrefixes[idx & 7]) + "_Var" + std::to_string(ints[idx] % 1000003) + "_" + std::to_string(idx);
+		}
+	};
+	Inputs g_inputs;
+
+	// One benchmark: setup is untimed, run does the measured work and returns the number of operations it did.
+	struct Benchmark
+	{
+		const char								*name;
+		std::function<void()>					setup;
+		std::function<UInt32()>					run;
+		std::function<void()>					teardown;
+	};
+
+	double TimeBenchmark(const Benchmark& bench)
+	{
+		double best = 0;
+		for (UInt32 iter = 0; iter < g_numRepeats; iter++)
+		{
+			if (bench.setup) bench.setup();
+			auto start = std::chrono::steady_clock::now();
+			UInt32 numOps = bench.run();
+			auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+			if (bench.teardown) bench.teardown();
+			double perOp = numOps ? elapsed / numOps : elapsed;
+			if (!iter || (perOp < best))
+				best = perOp;
+		}
+		return best;
+	}
+
+	// Containers shared between the setup and run steps of a benchmark; each setup recreates what it uses.
+	std::unique_ptr<Vector<ElementStandIn>>					s_vector;
+	std::unique_ptr<Map<UInt32, UInt32>>					s_mapInt;
+	std::unique_ptr<UnorderedMap<UInt32, UInt32>>			s_hashInt;
+	std::unique_ptr<Map<double, ElementStandIn>>			s_mapNum;
+	std::unique_ptr<Map<char*, ElementStandIn>>				s_mapStr;
+	std::unique_ptr<UnorderedMap<char*, ElementStandIn>>	s_hashStr;
+	std::unique_ptr<Set<UInt32>>							s_set;
+	std::unique_ptr<Serialization::SerializationTask>		s_task;
+
+	ElementStandIn MakeElement(double value)
+	{
+		ElementStandIn element{};
+		element.dataType = 1;
+		element.num = value;
+		return element;
+	}
+
+	void FillVector()
+	{
+		s_vector = std::make_unique<Vector<ElementStandIn>>();
+		for (double value : g_inputs.numbers)
+			s_vector->Append(MakeElement(value));
+	}
+
+	void FillMapInt()
+	{
+		s_mapInt = std::make_unique<Map<UInt32, UInt32>>();
+		for (UInt32 key : g_inputs.ints)
+			(*s_mapInt)[key] = key;
+	}
+
+	void FillHashInt()
+	{
+		s_hashInt = std::make_unique<UnorderedMap<UInt32, UInt32>>();
+		for (UInt32 key : g_inputs.ints)
+			(*s_hashInt)[key] = key;
+	}
+
+	void FillMapNum()
+	{
+		s_mapNum = std::make_unique<Map<double, ElementStandIn>>();
+		for (double key : g_inputs.numbers)
+			(*s_mapNum)[key] = MakeElement(key);
+	}
+
+	void FillMapStr()
+	{
+		s_mapStr = std::make_unique<Map<char*, ElementStandIn>>();
+		for (const std::string& key : g_inputs.strings)
+			(*s_mapStr)[(char*)key.c_str()] = MakeElement(key.size());
+	}
+
+	void FillHashStr()
+	{
+		s_hashStr = std::make_unique<UnorderedMap<char*, ElementStandIn>>();
+		for (const std::string& key : g_inputs.strings)
+			(*s_hashStr)[(char*)key.c_str()] = MakeElement(key.size());
+	}
+
+	void FillSet()
+	{
+		s_set = std::make_unique<Set<UInt32>>();
+		for (UInt32 key : g_inputs.ints)
+			s_set->Insert(key);
+	}
+
+	// Writes what a typical array record looks like: id, owner, key type, size, then typed elements.
+	void WriteRecords()
+	{
+		s_task = std::make_unique<Serialization::SerializationTask>();
+		s_task->Allocate(0x40000);
+		for (UInt32 idx = 0; idx < g_numElements; idx++)
+		{
+			const std::string& str = g_inputs.strings[idx];
+			s_task->Write8(1);
+			s_task->Write32(g_inputs.ints[idx]);
+			s_task->Write64(&g_inputs.numbers[idx]);
+			s_task->Write16(str.size());
+			s_task->WriteBuf(str.data(), str.size());
+		}
+	}
+
+	UInt32 ReadRecords()
+	{
+		s_task->SetOffset(0);
+		char buf[0x200];
+		UInt64 sum = 0;
+		for (UInt32 idx = 0; idx < g_numElements; idx++)
+		{
+			sum += s_task->Read8();
+			sum += s_task->Read32();
+			double num;
+			s_task->Read64(&num);
+			sum += (UInt64)num;
+			UInt16 len = s_task->Read16();
+			s_task->ReadBuf(buf, len);
+			sum += buf[0];
+		}
+		g_sink = g_sink + sum;
+		return g_numElements;
+	}
+
+	bool s_saveAsText = false;	// stand-in plugins format their numbers, for callbacks that do more than copy data
+
+	// Save callback of a stand-in plugin: a header record, then elements of the shared inputs in records of 256, more of
+	// them for higher kPlugin. Plugin 3 has nothing to save.
+	template <UInt32 kPlugin>
+	void SaveStandInPlugin(void*)
+	{
+		if (kPlugin == 3)
+			return;
+		UInt32 numElements = g_numElements * (kPlugin + 1) / 4;
+		Serialization::WriteRecord('HEAD', kPlugin, &numElements, sizeof(numElements));
+		for (UInt32 idx = 0; idx < numElements; idx++)
+		{
+			if (!(idx & 0xFF))
+				Serialization::OpenRecord('DATA', idx >> 8);
+			UInt32 input = (idx * (kPlugin + 1)) % g_numElements;
+			const std::string& str = g_inputs.strings[input];
+			Serialization::WriteRecord8(kPlugin);
+			Serialization::WriteRecord32(g_inputs.ints[input]);
+			if (s_saveAsText)
+			{
+				char buffer[0x20];
+				UInt16 length = snprintf(buffer, sizeof(buffer), "%.17g", g_inputs.numbers[input]);
+				Serialization::WriteRecord16(length);
+				Serialization::WriteRecordData(buffer, length);
+			}
+			else
+				Serialization::WriteRecord64(&g_inputs.numbers[input]);
+			Serialization::WriteRecord16(str.size());
+			Serialization::WriteRecordData(str.data(), str.size());
+		}
+	}
+
+	// Plugin 0 stands for NVSE itself, whose callback is never thread-safe.
+	const std::vector<Serialization::PluginSave> s_pluginSaves = {
+		{0x1400, SaveStandInPlugin<0>, false},
+		{0x3000, SaveStandInPlugin<1>, true},
+		{0x3100, SaveStandInPlugin<2>, true},
+		{0x3200, SaveStandInPlugin<3>, true},
+		{0x3300, SaveStandInPlugin<4>, false},
+		{0x3400, SaveStandInPlugin<5>, true},
+		{0x3500, SaveStandInPlugin<6>, true},
+		{0x3600, SaveStandInPlugin<7>, true},
+	};
+
+	UInt32 SavePlugins(bool parallel)
+	{
+		s_task = std::make_unique<Serialization::SerializationTask>();
+		s_task->Allocate(0x40000);
+		g_sink = g_sink + Serialization::SavePlugins(*s_task, s_pluginSaves, parallel);
+		return s_task->GetOffset();
+	}
+
+	// Untimed: a parallel save has to give the same bytes as a sequential one, whichever worker finishes first.
+	void CheckParallelSaves(bool saveAsText)
+	{
+		s_saveAsText = saveAsText;
+		// a plugin writing outside its save callback only gets an error logged
+		if (Serialization::OpenRecord('TEST', 1) || Serialization::WriteRecordData("x", 1))
+		{
+			fprintf(stderr, "record writes outside a save callback were accepted\n");
+			exit(1);
+		}
+		Serialization::WriteRecord32(0);
+		SavePlugins(false);
+		std::vector<UInt8> expected(s_task->GetData(0), s_task->GetData(s_task->GetOffset()));
+		for (UInt32 pass = 0; pass < 20; pass++)
+		{
+			UInt32 size = SavePlugins(true);
+			if ((size != expected.size()) || memcmp(s_task->GetData(0), expected.data(), size))
+			{
+				fprintf(stderr, "parallel plugin save differs from the sequential one (%u bytes, expected %zu)\n", size, expected.size());
+				exit(1);
+			}
+		}
+	}
+
+	// String variables the way mods use them: every element holds one of a few hundred editor IDs, menu paths and
+	// labels, all too long for std::string's inline buffer.
+	constexpr UInt32 kNumStringValues = 300;
+	std::vector<std::string> s_stringValues;
+	std::vector<std::string> s_stdStrings;
+	std::vector<InternedString> s_internedStrings;
+
+	const std::string& GetStringValue(UInt32 idx)
+	{
+		if (s_stringValues.empty())
+		{
+			static const char *kFormats[] = {"NVDLC%02uQuestStage%u", "HUDMainMenu/_Status%u/row%u", "Quest status: done (%u/%u)"};
+			char buffer[0x40];
+			for (UInt32 value = 0; value < kNumStringValues; value++)
+			{
+				snprintf(buffer, sizeof(buffer), kFormats[value % 3], value / 3, value * 7);
+				s_stringValues.emplace_back(buffer);
+			}
+		}
+		return s_stringValues[(idx * 7919) % kNumStringValues];
+	}
+
+	void FillStdStrings()
+	{
+		s_stdStrings.assign(g_numElements, std::string());
+		for (UInt32 idx = 0; idx < g_numElements; idx++)
+			s_stdStrings[idx] = GetStringValue(idx);
+	}
+
+	void FillInternedStrings()
+	{
+		s_internedStrings.assign(g_numElements, InternedString());
+		for (UInt32 idx = 0; idx < g_numElements; idx++)
+		{
+			const std::string &value = GetStringValue(idx);
+			s_internedStrings[idx] = InternedString(value.data(), value.size());
+		}
+	}
+
+	void FreeStrings()
+	{
+		s_stdStrings = std::vector<std::string>();
+		s_internedStrings = std::vector<InternedString>();
+	}
+
+	// Half of the pairs hold the same value: element i against i + kNumStringValues, or against its neighbour.
+	UInt32 GetStringPartner(UInt32 idx)
+	{
+		return ((idx & 1) ? (idx + 1) : (idx + kNumStringValues)) % g_numElements;
+	}
+
+	// Untimed: threads interning and dropping the same values, so entries keep being freed while others look them up,
+	// must always get their own string back and leave nothing behind once they exit. Strings this thread interned
+	// earlier stay in its recent list.
+	void CheckInternedStrings()
+	{
+		GetStringValue(0);	// builds the values before the threads share them
+		UInt32 numBefore, numBytes;
+		InternedString::GetUsage(&numBefore, &numBytes);
+		std::atomic<UInt32> mismatches = 0;
+		auto check = [&](UInt32 start)
+		{
+			std::vector<InternedString> held(64);
+			for (UInt32 idx = 0; idx < 20000; idx++)
+			{
+				const std::string &value = GetStringValue(start + idx);
+				InternedString &slot = held[idx & 63];
+				slot = InternedString(value.data(), value.size());
+				if ((slot.Length() != value.size()) || memcmp(slot.CStr(), value.data(), value.size()))
+					mismatches++;
+			}
+		};
+		std::vector<std::thread> threads;
+		for (UInt32 idx = 0; idx < 4; idx++)
+			threads.emplace_back(check, idx * 13);
+		for (std::thread &thread : threads)
+			thread.join();
+		UInt32 numStrings;
+		InternedString::GetUsage(&numStrings, &numBytes);
+		if (mismatches || (numStrings != numBefore))
+		{
+			fprintf(stderr, "interned strings: %u wrong strings returned, %u left after their last handle\n", mismatches.load(),
+				numStrings - numBefore);
+			exit(1);
+		}
+	}
+
+	// Untimed: what the strings take up, StringVar's own size included. Interned ones keep an empty std::string next
+	// to the handle.
+	void ReportStringMemory()
+	{
+		FillStdStrings();
+		size_t stdBytes = s_stdStrings.size() * sizeof(std::string);
+		for (const std::string& str : s_stdStrings)
+			stdBytes += (str.capacity() > 15) ? str.capacity() + 1 : 0;
+		FillInternedStrings();
+		UInt32 numInterned, poolBytes;
+		InternedString::GetUsage(&numInterned, &poolBytes);
+		size_t internedBytes = s_internedStrings.size() * (sizeof(std::string) + sizeof(InternedString)) + poolBytes;
+		FreeStrings();
+		printf("\n%u string values, %u distinct: %zu KB as std::string, %zu KB interned\n", g_numElements, numInterned,
+			stdBytes >> 10, internedBytes >> 10);
+	}
+
+	// About 4 MB of words with kNumSearchMatches copies of kSearchNeedle spread through it, for StringVar's Find, Count
+	// and Replace (SubStringSearcher). The case-insensitive benchmarks search for the needles in another case.
+	constexpr UInt32 kSearchTextSize = 4 << 20;
+	constexpr UInt32 kNumSearchMatches = 4096;
+	const char *kSearchNeedle = "xNVSE_Marker", *kSearchNeedleOtherCase = "XnvSe_mARKER";
+	// Same first and last characters as kSearchNeedle, so the SIMD scan stops at every match and has to verify it; the
+	// only real occurrence is at the very end.
+	const char *kFindNeedle = "xNVSE_Mxrker", *kFindNeedleOtherCase = "XNVSE_MXRKER";
+	const char *kReplaceWith = "xNVSE_Replacement";
+	std::string s_searchText;
+	std::string s_replacedText;
+
+	void BuildSearchText()
+	{
+		if (!s_searchText.empty())
+			return;
+		static const char *kWords[] = {"the ", "Vault ", "quest ", "NVDLC01 ", "stage ", "Courier ", "Mojave ", "xp ", "in ",
+			"Strip ", "of ", "Legion "};
+		std::mt19937 rng(0x53524348);
+		const UInt32 blockSize = kSearchTextSize / kNumSearchMatches, fillerSize = blockSize - strlen(kSearchNeedle) - 1;
+		s_searchText.reserve(kSearchTextSize + strlen(kFindNeedle));
+		for (UInt32 block = 0; block < kNumSearchMatches; block++)
+		{
+			const size_t fillerEnd = (size_t)block * blockSize + fillerSize;
+			while (s_searchText.size() < fillerEnd)
+				s_searchText += kWords[rng() % 12];
+			s_searchText.resize(fillerEnd);
+			s_searchText += kSearchNeedle;
+			s_searchText += ' ';
+		}
+		s_searchText += kFindNeedle;
+	}
+
+	// What StringVar did before SubStringSearcher: search a lowercased copy of the range with std::string::find
+	UInt32 CopySearch(const char* needle, bool count)
+	{
+		std::string source = s_searchText, lowerNeedle = needle;
+		std::transform(source.begin(), source.end(), source.begin(), game_tolower);
+		std::transform(lowerNeedle.begin(), lowerNeedle.end(), lowerNeedle.begin(), game_tolower);
+		if (!count)
+			return source.find(lowerNeedle);
+		UInt32 numFound = 0;
+		for (size_t pos = 0; (pos = source.find(lowerNeedle, pos)) != std::string::npos; pos += lowerNeedle.size())
+			numFound++;
+		return numFound;
+	}
+
+	std::string NaiveFold(std::string str, bool caseSensitive)
+	{
+		if (!caseSensitive)
+			std::transform(str.begin(), str.end(), str.begin(), game_tolower);
+		return str;
+	}
+
+	// Untimed: Find, Count and Replace over random ranges of random strings, from a small alphabet so that matches and
+	// near misses are frequent, have to agree with std::string::find on case-folded copies.
+	void CheckSubStringSearch()
+	{
+		std::mt19937 rng(0x53554253);
+		static const char kAlphabet[] = "aAbBx_";
+		UInt32 mismatches = 0;
+		for (UInt32 step = 0; step < 20000; step++)
+		{
+			std::string str(rng() % 200, ' '), needle(1 + rng() % 6, ' '), replaceWith(rng() % 4, 'r');
+			for (char &chr : str)
+				chr = kAlphabet[rng() % 6];
+			for (char &chr : needle)
+				chr = kAlphabet[rng() % 6];
+			const bool caseSensitive = rng() & 1;
+			const UInt32 startPos = str.empty() ? 0 : rng() % str.size(), numChars = rng() % (str.size() - startPos + 1);
+			const UInt32 numToReplace = (rng() & 1) ? -1 : rng() % 4;
+			const SubStringSearcher searcher(needle.data(), needle.size(), caseSensitive);
+			const std::string foldedStr = NaiveFold(str.substr(startPos, numChars), caseSensitive);
+			const std::string foldedNeedle = NaiveFold(needle, caseSensitive);
+
+			mismatches += searcher.Find(str.data() + startPos, numChars) != (UInt32)foldedStr.find(foldedNeedle);
+
+			std::string expected = str.substr(0, startPos);
+			UInt32 numFound = 0, numReplaced = 0;
+			size_t copied = 0;
+			for (size_t pos = 0; (pos = foldedStr.find(foldedNeedle, pos)) != std::string::npos; pos += needle.size())
+			{
+				numFound++;
+				if (numReplaced < numToReplace)
+				{
+					expected.append(str, startPos + copied, pos - copied);
+					expected += replaceWith;
+					copied = pos + needle.size();
+					numReplaced++;
+				}
+			}
+			expected.append(str, startPos + copied);
+			mismatches += searcher.Count(str.data() + startPos, numChars) != numFound;
+
+			std::string result = "unchanged";
+			const UInt32 replaced = searcher.Replace(str, startPos, numChars, replaceWith, numToReplace, result);
+			mismatches += (replaced != numReplaced) || (result != (replaced ? expected : "unchanged"));
+		}
+		if (mismatches)
+		{
+			fprintf(stderr, "substring search: %u results differ from std::string::find\n", mismatches);
+			exit(1);
+		}
+	}
+
+	enum SearchOp
+	{
+		kSearch_Find,
+		kSearch_Count,
+		kSearch_Replace,
+		kSearch_CopyFind,
+		kSearch_CopyCount,
+	};
+
+	// One search of the whole text, like sv_Find, sv_Count or sv_Replace on a 4 MB string; each op is one KB searched.
+	template <SearchOp Op, bool CaseSensitive>
+	Benchmark MakeSearchBenchmark(const char* name)
+	{
+		return {name, [] {if ((Op == kSearch_Find) && CaseSensitive) CheckSubStringSearch(); BuildSearchText();}, []
+		{
+			const char *needle = (Op == kSearch_Find) || (Op == kSearch_CopyFind) ? (CaseSensitive ? kFindNeedle : kFindNeedleOtherCase) :
+				(CaseSensitive ? kSearchNeedle : kSearchNeedleOtherCase);
+			const SubStringSearcher searcher(needle, strlen(needle), CaseSensitive);
+			UInt32 result;
+			switch (Op)
+			{
+			case kSearch_Find:
+				result = searcher.Find(s_searchText.data(), s_searchText.size());
+				break;
+			case kSearch_Count:
+				result = searcher.Count(s_searchText.data(), s_searchText.size());
+				break;
+			case kSearch_Replace:
+				result = searcher.Replace(s_searchText, 0, s_searchText.size(), kReplaceWith, -1, s_replacedText);
+				break;
+			default:
+				result = CopySearch(needle, Op == kSearch_CopyCount);
+				break;
+			}
+			g_sink = g_sink + result;
+			return (UInt32)(s_searchText.size() >> 10);
+		}};
+	}
+
+	// Stand-in for an ArrayElement holding a string. With Inline set, strings of up to 7 characters are kept in the value
+	// union the way ArrayData stores them (ArrayData::kMaxInlineStr), otherwise every string is a heap copy.
+	template <bool Inline> struct StrElementStandIn
+	{
+		static constexpr UInt32 kMaxInlineStr = 7;
+
+		UInt8		dataType = 0;
+		bool		strIsInline = false;
+		UInt8		pad[2];
+		UInt32		owningArray = 0;
+		union
+		{
+			char	*str = nullptr;
+			char	inlineStr[kMaxInlineStr + 1];
+		};
+		UInt64		reserved;
+
+		~StrElementStandIn()
+		{
+			if (!strIsInline)
+				free(str);
+		}
+
+		void SetStr(const std::string& value)
+		{
+			dataType = 3;
+			strIsInline = Inline && (value.size() <= kMaxInlineStr);
+			char *buffer = strIsInline ? inlineStr : (str = (char*)malloc(value.size() + 1));
+			memcpy(buffer, value.c_str(), value.size() + 1);
+		}
+
+		// as ArrayData::StrPtr
+		const char* GetStr() const
+		{
+			const uintptr_t inlineMask = 0 - (uintptr_t)strIsInline;
+			return (const char*)(((uintptr_t)inlineStr & inlineMask) | ((uintptr_t)str & ~inlineMask));
+		}
+	};
+	static_assert(sizeof(StrElementStandIn<true>) == 24);
+
+	// String array values as scripts build them: names, flags and numbers turned into strings, a few of them with a
+	// number appended, and every fourth one an editor ID too long to be stored inline.
+	const char *kElementWords[] = {"name", "value", "Caps", "NCR", "Legion", "done", "Stimpak", "x", "ammo", "Vault", "1", "250"};
+	constexpr UInt32 kNumElementWords = sizeof(kElementWords) / sizeof(kElementWords[0]);
+	std::vector<std::string> s_elementValues;
+	std::vector<UInt32> s_elementOrder;		// shuffled indices, the order lookups visit the elements in
+
+	template <bool Inline> std::unique_ptr<Vector<StrElementStandIn<Inline>>> s_strElements;
+
+	void MakeElementValues()
+	{
+		if (s_elementValues.size() == g_numElements)
+			return;
+		std::mt19937 rng(0x41525253);
+		s_elementValues.resize(g_numElements);
+		s_elementOrder.resize(g_numElements);
+		for (UInt32 idx = 0; idx < g_numElements; idx++)
+		{
+			if ((idx & 3) == 3)
+				s_elementValues[idx] = "NVDLC03Item_" + std::to_string(idx);
+			else
+			{
+				s_elementValues[idx] = kElementWords[rng() % kNumElementWords];
+				if (!(idx % 5))
+					s_elementValues[idx] += std::to_string(idx % 100);
+			}
+			s_elementOrder[idx] = idx;
+		}
+		std::shuffle(s_elementOrder.begin(), s_elementOrder.end(), rng);
+	}
+
+	template <bool Inline> UInt32 BuildStrElements()
+	{
+		MakeElementValues();
+		s_strElements<Inline> = std::make_unique<Vector<StrElementStandIn<Inline>>>();
+		for (const std::string& value : s_elementValues)
+			s_strElements<Inline>->Append()->SetStr(value);
+		return g_numElements;
+	}
+
+	// Compares every element, in random order, against a word the way ar_Find and string keyed lookups do.
+	template <bool Inline> UInt32 LookupStrElements()
+	{
+		const Vector<StrElementStandIn<Inline>> &elements = *s_strElements<Inline>;
+		UInt32 numEqual = 0;
+		for (UInt32 idx : s_elementOrder)
+			numEqual += !StrCompare(elements[idx].GetStr(), kElementWords[idx % kNumElementWords]);
+		g_sink = g_sink + numEqual;
+		return g_numElements;
+	}
+
+	template <bool Inline> UInt32 DestroyStrElements()
+	{
+		s_strElements<Inline>.reset();
+		return g_numElements;
+	}
+
+	// A packed array of the input numbers, in the PackedNumbers ArrayVar keeps them in, against the ArrayElements it
+	// kept them in before
+	std::unique_ptr<PackedNumbers> s_packed;
+
+	void FillPacked()
+	{
+		s_packed = std::make_unique<PackedNumbers>();
+		PackedNumbers::NumberVector &numbers = s_packed->Writable();
+		for (double value : g_inputs.numbers)
+			numbers.Append(value);
+	}
+
+	// ar_Sort on elements: each one inserted into the result with InsertSorted
+	void SortElements(Vector<ElementStandIn>& elements, Vector<ElementStandIn>& sorted, bool descending)
+	{
+		for (ElementStandIn &element : elements)
+			sorted.InsertSorted(element, descending);
+	}
+
+	// Untimed: sorting the numbers has to give the order inserting elements one by one gives, in both directions,
+	// with equal values and zeros of either sign among them.
+	void CheckPackedSort()
+	{
+		std::mt19937 rng(0x534F5254);
+		for (UInt32 round = 0; round < 200; round++)
+		{
+			const UInt32 count = 1 + rng() % 300, numValues = 1 + rng() % 40;
+			Vector<ElementStandIn> elements;
+			PackedNumbers packed;
+			for (UInt32 idx = 0; idx < count; idx++)
+			{
+				const UInt32 value = rng() % numValues;
+				const double num = value ? (double)value - (numValues / 2) : ((rng() & 1) ? -0.0 : 0.0);
+				elements.Append(MakeElement(num));
+				packed.Writable().Append(num);
+			}
+			for (bool descending : {false, true})
+			{
+				Vector<ElementStandIn> sortedElements;
+				PackedNumbers sorted;
+				SortElements(elements, sortedElements, descending);
+				PackedNumbers::AppendSorted(packed.Get(), sorted.Writable(), descending);
+				for (UInt32 idx = 0; idx < count; idx++)
+				{
+					if (memcmp(&sortedElements[idx].num, &sorted.Get()[idx], sizeof(double)))
+					{
+						fprintf(stderr, "packed numbers sort differently from elements (%u numbers, %s, at %u)\n", count,
+							descending ? "descending" : "ascending", idx);
+						exit(1);
+					}
+				}
+			}
+		}
+	}
+
+	// Cosave records of a packed array's values, as WriteArrayRecord writes them: a type byte and the number
+	void SaveElements()
+	{
+		s_task = std::make_unique<Serialization::SerializationTask>();
+		s_task->Allocate(0x40000);
+		for (ElementStandIn &element : *s_vector)
+		{
+			s_task->Write8(element.dataType);
+			s_task->Write64(&element.num);
+		}
+	}
+
+	void SavePacked()
+	{
+		s_task = std::make_unique<Serialization::SerializationTask>();
+		s_task->Allocate(0x40000);
+		const PackedNumbers::Range numbers = s_packed->Get();
+		for (UInt32 idx = 0; idx < numbers.Size(); idx++)
+		{
+			s_task->Write8(1);
+			s_task->Write64(numbers.GetPtr(idx));
+		}
+	}
+
+	void CheckPackedCopies()
+	{
+		if (const UInt32 mismatches = HostArrays::CheckCopies())
+		{
+			fprintf(stderr, "packed number copies: %u steps left an array holding other numbers than it should\n", mismatches);
+			exit(1);
+		}
+	}
+
+	enum CopyKind
+	{
+		kCopy_Elements,		// setting every element, as for arrays that hold more than numbers
+		kCopy_Numbers,		// copying the doubles
+		kCopy_Shared,		// sharing them until a write
+	};
+
+	// Copies of the packed array of the input numbers, each read through once, after one of its numbers is changed with
+	// Write set; each op is one number read.
+	template <CopyKind Kind, bool Write>
+	UInt32 CopyThenRead()
+	{
+		constexpr UInt32 kNumCopies = 20;
+		double sum = 0;
+		for (UInt32 copyIdx = 0; copyIdx < kNumCopies; copyIdx++)
+		{
+			const UInt32 written = copyIdx % g_numElements;
+			if constexpr (Kind == kCopy_Elements)
+			{
+				Vector<ElementStandIn> copy;
+				for (ElementStandIn &element : *s_vector)
+					copy.Append(element);
+				if (Write)
+					copy[written].num = -1;
+				for (const ElementStandIn &element : copy)
+					sum += element.num;
+			}
+			else
+			{
+				PackedNumbers copy;
+				if constexpr (Kind == kCopy_Shared)
+					copy = *s_packed;
+				else
+					copy.Writable().Concatenate(s_packed->Get().Data(), s_packed->Size());
+				if (Write)
+					copy.Writable()[written] = -1;
+				const PackedNumbers::Range numbers = copy.Get();
+				for (UInt32 idx = 0; idx < numbers.Size(); idx++)
+					sum += numbers[idx];
+			}
+		}
+		g_sink = g_sink + (UInt64)sum;
+		return kNumCopies * g_numElements;
+	}
+
+	void CheckPackedSlices()
+	{
+		if (const UInt32 mismatches = HostArrays::CheckSlices())
+		{
+			fprintf(stderr, "packed number slices: %u arrays or steps held other numbers than they should\n", mismatches);
+			exit(1);
+		}
+	}
+
+	// MakeSlice of half the packed array of the input numbers, each slice starting further in, read through with Read
+	// set; each op is one slice. A shared slice is a view of the array's numbers.
+	template <CopyKind Kind, bool Read>
+	UInt32 TakeSlices()
+	{
+		constexpr UInt32 kNumSlices = 200;
+		const UInt32 sliceSize = std::max(g_numElements / 2, 1U);
+		double sum = 0;
+		for (UInt32 sliceIdx = 0; sliceIdx < kNumSlices; sliceIdx++)
+		{
+			const UInt32 lower = sliceIdx % (g_numElements - sliceSize + 1);
+			if constexpr (Kind == kCopy_Elements)
+			{
+				Vector<ElementStandIn> slice;
+				for (UInt32 idx = lower; idx < lower + sliceSize; idx++)
+					slice.Append((*s_vector)[idx]);
+				if (Read)
+					for (const ElementStandIn &element : slice)
+						sum += element.num;
+			}
+			else
+			{
+				PackedNumbers slice;
+				if constexpr (Kind == kCopy_Shared)
+					slice.ShareRange(*s_packed, lower, sliceSize);
+				else
+				{
+					PackedNumbers::NumberVector &numbers = slice.Writable();
+					for (UInt32 idx = lower; idx < lower + sliceSize; idx++)
+						numbers.Append(s_packed->Get()[idx]);
+				}
+				if (Read)
+				{
+					const PackedNumbers::Range numbers = slice.Get();
+					for (UInt32 idx = 0; idx < numbers.Size(); idx++)
+						sum += numbers[idx];
+				}
+			}
+		}
+		g_sink = g_sink + (UInt64)sum;
+		return kNumSlices;
+	}
+
+	// Untimed: what the storage of a packed array of the input numbers takes up either way
+	void ReportNumberMemory()
+	{
+		s_vector.reset();
+		s_packed.reset();
+		UInt64 before = Pool_BytesInUse();
+		FillVector();
+		const UInt64 elementBytes = Pool_BytesInUse() - before;
+		s_vector.reset();
+		before = Pool_BytesInUse();
+		FillPacked();
+		const UInt64 packedBytes = Pool_BytesInUse() - before + sizeof(PackedNumbers::NumberVector);
+		s_packed.reset();
+		printf("\n%u numbers in a packed array: %llu KB as elements, %llu KB packed\n", g_numElements,
+			(unsigned long long)elementBytes >> 10, (unsigned long long)packedBytes >> 10);
+	}
+
+	// A HUD-like menu: 16 groups of 24 rows, each row with a text and an icon child. Every 50 lookups one row is destroyed
+	// and created again at the end of its group, the way list menus rebuild entries, and the tile hooks fire.
+	constexpr UInt32 kNumGroups = 16, kNumRows = 24, kChurnInterval = 50;
+	std::vector<std::string> s_tilePaths;	// shuffled
+	TileMenu *s_tileMenu = nullptr;
+	std::mt19937 s_churnRng;
+
+	Tile* CreateRow(Tile *group, UInt32 row)
+	{
+		Tile *tile = Tile::Create(group, ("row" + std::to_string(row)).c_str(), {"visible", "y"});
+		Tile::Create(tile, "text", {"string", "x", "width"});
+		Tile::Create(tile, "icon", {"x", "y", "visible", "alpha"});
+		return tile;
+	}
+
+	void BuildTileMenu()
+	{
+		if (s_tileMenu)
+			Tile::Destroy(s_tileMenu);
+		s_tileMenu = (TileMenu*)Tile::Create(nullptr, "HUDMainMenu", {"visible"});
+		for (UInt32 group = 0; group < kNumGroups; group++)
+		{
+			Tile *groupTile = Tile::Create(s_tileMenu, ("g" + std::to_string(group)).c_str(), {"x", "y"});
+			for (UInt32 row = 0; row < kNumRows; row++)
+				CreateRow(groupTile, row);
+		}
+		InterfaceManager::SetMenu("HUDMainMenu", s_tileMenu);
+		s_churnRng.seed(0x54494C45);
+		if (s_tilePaths.empty())
+		{
+			for (UInt32 group = 0; group < kNumGroups; group++)
+			{
+				for (UInt32 row = 0; row < kNumRows; row++)
+				{
+					std::string rowPath = "HUDMainMenu/g" + std::to_string(group) + "/row" + std::to_string(row);
+					s_tilePaths.push_back(rowPath + "/text/string");
+					s_tilePaths.push_back(rowPath + "/icon/alpha");
+					s_tilePaths.push_back(rowPath + "/visible");
+				}
+			}
+			std::shuffle(s_tilePaths.begin(), s_tilePaths.end(), std::mt19937(0x4E565345));
+		}
+	}
+
+	void ChurnRow()
+	{
+		std::string group = "g" + std::to_string(s_churnRng() % kNumGroups);
+		UInt32 row = s_churnRng() % kNumRows;
+		Tile *groupTile = s_tileMenu->GetChild(group.c_str());
+		Tile::Destroy(groupTile->GetChild(("row" + std::to_string(row)).c_str()));
+		CreateRow(groupTile, row);
+	}
+
+	// Runs the lookups with churn; invalidate plays the part of the tile hooks and lookup resolves one path.
+	template <typename Invalidate, typename Lookup>
+	UInt32 ResolveTilePaths(Invalidate&& invalidate, Lookup&& lookup)
+	{
+		char component[0x200];
+		UInt64 sum = 0;
+		for (UInt32 idx = 0; idx < g_numElements; idx++)
+		{
+			if (!(idx % kChurnInterval))
+			{
+				ChurnRow();
+				invalidate();
+			}
+			strcpy(component, s_tilePaths[idx % s_tilePaths.size()].c_str());
+			if (Tile::Value *value = lookup(component))
+				sum += value->id;
+		}
+		g_sink = g_sink + sum;
+		return g_numElements;
+	}
+
+	// Untimed: the cache has to give the uncached result for every lookup of the churned run.
+	void CheckTilePaths()
+	{
+		BuildTileMenu();
+		TilePathCache::Invalidate();
+		char component[0x200], direct[0x200];
+		for (UInt32 idx = 0; idx < g_numElements; idx++)
+		{
+			if (!(idx % kChurnInterval))
+			{
+				ChurnRow();
+				TilePathCache::Invalidate();
+			}
+			const std::string& path = s_tilePaths[idx % s_tilePaths.size()];
+			strcpy(component, path.c_str());
+			strcpy(direct, path.c_str());
+			Tile::Value *cached = TilePathCache::GetComponentValue(component), *expected = InterfaceManager::GetMenuComponentValue(direct);
+			strcpy(component, path.c_str());
+			strcpy(direct, path.c_str());
+			Tile::Value *cachedAlt = TilePathCache::GetComponentValueAlt(component), *expectedAlt = InterfaceManager::GetMenuComponentValueAlt(direct);
+			if (!expected || (cached != expected) || (cachedAlt != expectedAlt))
+			{
+				fprintf(stderr, "tile path cache mismatch for %s at lookup %u\n", path.c_str(), idx);
+				exit(1);
+			}
+		}
+	}
+
+	// Untimed: every cast through the cache has to match the hierarchy walk, also with several threads filling and
+	// overwriting slots at once.
+	void CheckDynamicCasts()
+	{
+		const std::vector<HostRTTI::CastCase> &cases = HostRTTI::BuildCastCases(g_numElements);
+		std::atomic<UInt32> mismatches = 0;
+		auto check = [&](UInt32 start)
+		{
+			for (UInt32 pass = 0; pass < 2; pass++)
+			{
+				for (UInt32 idx = 0; idx < cases.size(); idx++)
+				{
+					const HostRTTI::CastCase &cast = cases[(idx + start) % cases.size()];
+					if (DynamicCastCache::Cast(cast.srcObj, cast.fromType, cast.toType) != HostRTTI::ReferenceCast(cast.srcObj, 0, cast.fromType, cast.toType, 0))
+						mismatches++;
+				}
+			}
+		};
+		std::vector<std::thread> threads;
+		for (UInt32 idx = 0; idx < 4; idx++)
+			threads.emplace_back(check, idx * 977);
+		for (std::thread &thread : threads)
+			thread.join();
+		if (mismatches)
+		{
+			fprintf(stderr, "dynamic cast cache returned %u results that differ from the hierarchy walk\n", mismatches.load());
+			exit(1);
+		}
+	}
+
+	UInt32 RunDynamicCasts(void* (*doCast)(const HostRTTI::CastCase&))
+	{
+		const std::vector<HostRTTI::CastCase> &cases = HostRTTI::GetCastCases();
+		UInt64 sum = 0;
+		for (const HostRTTI::CastCase &cast : cases)
+			sum += (uintptr_t)doCast(cast);
+		g_sink = g_sink + sum;
+		return cases.size();
+	}
+
+	// Stand-ins for the two lookups on the UDF call path that UserFunctionManager::GetFunctionInfo and
+	// FunctionInfo::ResolveParam skip: m_functionInfos is an UnorderedMap<Script*, FunctionInfo>, and
+	// ScriptEventList::GetVariable walks the event list's variables for a parameter's id. FunctionScripts.cpp needs the
+	// game headers and does not build on the host; the rest of a call (evaluating the arguments, running the callee) is
+	// the same either way and left out. unit_tests/new_compiler/udf_call_path.txt times whole calls in the game.
+	struct LocalStandIn
+	{
+		UInt32			id;
+		double			data;
+		LocalStandIn	*next;
+	};
+
+	struct FunctionStandIn
+	{
+		// parameters are the first variables a UDF declares, followed by its locals
+		static constexpr UInt32 kNumVars = 16, kNumParams = 3;
+
+		std::vector<LocalStandIn>	vars;
+		LocalStandIn				*paramLocals[kNumParams] = {};
+
+		LocalStandIn* GetVariable(UInt32 id)
+		{
+			for (LocalStandIn *var = vars.data(); var; var = var->next)
+				if (var->id == id)
+					return var;
+			return nullptr;
+		}
+	};
+
+	constexpr UInt32 kNumStandInFunctions = 64;
+	std::vector<FunctionStandIn> s_functions;
+	UnorderedMap<const void*, FunctionStandIn*> s_functionInfos;
+	const void *s_lastFunction;
+	FunctionStandIn *s_lastFunctionInfo;
+
+	void BuildFunctions()
+	{
+		s_functions.assign(kNumStandInFunctions, FunctionStandIn());
+		for (FunctionStandIn &function : s_functions)
+		{
+			function.vars.resize(FunctionStandIn::kNumVars);
+			for (UInt32 idx = 0; idx < FunctionStandIn::kNumVars; idx++)
+				function.vars[idx] = {idx + 1, 0, idx + 1 < FunctionStandIn::kNumVars ? &function.vars[idx + 1] : nullptr};
+			s_functionInfos[&function] = &function;
+		}
+		s_lastFunction = nullptr;
+	}
+
+	void FreeFunctions()
+	{
+		s_functions = std::vector<FunctionStandIn>();
+		s_functionInfos.Clear();
+		s_lastFunction = nullptr;
+	}
+
+	// Finds function idx and writes three arguments to its parameters. Cached remembers the last function and, on the
+	// function's own event list, the parameters' variables; nested calls of a recursion run on another event list and
+	// walk it either way.
+	template <bool Cached>
+	double CallStandInFunction(UInt32 idx, double arg, bool ownEventList)
+	{
+		const void *script = &s_functions[idx];
+		FunctionStandIn *info;
+		if (!Cached)
+			info = *s_functionInfos.GetPtr(script);
+		else
+		{
+			if (script != s_lastFunction)
+			{
+				s_lastFunctionInfo = *s_functionInfos.GetPtr(script);
+				s_lastFunction = script;
+			}
+			info = s_lastFunctionInfo;
+		}
+		for (UInt32 param = 0; param < FunctionStandIn::kNumParams; param++)
+		{
+			LocalStandIn *local;
+			if (Cached && ownEventList)
+			{
+				local = info->paramLocals[param];
+				if (!local)
+					local = info->paramLocals[param] = info->GetVariable(param + 1);
+			}
+			else
+				local = info->GetVariable(param + 1);
+			local->data = arg + param;
+		}
+		return info->vars[0].data;
+	}
+
+	template <bool Cached>
+	UInt32 CallStandInFunctions(UInt32 n, UInt32 numInTurn, bool ownEventList)
+	{
+		double total = 0;
+		for (UInt32 call = 0; call < n; call++)
+			total += CallStandInFunction<Cached>(call % numInTurn, call, ownEventList);
+		g_sink = g_sink + (UInt64)total;
+		return n;
+	}
+
+	// GetRefs/GetNumRefs with a distance filter over a dense 5000-ref cell; each op is one radius query
+	constexpr UInt32 kNumCellRefs = 5000;
+	constexpr float kQueryRadius = 2048.0f;
+
+	// Untimed: the index has to accept the same refs as a plain scan, in the same order, while actors and items move
+	// between queries without invalidating the grid, after a fixed ref is moved and its cell invalidated, after fixed
+	// refs are moved without invalidating anything, and once so many have moved that the grid is rebuilt.
+	void CheckRefQueries()
+	{
+		HostCells::BuildCell(kNumCellRefs);
+		Vector<TESObjectREFR*> scanned, indexed;
+		for (UInt32 query = 0; query < 2500; query++)
+		{
+			if (!(query % 100))
+				HostCells::MoveMobileRefs();
+			if (query == 1000)
+				HostCells::MoveFixedRef(query, true);
+			else if ((query >= 1500) && (query < 1600) && !(query % 10))
+				HostCells::MoveFixedRef(query, false);
+			else if (query == 2000)
+			{
+				for (UInt32 index = 0; index < kNumCellRefs; index += 3)
+					index = HostCells::MoveFixedRef(index, false);
+			}
+			scanned.Clear();
+			indexed.Clear();
+			HostCells::ListMatches(query, kQueryRadius, false, scanned);
+			HostCells::ListMatches(query, kQueryRadius, true, indexed);
+			if ((scanned.Size() != indexed.Size()) || memcmp(scanned.Data(), indexed.Data(), scanned.Size() * sizeof(TESObjectREFR*)))
+			{
+				fprintf(stderr, "ref spatial index matched %u refs where a scan matched %u at query %u\n", indexed.Size(), scanned.Size(), query);
+				exit(1);
+			}
+		}
+	}
+
+	// Untimed: the string map container has to hold and hand out what a std::map does, in both of its modes
+	void CheckStrMap()
+	{
+		if (const UInt32 mismatches = HostStrMap::CheckParity())
+		{
+			fprintf(stderr, "string map differed from std::map after %u steps\n", mismatches);
+			exit(1);
+		}
+	}
+
+	// Untimed: every ref ExtractArgsPlanScope hands out has to be the one the list walk finds, see HostScripts
+	void CheckExtractArgs()
+	{
+		UInt32 mismatches = HostScripts::CheckParity();
+		for (UInt32 numRefs : {4, 64, 200})
+		{
+			HostScripts::BuildScript(numRefs);
+			mismatches += HostScripts::ExtractWalk(1000) != HostScripts::ExtractPlanned(1000);
+		}
+		HostScripts::FreeScript();
+		if (mismatches)
+		{
+			fprintf(stderr, "extract args plans: %u lookups differ from the ref list\n", mismatches);
+			exit(1);
+		}
+	}
+
+	// vExtractArgsEx's command and ref lookups for n calls of a script with NumRefs refs, walking the ref list or
+	// through the call site's plan. Scripts with fewer than ExtractArgsPlanScope::kMinPlannedRefs refs get no plan.
+	template <UInt32 NumRefs, bool Planned>
+	Benchmark MakeExtractArgsBenchmark(const char* name, UInt32 n)
+	{
+		return {name, [] {if (NumRefs == 4 && Planned) CheckExtractArgs(); HostScripts::BuildScript(NumRefs);}, [n]
+		{
+			g_sink = g_sink + (Planned ? HostScripts::ExtractPlanned(n) : HostScripts::ExtractWalk(n));
+			return n;
+		}, HostScripts::FreeScript};
+	}
+
+	void CheckInventories()
+	{
+		if (const UInt32 mismatches = HostInventory::CheckParity())
+		{
+			fprintf(stderr, "inventory enumeration: %u containers give other items than looking each one up\n", mismatches);
+			exit(1);
+		}
+	}
+
+	// Enumerations of a container of Entries base container entries, looking every item up in both lists or going
+	// through each list once; each op is one base container entry, so a cost growing with the size is quadratic.
+	template <UInt32 Entries, bool Merged>
+	Benchmark MakeInventoryBenchmark(const char* name)
+	{
+		constexpr UInt32 kNumCalls = std::max(20000 / Entries, 2U);
+		return {name, [] {if (Entries == 10 && Merged) CheckInventories(); HostInventory::BuildContainer(Entries, Entries);}, []
+		{
+			g_sink = g_sink + (Merged ? HostInventory::EnumerateMerged(kNumCalls) : HostInventory::EnumerateScanned(kNumCalls));
+			return kNumCalls * Entries;
+		}, HostInventory::FreeContainer};
+	}
+
+	void CheckDeltaCosaves()
+	{
+		if (const UInt32 differences = HostVars::CheckDeltaLoads())
+		{
+			fprintf(stderr, "delta cosaves: %u variables load differently from the variables saved\n", differences);
+			exit(1);
+		}
+		if (const UInt32 differences = HostVars::CheckMissingBase())
+		{
+			fprintf(stderr, "delta cosaves: %u differences loading with the base file missing\n", differences);
+			exit(1);
+		}
+	}
+
+	// Saves of n variables after 1% of them changed since the last base file; each op is one variable.
+	Benchmark MakeDeltaCosaveBenchmark(const char* name, UInt32 n, bool delta, bool withBase)
+	{
+		return {name, [n, delta]
+		{
+			if (delta) CheckDeltaCosaves();
+			HostVars::Build(n);
+			HostVars::Change(std::max(n / 100, 1U));
+		}, [n, delta, withBase]
+		{
+			g_sink = g_sink + (delta ? HostVars::SaveDelta() : HostVars::SaveFull(withBase));
+			return n;
+		}, HostVars::Free};
+	}
+
+	void CheckAlgohol()
+	{
+		if (const UInt32 mismatches = HostAlgohol::CheckParity())
+		{
+			fprintf(stderr, "algohol batch commands: %u results differ from the scalar commands\n", mismatches);
+			exit(1);
+		}
+	}
+
+	// An Algohol command over n vectors or quaternions, called once per element like the *Ex commands or once for the
+	// whole array like the *Batch commands; each op is one element.
+	template <HostAlgohol::Command Command, bool Batch>
+	Benchmark MakeAlgoholBenchmark(const char* name, UInt32 n)
+	{
+		return {name, [n]
+		{
+			if ((Command == HostAlgohol::kCommand_Normalize) && !Batch) CheckAlgohol();
+			HostAlgohol::Build(n, 0x414C474F);
+		}, [n]
+		{
+			g_sink = g_sink + (Batch ? HostAlgohol::RunBatch(Command) : HostAlgohol::RunScalar(Command));
+			return n;
+		}, HostAlgohol::Free};
+	}
+
+	std::vector<Benchmark> MakeBenchmarks()
+	{
+		const UInt32 n = g_numElements;
+		return {
+			// Vector<ArrayElement>: the storage of array-type arrays
+			{"vector/append", nullptr, [n]
+			{
+				Vector<ElementStandIn> vec;
+				for (double value : g_inputs.numbers)
+					vec.Append(MakeElement(value));
+				g_sink = g_sink + vec.Size();
+				return n;
+			}},
+			{"vector/iterate", FillVector, [n]
+			{
+				double sum = 0;
+				for (const ElementStandIn& element : *s_vector)
+					sum += element.num;
+				g_sink = g_sink + (UInt64)sum;
+				return n;
+			}},
+			{"vector/sort", FillVector, [n]
+			{
+				s_vector->Sort();
+				return n;
+			}},
+			{"vector/erase_front", FillVector, [n]
+			{
+				UInt32 count = std::min(n, 1000U);
+				for (UInt32 idx = 0; idx < count; idx++)
+					s_vector->RemoveNth(0);
+				return count;
+			}},
+
+			// Map<UInt32> and UnorderedMap<UInt32>: form and refID keyed tables
+			{"map_int/insert", nullptr, [n] {FillMapInt(); return n;}},
+			{"map_int/lookup", FillMapInt, [n]
+			{
+				UInt64 sum = 0;
+				for (UInt32 key : g_inputs.ints)
+					sum += *s_mapInt->GetPtr(key);
+				g_sink = g_sink + sum;
+				return n;
+			}},
+			{"map_int/iterate", FillMapInt, [n]
+			{
+				UInt64 sum = 0;
+				for (auto iter = s_mapInt->Begin(); !iter.End(); ++iter)
+					sum += iter.Get();
+				g_sink = g_sink + sum;
+				return n;
+			}},
+			{"map_int/erase", FillMapInt, [n]
+			{
+				for (UInt32 key : g_inputs.ints)
+					s_mapInt->Erase(key);
+				return n;
+			}},
+			{"hash_int/insert", nullptr, [n] {FillHashInt(); return n;}},
+			{"hash_int/lookup", FillHashInt, [n]
+			{
+				UInt64 sum = 0;
+				for (UInt32 key : g_inputs.ints)
+					sum += *s_hashInt->GetPtr(key);
+				g_sink = g_sink + sum;
+				return n;
+			}},
+			{"hash_int/iterate", FillHashInt, [n]
+			{
+				UInt64 sum = 0;
+				for (auto iter = s_hashInt->Begin(); !iter.End(); ++iter)
+					sum += iter.Get();
+				g_sink = g_sink + sum;
+				return n;
+			}},
+			{"hash_int/erase", FillHashInt, [n]
+			{
+				for (UInt32 key : g_inputs.ints)
+					s_hashInt->Erase(key);
+				return n;
+			}},
+
+			// Map<double, ArrayElement>: the storage of map-type arrays
+			{"map_num/insert", nullptr, [n] {FillMapNum(); return n;}},
+			{"map_num/lookup", FillMapNum, [n]
+			{
+				double sum = 0;
+				for (double key : g_inputs.numbers)
+					sum += s_mapNum->GetPtr(key)->num;
+				g_sink = g_sink + (UInt64)sum;
+				return n;
+			}},
+
+			// Map<char*, ArrayElement> and UnorderedMap<char*, ArrayElement>: stringmaps and name tables
+			{"map_str/insert", nullptr, [n] {FillMapStr(); return n;}},
+			{"map_str/lookup", FillMapStr, [n]
+			{
+				double sum = 0;
+				for (const std::string& key : g_inputs.strings)
+					sum += s_mapStr->GetPtr((char*)key.c_str())->num;
+				g_sink = g_sink + (UInt64)sum;
+				return n;
+			}},
+			{"map_str/iterate", FillMapStr, [n]
+			{
+				UInt64 sum = 0;
+				for (auto iter = s_mapStr->Begin(); !iter.End(); ++iter)
+					sum += iter.Key()[0];
+				g_sink = g_sink + sum;
+				return n;
+			}},
+			{"map_str/erase", FillMapStr, [n]
+			{
+				for (const std::string& key : g_inputs.strings)
+					s_mapStr->Erase((char*)key.c_str());
+				return n;
+			}},
+			{"hash_str/insert", nullptr, [n] {FillHashStr(); return n;}},
+			{"hash_str/lookup", FillHashStr, [n]
+			{
+				double sum = 0;
+				for (const std::string& key : g_inputs.strings)
+					sum += s_hashStr->GetPtr((char*)key.c_str())->num;
+				g_sink = g_sink + (UInt64)sum;
+				return n;
+			}},
+			{"hash_str/iterate", FillHashStr, [n]
+			{
+				UInt64 sum = 0;
+				for (auto iter = s_hashStr->Begin(); !iter.End(); ++iter)
+					sum += iter.Key()[0];
+				g_sink = g_sink + sum;
+				return n;
+			}},
+			{"hash_str/erase", FillHashStr, [n]
+			{
+				for (const std::string& key : g_inputs.strings)
+					s_hashStr->Erase((char*)key.c_str());
+				return n;
+			}},
+
+			// ArrayVarElementContainer as a string map: sorted entries and binary search below kStrMapHashThreshold keys,
+			// the hash index and an unsorted tail of new keys from there on; each op is one key
+			{"strmap/build_48", nullptr, [n]
+			{
+				g_sink = g_sink + HostStrMap::BuildSmallMaps(n / 48, 48);
+				return n / 48 * 48;
+			}, HostStrMap::Free},
+			{"strmap/build_128", nullptr, [n]
+			{
+				g_sink = g_sink + HostStrMap::BuildSmallMaps(n / 128, 128);
+				return n / 128 * 128;
+			}, HostStrMap::Free},
+			{"strmap/lookup_63", [] {CheckStrMap(); HostStrMap::Build(63);}, [n]
+			{
+				g_sink = g_sink + HostStrMap::Lookup(n);
+				return n;
+			}, HostStrMap::Free},
+			{"strmap/lookup_64", [] {HostStrMap::Build(64);}, [n]
+			{
+				g_sink = g_sink + HostStrMap::Lookup(n);
+				return n;
+			}, HostStrMap::Free},
+			{"strmap/lookup", [n] {HostStrMap::Build(n);}, [n]
+			{
+				g_sink = g_sink + HostStrMap::Lookup(n);
+				return n;
+			}, HostStrMap::Free},
+			{"strmap/insert", [n] {HostStrMap::Build(n);}, [n]
+			{
+				g_sink = g_sink + HostStrMap::Insert(n);
+				return n;
+			}, HostStrMap::Free},
+			{"strmap/iterate", [n] {HostStrMap::Build(n);}, [n]
+			{
+				g_sink = g_sink + HostStrMap::Iterate();
+				return n;
+			}, HostStrMap::Free},
+			{"strmap/merge_iterate", [n] {HostStrMap::Build(n); HostStrMap::Insert(n / 8);}, [n]
+			{
+				g_sink = g_sink + HostStrMap::Iterate();
+				return n + n / 8;
+			}, HostStrMap::Free},
+
+			// Set<UInt32>
+			{"set_int/insert", nullptr, [n] {FillSet(); return n;}},
+			{"set_int/lookup", FillSet, [n]
+			{
+				UInt32 found = 0;
+				for (UInt32 key : g_inputs.ints)
+					found += s_set->HasKey(key);
+				g_sink = g_sink + found;
+				return n;
+			}},
+
+			// SerializationTask: cosave record encoding and decoding
+			{"cosave/write", nullptr, [n] {WriteRecords(); return n;}},
+			{"cosave/read", WriteRecords, ReadRecords},
+
+			// Serialization::SavePlugins: eight plugin save callbacks, six of them thread-safe, that either only copy their
+			// data or format it first; ns per cosave byte
+			{"cosave/plugins_serial", [] {s_saveAsText = false;}, [] {return SavePlugins(false);}},
+			{"cosave/plugins_parallel", [] {CheckParallelSaves(false);}, [] {return SavePlugins(true);}},
+			{"cosave/text_serial", [] {s_saveAsText = true;}, [] {return SavePlugins(false);}},
+			{"cosave/text_parallel", [] {CheckParallelSaves(true);}, [] {return SavePlugins(true);}},
+
+			// StringVar storage: assigning and comparing (case-insensitively, like scripts do) owned and interned strings
+			{"strings/std_assign", [] {s_stdStrings.assign(g_numElements, std::string());}, [n]
+			{
+				for (UInt32 idx = 0; idx < n; idx++)
+					s_stdStrings[idx] = GetStringValue(idx);
+				return n;
+			}, FreeStrings},
+			{"strings/intern_assign", [] {CheckInternedStrings(); s_internedStrings.assign(g_numElements, InternedString());}, [n]
+			{
+				for (UInt32 idx = 0; idx < n; idx++)
+				{
+					const std::string &value = GetStringValue(idx);
+					s_internedStrings[idx] = InternedString(value.data(), value.size());
+				}
+				return n;
+			}, FreeStrings},
+			{"strings/std_equal", FillStdStrings, [n]
+			{
+				UInt32 numEqual = 0;
+				for (UInt32 idx = 0; idx < n; idx++)
+					numEqual += !StrCompare(s_stdStrings[idx].c_str(), s_stdStrings[GetStringPartner(idx)].c_str());
+				g_sink = g_sink + numEqual;
+				return n;
+			}, FreeStrings},
+			{"strings/intern_equal", FillInternedStrings, [n]
+			{
+				UInt32 numEqual = 0;
+				for (UInt32 idx = 0; idx < n; idx++)
+				{
+					const InternedString &lhs = s_internedStrings[idx], &rhs = s_internedStrings[GetStringPartner(idx)];
+					numEqual += (lhs == rhs) || !StrCompare(lhs.CStr(), rhs.CStr());
+				}
+				g_sink = g_sink + numEqual;
+				return n;
+			}, FreeStrings},
+
+			// StringVar's Find, Count and Replace (SubStringSearcher) on a 4 MB string with 4096 matches, in both case
+			// modes; the copy benchmarks are the lowercased copy and std::string::find they replaced
+			MakeSearchBenchmark<kSearch_Find, true>("strings/find_case"),
+			MakeSearchBenchmark<kSearch_Find, false>("strings/find_nocase"),
+			MakeSearchBenchmark<kSearch_CopyFind, false>("strings/find_copy_nocase"),
+			MakeSearchBenchmark<kSearch_Count, true>("strings/count_case"),
+			MakeSearchBenchmark<kSearch_Count, false>("strings/count_nocase"),
+			MakeSearchBenchmark<kSearch_CopyCount, false>("strings/count_copy_nocase"),
+			MakeSearchBenchmark<kSearch_Replace, true>("strings/replace_case"),
+			MakeSearchBenchmark<kSearch_Replace, false>("strings/replace_nocase"),
+
+			// Vector<ArrayElement> holding strings: heap copies only against strings of up to 7 characters stored inline
+			{"arr_str/heap_build", nullptr, BuildStrElements<false>, DestroyStrElements<false>},
+			{"arr_str/inline_build", nullptr, BuildStrElements<true>, DestroyStrElements<true>},
+			{"arr_str/heap_lookup", BuildStrElements<false>, LookupStrElements<false>, DestroyStrElements<false>},
+			{"arr_str/inline_lookup", BuildStrElements<true>, LookupStrElements<true>, DestroyStrElements<true>},
+			{"arr_str/heap_destroy", BuildStrElements<false>, DestroyStrElements<false>},
+			{"arr_str/inline_destroy", BuildStrElements<true>, DestroyStrElements<true>},
+
+			// Packed arrays holding only numbers, as ArrayElements and as PackedNumbers
+			{"arr_num/elem_build", nullptr, [n] {FillVector(); return n;}},
+			{"arr_num/packed_build", nullptr, [n] {FillPacked(); return n;}},
+			{"arr_num/elem_sum", FillVector, [n]
+			{
+				double sum = 0;
+				for (const ElementStandIn& element : *s_vector)
+					sum += element.num;
+				g_sink = g_sink + (UInt64)sum;
+				return n;
+			}},
+			{"arr_num/packed_sum", FillPacked, [n]
+			{
+				const PackedNumbers::Range numbers = s_packed->Get();
+				double sum = 0;
+				for (UInt32 idx = 0; idx < numbers.Size(); idx++)
+					sum += numbers[idx];
+				g_sink = g_sink + (UInt64)sum;
+				return n;
+			}},
+			{"arr_num/elem_sort", FillVector, [n]
+			{
+				Vector<ElementStandIn> sorted(n);
+				SortElements(*s_vector, sorted, false);
+				g_sink = g_sink + sorted.Size();
+				return n;
+			}},
+			{"arr_num/packed_sort", [] {CheckPackedSort(); FillPacked();}, [n]
+			{
+				PackedNumbers sorted;
+				PackedNumbers::AppendSorted(s_packed->Get(), sorted.Writable(), false);
+				g_sink = g_sink + sorted.Size();
+				return n;
+			}},
+			{"arr_num/elem_save", FillVector, [n] {SaveElements(); return n;}},
+			{"arr_num/packed_save", FillPacked, [n] {SavePacked(); return n;}},
+
+			// ar_Copy of a packed array of numbers, then reading the copy, or writing one number first and reading it
+			{"arr_cow/elem_read", FillVector, CopyThenRead<kCopy_Elements, false>},
+			{"arr_cow/copied_read", FillPacked, CopyThenRead<kCopy_Numbers, false>},
+			{"arr_cow/shared_read", [] {CheckPackedCopies(); FillPacked();}, CopyThenRead<kCopy_Shared, false>},
+			{"arr_cow/elem_write", FillVector, CopyThenRead<kCopy_Elements, true>},
+			{"arr_cow/copied_write", FillPacked, CopyThenRead<kCopy_Numbers, true>},
+			{"arr_cow/shared_write", FillPacked, CopyThenRead<kCopy_Shared, true>},
+
+			// a[lo:hi] of a packed array of numbers, half as long as the array, and the same reading the slice; each op is
+			// one slice
+			{"slice/elements", FillVector, TakeSlices<kCopy_Elements, false>},
+			{"slice/copied", FillPacked, TakeSlices<kCopy_Numbers, false>},
+			{"slice/view", [] {CheckPackedSlices(); FillPacked();}, TakeSlices<kCopy_Shared, false>},
+			{"slice/elements_read", FillVector, TakeSlices<kCopy_Elements, true>},
+			{"slice/copied_read", FillPacked, TakeSlices<kCopy_Numbers, true>},
+			{"slice/view_read", FillPacked, TakeSlices<kCopy_Shared, true>},
+
+			// UI component paths resolved while tiles are created and destroyed; churn_only is the cost of the churn alone
+			{"tiles/churn_only", BuildTileMenu, []
+			{
+				return ResolveTilePaths([] {}, [](char*) {return (Tile::Value*)nullptr;});
+			}},
+			{"tiles/uncached", BuildTileMenu, []
+			{
+				return ResolveTilePaths([] {}, [](char *component) {return InterfaceManager::GetMenuComponentValue(component);});
+			}},
+			{"tiles/global_wipe", BuildTileMenu, []
+			{
+				// what GetUIFloat and friends did before TilePathCache
+				static MemoizedMap<const char*, Tile::Value*> s_memoized;
+				return ResolveTilePaths([] {s_memoized.Clear();}, [](char *component)
+				{
+					return s_memoized.Get(component, [](const char *component) {return InterfaceManager::GetMenuComponentValue(component);});
+				});
+			}},
+			{"tiles/path_cache", [] {CheckTilePaths(); BuildTileMenu(); TilePathCache::Invalidate();}, []
+			{
+				return ResolveTilePaths(TilePathCache::Invalidate, TilePathCache::GetComponentValue);
+			}},
+
+			// DYNAMIC_CAST: the game's hierarchy walk, modelled in host_rtti.cpp, against the cached pointer adjustment
+			{"rtti/hierarchy_walk", [n] {HostRTTI::BuildCastCases(n);}, []
+			{
+				return RunDynamicCasts([](const HostRTTI::CastCase& cast) {return HostRTTI::ReferenceCast(cast.srcObj, 0, cast.fromType, cast.toType, 0);});
+			}, HostRTTI::FreeCastCases},
+			{"rtti/cast_cache", CheckDynamicCasts, []
+			{
+				return RunDynamicCasts([](const HostRTTI::CastCase& cast) {return DynamicCastCache::Cast(cast.srcObj, cast.fromType, cast.toType);});
+			}, HostRTTI::FreeCastCases},
+
+			// GetRefs radius queries: a scan of objectList against the grid, kept across queries and rebuilt before each
+			{"refs/linear_scan", [] {HostCells::BuildCell(kNumCellRefs);}, [n]
+			{
+				g_sink = g_sink + HostCells::QueryLinear(n, kQueryRadius);
+				return n;
+			}, HostCells::FreeCell},
+			{"refs/spatial_index", [] {CheckRefQueries(); HostCells::BuildCell(kNumCellRefs);}, [n]
+			{
+				g_sink = g_sink + HostCells::QueryIndexed(n, kQueryRadius);
+				return n;
+			}, HostCells::FreeCell},
+			{"refs/index_rebuilt", [] {HostCells::BuildCell(kNumCellRefs);}, [n]
+			{
+				UInt64 total = 0;
+				for (UInt32 idx = 0; idx < n; idx++)
+				{
+					HostCells::InvalidateCell();
+					total += HostCells::QueryIndexed(1, kQueryRadius);
+				}
+				g_sink = g_sink + total;
+				return n;
+			}, HostCells::FreeCell},
+
+			// UDF calls: one function in a loop, nested calls of a recursion, two functions in turns; each op is one call
+			{"udf/loop_lookups", BuildFunctions, [n] {return CallStandInFunctions<false>(n, 1, true);}, FreeFunctions},
+			{"udf/loop_cached", BuildFunctions, [n] {return CallStandInFunctions<true>(n, 1, true);}, FreeFunctions},
+			{"udf/recurse_lookups", BuildFunctions, [n] {return CallStandInFunctions<false>(n, 1, false);}, FreeFunctions},
+			{"udf/recurse_cached", BuildFunctions, [n] {return CallStandInFunctions<true>(n, 1, false);}, FreeFunctions},
+			{"udf/mixed_lookups", BuildFunctions, [n] {return CallStandInFunctions<false>(n, 2, true);}, FreeFunctions},
+			{"udf/mixed_cached", BuildFunctions, [n] {return CallStandInFunctions<true>(n, 2, true);}, FreeFunctions},
+
+			// ExtractArgsEx on a command with two or three ref arguments; each op is one call
+			MakeExtractArgsBenchmark<4, false>("args/walk_4", n),
+			MakeExtractArgsBenchmark<4, true>("args/plan_4", n),
+			MakeExtractArgsBenchmark<64, false>("args/walk_64", n),
+			MakeExtractArgsBenchmark<64, true>("args/plan_64", n),
+			MakeExtractArgsBenchmark<200, false>("args/walk_200", n),
+			MakeExtractArgsBenchmark<200, true>("args/plan_200", n),
+
+			// the core plugin's save of string variables: a full cosave, a full one also writing the base file, a delta
+			MakeDeltaCosaveBenchmark("vars/full_save", n, false, false),
+			MakeDeltaCosaveBenchmark("vars/full_with_base", n, false, true),
+			MakeDeltaCosaveBenchmark("vars/delta_save", n, true, false),
+
+			// GetInventoryItems on containers of 10 to 10000 entries
+			MakeInventoryBenchmark<10, false>("inv/scan_10"),
+			MakeInventoryBenchmark<10, true>("inv/merge_10"),
+			MakeInventoryBenchmark<100, false>("inv/scan_100"),
+			MakeInventoryBenchmark<100, true>("inv/merge_100"),
+			MakeInventoryBenchmark<1000, false>("inv/scan_1000"),
+			MakeInventoryBenchmark<1000, true>("inv/merge_1000"),
+			MakeInventoryBenchmark<10000, false>("inv/scan_10000"),
+			MakeInventoryBenchmark<10000, true>("inv/merge_10000"),
+
+			// Algohol vector and quaternion commands over packed arrays, per element or batched
+			MakeAlgoholBenchmark<HostAlgohol::kCommand_Normalize, false>("algohol/norm_scalar", n),
+			MakeAlgoholBenchmark<HostAlgohol::kCommand_Normalize, true>("algohol/norm_batch", n),
+			MakeAlgoholBenchmark<HostAlgohol::kCommand_Cross, false>("algohol/cross_scalar", n),
+			MakeAlgoholBenchmark<HostAlgohol::kCommand_Cross, true>("algohol/cross_batch", n),
+			MakeAlgoholBenchmark<HostAlgohol::kCommand_QMultV3, false>("algohol/qmultv3_scalar", n),
+			MakeAlgoholBenchmark<HostAlgohol::kCommand_QMultV3, true>("algohol/qmultv3_batch", n),
+			MakeAlgoholBenchmark<HostAlgohol::kCommand_Nlerp, false>("algohol/nlerp_scalar", n),
+			MakeAlgoholBenchmark<HostAlgohol::kCommand_Nlerp, true>("algohol/nlerp_batch", n),
+			MakeAlgoholBenchmark<HostAlgohol::kCommand_Slerp, false>("algohol/slerp_scalar", n),
+			MakeAlgoholBenchmark<HostAlgohol::kCommand_Slerp, true>("algohol/slerp_batch", n),
+			MakeAlgoholBenchmark<HostAlgohol::kCommand_FromEuler, false>("algohol/qfrome_scalar", n),
+			MakeAlgoholBenchmark<HostAlgohol::kCommand_FromEuler, true>("algohol/qfrome_batch", n),
+			MakeAlgoholBenchmark<HostAlgohol::kCommand_ToEuler, false>("algohol/qtoe_scalar", n),
+			MakeAlgoholBenchmark<HostAlgohol::kCommand_ToEuler, true>("algohol/qtoe_batch", n),
+		};
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const char *filter = nullptr;
+	for (int idx = 1; idx < argc; idx++)
+	{
+		std::string arg = argv[idx];
+		if ((arg == "-n") && (idx + 1 < argc))
+			g_numElements = std::max(1UL, std::strtoul(argv[++idx], nullptr, 10));
+		else if ((arg == "-r") && (idx + 1 < argc))
+			g_numRepeats = std::max(1UL, std::strtoul(argv[++idx], nullptr, 10));
+		else if ((arg == "-h") || (arg == "--help"))
+		{
+			printf("usage: %s [filter] [-n <elements>] [-r <repeats>]\n", argv[0]);
+			return 0;
+		}
+		else filter = argv[idx];
+	}
+
+	g_inputs.Build(g_numElements);
+	printf("%u elements, best of %u runs\n\n%-22s %12s\n", g_numElements, g_numRepeats, "benchmark", "ns/op");
+	bool ranStrings = false, ranNumbers = false;
+	for (const Benchmark& bench : MakeBenchmarks())
+	{
+		if (filter && !strstr(bench.name, filter))
+			continue;
+		printf("%-22s %12.2f\n", bench.name, TimeBenchmark(bench));
+		fflush(stdout);
+		ranStrings |= !strncmp(bench.name, "strings/", 8);
+		ranNumbers |= !strncmp(bench.name, "arr_num/", 8);
+	}
+	if (ranStrings)
+		ReportStringMemory();
+	if (ranNumbers)
+		ReportNumberMemory();
+	return 0;
+}
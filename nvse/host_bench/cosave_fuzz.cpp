@@ -0,0 +1,205 @@
+// Fuzz harness for the cosave reader: mutated cosaves go through the same checks HandleLoadGame makes before any plugin
+// callback runs (the header read and CosaveIndex::Build), and whatever the index accepts is read back chunk by chunk.
+// Every accepted chunk has to lie inside the file, and no input may read out of bounds; build with
+// -DCMAKE_CXX_FLAGS="-fsanitize=address,undefined" to have the sanitizers catch what the checks here do not.
+//
+// Usage: nvse_cosave_fuzz [-n <iterations>] [-s <seed>]
+// With -DNVSE_COSAVE_LIBFUZZER=ON and Clang the harness is built as a libFuzzer target instead.
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Serialization.h"
+
+namespace
+{
+	using Serialization::CosaveIndex;
+
+	void Fail(const char* what, UInt32 plugin, UInt32 chunk)
+	{
+		fprintf(stderr, "cosave index: %s (plugin %u, chunk %u)\n", what, plugin, chunk);
+		abort();
+	}
+
+	// Returns whether the index accepted data; aborts if it accepted anything it should not have.
+	bool FuzzOne(const UInt8* data, UInt32 size)
+	{
+		Serialization::SerializationTask task;
+		task.Allocate(size);
+		task.WriteBuf(data, size);
+		task.SetOffset(0);
+		Serialization::Header header;
+		try
+		{
+			task.ReadBuf(&header, sizeof(header));
+		}
+		catch (const std::out_of_range&)
+		{
+			return false;
+		}
+
+		CosaveIndex index;
+		if (!index.Build(task.GetData(0), size, sizeof(header)))
+		{
+			if (index.Plugins().Size())
+				Fail("rejected data left in the index", 0, 0);
+			return false;
+		}
+		UInt32 end = sizeof(header), nextChunk = 0;
+		std::vector<UInt8> buffer;
+		for (UInt32 plugin = 0; plugin < index.Plugins().Size(); plugin++)
+		{
+			const CosaveIndex::Plugin &indexed = index.Plugins()[plugin];
+			if (indexed.firstChunk != nextChunk)
+				Fail("chunks are not in file order", plugin, indexed.firstChunk);
+			end += sizeof(Serialization::PluginHeader);
+			for (UInt32 chunk = indexed.firstChunk; chunk < indexed.firstChunk + indexed.numChunks; chunk++)
+			{
+				const CosaveIndex::Chunk &indexedChunk = index.GetChunk(chunk);
+				end += sizeof(Serialization::ChunkHeader);
+				if ((indexedChunk.dataOffset != end) || (indexedChunk.length > size - end))
+					Fail("chunk is not where its header says or runs past the file", plugin, chunk);
+				end += indexedChunk.length;
+
+				// the reads a load callback makes through ReadRecordData
+				buffer.resize(indexedChunk.length);
+				task.SetOffset(indexedChunk.dataOffset);
+				task.ReadBuf(buffer.data(), indexedChunk.length);
+
+				UInt32 first = index.Find(plugin, indexedChunk.type);
+				if ((first < indexed.firstChunk) || (first > chunk) || (index.GetChunk(first).type != indexedChunk.type))
+					Fail("FindRecord would not return the first chunk of this type", plugin, chunk);
+			}
+			nextChunk = indexed.firstChunk + indexed.numChunks;
+		}
+		if (index.Find(index.Plugins().Size(), 'DATA') != CosaveIndex::kNoChunk)
+			Fail("chunk found for a plugin that is not in the file", index.Plugins().Size(), 0);
+		return true;
+	}
+
+	template <UInt32 kPlugin>
+	void SaveSeedPlugin(void*)
+	{
+		if (kPlugin == 2)
+			return;
+		Serialization::WriteRecord('HEAD', kPlugin, nullptr, 0);
+		for (UInt32 record = 0; record < 4 + kPlugin; record++)
+		{
+			Serialization::OpenRecord((record & 1) ? 'DATA' : 'LIST', record);
+			for (UInt32 idx = 0; idx < record * 3; idx++)
+				Serialization::WriteRecord32(idx * 0x01010101);
+		}
+	}
+
+	// A cosave like the game writes: the file header, then plugins with empty and non-empty records of several types.
+	std::vector<UInt8> MakeSeed()
+	{
+		const std::vector<Serialization::PluginSave> plugins = {
+			{0x1400, SaveSeedPlugin<0>, false},
+			{0x3000, SaveSeedPlugin<1>, false},
+			{0x3100, SaveSeedPlugin<2>, false},
+			{0x3200, SaveSeedPlugin<3>, false},
+		};
+		Serialization::SerializationTask task;
+		task.Allocate(0x1000);
+		Serialization::Header header = {Serialization::Header::kSignature, Serialization::Header::kVersion, 6, 0, 0x040020D0, 0};
+		task.WriteBuf(&header, sizeof(header));
+		header.numPlugins = Serialization::SavePlugins(task, plugins, false);
+		UInt32 size = task.GetOffset();
+		task.SetOffset(0);
+		task.WriteBuf(&header, sizeof(header));
+		return std::vector<UInt8>(task.GetData(0), task.GetData(size));
+	}
+
+	void Mutate(std::vector<UInt8>& data, std::mt19937& rng)
+	{
+		auto pick = [&](UInt32 range) {return range ? (UInt32)(rng() % range) : 0;};
+		for (UInt32 count = 1 + pick(3); count; count--)
+		{
+			switch (pick(5))
+			{
+				case 0:
+					if (!data.empty())
+						data[pick(data.size())] ^= 1 << pick(8);
+					break;
+				case 1:
+					// header fields are 4-byte aligned, lengths and counts are where corrupt files hurt
+					if (data.size() >= 4)
+					{
+						static const UInt32 kValues[] = {0, 1, 4, 12, 0x7FFFFFFF, 0x80000000, 0xFFFFFFF4, 0xFFFFFFFF};
+						UInt32 value = pick(3) ? kValues[pick(std::size(kValues))] : (UInt32)rng();
+						memcpy(&data[pick(data.size() / 4) * 4], &value, sizeof(value));
+					}
+					break;
+				case 2:
+					data.resize(pick(data.size() + 1));
+					break;
+				case 3:
+					if (!data.empty())
+					{
+						UInt32 start = pick(data.size()), length = pick(data.size() - start + 1);
+						data.insert(data.begin() + pick(data.size() + 1), data.begin() + start, data.begin() + start + length);
+					}
+					break;
+				default:
+					if (!data.empty())
+					{
+						UInt32 start = pick(data.size());
+						data.erase(data.begin() + start, data.begin() + start + pick(data.size() - start + 1));
+					}
+					break;
+			}
+		}
+	}
+}
+
+#ifdef NVSE_COSAVE_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	if (size <= 0x1000000)
+		FuzzOne(data, size);
+	return 0;
+}
+
+#else
+
+int main(int argc, char **argv)
+{
+	UInt32 numIterations = 200000, seed = 0x4E565345;
+	for (int idx = 1; idx < argc; idx++)
+	{
+		std::string arg = argv[idx];
+		if ((arg == "-n") && (idx + 1 < argc))
+			numIterations = std::strtoul(argv[++idx], nullptr, 0);
+		else if ((arg == "-s") && (idx + 1 < argc))
+			seed = std::strtoul(argv[++idx], nullptr, 0);
+		else
+		{
+			printf("usage: %s [-n <iterations>] [-s <seed>]\n", argv[0]);
+			return 0;
+		}
+	}
+
+	std::vector<UInt8> seedData = MakeSeed();
+	if (!FuzzOne(seedData.data(), seedData.size()))
+	{
+		fprintf(stderr, "the unmodified cosave was rejected\n");
+		return 1;
+	}
+	std::mt19937 rng(seed);
+	UInt32 numAccepted = 0;
+	std::vector<UInt8> data;
+	for (UInt32 iteration = 0; iteration < numIterations; iteration++)
+	{
+		data = seedData;
+		Mutate(data, rng);
+		numAccepted += FuzzOne(data.data(), data.size());
+	}
+	printf("%u mutated cosaves, %u accepted, %u rejected\n", numIterations, numAccepted, numIterations - numAccepted);
+	return 0;
+}
+
+#endif
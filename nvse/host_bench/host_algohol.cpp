@@ -0,0 +1,296 @@
+// Host arrays for the Algohol benchmarks: the scalar commands' per element calls and the batch commands' deinterleaved
+// components (BatchComponents in commands_Algohol.cpp), over the same packed input arrays.
+
+#include "Algohol/algMath.h"
+#include "host_algohol.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr float kInterpolateT = 0.3f;
+
+	// interleaved components as a packed array holds them: [x0, y0, z0, x1, ...] or [w0, x0, y0, z0, w1, ...]
+	std::vector<double>	s_vecs, s_vecs2, s_quats, s_quats2, s_eulers, s_out;
+
+	// BatchComponents: the components of a packed array, one float array per component
+	class Components
+	{
+		std::vector<float>	m_data;
+		UInt32				m_count = 0;
+		UInt32				m_stride = 0;
+
+	public:
+		void Read(const std::vector<double>& arr, UInt32 stride)
+		{
+			Resize(arr.size() / stride, stride);
+			float *components[4];
+			for (UInt32 c = 0; c < stride; c++)
+				components[c] = Component(c);
+			const double *numbers = arr.data();
+			for (UInt32 i = 0; i < m_count; i++, numbers += stride)
+			{
+				for (UInt32 c = 0; c < stride; c++)
+					components[c][i] = numbers[c];
+			}
+		}
+
+		void Resize(UInt32 count, UInt32 stride)
+		{
+			m_count = count;
+			m_stride = stride;
+			m_data.resize(count * stride);
+		}
+
+		void Write(std::vector<double>& arr) const
+		{
+			arr.resize(m_count * m_stride);
+			const float *components[4];
+			for (UInt32 c = 0; c < m_stride; c++)
+				components[c] = m_data.data() + c * m_count;
+			double *out = arr.data();
+			for (UInt32 i = 0; i < m_count; i++, out += m_stride)
+			{
+				for (UInt32 c = 0; c < m_stride; c++)
+					out[c] = components[c][i];
+			}
+		}
+
+		float* Component(UInt32 idx) {return m_data.data() + idx * m_count;}
+		UInt32 Count() const {return m_count;}
+	};
+
+	// what the *Ex command does for each element, its float arguments read from the arrays
+	void RunScalar(HostAlgohol::Command command, int flag, std::vector<double>& out)
+	{
+		const UInt32 count = s_vecs.size() / 3;
+		out.resize(count * (((command == HostAlgohol::kCommand_Nlerp) || (command == HostAlgohol::kCommand_Slerp) ||
+			(command == HostAlgohol::kCommand_FromEuler)) ? 4 : 3));
+		const double *v = s_vecs.data(), *v2 = s_vecs2.data(), *q = s_quats.data(), *q2 = s_quats2.data(), *e = s_eulers.data();
+		for (UInt32 i = 0; i < count; i++)
+		{
+			switch (command)
+			{
+			case HostAlgohol::kCommand_Normalize:
+				{
+					Vector3 r(v[i * 3], v[i * 3 + 1], v[i * 3 + 2]);
+					V3Normalize(r);
+					out[i * 3] = r.x;
+					out[i * 3 + 1] = r.y;
+					out[i * 3 + 2] = r.z;
+					break;
+				}
+			case HostAlgohol::kCommand_Cross:
+				{
+					Vector3 r = V3Crossproduct(Vector3(v[i * 3], v[i * 3 + 1], v[i * 3 + 2]), Vector3(v2[i * 3], v2[i * 3 + 1], v2[i * 3 + 2]));
+					out[i * 3] = r.x;
+					out[i * 3 + 1] = r.y;
+					out[i * 3 + 2] = r.z;
+					break;
+				}
+			case HostAlgohol::kCommand_QMultV3:
+				{
+					Quat rot(q[i * 4], q[i * 4 + 1], q[i * 4 + 2], q[i * 4 + 3]);
+					Vector3 vec(v[i * 3], v[i * 3 + 1], v[i * 3 + 2]);
+					Vector3 r = rot * vec;
+					out[i * 3] = r.x;
+					out[i * 3 + 1] = r.y;
+					out[i * 3 + 2] = r.z;
+					break;
+				}
+			case HostAlgohol::kCommand_Nlerp:
+			case HostAlgohol::kCommand_Slerp:
+				{
+					Quat from(q[i * 4], q[i * 4 + 1], q[i * 4 + 2], q[i * 4 + 3]), to(q2[i * 4], q2[i * 4 + 1], q2[i * 4 + 2], q2[i * 4 + 3]);
+					Quat r = (command == HostAlgohol::kCommand_Slerp) ? slerp(from, to, kInterpolateT) : nlerp(from, to, kInterpolateT);
+					out[i * 4] = r.w;
+					out[i * 4 + 1] = r.x;
+					out[i * 4 + 2] = r.y;
+					out[i * 4 + 3] = r.z;
+					break;
+				}
+			case HostAlgohol::kCommand_FromEuler:
+				{
+					Quat r = fromEuler(Euler(e[i * 3], e[i * 3 + 1], e[i * 3 + 2]), flag);
+					out[i * 4] = r.w;
+					out[i * 4 + 1] = r.x;
+					out[i * 4 + 2] = r.y;
+					out[i * 4 + 3] = r.z;
+					break;
+				}
+			case HostAlgohol::kCommand_ToEuler:
+				{
+					Euler r = fromQuat(Quat(q[i * 4], q[i * 4 + 1], q[i * 4 + 2], q[i * 4 + 3]), flag, 1);
+					out[i * 3] = r.elevation;
+					out[i * 3 + 1] = r.bank;
+					out[i * 3 + 2] = r.heading;
+					break;
+				}
+			}
+		}
+	}
+
+	// The command's component buffers; it allocates them per call from the game's heap, here they are kept between
+	// calls, as fresh blocks of this size come straight from mmap and their page faults would be most of what is timed.
+	Components s_a, s_b;
+
+	// what the *Batch command does: deinterleave, one kernel call, interleave into the result array
+	void RunBatch(HostAlgohol::Command command, int flag, std::vector<double>& out)
+	{
+		Components &a = s_a, &b = s_b;
+		switch (command)
+		{
+		case HostAlgohol::kCommand_Normalize:
+			a.Read(s_vecs, 3);
+			V3NormalizeBatch(a.Component(0), a.Component(1), a.Component(2), a.Count());
+			a.Write(out);
+			break;
+		case HostAlgohol::kCommand_Cross:
+			a.Read(s_vecs, 3);
+			b.Read(s_vecs2, 3);
+			V3CrossproductBatch(a.Component(0), a.Component(1), a.Component(2), b.Component(0), b.Component(1), b.Component(2),
+				a.Component(0), a.Component(1), a.Component(2), a.Count());
+			a.Write(out);
+			break;
+		case HostAlgohol::kCommand_QMultV3:
+			a.Read(s_quats, 4);
+			b.Read(s_vecs, 3);
+			QMultQuatVector3Batch(a.Component(0), a.Component(1), a.Component(2), a.Component(3), 1,
+				b.Component(0), b.Component(1), b.Component(2), b.Component(0), b.Component(1), b.Component(2), b.Count());
+			b.Write(out);
+			break;
+		case HostAlgohol::kCommand_Nlerp:
+		case HostAlgohol::kCommand_Slerp:
+			{
+				a.Read(s_quats, 4);
+				b.Read(s_quats2, 4);
+				const float *from[4] = {a.Component(0), a.Component(1), a.Component(2), a.Component(3)};
+				const float *to[4] = {b.Component(0), b.Component(1), b.Component(2), b.Component(3)};
+				float *result[4] = {a.Component(0), a.Component(1), a.Component(2), a.Component(3)};
+				QInterpolateBatch(from, to, kInterpolateT, command == HostAlgohol::kCommand_Slerp, result, a.Count());
+				a.Write(out);
+				break;
+			}
+		case HostAlgohol::kCommand_FromEuler:
+			{
+				a.Read(s_eulers, 3);
+				b.Resize(a.Count(), 4);
+				const float *in[3] = {a.Component(0), a.Component(1), a.Component(2)};
+				float *result[4] = {b.Component(0), b.Component(1), b.Component(2), b.Component(3)};
+				QFromEulerBatch(in, flag, result, a.Count());
+				b.Write(out);
+				break;
+			}
+		case HostAlgohol::kCommand_ToEuler:
+			{
+				a.Read(s_quats, 4);
+				b.Resize(a.Count(), 3);
+				const float *in[4] = {a.Component(0), a.Component(1), a.Component(2), a.Component(3)};
+				float *result[3] = {b.Component(0), b.Component(1), b.Component(2)};
+				QToEulerBatch(in, flag, result, a.Count());
+				b.Write(out);
+				break;
+			}
+		}
+	}
+
+	UInt64 SumBits(const std::vector<double>& values)
+	{
+		UInt64 sum = 0;
+		for (double value : values)
+		{
+			UInt64 bits;
+			memcpy(&bits, &value, sizeof(bits));
+			sum += bits;
+		}
+		return sum;
+	}
+}
+
+namespace HostAlgohol
+{
+	void Build(UInt32 count, UInt32 seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> coord(-100.0f, 100.0f), unit(-1.0f, 1.0f), angle(-180.0f, 180.0f);
+		s_vecs.resize(count * 3);
+		s_vecs2.resize(count * 3);
+		s_quats.resize(count * 4);
+		s_quats2.resize(count * 4);
+		s_eulers.resize(count * 3);
+		for (UInt32 i = 0; i < count; i++)
+		{
+			for (UInt32 c = 0; c < 3; c++)
+			{
+				// zero vectors take the other branch of normalizing
+				s_vecs[i * 3 + c] = (i % 17 == 5) ? 0.0f : coord(rng);
+				s_vecs2[i * 3 + c] = coord(rng);
+				s_eulers[i * 3 + c] = angle(rng);
+			}
+			for (UInt32 c = 0; c < 4; c++)
+			{
+				s_quats[i * 4 + c] = unit(rng);
+				s_quats2[i * 4 + c] = unit(rng);
+			}
+			// pitched straight up or down, the gimbal lock cases of QToEuler; the same pair twice is slerp's early out
+			if (i % 13 == 3)
+			{
+				const double quat[4] = {0.70710678, 0, (i & 1) ? 0.70710678 : -0.70710678, 0};
+				std::copy(quat, quat + 4, s_quats.begin() + i * 4);
+				std::copy(quat, quat + 4, s_quats2.begin() + i * 4);
+			}
+		}
+		// the result array and the component buffers at their largest, for the same reason
+		s_out.assign(count * 4, 0);
+		s_a.Resize(count, 4);
+		s_b.Resize(count, 4);
+	}
+
+	void Free()
+	{
+		for (std::vector<double> *arr : {&s_vecs, &s_vecs2, &s_quats, &s_quats2, &s_eulers, &s_out})
+			std::vector<double>().swap(*arr);
+		s_a = Components();
+		s_b = Components();
+	}
+
+	UInt64 RunScalar(Command command)
+	{
+		::RunScalar(command, 0, s_out);
+		return SumBits(s_out);
+	}
+
+	UInt64 RunBatch(Command command)
+	{
+		::RunBatch(command, 0, s_out);
+		return SumBits(s_out);
+	}
+
+	UInt32 CheckParity()
+	{
+		UInt32 mismatches = 0;
+		std::vector<double> scalar, batch;
+		for (UInt32 count = 0; count <= 40; count++)
+		{
+			Build(count, 0x414C474F + count);
+			for (Command command : {kCommand_Normalize, kCommand_Cross, kCommand_QMultV3, kCommand_Nlerp, kCommand_Slerp, kCommand_FromEuler, kCommand_ToEuler})
+			{
+				for (int flag = 0; flag < 2; flag++)
+				{
+					::RunScalar(command, flag, scalar);
+					::RunBatch(command, flag, batch);
+					if (scalar.size() != batch.size())
+						mismatches += std::max(scalar.size(), batch.size());
+					else
+					{
+						for (UInt32 i = 0; i < scalar.size(); i++)
+							mismatches += memcmp(&scalar[i], &batch[i], sizeof(double)) != 0;
+					}
+				}
+			}
+		}
+		Free();
+		return mismatches;
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+// Packed arrays of vectors, quaternions and euler angles for timing the Algohol commands on the host: one scalar
+// function call per element, as the *Ex commands make, against one call of the batch kernel (algMath.cpp) over the
+// components the *Batch commands deinterleave from the array. Both read and write the arrays' doubles.
+
+namespace HostAlgohol
+{
+	enum Command
+	{
+		kCommand_Normalize,		// V3NormalizeEx, V3NormalizeBatch
+		kCommand_Cross,			// V3CrossproductEx, V3CrossproductBatch
+		kCommand_QMultV3,		// QMultQuatVector3Ex, QMultQuatVector3Batch with one quaternion per vector
+		kCommand_Nlerp,			// QInterpolateEx, QInterpolateBatch
+		kCommand_Slerp,			// the same with the slerp flag
+		kCommand_FromEuler,		// QFromEulerEx, QFromEulerBatch
+		kCommand_ToEuler,		// QToEulerEx, QToEulerBatch
+	};
+
+	// Makes count random elements of each input array.
+	void Build(UInt32 count, UInt32 seed);
+	void Free();
+
+	// Runs the command over every element and returns a sum of the results' bits; both give the same sum.
+	UInt64 RunScalar(Command command);
+	UInt64 RunBatch(Command command);
+
+	// Untimed: every batch command against its scalar command, bit for bit and for both values of their flags, over
+	// arrays of 0 to 40 elements so that every count of leftover elements is covered. Returns the number of results
+	// that differ.
+	UInt32 CheckParity();
+}
@@ -0,0 +1,247 @@
+// Host arrays for the packed number checks: the PackedNumbers of each array next to the values it should hold.
+
+#include "PackedNumbers.h"
+#include "host_arrays.h"
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	constexpr UInt32 kNumArrays = 8;
+
+	struct HostArray
+	{
+		PackedNumbers		numbers;
+		std::vector<double>	expected;
+
+		bool Matches() const
+		{
+			const PackedNumbers::Range range = numbers.Get();
+			return (range.Size() == expected.size()) && (expected.empty() || !memcmp(range.Data(), expected.data(), range.Size() * sizeof(double)));
+		}
+	};
+
+	// ArrayVar::InsertArray with both arrays holding only numbers; holding the source's numbers makes Writable detach
+	// from them, also when an array is inserted into itself.
+	void InsertArray(HostArray& dst, UInt32 atIndex, const HostArray& src)
+	{
+		const std::vector<double> srcExpected = src.expected;
+		const PackedNumbers srcNumbers = src.numbers;
+		const PackedNumbers::Range srcRange = src.numbers.Get();
+		if (!srcRange.Size())
+			return;
+		PackedNumbers::NumberVector &numbers = dst.numbers.Writable();
+		numbers.InsertSize(atIndex, srcRange.Size());
+		memcpy(numbers.Data() + atIndex, srcRange.Data(), sizeof(double) * srcRange.Size());
+		dst.expected.insert(dst.expected.begin() + atIndex, srcExpected.begin(), srcExpected.end());
+	}
+
+	// ArrayVar::Resize, padding with value
+	void Resize(HostArray& array, UInt32 newSize, double value)
+	{
+		const UInt32 size = array.numbers.Size();
+		if (newSize == size)
+			return;
+		PackedNumbers::NumberVector &numbers = array.numbers.Writable();
+		numbers.Resize(newSize);
+		if (newSize > size)
+			std::fill(numbers.Data() + size, numbers.Data() + newSize, value);
+		array.expected.resize(newSize, value);
+	}
+
+	// ar_Sort: the sorted numbers go to a new array, which then replaces the array at dst
+	void Sort(HostArray& dst, const HostArray& src, bool descending)
+	{
+		PackedNumbers sorted;
+		PackedNumbers::AppendSorted(src.numbers.Get(), sorted.Writable(), descending);
+		std::vector<double> expected = src.expected;
+		std::stable_sort(expected.begin(), expected.end());
+		if (descending)
+			std::reverse(expected.begin(), expected.end());
+		dst.numbers = sorted;
+		dst.expected = std::move(expected);
+	}
+
+	// ArrayVar::MakeSlice of an array holding only numbers, the elements lower to upper; the slice replaces the array
+	// at dst. A slice has to be a view of the source's numbers until either side writes.
+	bool Slice(HostArray& dst, const HostArray& src, UInt32 lower, UInt32 upper)
+	{
+		PackedNumbers slice;
+		std::vector<double> expected;
+		const UInt32 size = src.numbers.Size();
+		bool shared = true;
+		if (size && (lower < size) && (lower <= upper))
+		{
+			upper = std::min(upper, size - 1);
+			slice.ShareRange(src.numbers, lower, upper - lower + 1);
+			expected.assign(src.expected.begin() + lower, src.expected.begin() + upper + 1);
+			shared = slice.Get().Data() == src.numbers.Get().Data() + lower;
+		}
+		dst.numbers = slice;
+		dst.expected = std::move(expected);
+		return shared;
+	}
+
+	// Random steps over kNumArrays arrays, every array compared with what it should hold after each; slices are taken
+	// with withSlices set. Returns the number of steps after which an array differed.
+	UInt32 RunSteps(UInt32 numSteps, UInt32 seed, bool withSlices)
+	{
+		std::vector<HostArray> arrays(kNumArrays);
+		std::mt19937 rng(seed);
+		UInt32 mismatches = 0;
+		for (UInt32 step = 0; step < numSteps; step++)
+		{
+			HostArray &dst = arrays[rng() % kNumArrays];
+			const HostArray &src = arrays[rng() % kNumArrays];
+			const UInt32 size = dst.expected.size();
+			const double value = rng() % 1000;
+			bool stepFailed = false;
+			switch (rng() % (withSlices ? 12 : 10))
+			{
+			case 0:
+			case 1:
+				// ar_Copy; until either side writes the copy has to read the source's numbers
+				dst.numbers = src.numbers;
+				dst.expected = src.expected;
+				stepFailed = dst.numbers.Get().Data() != src.numbers.Get().Data();
+				break;
+			case 2:
+				if (size)
+				{
+					const UInt32 index = rng() % size;
+					dst.numbers.Writable()[index] = value;
+					dst.expected[index] = value;
+				}
+				break;
+			case 3:
+				dst.numbers.Writable().Append(value);
+				dst.expected.push_back(value);
+				break;
+			case 4:
+				if (size)
+				{
+					const UInt32 index = rng() % size;
+					dst.numbers.Writable().RemoveNth(index);
+					dst.expected.erase(dst.expected.begin() + index);
+				}
+				break;
+			case 5:
+				{
+					const UInt32 index = rng() % (size + 1);
+					dst.numbers.Writable().Insert(index, value);
+					dst.expected.insert(dst.expected.begin() + index, value);
+					break;
+				}
+			case 6:
+				Resize(dst, rng() % (size + 6), value);
+				break;
+			case 7:
+				InsertArray(dst, rng() % (size + 1), src);
+				break;
+			case 8:
+				Sort(dst, src, rng() & 1);
+				break;
+			case 9:
+				// ar_Erase of the whole array
+				dst.numbers.Release();
+				dst.expected.clear();
+				break;
+			default:
+				{
+					const UInt32 srcSize = src.expected.size() + 2, lower = rng() % srcSize;
+					stepFailed = !Slice(dst, src, lower, lower + rng() % srcSize);
+					break;
+				}
+			}
+			for (const HostArray &array : arrays)
+				stepFailed |= !array.Matches();
+			mismatches += stepFailed;
+		}
+		return mismatches;
+	}
+
+	// Copies taken on several threads at once from one array, each written and checked on its own thread, while the
+	// copies of the others are released. Returns the number of copies that saw a write through another.
+	UInt32 CheckThreadedCopies()
+	{
+		HostArray source;
+		for (UInt32 idx = 0; idx < 500; idx++)
+		{
+			source.numbers.Writable().Append(idx);
+			source.expected.push_back(idx);
+		}
+		std::atomic<UInt32> mismatches = 0;
+		auto check = [&](UInt32 thread)
+		{
+			for (UInt32 round = 0; round < 2000; round++)
+			{
+				HostArray copy;
+				copy.numbers = source.numbers;
+				copy.expected = source.expected;
+				copy.numbers.Writable()[round % 500] = -1.0 - thread;
+				copy.expected[round % 500] = -1.0 - thread;
+				mismatches += !copy.Matches() || !source.Matches();
+			}
+		};
+		std::vector<std::thread> threads;
+		for (UInt32 idx = 0; idx < 4; idx++)
+			threads.emplace_back(check, idx);
+		for (std::thread &thread : threads)
+			thread.join();
+		return mismatches;
+	}
+}
+
+namespace HostArrays
+{
+	UInt32 CheckCopies()
+	{
+		const UInt64 poolBytes = Pool_BytesInUse();
+		const UInt32 mismatches = RunSteps(20000, 0x434F5059, false) + CheckThreadedCopies();
+		return mismatches + (Pool_BytesInUse() != poolBytes);
+	}
+
+	UInt32 CheckSlices()
+	{
+		const UInt64 poolBytes = Pool_BytesInUse();
+		UInt32 mismatches = 0;
+		{
+			// slices of a slice, then every way of changing the source
+			HostArray source, slice, innerSlice, copy;
+			for (UInt32 idx = 0; idx < 1000; idx++)
+			{
+				source.numbers.Writable().Append(idx);
+				source.expected.push_back(idx);
+			}
+			mismatches += !Slice(slice, source, 100, 199) + !Slice(innerSlice, slice, 10, 19);
+			copy.numbers = innerSlice.numbers;
+			copy.expected = innerSlice.expected;
+			auto check = [&]
+			{
+				mismatches += !slice.Matches() + !innerSlice.Matches() + !copy.Matches() + (slice.expected[0] != 100) +
+					(innerSlice.expected[0] != 110);
+			};
+			for (UInt32 idx = 0; idx < 1000; idx++)
+				source.numbers.Writable()[idx] = -1;
+			check();
+			source.numbers.Writable().RemoveRange(0, 500);
+			source.expected.erase(source.expected.begin(), source.expected.begin() + 500);
+			Resize(source, 2000, -2);
+			check();
+			source.numbers.Release();
+			check();
+			// and the other way round: writing to the slices leaves what they were taken from alone
+			innerSlice.numbers.Writable()[0] = -3;
+			innerSlice.expected[0] = -3;
+			slice.numbers.Writable().Append(-4);
+			slice.expected.push_back(-4);
+			mismatches += !slice.Matches() + !innerSlice.Matches() + !copy.Matches() + (slice.expected[10] != 110) +
+				(copy.expected[0] != 110);
+		}
+		mismatches += RunSteps(20000, 0x534C4943, true);
+		return mismatches + (Pool_BytesInUse() != poolBytes);
+	}
+}
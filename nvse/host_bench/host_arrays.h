@@ -0,0 +1,18 @@
+#pragma once
+// Packed number arrays for checking on the host that the number storage ArrayVar shares between copies and slices
+// (PackedNumbers) never lets a write through one array show through another. ArrayVar itself needs the game headers;
+// each host array makes the PackedNumbers calls ArrayVar makes for the command it stands for.
+
+namespace HostArrays
+{
+	// Untimed: random ar_Copy calls and writes on either side of them (setting, appending, erasing, inserting,
+	// resizing, inserting an array into another, sorting into an array, clearing), each array compared after every step
+	// with a std::vector holding what it should. Returns the number of steps after which an array differed, plus one if
+	// pool memory was left over after freeing the arrays.
+	UInt32 CheckCopies();
+
+	// Untimed: slices of slices and copies of them kept while the source is written, shrunk, grown and cleared, then
+	// written themselves; then the random steps of CheckCopies with slices taken between them (MakeSlice). Returns the
+	// number of wrong arrays and steps, plus one if pool memory was left over.
+	UInt32 CheckSlices();
+}
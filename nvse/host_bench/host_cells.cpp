@@ -0,0 +1,177 @@
+// Host cell for the ref spatial index benchmarks. Refs live in one allocation, are linked into the cell's objectList
+// in creation order and are registered for LookupFormByID like the game's form map.
+
+#include "GameObjects.h"
+#include "CommandTable.h"
+#include "RefSpatialIndex.h"
+#include "host_cells.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+CommandTable g_scriptCommands;
+
+namespace
+{
+	constexpr float kCellExtent = 4096.0f * 5;	// a 5x5 block of exterior cells, like uGridsToLoad 5 merged into one
+
+	TESForm							s_baseForms[4];		// static, door, actor, misc item
+	std::vector<TESObjectREFR>		s_refs;
+	std::vector<ListNode<TESObjectREFR>>	s_nodes;
+	UnorderedMap<UInt32, TESForm*>	s_formMap;
+	TESObjectCELL					s_cell;
+	std::mt19937					s_random;
+
+	bool IsMobile(const TESObjectREFR& refr)
+	{
+		return refr.baseForm->typeID == kFormType_TESNPC || refr.baseForm->typeID == kFormType_TESObjectMISC;
+	}
+
+	// GetRefs' distance test (DistanceAngleMatcher) without the heading check
+	bool InRange(const TESObjectREFR* refr, const TESObjectREFR* center, float radius)
+	{
+		if (refr == center)
+			return true;
+		const float dx = refr->posX - center->posX, dy = refr->posY - center->posY, dz = refr->posZ - center->posZ;
+		return std::sqrt(dx * dx + dy * dy + dz * dz) <= radius;
+	}
+
+	const TESObjectREFR* CenterOf(UInt32 query)
+	{
+		return &s_refs[(query * 2654435761U) % s_refs.size()];
+	}
+}
+
+TESForm *LookupFormByID(UInt32 refID)
+{
+	TESForm **form = s_formMap.GetPtr(refID);
+	return form ? *form : nullptr;
+}
+
+namespace HostCells
+{
+	void BuildCell(UInt32 numRefs)
+	{
+		FreeCell();
+		const UInt8 baseTypes[] = {kFormType_TESObjectSTAT, kFormType_TESObjectDOOR, kFormType_TESNPC, kFormType_TESObjectMISC};
+		for (UInt32 idx = 0; idx < std::size(baseTypes); idx++)
+			s_baseForms[idx] = TESForm{baseTypes[idx], 0x100 + idx};
+
+		s_random.seed(0x5EED);
+		std::uniform_real_distribution<float> coord(0, kCellExtent), height(-200, 2000);
+		s_refs.resize(numRefs);
+		s_nodes.resize(numRefs);
+		s_cell.typeID = kFormType_TESObjectCELL;
+		s_cell.refID = 0x1000;
+		for (UInt32 idx = 0; idx < numRefs; idx++)
+		{
+			TESObjectREFR &refr = s_refs[idx];
+			const UInt32 kind = s_random() % 16;
+			refr.typeID = kind < 1 ? kFormType_Character : kFormType_TESObjectREFR;
+			refr.refID = 0x10000 + idx;
+			refr.baseForm = &s_baseForms[kind < 1 ? 2 : kind < 2 ? 3 : kind < 4 ? 1 : 0];
+			refr.posX = coord(s_random);
+			refr.posY = coord(s_random);
+			refr.posZ = height(s_random);
+			refr.parentCell = &s_cell;
+			s_formMap[refr.refID] = &refr;
+			s_nodes[idx].data = &refr;
+			s_nodes[idx].next = idx + 1 < numRefs ? &s_nodes[idx + 1] : nullptr;
+		}
+		s_cell.objectList.m_listHead = numRefs ? s_nodes[0] : ListNode<TESObjectREFR>{};
+		RefSpatialIndex::MarkDirty(&s_cell);
+	}
+
+	void FreeCell()
+	{
+		s_refs.clear();
+		s_nodes.clear();
+		s_formMap.Clear();
+		s_cell.objectList.m_listHead = {};
+		RefSpatialIndex::MarkDirty(&s_cell);
+	}
+
+	void MoveMobileRefs()
+	{
+		std::uniform_real_distribution<float> step(-300, 300);
+		for (TESObjectREFR &refr : s_refs)
+		{
+			if (!IsMobile(refr))
+				continue;
+			refr.posX = std::clamp(refr.posX + step(s_random), 0.0f, kCellExtent);
+			refr.posY = std::clamp(refr.posY + step(s_random), 0.0f, kCellExtent);
+		}
+	}
+
+	UInt32 MoveFixedRef(UInt32 index, bool invalidate)
+	{
+		for (; index < s_refs.size(); index++)
+		{
+			TESObjectREFR &refr = s_refs[index];
+			if (IsMobile(refr))
+				continue;
+			refr.posX = kCellExtent - refr.posX;
+			refr.posY = kCellExtent - refr.posY;
+			if (invalidate)
+				RefSpatialIndex::MarkRefDirty(&refr);
+			break;
+		}
+		return index;
+	}
+
+	void InvalidateCell()
+	{
+		RefSpatialIndex::MarkDirty(&s_cell);
+	}
+
+	UInt64 QueryLinear(UInt32 numQueries, float radius)
+	{
+		UInt64 total = 0;
+		for (UInt32 query = 0; query < numQueries; query++)
+		{
+			const TESObjectREFR *center = CenterOf(query);
+			for (auto iter = s_cell.objectList.Begin(); !iter.End(); ++iter)
+				if (TESObjectREFR *refr = iter.Get())
+					total += InRange(refr, center, radius);
+		}
+		return total;
+	}
+
+	UInt64 QueryIndexed(UInt32 numQueries, float radius)
+	{
+		Vector<TESObjectREFR*> candidates;
+		UInt64 total = 0;
+		for (UInt32 query = 0; query < numQueries; query++)
+		{
+			const TESObjectREFR *center = CenterOf(query);
+			candidates.Clear();
+			if (!RefSpatialIndex::GatherCandidates(&s_cell, center, radius, candidates))
+			{
+				for (auto iter = s_cell.objectList.Begin(); !iter.End(); ++iter)
+					if (TESObjectREFR *refr = iter.Get())
+						total += InRange(refr, center, radius);
+				continue;
+			}
+			for (TESObjectREFR *refr : candidates)
+				total += InRange(refr, center, radius);
+		}
+		return total;
+	}
+
+	void ListMatches(UInt32 query, float radius, bool indexed, Vector<TESObjectREFR*>& matches)
+	{
+		const TESObjectREFR *center = CenterOf(query);
+		Vector<TESObjectREFR*> candidates;
+		if (!indexed || !RefSpatialIndex::GatherCandidates(&s_cell, center, radius, candidates))
+		{
+			candidates.Clear();
+			for (auto iter = s_cell.objectList.Begin(); !iter.End(); ++iter)
+				if (TESObjectREFR *refr = iter.Get())
+					candidates.Append(refr);
+		}
+		for (TESObjectREFR *refr : candidates)
+			if (InRange(refr, center, radius))
+				matches.Append(refr);
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+// A cell full of references for timing GetRefs/GetNumRefs radius queries on the host: a plain scan of objectList, as
+// the commands do without an index, against the candidates RefSpatialIndex hands out.
+
+namespace HostCells
+{
+	// Makes a cell of numRefs refs spread over an exterior-sized area with a fixed seed. About one in eight is an actor
+	// or a loose item, the rest are statics, doors and other fixed refs.
+	void BuildCell(UInt32 numRefs);
+	void FreeCell();
+
+	// Moves every actor and item a little, as the engine does between frames, without invalidating anything.
+	void MoveMobileRefs();
+
+	// Moves the first fixed ref at or after index across the cell and returns its index. With invalidate set the cell
+	// is invalidated, as after SetPos; without, the position is just written, as a plugin may do.
+	UInt32 MoveFixedRef(UInt32 index, bool invalidate);
+
+	// What the engine hooks do when a ref is attached to the cell or the cell changes state.
+	void InvalidateCell();
+
+	// Counts the refs within radius of each of numQueries centers picked from the cell, by scanning or through the
+	// index, and returns the total. Both apply the same distance test, so the totals must match.
+	UInt64 QueryLinear(UInt32 numQueries, float radius);
+	UInt64 QueryIndexed(UInt32 numQueries, float radius);
+
+	// Lists the refs the scan and the index accept for one query, in the order they are visited.
+	void ListMatches(UInt32 query, float radius, bool indexed, Vector<TESObjectREFR*>& matches);
+}
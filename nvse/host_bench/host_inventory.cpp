@@ -0,0 +1,167 @@
+// Host containers for the inventory enumeration benchmarks, built from the stand-ins in shims/GameForms.h and
+// shims/GameExtraData.h.
+
+#include "InventoryItems.h"
+#include "host_inventory.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+	using EntryData = ExtraContainerChanges::EntryData;
+
+	std::vector<TESForm>								s_forms;
+	std::vector<TESContainer::FormCount>				s_counts;
+	std::vector<ListNode<TESContainer::FormCount>>		s_countNodes;
+	std::vector<EntryData>								s_entries;
+	std::vector<ListNode<EntryData>>					s_entryNodes;
+	ExtraContainerChanges::ExtendDataList				s_leveledData = {true};
+	ExtraContainerChanges::ExtendDataList				s_otherData = {false};
+	TESContainer										s_container;
+	ExtraContainerChanges::EntryDataList				s_entryList;
+
+	template <typename T_Item, typename T_List>
+	void LinkList(T_List& list, std::vector<T_Item>& items, std::vector<ListNode<T_Item>>& nodes)
+	{
+		nodes.resize(items.size());
+		for (UInt32 idx = 0; idx < items.size(); idx++)
+			nodes[idx] = {&items[idx], (idx + 1 < items.size()) ? &nodes[idx + 1] : nullptr};
+		list.m_listHead = items.empty() ? ListNode<T_Item>{} : nodes[0];
+	}
+
+	// GetInventoryItems before GetContainerItems: a GetCountForForm and a FindForItem scan for every base item
+	bool ScanContainerItems(TESContainer* container, ExtraContainerChanges::EntryDataList* entryList, InventoryItemsMap& invItems)
+	{
+		TESForm *item;
+		SInt32 contCount, countDelta;
+		EntryData *entry;
+		for (auto contIter = container->formCountList.Begin(); !contIter.End(); ++contIter)
+		{
+			item = contIter->form;
+			if ((item->typeID == kFormType_TESLevItem) || invItems.HasKey(item))
+				continue;
+			contCount = container->GetCountForForm(item);
+			if (entry = entryList->FindForItem(item))
+			{
+				countDelta = entry->countDelta;
+				if (entry->HasExtraLeveledItem())
+					contCount = countDelta;
+				else contCount += countDelta;
+			}
+			if (contCount > 0)
+				invItems.Emplace(item, contCount, entry);
+		}
+		for (auto xtraIter = entryList->Begin(); !xtraIter.End(); ++xtraIter)
+		{
+			entry = xtraIter.Get();
+			item = entry->type;
+			if (invItems.HasKey(item))
+				continue;
+			countDelta = entry->countDelta;
+			if (countDelta > 0)
+				invItems.Emplace(item, countDelta, entry);
+		}
+		return !invItems.Empty();
+	}
+
+	template <bool Merged>
+	UInt64 Enumerate(UInt32 numCalls)
+	{
+		UInt64 total = 0;
+		InventoryItemsMap invItems(0x40);
+		for (UInt32 call = 0; call < numCalls; call++)
+		{
+			invItems.Clear();
+			if (Merged ? GetContainerItems(&s_container, &s_entryList, invItems) : ScanContainerItems(&s_container, &s_entryList, invItems))
+				for (auto iter = invItems.Begin(); !iter.End(); ++iter)
+					total += iter.Get().count;
+		}
+		return total;
+	}
+}
+
+namespace HostInventory
+{
+	void BuildContainer(UInt32 numEntries, UInt32 seed)
+	{
+		FreeContainer();
+		std::mt19937 random(seed);
+		// a quarter of the base entries are more stacks of an item already in it
+		const UInt32 numBaseItems = std::max(numEntries * 3 / 4, 1U), numForms = numBaseItems + numEntries / 4 + 1;
+		s_forms.resize(numForms);
+		for (UInt32 idx = 0; idx < numForms; idx++)
+			s_forms[idx] = TESForm{(UInt8)((random() % 20) ? kFormType_TESObjectMISC : kFormType_TESLevItem), 0x10000 + idx};
+
+		s_counts.resize(numEntries);
+		for (TESContainer::FormCount &count : s_counts)
+			count = {(SInt32)(random() % 5) + 1, &s_forms[random() % numBaseItems], nullptr};
+
+		for (UInt32 idx = 0; idx < numEntries / 2; idx++)
+		{
+			EntryData entry;
+			switch (random() % 6)
+			{
+			case 0:		// taken out, some of them all of it
+				entry = {nullptr, -(SInt32)(random() % 8), &s_forms[random() % numBaseItems]};
+				break;
+			case 1:		// only in the changes
+				entry = {&s_otherData, (SInt32)(random() % 4), &s_forms[numBaseItems + random() % (numForms - numBaseItems)]};
+				break;
+			case 2:		// resolved from a leveled list, the delta is the count
+				entry = {&s_leveledData, (SInt32)(random() % 4), &s_forms[random() % numBaseItems]};
+				break;
+			default:	// added to, or another entry for an item that has one
+				entry = {(random() & 1) ? &s_otherData : nullptr, (SInt32)(random() % 6) - 1, &s_forms[random() % numForms]};
+				break;
+			}
+			s_entries.push_back(entry);
+		}
+
+		LinkList(s_container.formCountList, s_counts, s_countNodes);
+		LinkList(s_entryList, s_entries, s_entryNodes);
+	}
+
+	void FreeContainer()
+	{
+		s_container.formCountList.m_listHead = {};
+		s_entryList.m_listHead = {};
+		s_forms.clear();
+		s_counts.clear();
+		s_countNodes.clear();
+		s_entries.clear();
+		s_entryNodes.clear();
+	}
+
+	UInt64 EnumerateScanned(UInt32 numCalls)
+	{
+		return Enumerate<false>(numCalls);
+	}
+
+	UInt64 EnumerateMerged(UInt32 numCalls)
+	{
+		return Enumerate<true>(numCalls);
+	}
+
+	UInt32 CheckParity()
+	{
+		UInt32 mismatches = 0;
+		InventoryItemsMap scanned(0x40), merged(0x40);
+		for (UInt32 seed = 0; seed < 2000; seed++)
+		{
+			BuildContainer(seed % 300, seed);
+			scanned.Clear();
+			merged.Clear();
+			bool differs = ScanContainerItems(&s_container, &s_entryList, scanned) != GetContainerItems(&s_container, &s_entryList, merged);
+			differs |= scanned.Size() != merged.Size();
+			for (auto iter = scanned.Begin(); !differs && !iter.End(); ++iter)
+			{
+				const InventoryItemData *data = merged.GetPtr(iter.Key());
+				differs = !data || (data->count != iter.Get().count) || (data->entry != iter.Get().entry);
+			}
+			mismatches += differs;
+		}
+		FreeContainer();
+		return mismatches;
+	}
+}
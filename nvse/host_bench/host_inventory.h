@@ -0,0 +1,21 @@
+#pragma once
+// A container reference's base container and ExtraContainerChanges entries for timing inventory enumeration on the
+// host: looking every item up in both lists, as TESObjectREFR::GetInventoryItems did before, against the one pass of
+// GetContainerItems (InventoryItems.cpp).
+
+namespace HostInventory
+{
+	// Makes a base container of numEntries entries, some of them stacks of the same item or leveled lists, and about
+	// half as many changes entries: deltas for base items, some taking all of them away, items only the changes hold,
+	// leveled items and repeated entries for an item.
+	void BuildContainer(UInt32 numEntries, UInt32 seed);
+	void FreeContainer();
+
+	// Enumerates the container numCalls times and returns a sum of the item counts; both give the same sum.
+	UInt64 EnumerateScanned(UInt32 numCalls);
+	UInt64 EnumerateMerged(UInt32 numCalls);
+
+	// Untimed: compares the items, counts and entries both find in random containers of up to 300 entries. Returns
+	// the number of containers where they differ.
+	UInt32 CheckParity();
+}
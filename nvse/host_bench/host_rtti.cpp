@@ -0,0 +1,131 @@
+// Model class hierarchy for the dynamic cast cache. Layouts follow the game's classes loosely; what matters is that
+// they mix single inheritance chains, multiple inheritance at non-zero offsets and casts that fail.
+
+#include "GameRTTI.h"
+#include "host_rtti.h"
+
+#include <algorithm>
+#include <random>
+
+namespace
+{
+	struct TypeDescriptor
+	{
+		const char	*name;
+	};
+
+	struct BaseClass
+	{
+		const TypeDescriptor	*type;
+		SInt32					offset;
+	};
+
+	struct ClassLayout
+	{
+		std::vector<BaseClass>	bases;		// the class itself first, at offset 0
+		std::vector<SInt32>		vtables;	// offsets of the polymorphic subobjects
+		UInt32					size;
+	};
+
+	struct VTable
+	{
+		const ClassLayout	*layout;
+		SInt32				offset;		// of the subobject holding this vtable in the complete object
+	};
+
+	TypeDescriptor kTESForm{"TESForm"}, kTESObjectREFR{"TESObjectREFR"}, kMobileObject{"MobileObject"}, kActor{"Actor"},
+		kCharacter{"Character"}, kCreature{"Creature"}, kTESChildCell{"TESChildCell"}, kTESFullName{"TESFullName"},
+		kTESModel{"TESModel"}, kTESIcon{"TESIcon"}, kTESScriptableForm{"TESScriptableForm"}, kTESObjectWEAP{"TESObjectWEAP"},
+		kTESActorBase{"TESActorBase"}, kTESContainer{"TESContainer"}, kTESSpellList{"TESSpellList"}, kTESNPC{"TESNPC"},
+		kTESQuest{"TESQuest"}, kScript{"Script"};
+
+	const TypeDescriptor *kAllTypes[] = {&kTESForm, &kTESObjectREFR, &kMobileObject, &kActor, &kCharacter, &kCreature,
+		&kTESChildCell, &kTESFullName, &kTESModel, &kTESIcon, &kTESScriptableForm, &kTESObjectWEAP, &kTESActorBase,
+		&kTESContainer, &kTESSpellList, &kTESNPC, &kTESQuest, &kScript};
+
+	const ClassLayout kLayouts[] =
+	{
+		{{{&kTESObjectREFR, 0}, {&kTESForm, 0}, {&kTESChildCell, 0x18}}, {0, 0x18}, 0x68},
+		{{{&kCharacter, 0}, {&kActor, 0}, {&kMobileObject, 0}, {&kTESObjectREFR, 0}, {&kTESForm, 0}, {&kTESChildCell, 0x18}}, {0, 0x18}, 0x1C0},
+		{{{&kCreature, 0}, {&kActor, 0}, {&kMobileObject, 0}, {&kTESObjectREFR, 0}, {&kTESForm, 0}, {&kTESChildCell, 0x18}}, {0, 0x18}, 0x1C0},
+		{{{&kTESObjectWEAP, 0}, {&kTESForm, 0}, {&kTESFullName, 0x18}, {&kTESModel, 0x24}, {&kTESIcon, 0x3C}, {&kTESScriptableForm, 0x48}}, {0, 0x18, 0x24, 0x3C, 0x48}, 0x388},
+		{{{&kTESNPC, 0}, {&kTESActorBase, 0}, {&kTESForm, 0}, {&kTESContainer, 0x30}, {&kTESSpellList, 0x3C}, {&kTESFullName, 0x50}, {&kTESModel, 0x5C}, {&kTESScriptableForm, 0x74}}, {0, 0x30, 0x3C, 0x50, 0x5C, 0x74}, 0x20C},
+		{{{&kTESQuest, 0}, {&kTESForm, 0}, {&kTESScriptableForm, 0x18}, {&kTESIcon, 0x24}, {&kTESFullName, 0x30}}, {0, 0x18, 0x24, 0x30}, 0x6C},
+		{{{&kScript, 0}, {&kTESForm, 0}}, {0}, 0x54},
+	};
+
+	std::vector<std::vector<VTable>>	s_vtables;	// per layout, per subobject
+	std::vector<UInt8*>					s_objects;
+	std::vector<HostRTTI::CastCase>		s_cases;
+
+	void BuildVTables()
+	{
+		if (!s_vtables.empty())
+			return;
+		for (const ClassLayout &layout : kLayouts)
+		{
+			std::vector<VTable> &vtables = s_vtables.emplace_back();
+			for (SInt32 offset : layout.vtables)
+				vtables.push_back({&layout, offset});
+		}
+	}
+
+	const TypeDescriptor* SubobjectType(const ClassLayout &layout, SInt32 offset)
+	{
+		// the last base at that offset is the most basic one, which is what a component pointer is typed as
+		const TypeDescriptor *type = nullptr;
+		for (const BaseClass &base : layout.bases)
+			if (base.offset == offset)
+				type = base.type;
+		return type;
+	}
+}
+
+const _Fallout_DynamicCast Fallout_DynamicCast = HostRTTI::ReferenceCast;
+
+void* HostRTTI::ReferenceCast(void *srcObj, UInt32 arg1, const void *fromType, const void *toType, UInt32 arg4)
+{
+	if (!srcObj)
+		return nullptr;
+	const VTable *vtable = *(const VTable**)srcObj;
+	UInt8 *complete = (UInt8*)srcObj - vtable->offset;
+	const char *toName = ((const TypeDescriptor*)toType)->name;
+	for (const BaseClass &base : vtable->layout->bases)
+		if (!strcmp(base.type->name, toName))
+			return complete + base.offset;
+	return nullptr;
+}
+
+const std::vector<HostRTTI::CastCase>& HostRTTI::BuildCastCases(UInt32 count)
+{
+	BuildVTables();
+	FreeCastCases();
+	std::mt19937 rng(0x52545449);
+	for (UInt32 idx = 0; idx < count; idx++)
+	{
+		UInt32 layoutIdx = rng() % std::size(kLayouts);
+		const ClassLayout &layout = kLayouts[layoutIdx];
+		auto *object = (UInt8*)calloc(1, layout.size);
+		for (const VTable &vtable : s_vtables[layoutIdx])
+			*(const VTable**)(object + vtable.offset) = &vtable;
+		s_objects.push_back(object);
+		// mostly casts of the form itself, like DYNAMIC_CAST(form, TESForm, ...), some from a component
+		SInt32 fromOffset = (rng() % 4) ? 0 : layout.vtables[rng() % layout.vtables.size()];
+		const void *toType = kAllTypes[rng() % std::size(kAllTypes)];
+		s_cases.push_back({object + fromOffset, SubobjectType(layout, fromOffset), toType});
+	}
+	return s_cases;
+}
+
+const std::vector<HostRTTI::CastCase>& HostRTTI::GetCastCases()
+{
+	return s_cases;
+}
+
+void HostRTTI::FreeCastCases()
+{
+	for (UInt8 *object : s_objects)
+		free(object);
+	s_objects.clear();
+	s_cases.clear();
+}
@@ -0,0 +1,25 @@
+#pragma once
+// A model of the MSVC RTTI the game's Fallout_DynamicCast walks, for checking and timing DynamicCastCache on the host.
+// Objects carry a vtable pointer per polymorphic subobject; the vtable names the complete class and the subobject's
+// offset in it, and the class lists every base with its offset, matched by name like the game's type descriptors.
+
+#include <vector>
+
+namespace HostRTTI
+{
+	struct CastCase
+	{
+		void		*srcObj;
+		const void	*fromType;
+		const void	*toType;
+	};
+
+	// Fallout_DynamicCast on the host: the reference hierarchy walk.
+	void* ReferenceCast(void *srcObj, UInt32 arg1, const void *fromType, const void *toType, UInt32 arg4);
+
+	// Makes count objects of classes modelled on the game's forms and references, with one cast per object from the
+	// object or one of its component subobjects to a modelled type, chosen with a fixed seed.
+	const std::vector<CastCase>& BuildCastCases(UInt32 count);
+	const std::vector<CastCase>& GetCastCases();
+	void FreeCastCases();
+}
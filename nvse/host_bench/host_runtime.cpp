@@ -0,0 +1,216 @@
+// Portable versions of the allocator and string helpers that nvse/containers.cpp and nvse/utility.cpp implement in
+// x86 assembly, and FormatString. They follow the same size classes, growth and hashing so container behaviour matches
+// the game build.
+
+#include <atomic>
+#include <bit>
+#include <cctype>
+
+#define MAX_BLOCK_SIZE		0x400
+#define MEMORY_POOL_SIZE	0x1000
+
+namespace
+{
+	struct BlockNode
+	{
+		BlockNode	*next;
+	};
+
+	std::atomic_flag s_poolLock = ATOMIC_FLAG_INIT;
+	BlockNode *s_pools[MAX_BLOCK_SIZE >> 4] = {nullptr};
+	std::atomic<UInt64> s_poolBytesInUse = 0;
+
+	struct PoolLock
+	{
+		PoolLock() {while (s_poolLock.test_and_set(std::memory_order_acquire));}
+		~PoolLock() {s_poolLock.clear(std::memory_order_release);}
+	};
+
+	UInt32 AlignBlockSize(UInt32 size)
+	{
+		return (size <= 0x10) ? 0x10 : ((size + 0xF) & ~0xF);
+	}
+}
+
+void* Pool_Alloc(UInt32 size)
+{
+	size = AlignBlockSize(size);
+	s_poolBytesInUse += size;
+	if (size > MAX_BLOCK_SIZE)
+		return malloc(size);
+	PoolLock lock;
+	BlockNode *&head = s_pools[(size >> 4) - 1];
+	if (BlockNode *block = head)
+	{
+		head = block->next;
+		return block;
+	}
+	// carve a new pool into blocks of this size, keep all but the last one on the free list
+	UInt32 numBlocks = MEMORY_POOL_SIZE / size;
+	auto *pool = (UInt8*)aligned_alloc(0x10, numBlocks * size);
+	head = (BlockNode*)pool;
+	for (UInt32 idx = 0; idx < numBlocks - 2; idx++)
+		((BlockNode*)(pool + idx * size))->next = (BlockNode*)(pool + (idx + 1) * size);
+	((BlockNode*)(pool + (numBlocks - 2) * size))->next = nullptr;
+	return pool + (numBlocks - 1) * size;
+}
+
+void Pool_Free(void *pBlock, UInt32 size)
+{
+	if (!pBlock)
+		return;
+	size = AlignBlockSize(size);
+	s_poolBytesInUse -= size;
+	if (size > MAX_BLOCK_SIZE)
+	{
+		free(pBlock);
+		return;
+	}
+	PoolLock lock;
+	BlockNode *&head = s_pools[(size >> 4) - 1];
+	((BlockNode*)pBlock)->next = head;
+	head = (BlockNode*)pBlock;
+}
+
+void* Pool_Realloc(void *pBlock, UInt32 curSize, UInt32 reqSize)
+{
+	if (!pBlock)
+		return Pool_Alloc(reqSize);
+	if (reqSize <= curSize)
+		return pBlock;
+	if (AlignBlockSize(curSize) > MAX_BLOCK_SIZE)
+	{
+		s_poolBytesInUse += AlignBlockSize(reqSize) - AlignBlockSize(curSize);
+		return realloc(pBlock, reqSize);
+	}
+	void *newBlock = Pool_Alloc(reqSize);
+	memcpy(newBlock, pBlock, curSize);
+	Pool_Free(pBlock, curSize);
+	return newBlock;
+}
+
+UInt64 Pool_BytesInUse()
+{
+	return s_poolBytesInUse;
+}
+
+void* Pool_Alloc_Buckets(UInt32 numBuckets)
+{
+	// the game build allocates numBuckets * 4 bytes; buckets hold one pointer, which is wider on 64-bit hosts
+	void *buckets = Pool_Alloc(numBuckets * sizeof(void*));
+	memset(buckets, 0, numBuckets * sizeof(void*));
+	return buckets;
+}
+
+UInt32 AlignBucketCount(UInt32 count)
+{
+	if (count <= MAP_DEFAULT_BUCKET_COUNT)
+		return MAP_DEFAULT_BUCKET_COUNT;
+	if (count >= MAP_MAX_BUCKET_COUNT)
+		return MAP_MAX_BUCKET_COUNT;
+	return std::has_single_bit(count) ? count : std::bit_ceil(count);
+}
+
+void MemZero(void *dest, UInt32 bsize)
+{
+	memset(dest, 0, bsize);
+}
+
+UInt32 StrLen(const char *str)
+{
+	return str ? (UInt32)strlen(str) : 0;
+}
+
+char StrCompare(const char *lstr, const char *rstr)
+{
+	if (!lstr) return rstr ? -1 : 0;
+	if (!rstr) return 1;
+	UInt8 lchr, rchr;
+	while (*lstr)
+	{
+		lchr = toupper(*(UInt8*)lstr);
+		rchr = toupper(*(UInt8*)rstr);
+		if (lchr == rchr)
+		{
+			lstr++;
+			rstr++;
+			continue;
+		}
+		return (lchr < rchr) ? -1 : 1;
+	}
+	return *rstr ? -1 : 0;
+}
+
+bool StrEqual(const char *lstr, const char *rstr)
+{
+	return StrCompare(lstr, rstr) == 0;
+}
+
+char* SlashPos(const char *str)
+{
+	if (!str) return NULL;
+	char curr;
+	while ((curr = *str))
+	{
+		if ((curr == '/') || (curr == '\\'))
+			return const_cast<char*>(str);
+		str++;
+	}
+	return NULL;
+}
+
+char* CopyString(const char *key)
+{
+	UInt32 length = StrLen(key) + 1;
+	auto *newStr = (char*)malloc(length);
+	memcpy(newStr, key, length);
+	return newStr;
+}
+
+char* CopyString(const char *key, UInt32 length)
+{
+	auto *newStr = (char*)malloc(length + 1);
+	memcpy(newStr, key, length);
+	newStr[length] = 0;
+	return newStr;
+}
+
+template <bool CaseInsensitive>
+static UInt32 StrHash(const char *inKey)
+{
+	// hash -= chr << (4, 12, 20, 0 for each group of four characters); hash *= 31
+	static constexpr UInt32 kShifts[] = {4, 12, 20, 0};
+	UInt32 hash = 0x6B49D20B;
+	if (!inKey)
+		return hash;
+	for (UInt32 idx = 0; inKey[idx]; idx++)
+	{
+		UInt32 chr = *(const UInt8*)(inKey + idx);
+		if constexpr (CaseInsensitive)
+			chr = tolower(chr);
+		hash -= chr << kShifts[idx & 3];
+		hash = (hash << 5) - hash;
+	}
+	return hash;
+}
+
+UInt32 StrHashCS(const char *inKey)
+{
+	return StrHash<false>(inKey);
+}
+
+UInt32 StrHashCI(const char *inKey)
+{
+	return StrHash<true>(inKey);
+}
+
+// nvse/Utilities.cpp
+std::string FormatString(const char *fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	char msg[0x800];
+	vsnprintf(msg, sizeof(msg), fmt, args);
+	va_end(args);
+	return msg;
+}
@@ -0,0 +1,234 @@
+// Host script for the ExtractArgsPlanScope benchmarks. The bytecode holds one command call per call site, laid out
+// the way vExtractArgsEx reads it: opcode, length, argument count, then a 'r' and a ref list index per argument.
+
+#include "CommandTable.h"
+#include "ExtractArgsPlan.h"
+#include "host_scripts.h"
+
+#include <list>
+#include <vector>
+
+namespace
+{
+	constexpr UInt32 kFirstOpcode = 0x1000;
+
+	// Ref lists are never freed before FreeScript, so a list replaced by a recompile can't be reallocated at the same
+	// address and pass for the old one.
+	struct RefStorage
+	{
+		std::vector<TESForm>					forms;
+		std::vector<Script::RefVariable>		vars;
+		std::vector<ListNode<Script::RefVariable>>	nodes;
+	};
+
+	Script					s_script;
+	std::list<RefStorage>	s_refStorage;
+	std::vector<UInt8>		s_data;
+	std::vector<UInt32>		s_sites;	// offsets of the argument lists in s_data
+	ParamInfo				s_params[0x10];
+
+	// Gives the script a new ref list of numRefs refs, numbered from firstVarIdx.
+	void LinkRefs(UInt32 numRefs, UInt32 firstVarIdx)
+	{
+		RefStorage &storage = s_refStorage.emplace_back();
+		storage.forms.resize(numRefs);
+		storage.vars.resize(numRefs);
+		storage.nodes.resize(numRefs);
+		for (UInt32 idx = 0; idx < numRefs; idx++)
+		{
+			storage.forms[idx] = TESForm{kFormType_TESObjectREFR, 0x10000 + idx};
+			storage.vars[idx] = Script::RefVariable{&storage.forms[idx], firstVarIdx + idx};
+			storage.nodes[idx].data = &storage.vars[idx];
+			storage.nodes[idx].next = idx + 1 < numRefs ? &storage.nodes[idx + 1] : nullptr;
+		}
+		s_script.refList.m_listHead = numRefs ? storage.nodes[0] : ListNode<Script::RefVariable>{};
+		s_script.info.numRefs = numRefs;
+	}
+
+	void AddSite(std::initializer_list<UInt32> refIndices)
+	{
+		const UInt16 opcode = kFirstOpcode + s_sites.size() % 4, length = 2 + refIndices.size() * 3;
+		const UInt16 numArgs = refIndices.size();
+		auto append = [](const void* src, UInt32 size) {s_data.insert(s_data.end(), (const UInt8*)src, (const UInt8*)src + size);};
+		append(&opcode, 2);
+		append(&length, 2);
+		s_sites.push_back(s_data.size());
+		append(&numArgs, 2);
+		for (UInt32 refIdx : refIndices)
+		{
+			const UInt16 index = refIdx;
+			s_data.push_back('r');
+			append(&index, 2);
+		}
+	}
+
+	const UInt8* SiteArgs(UInt32 site)
+	{
+		return s_data.data() + s_sites[site % s_sites.size()];
+	}
+
+	template <bool Planned>
+	UInt64 LookupArgs(CommandInfo* command, const UInt8* args)
+	{
+		UInt64 total = command ? command->opcode : 0;
+		const UInt32 numArgs = *(const UInt16*)args;
+		args += 2;
+		for (UInt32 arg = 0; arg < numArgs; arg++, args += 3)
+		{
+			const UInt32 refIdx = *(const UInt16*)(args + 1);
+			Script::RefVariable *refVar = Planned ? ExtractArgsPlanScope::GetRef(&s_script, refIdx) : s_script.GetRefFromRefList(refIdx);
+			if (refVar)
+				total += refVar->varIdx;
+		}
+		return total;
+	}
+
+	// One call of a site read from dataIn, checking each lookup against the list. nested runs after the first argument,
+	// like a call made from an expression.
+	template <typename T_Nested>
+	void CheckSite(const void* dataIn, const UInt8* args, UInt32& mismatches, T_Nested&& nested)
+	{
+		const ExtractArgsPlanScope scope(s_params, dataIn, args, &s_script, *(const UInt16*)(args - 4));
+		if (scope.Command() != g_scriptCommands.GetByOpcode(*(const UInt16*)(args - 4)))
+			mismatches++;
+		const UInt32 numArgs = *(const UInt16*)args;
+		args += 2;
+		for (UInt32 arg = 0; arg < numArgs; arg++, args += 3)
+		{
+			if (arg == 1)
+				nested();
+			const UInt32 refIdx = *(const UInt16*)(args + 1);
+			if (ExtractArgsPlanScope::GetRef(&s_script, refIdx) != s_script.GetRefFromRefList(refIdx))
+				mismatches++;
+		}
+	}
+
+	void CheckSite(const void* dataIn, const UInt8* args, UInt32& mismatches)
+	{
+		CheckSite(dataIn, args, mismatches, [] {});
+	}
+
+	void CheckAllSites(UInt32& mismatches)
+	{
+		for (UInt32 site = 0; site < s_sites.size(); site++)
+			CheckSite(s_data.data(), SiteArgs(site), mismatches);
+	}
+}
+
+namespace HostScripts
+{
+	void BuildScript(UInt32 numRefs)
+	{
+		FreeScript();
+		if (g_scriptCommands.m_commands.empty())
+			for (UInt32 idx = 0; idx < 4; idx++)
+				g_scriptCommands.m_commands.push_back(CommandInfo{nullptr, kFirstOpcode + idx});
+
+		s_script.typeID = 0x11;
+		s_script.refID = 0x2000;
+		LinkRefs(numRefs, 1);
+		const UInt32 last = numRefs, middle = (numRefs + 1) / 2;
+		AddSite({middle, last});
+		AddSite({last - 1, middle + 1 > last ? last : middle + 1, 1});
+		AddSite({(numRefs + 2) / 3, (numRefs * 2 + 2) / 3});
+		AddSite({last, last});
+		s_script.data = s_data.data();
+		s_script.info.dataLength = s_data.size();
+	}
+
+	void FreeScript()
+	{
+		s_script = Script();
+		s_refStorage.clear();
+		s_data.clear();
+		s_sites.clear();
+	}
+
+	UInt64 ExtractWalk(UInt32 numCalls)
+	{
+		UInt64 total = 0;
+		for (UInt32 call = 0; call < numCalls; call++)
+		{
+			const UInt8 *args = SiteArgs(call);
+			total += LookupArgs<false>(g_scriptCommands.GetByOpcode(*(const UInt16*)(args - 4)), args);
+		}
+		return total;
+	}
+
+	UInt64 ExtractPlanned(UInt32 numCalls)
+	{
+		UInt64 total = 0;
+		for (UInt32 call = 0; call < numCalls; call++)
+		{
+			const UInt8 *args = SiteArgs(call);
+			const ExtractArgsPlanScope scope(s_params, s_script.data, args, &s_script, *(const UInt16*)(args - 4));
+			total += LookupArgs<true>(scope.Command(), args);
+		}
+		return total;
+	}
+
+	UInt32 CheckParity()
+	{
+		UInt32 mismatches = 0;
+
+		// recorded on the first round, replayed on the next ones
+		BuildScript(200);
+		for (UInt32 round = 0; round < 3; round++)
+			CheckAllSites(mismatches);
+
+		// calls made from an expression of another call: one without a plan of its own (bytecode that is not the
+		// script's, as for lambdas) and one with a plan of its own
+		const std::vector<UInt8> otherData = s_data;
+		for (UInt32 round = 0; round < 3; round++)
+		{
+			CheckSite(s_data.data(), SiteArgs(0), mismatches, [&]
+			{
+				CheckSite(otherData.data(), otherData.data() + s_sites[1], mismatches);
+			});
+			CheckSite(s_data.data(), SiteArgs(2), mismatches, [&]
+			{
+				CheckSite(s_data.data(), SiteArgs(3), mismatches);
+			});
+		}
+
+		// lookups in another order than recorded
+		UInt8 *firstSite = s_data.data() + s_sites[0];
+		UInt16 *firstIndex = (UInt16*)(firstSite + 3), *secondIndex = (UInt16*)(firstSite + 6);
+		std::swap(*firstIndex, *secondIndex);
+		CheckAllSites(mismatches);
+		std::swap(*firstIndex, *secondIndex);
+		CheckAllSites(mismatches);
+
+		// more ref arguments than a plan holds
+		AddSite({1, 20, 40, 60, 80, 100, 120, 140, 160, 180, 200});
+		s_script.data = s_data.data();
+		s_script.info.dataLength = s_data.size();
+		for (UInt32 round = 0; round < 3; round++)
+			CheckAllSites(mismatches);
+
+		// recompiled into the same list nodes, which only the compile hook can tell
+		std::vector<ListNode<Script::RefVariable>> &nodes = s_refStorage.back().nodes;
+		for (UInt32 idx = 1, last = nodes.size() - 1; idx < last; idx++, last--)
+			std::swap(nodes[idx].data, nodes[last].data);
+		ExtractArgsPlanScope::Invalidate(&s_script);
+		for (UInt32 round = 0; round < 2; round++)
+			CheckAllSites(mismatches);
+
+		// recompiled with a new ref list, without the compile hook having run
+		LinkRefs(200, 1001);
+		for (UInt32 round = 0; round < 2; round++)
+			CheckAllSites(mismatches);
+
+		// scripts too small for plans, and temporary ones
+		BuildScript(4);
+		for (UInt32 round = 0; round < 2; round++)
+			CheckAllSites(mismatches);
+		BuildScript(200);
+		s_script.flags |= TESForm::kFormFlags_Temporary;
+		for (UInt32 round = 0; round < 2; round++)
+			CheckAllSites(mismatches);
+
+		FreeScript();
+		return mismatches;
+	}
+}
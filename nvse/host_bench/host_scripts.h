@@ -0,0 +1,21 @@
+#pragma once
+// A script with a long ref list for timing the ref lookups vExtractArgsEx makes on the host: walking Script::refList
+// for every lookup, as the extractor did before, against handing them back from ExtractArgsPlanScope.
+
+namespace HostScripts
+{
+	// Makes a script with numRefs refs and a few call sites of commands taking two or three ref arguments, some from
+	// the middle of the list and some from its end, like the form arguments of a quest script.
+	void BuildScript(UInt32 numRefs);
+	void FreeScript();
+
+	// Does the command lookup and ref lookups of numCalls calls, going round the call sites, and returns a sum of what
+	// was found. Both make the same lookups, so the sums must match.
+	UInt64 ExtractWalk(UInt32 numCalls);
+	UInt64 ExtractPlanned(UInt32 numCalls);
+
+	// Untimed: compares every lookup made through ExtractArgsPlanScope with the list walk, with calls nested in other
+	// calls, lookups made in another order than recorded, more refs than a plan holds, recompiles and small scripts.
+	// Returns the number of lookups that differed.
+	UInt32 CheckParity();
+}
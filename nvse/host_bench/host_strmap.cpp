@@ -0,0 +1,211 @@
+// Host string maps for the ArrayVarElementContainer benchmarks: the real container, made a string map the way ArrayVar
+// does, with stand-in elements that only hold a number.
+
+#include "ArrayVar.h"
+#include "host_strmap.h"
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+thread_local ArrayKey s_arrNumKey, s_arrStrKey;
+
+namespace
+{
+	std::unique_ptr<ArrayVarElementContainer>	s_map;
+	std::vector<std::string>					s_keys;			// mixed case, like editor IDs used as keys
+	std::vector<std::string>					s_lookupKeys;	// the same keys in random order, some in another case
+	UInt32										s_numInserted = 0;
+
+	void MakeKeys(UInt32 count, UInt32 seed, std::vector<std::string>& keys)
+	{
+		static const char *kPrefixes[] = {"NVDLC", "Vault", "xNVSE", "aaQuest", "MS", "VMS", "Key", "Note"};
+		std::mt19937 rng(seed);
+		keys.resize(count);
+		for (UInt32 idx = 0; idx < count; idx++)
+			keys[idx] = std::string(kPrefixes[rng() & 7]) + "_Var" + std::to_string(rng() % 1000003) + "_" + std::to_string(idx);
+	}
+
+	void ChangeCase(std::string& key)
+	{
+		for (char &chr : key)
+			chr = isupper((UInt8)chr) ? tolower((UInt8)chr) : toupper((UInt8)chr);
+	}
+
+	ArrayVarElementContainer* NewStrMap()
+	{
+		auto *map = new ArrayVarElementContainer();
+		ArrayVar::InitStrMap(*map);
+		return map;
+	}
+
+	void SetNumber(ArrayElement* element, double num)
+	{
+		element->m_data.dataType = kDataType_Numeric;
+		element->m_data.num = num;
+	}
+
+	UInt64 Walk(ArrayVarElementContainer& map)
+	{
+		UInt64 sum = 0;
+		for (auto iter = map.begin(); !iter.End(); ++iter)
+			sum += iter.first()->key.str[0] + (UInt64)iter.second()->m_data.num;
+		return sum;
+	}
+
+	struct KeyLess
+	{
+		bool operator()(const std::string& lhs, const std::string& rhs) const {return StrCompare(lhs.c_str(), rhs.c_str()) < 0;}
+	};
+}
+
+namespace HostStrMap
+{
+	void Build(UInt32 numKeys)
+	{
+		Free();
+		MakeKeys(numKeys * 2, 0x53544D50, s_keys);
+		s_lookupKeys.assign(s_keys.begin(), s_keys.begin() + numKeys);
+		std::shuffle(s_lookupKeys.begin(), s_lookupKeys.end(), std::mt19937(numKeys));
+		for (UInt32 idx = 0; idx < numKeys; idx += 3)
+			ChangeCase(s_lookupKeys[idx]);
+		s_map.reset(NewStrMap());
+		for (UInt32 idx = 0; idx < numKeys; idx++)
+			SetNumber(s_map->emplaceStrMapElement(s_keys[idx].c_str()), idx);
+		s_numInserted = numKeys;
+		Walk(*s_map);
+	}
+
+	void Free()
+	{
+		s_map.reset();
+		s_keys.clear();
+		s_lookupKeys.clear();
+		s_numInserted = 0;
+	}
+
+	UInt64 Insert(UInt32 numKeys)
+	{
+		UInt64 sum = 0;
+		const UInt32 end = std::min<UInt32>(s_numInserted + numKeys, s_keys.size());
+		for (; s_numInserted < end; s_numInserted++)
+		{
+			ArrayElement *element = s_map->emplaceStrMapElement(s_keys[s_numInserted].c_str());
+			SetNumber(element, s_numInserted);
+			sum += s_numInserted;
+		}
+		return sum;
+	}
+
+	UInt64 Lookup(UInt32 numLookups)
+	{
+		UInt64 sum = 0;
+		for (UInt32 idx = 0; idx < numLookups; idx++)
+			sum += (UInt64)s_map->getStrMapElement(s_lookupKeys[idx % s_lookupKeys.size()].c_str())->m_data.num;
+		return sum;
+	}
+
+	UInt64 Iterate()
+	{
+		return Walk(*s_map);
+	}
+
+	UInt64 BuildSmallMaps(UInt32 numMaps, UInt32 numKeys)
+	{
+		if (s_keys.size() < numKeys)
+			MakeKeys(numKeys, 0x534D4C4C, s_keys);
+		UInt64 sum = 0;
+		for (UInt32 mapIdx = 0; mapIdx < numMaps; mapIdx++)
+		{
+			ArrayVarElementContainer map;
+			ArrayVar::InitStrMap(map);
+			for (UInt32 idx = 0; idx < numKeys; idx++)
+				SetNumber(map.emplaceStrMapElement(s_keys[idx].c_str()), idx);
+			sum += Walk(map);
+		}
+		return sum;
+	}
+
+	UInt32 CheckParity()
+	{
+		std::vector<std::string> keys;
+		MakeKeys(300, 0x50415249, keys);
+		std::unique_ptr<ArrayVarElementContainer> map(NewStrMap());
+		std::map<std::string, double, KeyLess> expected;
+		std::mt19937 rng(0x50415249);
+		UInt32 mismatches = 0;
+		for (UInt32 step = 0; step < 100000; step++)
+		{
+			// inserts draw from the first 50 keys and from all of them in turn, erases always from all of them, so the
+			// map grows past the threshold and shrinks back below it several times
+			const UInt32 op = rng() % 16;
+			const UInt32 window = ((op < 5) && !(step / 2000 % 2)) ? 50 : keys.size();
+			std::string key = keys[rng() % window];
+			if (rng() & 1)
+				ChangeCase(key);
+			const double value = rng() % 1000;
+			bool stepFailed = false;
+			switch (op)
+			{
+			case 0: case 1: case 2: case 3: case 4:
+				{
+					// SetElement: the key keeps the case it was first inserted with
+					SetNumber(map->emplaceStrMapElement(key.c_str()), value);
+					auto found = expected.find(key);
+					if (found != expected.end())
+						found->second = value;
+					else
+						expected.emplace(key, value);
+					break;
+				}
+			case 5: case 6: case 7: case 8: case 9:
+				{
+					const ArrayElement *element = map->getStrMapElement(key.c_str());
+					auto found = expected.find(key);
+					stepFailed = (found == expected.end()) ? (element != nullptr) : (!element || (element->m_data.num != found->second));
+					break;
+				}
+			case 10: case 11: case 12: case 13:
+				{
+					ArrayKey arrKey;
+					arrKey.key.dataType = kDataType_String;
+					arrKey.key.str = key.data();
+					stepFailed = map->erase(&arrKey) != expected.erase(key);
+					break;
+				}
+			case 14:
+				{
+					// ar_Sort and the other commands that take the map itself
+					ElementStrMap *strMap = map->getStrMapPtr();
+					stepFailed = strMap->Size() != expected.size();
+					break;
+				}
+			default:
+				{
+					auto expectedIter = expected.begin();
+					for (auto iter = map->begin(); !iter.End(); ++iter, ++expectedIter)
+					{
+						if ((expectedIter == expected.end()) || StrCompare(iter.first()->key.str, expectedIter->first.c_str()) ||
+							(iter.second()->m_data.num != expectedIter->second))
+						{
+							stepFailed = true;
+							break;
+						}
+					}
+					stepFailed |= expectedIter != expected.end();
+					break;
+				}
+			}
+			stepFailed |= map->size() != expected.size();
+			mismatches += stepFailed;
+			if (step % 25000 == 24999)
+			{
+				map->clear();
+				expected.clear();
+			}
+		}
+		return mismatches;
+	}
+}
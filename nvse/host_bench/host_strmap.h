@@ -0,0 +1,30 @@
+#pragma once
+// A string-keyed array's element container (ArrayVarElementContainer) for timing its two modes on the host: binary
+// search over the sorted keys below kStrMapHashThreshold keys, the hash index with an unsorted tail of new keys from
+// there on, sorted and merged back in when the map is next iterated.
+
+namespace HostStrMap
+{
+	// Makes a string map with numKeys keys, each holding its index, inserted in random order as ar_Map or SetElement
+	// would, then walks it once so that its keys are all sorted.
+	void Build(UInt32 numKeys);
+	void Free();
+
+	// Inserts the next numKeys keys, the map being numKeys smaller to begin with; returns the sum of their values.
+	UInt64 Insert(UInt32 numKeys);
+
+	// Looks up numLookups keys of the map, in random order and with the case of some changed; returns the sum of values.
+	UInt64 Lookup(UInt32 numLookups);
+
+	// Walks the map in key order, which first sorts the keys inserted since the last walk and merges them in; returns a
+	// sum over the keys and values.
+	UInt64 Iterate();
+
+	// Maps of numKeys keys, numMaps of them, each built key by key and walked; returns a sum of the values.
+	UInt64 BuildSmallMaps(UInt32 numMaps, UInt32 numKeys);
+
+	// Untimed: random inserts, lookups, erases, walks and sorted-map handouts (getStrMapPtr) on one map, which crosses
+	// the threshold in both directions, each compared with a std::map ordered by StrCompare. Returns the number of
+	// steps after which the two differed.
+	UInt32 CheckParity();
+}
@@ -0,0 +1,207 @@
+// Host versions of the tile lookups in nvse/GameTiles.cpp and nvse/GameUI.cpp, plus tile creation and destruction
+// for the tile path benchmarks. The lookups follow the game build line for line.
+
+#include "GameUI.h"
+
+namespace
+{
+	const char *kTraitNames[] = {"x", "y", "visible", "alpha", "width", "height", "string", "user0", "user1"};
+
+	UnorderedMap<const char*, TileMenu*> s_menus;
+}
+
+UInt32 TraitNameToID(const char *traitName)
+{
+	for (UInt32 idx = 0; idx < std::size(kTraitNames); idx++)
+		if (!StrCompare(kTraitNames[idx], traitName))
+			return 0xFA1 + idx;
+	return 0;
+}
+
+Tile::Value *Tile::GetValue(UInt32 typeID)
+{
+	UInt32 low = 0, high = values.Size();
+	while (low < high)
+	{
+		UInt32 mid = (low + high) >> 1;
+		Value *value = values[mid];
+		if (value->id == typeID)
+			return value;
+		if (value->id < typeID)
+			low = mid + 1;
+		else high = mid;
+	}
+	return nullptr;
+}
+
+Tile::Value *Tile::GetValueName(const char *valueName)
+{
+	return GetValue(TraitNameToID(valueName));
+}
+
+Tile *Tile::GetChild(const char *childName)
+{
+	int childIndex = 0;
+	char *colon = strchr(const_cast<char*>(childName), ':');
+	if (colon)
+	{
+		if (colon == childName) return nullptr;
+		*colon = 0;
+		childIndex = atoi(colon + 1);
+	}
+	Tile *result = nullptr;
+	for (tList<ChildNode>::Iterator iter = childList.Begin(); !iter.End(); ++iter)
+	{
+		if (*iter && iter->child && ((*childName == '*') || !StrCompare(iter->child->name.m_data, childName)) && !childIndex--)
+		{
+			result = iter->child;
+			break;
+		}
+	}
+	if (colon) *colon = ':';
+	return result;
+}
+
+Tile *Tile::GetChildAlt(const char *childName)
+{
+	int childIndex = 0;
+	char *colon = strchr(const_cast<char*>(childName), ':');
+	if (colon)
+	{
+		if (colon == childName) return nullptr;
+		*colon = 0;
+		childIndex = atoi(colon + 1);
+	}
+	Tile *result = nullptr;
+	bool wildcard = *childName == '*';
+	for (auto node = ((DList<Tile>*)&childList)->Head(); node; node = node->next)
+	{
+		if (node->data && (wildcard || !StrCompare(node->data->name.m_data, childName)) && !childIndex--)
+		{
+			result = node->data;
+			break;
+		}
+	}
+	if (colon) *colon = ':';
+	return result;
+}
+
+Tile::Value *Tile::GetComponentValueAlt(const char *componentPath)
+{
+	Tile *parentTile = this;
+	char *slashPos;
+	while ((slashPos = SlashPos(componentPath)))
+	{
+		*slashPos = 0;
+		parentTile = parentTile->GetChildAlt(componentPath);
+		if (!parentTile) return nullptr;
+		componentPath = slashPos + 1;
+	}
+	return *componentPath ? parentTile->GetValueName(componentPath) : nullptr;
+}
+
+Tile *Tile::GetComponent(const char *componentPath, const char **trait)
+{
+	Tile *parentTile = this;
+	char *slashPos;
+	while ((slashPos = SlashPos(componentPath)))
+	{
+		*slashPos = 0;
+		parentTile = parentTile->GetChild(componentPath);
+		if (!parentTile) return nullptr;
+		componentPath = slashPos + 1;
+	}
+	if (*componentPath)
+	{
+		Tile *result = parentTile->GetChild(componentPath);
+		if (result) return result;
+		*trait = componentPath;
+	}
+	return parentTile;
+}
+
+Tile::Value *Tile::GetComponentValue(const char *componentPath)
+{
+	const char *trait = nullptr;
+	Tile *tile = GetComponent(componentPath, &trait);
+	return (tile && trait) ? tile->GetValueName(trait) : nullptr;
+}
+
+Tile *Tile::Create(Tile *parent, const char *name, std::initializer_list<const char*> traits)
+{
+	Tile *tile = parent ? new Tile() : new TileMenu();
+	memset((void*)&tile->childList, 0, sizeof(tile->childList));
+	tile->name.m_dataLen = StrLen(name);
+	tile->name.m_data = CopyString(name);
+	tile->parent = parent;
+	for (const char *trait : traits)
+	{
+		auto *value = new Value{TraitNameToID(trait), tile, 1.0F, nullptr, nullptr};
+		UInt32 idx = 0;
+		while ((idx < tile->values.Size()) && (tile->values[idx]->id < value->id))
+			idx++;
+		tile->values.Insert(idx, value);
+	}
+	if (parent)
+	{
+		// appended like the game does when a menu's XML adds a tile
+		auto *node = new ChildNode{nullptr, parent->childList.last, tile};
+		if (parent->childList.last)
+			parent->childList.last->next = node;
+		else parent->childList.first = node;
+		parent->childList.last = node;
+		parent->childList.count++;
+	}
+	return tile;
+}
+
+void Tile::Destroy(Tile *tile)
+{
+	while (ChildNode *node = tile->childList.first)
+		Destroy(node->child);
+	if (Tile *parent = tile->parent)
+	{
+		ChildNode *node = parent->childList.first;
+		while (node->child != tile)
+			node = node->next;
+		(node->prev ? node->prev->next : parent->childList.first) = node->next;
+		(node->next ? node->next->prev : parent->childList.last) = node->prev;
+		parent->childList.count--;
+		delete node;
+	}
+	for (Value *value : tile->values)
+		delete value;
+	free(tile->name.m_data);
+	delete tile;
+}
+
+TileMenu *InterfaceManager::GetMenuByPath(const char *componentPath, const char **pSlashPos)
+{
+	char *slashPos = SlashPos(componentPath);
+	if (slashPos) *slashPos = 0;
+	*pSlashPos = slashPos;
+	return s_menus.Get(componentPath);
+}
+
+Tile::Value *InterfaceManager::GetMenuComponentValue(const char *componentPath)
+{
+	const char *slashPos;
+	TileMenu *tileMenu = GetMenuByPath(componentPath, &slashPos);
+	if (tileMenu && slashPos)
+		return tileMenu->GetComponentValue(slashPos + 1);
+	return nullptr;
+}
+
+Tile::Value *InterfaceManager::GetMenuComponentValueAlt(const char *componentPath)
+{
+	const char *slashPos;
+	TileMenu *tileMenu = GetMenuByPath(componentPath, &slashPos);
+	if (tileMenu && slashPos)
+		return tileMenu->GetComponentValueAlt(slashPos + 1);
+	return nullptr;
+}
+
+void InterfaceManager::SetMenu(const char *name, TileMenu *tileMenu)
+{
+	s_menus[name] = tileMenu;
+}
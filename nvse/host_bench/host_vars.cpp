@@ -0,0 +1,388 @@
+// Host variables for the delta cosave benchmarks. The records follow StringVarMap::Save and SaveChanges: STVS, an
+// STVR per saved variable and STVE, with a delta cosave starting with VDLT and listing dropped IDs in STVX.
+
+#include "VarMap.h"
+#include "host_vars.h"
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	constexpr UInt32 kNumMods = 12;
+	constexpr UInt64 kBaseID = 0x01DB2F4A5C3E7000;
+
+	// Stand-in for StringVar: the string and the mod owning it, 0xFF for function results, which are never saved.
+	struct HostVar
+	{
+		std::string	value;
+		UInt8		modIndex;
+
+		HostVar(const char* _value, UInt8 _modIndex) : value(_value), modIndex(_modIndex) {}
+	};
+
+	class HostVarMap : public VarMap<HostVar>
+	{
+	public:
+		UInt32 Add(const char* value, UInt8 modIndex)
+		{
+			const UInt32 varID = GetUnusedID();
+			Insert(varID, value, modIndex);
+			return varID;
+		}
+
+		// as StringVarMap::GetSaved
+		HostVar* GetSaved(UInt32 varID)
+		{
+			HostVar *var = Get(varID);
+			if (!var || IsTemporary(varID) || (var->modIndex == 0xFF))
+				return nullptr;
+			return var;
+		}
+
+		template <typename F>
+		void ForEachVar(F&& func)
+		{
+			ScopedLock lock(cs);
+			for (auto iter = vars.Begin(); !iter.End(); ++iter)
+				func(iter.Key());
+		}
+	};
+
+	// IDs of the variables, value and mod index as loaded
+	using LoadedVars = std::map<UInt32, std::pair<UInt8, std::string>>;
+
+	std::unique_ptr<HostVarMap>				s_vars;
+	std::vector<UInt32>						s_ids;		// of every variable, to pick the changed ones from
+	std::mt19937							s_random;
+	Serialization::SerializationTask		s_cosave;
+	Serialization::SerializationTask		s_base;
+	bool									s_writeBase = false;
+
+	const Serialization::Header kHeader = {Serialization::Header::kSignature, Serialization::Header::kVersion, 6, 4, 0x040020D0, 0};
+
+	std::string MakeValue(UInt32 seed)
+	{
+		static const char *kFormats[] = {"NVDLC%02uQuestStage%u", "HUDMainMenu/_Status%u/row%u", "Quest status: done (%u/%u)", "%u/%u"};
+		char buffer[0x40];
+		snprintf(buffer, sizeof(buffer), kFormats[seed & 3], seed % 97, seed);
+		return buffer;
+	}
+
+	void WriteModList()
+	{
+		Serialization::OpenRecord('MODS', 0);
+		Serialization::WriteRecord8(kNumMods);
+		for (UInt32 idx = 0; idx < kNumMods; idx++)
+		{
+			char name[0x20];
+			const UInt16 nameLen = snprintf(name, sizeof(name), "HostMod%02u.esp", idx);
+			Serialization::WriteRecord16(nameLen);
+			Serialization::WriteRecordData(name, nameLen);
+		}
+	}
+
+	void WriteVar(UInt32 varID, const HostVar& var)
+	{
+		Serialization::OpenRecord('STVR', 0);
+		Serialization::WriteRecord8(var.modIndex);
+		Serialization::WriteRecord32(varID);
+		const UInt16 len = var.value.size();
+		Serialization::WriteRecord16(len);
+		Serialization::WriteRecordData(var.value.data(), len);
+	}
+
+	void SaveFullCallback(void*)
+	{
+		WriteModList();
+		const UInt32 varsStart = Serialization::GetWriteOffset();
+		Serialization::OpenRecord('STVS', 0);
+		s_vars->ForEachVar([](UInt32 varID)
+		{
+			if (const HostVar *var = s_vars->GetSaved(varID))
+				WriteVar(varID, *var);
+		});
+		Serialization::OpenRecord('STVE', 0);
+		if (s_writeBase && Serialization::CopyWrittenRecords(s_base, kHeader, varsStart))
+			s_vars->ClearChanged();
+	}
+
+	void SaveDeltaCallback(void*)
+	{
+		Serialization::OpenRecord('VDLT', 0);
+		Serialization::WriteRecordData(&kBaseID, sizeof(kBaseID));
+		WriteModList();
+
+		Vector<UInt32> dropped;
+		s_vars->ForEachChanged([&](UInt32 varID)
+		{
+			if (!s_vars->GetSaved(varID))
+				dropped.Append(varID);
+		});
+		Serialization::OpenRecord('STVX', 0);
+		Serialization::WriteRecord32(dropped.Size());
+		Serialization::WriteRecordData(dropped.Data(), dropped.Size() * sizeof(UInt32));
+
+		s_vars->ForEachChanged([](UInt32 varID)
+		{
+			if (const HostVar *var = s_vars->GetSaved(varID))
+				WriteVar(varID, *var);
+		});
+		Serialization::OpenRecord('STVE', 0);
+	}
+
+	UInt32 SaveCore(NVSESerializationInterface::EventCallback callback)
+	{
+		s_cosave.Allocate(0x40000);
+		s_cosave.Skip(sizeof(Serialization::Header), false);
+		Serialization::Header header = kHeader;
+		header.numPlugins = Serialization::SavePlugins(s_cosave, {{0x1400, callback, false}}, false);
+		const UInt32 size = s_cosave.GetOffset();
+		s_cosave.SetOffset(0);
+		s_cosave.WriteBuf(&header, sizeof(header));
+		s_cosave.SetOffset(size);
+		return size;
+	}
+
+	// as Serialization::DeltaBaseExists
+	bool BaseExists()
+	{
+		Serialization::Header header = {};
+		if (s_base.GetOffset() >= sizeof(header))
+			memcpy(&header, s_base.GetData(0), sizeof(header));
+		return (header.signature == Serialization::Header::kSignature) && (header.numPlugins == 1);
+	}
+
+	// Reads the records of the core plugin in a cosave the way Core_PreLoadCallback does, the base file's going in
+	// right after the mod list of a delta cosave; if it is missing or turned down, what it had loaded is cleared and
+	// baseMissing set. False if the cosave is turned down.
+	bool LoadCore(const Serialization::SerializationTask& cosave, LoadedVars& loaded, bool* baseMissing = nullptr)
+	{
+		Serialization::CosaveIndex index;
+		if ((cosave.GetOffset() < sizeof(Serialization::Header)) ||
+			!index.Build(cosave.GetData(0), cosave.GetOffset(), sizeof(Serialization::Header)) || (index.Plugins().Size() != 1))
+			return false;
+		const Serialization::CosaveIndex::Plugin &plugin = index.Plugins()[0];
+		UInt64 baseID = 0;
+		for (UInt32 chunk = plugin.firstChunk; chunk < plugin.firstChunk + plugin.numChunks; chunk++)
+		{
+			const Serialization::CosaveIndex::Chunk &indexed = index.GetChunk(chunk);
+			const UInt8 *data = cosave.GetData(indexed.dataOffset);
+			switch (indexed.type)
+			{
+			case 'VDLT':
+				memcpy(&baseID, data, sizeof(baseID));
+				break;
+			case 'MODS':
+				if ((baseID == kBaseID) && !LoadCore(s_base, loaded))
+				{
+					loaded.clear();
+					if (baseMissing)
+						*baseMissing = true;
+				}
+				break;
+			case 'STVX':
+				{
+					UInt32 numDropped, varID;
+					memcpy(&numDropped, data, 4);
+					for (UInt32 idx = 0; idx < numDropped; idx++)
+					{
+						memcpy(&varID, data + 4 + idx * 4, 4);
+						loaded.erase(varID);
+					}
+					break;
+				}
+			case 'STVR':
+				{
+					UInt32 varID;
+					UInt16 len;
+					memcpy(&varID, data + 1, 4);
+					memcpy(&len, data + 5, 2);
+					loaded[varID] = {data[0], std::string((const char*)data + 7, len)};
+					break;
+				}
+			default:
+				break;
+			}
+		}
+		return true;
+	}
+
+	// variables differing between the loaded ones and those a save writes
+	UInt32 CountDifferences(const LoadedVars& loaded)
+	{
+		LoadedVars expected;
+		s_vars->ForEachVar([&](UInt32 varID)
+		{
+			if (const HostVar *var = s_vars->GetSaved(varID))
+				expected[varID] = {var->modIndex, var->value};
+		});
+		UInt32 differences = 0;
+		for (const auto &[varID, value] : expected)
+		{
+			auto iter = loaded.find(varID);
+			differences += (iter == loaded.end()) || (iter->second != value);
+		}
+		for (const auto &[varID, value] : loaded)
+			differences += !expected.contains(varID);
+		return differences;
+	}
+}
+
+namespace HostVars
+{
+	void Build(UInt32 numVars)
+	{
+		Free();
+		s_vars = std::make_unique<HostVarMap>();
+		s_random.seed(46);
+		for (UInt32 idx = 0; idx < numVars; idx++)
+			s_ids.push_back(s_vars->Add(MakeValue(idx).c_str(), (idx % 50) ? idx % kNumMods : 0xFF));
+		SaveFull(true);
+	}
+
+	void Free()
+	{
+		s_vars.reset();
+		s_ids.clear();
+		s_cosave = Serialization::SerializationTask();
+		s_base = Serialization::SerializationTask();
+	}
+
+	void Change(UInt32 numChanges)
+	{
+		for (UInt32 change = 0; change < numChanges; change++)
+		{
+			const UInt32 varID = s_ids[s_random() % s_ids.size()];
+			s_vars->Get(varID)->value = MakeValue(s_random());
+			s_vars->MarkChanged(varID);
+		}
+		for (UInt32 change = 0; change < numChanges / 5; change++)
+		{
+			UInt32 &varID = s_ids[s_random() % s_ids.size()];
+			s_vars->Delete(varID);
+			varID = s_vars->Add(MakeValue(s_random()).c_str(), s_random() % kNumMods);
+		}
+		for (UInt32 change = 0; change < numChanges / 10; change++)
+		{
+			const UInt32 varID = s_ids[s_random() % s_ids.size()];
+			s_vars->MarkTemporary(varID, !s_vars->IsTemporary(varID));
+		}
+		// deleted last, so no new variable takes their IDs before the save
+		for (UInt32 change = 0; (change < numChanges / 10) && (s_ids.size() > 1); change++)
+		{
+			UInt32 &varID = s_ids[s_random() % s_ids.size()];
+			s_vars->Delete(varID);
+			varID = s_ids.back();
+			s_ids.pop_back();
+		}
+	}
+
+	UInt32 SaveFull(bool withBase)
+	{
+		s_writeBase = withBase;
+		const UInt32 size = SaveCore(SaveFullCallback);
+		s_writeBase = false;
+		return size;
+	}
+
+	UInt32 SaveDelta()
+	{
+		return BaseExists() ? SaveCore(SaveDeltaCallback) : SaveFull(true);
+	}
+
+	UInt32 CheckDeltaLoads()
+	{
+		UInt32 differences = 0;
+		Build(3000);
+		LoadedVars fromBase;
+		if (!LoadCore(s_base, fromBase))
+			return 1;
+		differences += CountDifferences(fromBase);
+
+		// every delta holds the changes since the base file, not since the delta before it
+		for (UInt32 round = 1; round <= 6; round++)
+		{
+			Change(round * 40);
+			LoadedVars fromDelta, fromFull;
+			SaveDelta();
+			if (!LoadCore(s_cosave, fromDelta))
+				return 1;
+			SaveFull(false);
+			if (!LoadCore(s_cosave, fromFull))
+				return 1;
+			differences += CountDifferences(fromDelta) + CountDifferences(fromFull);
+		}
+
+		// a new base file starts the changes over
+		SaveFull(true);
+		Change(100);
+		LoadedVars fromNewBase;
+		SaveDelta();
+		if (!LoadCore(s_cosave, fromNewBase))
+			return 1;
+		differences += CountDifferences(fromNewBase);
+
+		// a delta can't hold a variable whose ID isn't tracked, saves have to be full until the next base file
+		differences += !s_vars->ChangesTracked();
+		s_vars->Insert(0x10000000, "untracked", 1);
+		differences += s_vars->ChangesTracked();
+		SaveFull(true);
+		differences += !s_vars->ChangesTracked();
+
+		Free();
+		return differences;
+	}
+
+	UInt32 CheckMissingBase()
+	{
+		UInt32 differences = 0;
+		Build(3000);
+		Change(200);
+		SaveDelta();
+
+		// what the delta holds on its own: the saved variables changed since the base file
+		LoadedVars expected;
+		s_vars->ForEachChanged([&](UInt32 varID)
+		{
+			if (const HostVar *var = s_vars->GetSaved(varID))
+				expected[varID] = {var->modIndex, var->value};
+		});
+
+		// the base file is deleted or damaged after the delta was written
+		for (const UInt32 damagedSize : {0U, 8U, (UInt32)sizeof(Serialization::Header) + 20})
+		{
+			Serialization::SerializationTask base;
+			base.Allocate(0x100);
+			base.WriteBuf(s_base.GetData(0), damagedSize);
+			std::swap(s_base, base);
+			LoadedVars loaded;
+			bool baseMissing = false;
+			if (!LoadCore(s_cosave, loaded, &baseMissing))
+				return 1;
+			differences += !baseMissing + (loaded != expected);
+			std::swap(s_base, base);
+		}
+
+		// with the base file gone, the next save is full and writes a new one
+		s_base = Serialization::SerializationTask();
+		SaveDelta();
+		LoadedVars fromFull;
+		bool baseMissing = false;
+		if (!LoadCore(s_cosave, fromFull, &baseMissing))
+			return 1;
+		differences += baseMissing + CountDifferences(fromFull) + !BaseExists() + !s_vars->ChangesTracked();
+		Change(50);
+		SaveDelta();
+		LoadedVars fromDelta;
+		if (!LoadCore(s_cosave, fromDelta, &baseMissing))
+			return 1;
+		differences += baseMissing + CountDifferences(fromDelta);
+
+		Free();
+		return differences;
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+// String variables in a real VarMap, saved the way Core_SaveCallback saves g_StringMap: a full cosave with every
+// variable, optionally copied into a delta base file, or a delta cosave with only the variables changed since the base
+// file was written (ChangedVarIDs). StringVar itself needs the game headers, a stand-in holding the string and the
+// owning mod takes its place.
+
+namespace HostVars
+{
+	// Makes numVars variables, then a full save with a base file, which leaves no variable marked as changed.
+	void Build(UInt32 numVars);
+	void Free();
+
+	// Changes numChanges variables in place, replaces a fifth as many with new ones, makes a tenth as many temporary or
+	// not and deletes a tenth as many, like scripts do between two saves.
+	void Change(UInt32 numChanges);
+
+	// Saves the core plugin into a new cosave and returns its size in bytes. A full save with withBase set also
+	// writes the base file and clears the changes, as with iDeltaCosaveChain; a delta save without a base file is
+	// full and writes one.
+	UInt32 SaveFull(bool withBase);
+	UInt32 SaveDelta();
+
+	// Untimed: after rounds of changes, loads each delta cosave on top of its base file and each full cosave, and
+	// compares them with the variables; also checks that a variable ID past the tracked range is reported. Returns the
+	// number of variables that differed.
+	UInt32 CheckDeltaLoads();
+
+	// Untimed: loads a delta cosave whose base file is gone or cut short, which has to come out as just the variables
+	// the delta holds, then checks that the next save is full with a new base file and the one after a delta again.
+	// Returns the number of differences.
+	UInt32 CheckMissingBase();
+}
@@ -0,0 +1,57 @@
+#pragma once
+// Host stand-in for nvse/ArrayVar.h: the element and key fields ArrayVarElementContainer.cpp reads, ahead of the real
+// ArrayVarElementContainer.h. The container source is runtime-only; everything it calls already has its host version
+// from host_prefix.h, so RUNTIME is turned on only from here on.
+
+#ifndef RUNTIME
+#define RUNTIME 1
+#endif
+
+typedef UInt32 ArrayID;
+
+enum DataType : UInt8
+{
+	kDataType_Invalid,
+
+	kDataType_Numeric,
+	kDataType_Form,
+	kDataType_String,
+	kDataType_Array,
+};
+
+struct ArrayData
+{
+	DataType	dataType = kDataType_Invalid;
+	ArrayID		owningArray = 0;
+	union
+	{
+		double		num;
+		char		*str;
+	};
+
+	char *StrPtr() const {return str;}
+};
+
+struct ArrayElement
+{
+	ArrayData	m_data;
+
+	virtual ~ArrayElement() = default;
+	virtual void Unset() {m_data.dataType = kDataType_Invalid;}
+};
+
+struct ArrayKey
+{
+	ArrayData	key;
+};
+
+extern thread_local ArrayKey s_arrNumKey, s_arrStrKey;
+
+#include "ArrayVarElementContainer.h"
+
+// what ArrayVar's constructor does to the element container of a string-keyed array
+class ArrayVar
+{
+public:
+	static void InitStrMap(ArrayVarElementContainer& elements) {elements.m_type = kContainer_StringMap;}
+};
@@ -0,0 +1,49 @@
+#pragma once
+// Host stand-in for nvse/CommandTable.h, enough for the command wrappers in RefSpatialIndex.cpp to build and for
+// ExtractArgsPlan.cpp to look commands up by opcode. GetByName finds nothing, so nothing gets wrapped.
+
+#include <vector>
+
+struct ParamInfo;
+class Script;
+class ScriptEventList;
+class TESObjectREFR;
+
+#define COMMAND_ARGS		ParamInfo * paramInfo, void * scriptData, TESObjectREFR * thisObj, TESObjectREFR * containingObj, Script * scriptObj, ScriptEventList * eventList, double * result, UInt32 * opcodeOffsetPtr
+#define PASS_COMMAND_ARGS	paramInfo, scriptData, thisObj, containingObj, scriptObj, eventList, result, opcodeOffsetPtr
+
+typedef bool (*Cmd_Execute)(COMMAND_ARGS);
+
+struct ParamInfo
+{
+	const char	*typeStr;
+	UInt32		typeID;
+	UInt32		isOptional;
+};
+
+struct CommandInfo
+{
+	Cmd_Execute	execute;
+	UInt32		opcode;
+};
+
+class CommandTable
+{
+public:
+	std::vector<CommandInfo>	m_commands;
+
+	CommandInfo *GetByName(const char *name) {return nullptr;}
+
+	// same lookup as the game's table: commands are stored by opcode from the first one
+	CommandInfo *GetByOpcode(UInt32 opcode)
+	{
+		if (m_commands.empty())
+			return nullptr;
+		const UInt32 arrayIndex = opcode - m_commands.front().opcode;
+		if ((arrayIndex >= m_commands.size()) || (m_commands[arrayIndex].opcode != opcode))
+			return nullptr;
+		return &m_commands[arrayIndex];
+	}
+};
+
+extern CommandTable g_scriptCommands;
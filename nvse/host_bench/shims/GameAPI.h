@@ -0,0 +1,4 @@
+#pragma once
+// Host stand-in for nvse/GameAPI.h, only what the UI sources built here use.
+
+const UInt32 kMaxMessageLength = 0x4000;
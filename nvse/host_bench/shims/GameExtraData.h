@@ -0,0 +1,43 @@
+#pragma once
+// Host stand-in for nvse/GameExtraData.h: the ExtraContainerChanges entries and inventory map InventoryItems.cpp uses.
+// An entry's extra data lists only record whether one of them is ExtraLeveledItem.
+
+#include "GameForms.h"
+
+class ExtraContainerChanges
+{
+public:
+	struct ExtendDataList
+	{
+		bool	hasLeveledItem;
+	};
+
+	struct EntryData
+	{
+		ExtendDataList	*extendData;
+		SInt32			countDelta;
+		TESForm			*type;
+
+		bool HasExtraLeveledItem() {return extendData && extendData->hasLeveledItem;}
+	};
+
+	struct EntryDataList : tList<EntryData>
+	{
+		EntryData *FindForItem(TESForm *item)
+		{
+			for (auto iter = Begin(); !iter.End(); ++iter)
+				if (iter->type == item) return iter.Get();
+			return NULL;
+		}
+	};
+};
+
+struct InventoryItemData
+{
+	SInt32								count;
+	ExtraContainerChanges::EntryData	*entry;
+
+	InventoryItemData(SInt32 _count, ExtraContainerChanges::EntryData *_entry) : count(_count), entry(_entry) {}
+};
+
+typedef UnorderedMap<TESForm*, InventoryItemData> InventoryItemsMap;
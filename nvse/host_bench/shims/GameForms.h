@@ -0,0 +1,113 @@
+#pragma once
+// Host stand-in for nvse/GameForms.h: the form fields, form types, cell reference list and base container
+// RefSpatialIndex.cpp, ExtractArgsPlan.cpp and InventoryItems.cpp read.
+// host_cells.cpp registers the forms LookupFormByID finds.
+
+enum FormType
+{
+	kFormType_TESSound				= 0x0D,
+	kFormType_BGSTerminal			= 0x17,
+	kFormType_TESObjectDOOR			= 0x1C,
+	kFormType_TESObjectMISC			= 0x1F,
+	kFormType_TESObjectSTAT			= 0x20,
+	kFormType_BGSStaticCollection	= 0x21,
+	kFormType_BGSMovableStatic		= 0x22,
+	kFormType_TESGrass				= 0x24,
+	kFormType_TESObjectTREE			= 0x25,
+	kFormType_TESFurniture			= 0x27,
+	kFormType_TESNPC				= 0x2A,
+	kFormType_BGSIdleMarker			= 0x30,
+	kFormType_TESLevItem			= 0x34,
+	kFormType_TESObjectCELL			= 0x39,
+	kFormType_TESObjectREFR			= 0x3A,
+	kFormType_Character				= 0x3B,
+};
+
+class TESForm
+{
+public:
+	enum
+	{
+		kFormFlags_Temporary = 0x00004000,
+	};
+
+	UInt8	typeID;
+	UInt32	refID;
+	UInt32	flags;
+
+	bool IsTemporary() const {return (flags & kFormFlags_Temporary) != 0;}
+};
+
+TESForm *LookupFormByID(UInt32 refID);
+
+template <typename T_Data>
+struct ListNode
+{
+	T_Data		*data;
+	ListNode	*next;
+};
+
+// The game's singly linked list with its head node stored inline, as TESObjectCELL::objectList uses it.
+template <class Item>
+class tList
+{
+public:
+	typedef ListNode<Item> _Node;
+
+	_Node m_listHead;
+
+	class Iterator
+	{
+		_Node *m_curr;
+
+	public:
+		Iterator operator++()
+		{
+			if (m_curr)
+				m_curr = m_curr->next;
+			return *this;
+		}
+		bool End() const {return !m_curr || (!m_curr->data && !m_curr->next);}
+		Item *Get() const {return m_curr->data;}
+		Item *operator->() const {return m_curr->data;}
+
+		Iterator(_Node *node = NULL) : m_curr(node) {}
+	};
+
+	_Node *Head() const {return const_cast<_Node*>(&m_listHead);}
+	Iterator Begin() const {return Iterator(Head());}
+};
+
+class TESObjectREFR;
+
+class TESContainer
+{
+public:
+	struct FormCount
+	{
+		SInt32		count;
+		TESForm		*form;
+		void		*contExtraData;
+	};
+
+	typedef tList<FormCount> FormCountList;
+	FormCountList formCountList;
+
+	SInt32 GetCountForForm(TESForm *form)
+	{
+		SInt32 result = 0;
+		for (auto iter = formCountList.Begin(); !iter.End(); ++iter)
+			if (iter->form == form)
+				result += iter->count;
+		return result;
+	}
+};
+
+class TESObjectCELL : public TESForm
+{
+public:
+	typedef tList<TESObjectREFR> RefList;
+
+	UInt8		cellState;
+	RefList		objectList;
+};
@@ -0,0 +1,12 @@
+#pragma once
+// Host stand-in for nvse/GameObjects.h: the reference fields RefSpatialIndex.cpp and the GetRefs distance test read.
+
+#include "GameForms.h"
+
+class TESObjectREFR : public TESForm
+{
+public:
+	TESForm			*baseForm;
+	float			posX, posY, posZ;
+	TESObjectCELL	*parentCell;
+};
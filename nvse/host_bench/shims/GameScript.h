@@ -0,0 +1,42 @@
+#pragma once
+// Host stand-in for nvse/GameScript.h: the script fields and ref list ExtractArgsPlan.cpp reads. host_scripts.cpp
+// builds the scripts.
+
+#include "GameForms.h"
+
+class Script : public TESForm
+{
+public:
+	struct RefVariable
+	{
+		TESForm	*form;
+		UInt32	varIdx;
+	};
+
+	struct ScriptInfo
+	{
+		UInt32	numRefs;
+		UInt32	dataLength;
+	};
+
+	ScriptInfo			info;
+	void				*data;
+	tList<RefVariable>	refList;
+
+	// the game's walk, which starts counting at 1
+	RefVariable *GetRefFromRefList(UInt32 refIdx)
+	{
+		UInt32 idx = 1;
+		if (refIdx)
+		{
+			auto *varIter = refList.Head();
+			do
+			{
+				if (idx == refIdx)
+					return varIter->data;
+				idx++;
+			} while ((varIter = varIter->next));
+		}
+		return nullptr;
+	}
+};
@@ -0,0 +1,100 @@
+#pragma once
+// Host stand-in for nvse/GameTiles.h: Tile keeps the game's member names and the child list layout both GetChild
+// (walked as a tList) and GetChildAlt (walked as a DList) rely on. host_tiles.cpp implements the lookups like
+// GameTiles.cpp and lets the benchmarks build and destroy tiles.
+
+template <typename T_Data>
+struct DListNode
+{
+	DListNode	*next;
+	DListNode	*prev;
+	T_Data		*data;
+};
+
+template <class Item>
+class DList
+{
+public:
+	typedef DListNode<Item> Node;
+
+	Node	*first;
+	Node	*last;
+	UInt32	count;
+
+	Node *Head() {return first;}
+	Node *Tail() {return last;}
+};
+
+// Over the child list, Item is Tile::ChildNode and the nodes are the DList's own.
+template <class Item>
+class tList
+{
+public:
+	Item	*first;
+	Item	*last;
+	UInt32	count;
+
+	class Iterator
+	{
+		Item	*m_curr;
+
+	public:
+		Iterator(Item *node) : m_curr(node) {}
+		bool End() const {return !m_curr;}
+		Item *operator->() const {return m_curr;}
+		Item *operator*() const {return m_curr;}
+		Iterator& operator++() {m_curr = m_curr->next; return *this;}
+	};
+
+	Iterator Begin() const {return Iterator(first);}
+};
+
+class String
+{
+public:
+	char	*m_data;
+	UInt16	m_dataLen;
+	UInt16	m_bufLen;
+};
+
+UInt32 TraitNameToID(const char *traitName);
+
+class Tile
+{
+public:
+	struct Value
+	{
+		UInt32		id;
+		Tile		*parent;
+		float		num;
+		char		*str;
+		void		*action;
+	};
+
+	struct ChildNode
+	{
+		ChildNode	*next;
+		ChildNode	*prev;
+		Tile		*child;
+	};
+
+	tList<ChildNode>	childList;
+	UInt32				unk0C;
+	Vector<Value*>		values;		// sorted by id
+	String				name;
+	Tile				*parent;
+
+	Value *GetValue(UInt32 typeID);
+	Value *GetValueName(const char *valueName);
+	Tile *GetChild(const char *childName);
+	Tile *GetChildAlt(const char *childName);
+	Tile *GetComponent(const char *componentPath, const char **trait);
+	Value *GetComponentValue(const char *componentPath);
+	Value *GetComponentValueAlt(const char *componentPath);
+
+	// host only
+	static Tile *Create(Tile *parent, const char *name, std::initializer_list<const char*> traits);
+	static void Destroy(Tile *tile);
+};
+
+class TileMenu : public Tile {};
@@ -0,0 +1,15 @@
+#pragma once
+// Host stand-in for nvse/GameUI.h: menus are registered by name instead of living in the game's menu array.
+
+#include "GameTiles.h"
+
+class InterfaceManager
+{
+public:
+	static TileMenu *GetMenuByPath(const char *componentPath, const char **slashPos);
+	static Tile::Value *GetMenuComponentValue(const char *componentPath);
+	static Tile::Value *GetMenuComponentValueAlt(const char *componentPath);
+
+	// host only
+	static void SetMenu(const char *name, TileMenu *tileMenu);
+};
@@ -0,0 +1,23 @@
+#pragma once
+// Stand-in for common/ICriticalSection.h, which spins on Windows thread IDs: a recursive lock with the same interface,
+// enough for VarMap.
+
+#include <mutex>
+
+class ICriticalSection
+{
+	std::recursive_mutex	mutex;
+
+public:
+	void Enter() {mutex.lock();}
+	void Leave() {mutex.unlock();}
+};
+
+class ScopedLock
+{
+	ICriticalSection		*m_cs;
+
+public:
+	ScopedLock(ICriticalSection &cs) : m_cs(&cs) {cs.Enter();}
+	~ScopedLock() {m_cs->Leave();}
+};
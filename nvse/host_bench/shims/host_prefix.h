@@ -0,0 +1,87 @@
+#pragma once
+// Forced include standing in for nvse/prefix.h (common/IPrefix.h) when NVSE sources are built on a non-Windows host.
+// Only what containers.h, utility.h, the Serialization sources and the Algohol math need is provided.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+typedef uint8_t		UInt8;
+typedef uint16_t	UInt16;
+typedef uint32_t	UInt32;
+typedef uint64_t	UInt64;
+typedef int8_t		SInt8;
+typedef int16_t		SInt16;
+typedef int32_t		SInt32;
+typedef int64_t		SInt64;
+typedef float		Float32;
+typedef double		Float64;
+typedef uint32_t	DWORD;
+
+#define __fastcall
+#define __stdcall
+#define __cdecl
+#define __thiscall
+#define __vectorcall
+#define __forceinline inline __attribute__((always_inline))
+#define __declspec(x)
+
+// MSVC's _BitScanForward (intrin.h)
+inline unsigned char _BitScanForward(unsigned long* index, unsigned long mask)
+{
+	if (!mask)
+		return 0;
+	*index = __builtin_ctzl(mask);
+	return 1;
+}
+
+// common/ITypes.h
+#define MACRO_SWAP32(a)			((((a) & 0x000000FF) << 24) | (((a) & 0x0000FF00) << 8) | (((a) & 0x00FF0000) >> 8) | (((a) & 0xFF000000) >> 24))
+
+// common/ITypes.h, the parts Algohol's math uses
+class Vector3
+{
+public:
+	Vector3()									{ }
+	Vector3(const Vector3 & in)					{ x = in.x; y = in.y; z = in.z; }
+	Vector3(float inX, float inY, float inZ)	{ x = inX; y = inY; z = inZ; }
+
+	float	Magnitude(void)	{ return sqrt(x*x + y*y + z*z); }
+
+	union
+	{
+		struct
+		{
+			float	x, y, z;
+		};
+		float	d[3];
+	};
+};
+
+// common/IDebugLog.h, the log goes to stderr
+inline void _ERROR(const char *fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	fputc('\n', stderr);
+	va_end(args);
+}
+
+// the min/max macros of windows.h
+using std::min;
+using std::max;
+
+// common/IErrors.h
+#define ASSERT(a)	do { if (!(a)) {fprintf(stderr, "%s(%d): assertion failed: %s\n", __FILE__, __LINE__, #a); abort();} } while (0)
+
+#include "nvse/utility.h"
+#include "nvse/containers.h"
+
+// host_runtime.cpp: bytes in the blocks Pool_Alloc handed out that were not freed since, for memory reports
+UInt64 Pool_BytesInUse();
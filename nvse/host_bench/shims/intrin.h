@@ -0,0 +1,3 @@
+#pragma once
+// MSVC's <intrin.h>; the GCC/Clang equivalents live in <x86intrin.h>.
+#include <x86intrin.h>
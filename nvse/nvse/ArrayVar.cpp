@@ -77,16 +77,19 @@ ArrayElement::ArrayElement(ArrayElement& from)
 	m_data.dataType = from.m_data.dataType;
 	m_data.owningArray = from.m_data.owningArray;
 	if (m_data.dataType == kDataType_String)
-		m_data.SetStr(from.m_data.str);
+		m_data.SetStr(from.m_data.GetStr());
 	else m_data.num = from.m_data.num;
 }
 
 
 ArrayElement::ArrayElement(ArrayElement&& from) noexcept
 {
+	// an inline string is taken over byte for byte, copying it through num could change the bits
 	m_data.dataType = std::exchange(from.m_data.dataType, kDataType_Invalid);
+	m_data.strIsInline = std::exchange(from.m_data.strIsInline, false);
 	m_data.owningArray = std::exchange(from.m_data.owningArray, 0);
-	m_data.num = std::exchange(from.m_data.num, 0);
+	memcpy(m_data.inlineStr, from.m_data.inlineStr, sizeof(m_data.inlineStr));
+	from.m_data.num = 0;
 }
 
 
@@ -104,7 +107,7 @@ bool ArrayElement::operator<(const ArrayElement& rhs) const
 	case kDataType_Array:
 		return m_data.formID < rhs.m_data.formID;
 	case kDataType_String:
-		return StrCompare(m_data.str, rhs.m_data.str) < 0;
+		return StrCompare(m_data.StrPtr(), rhs.m_data.StrPtr()) < 0;
 	default:
 		return m_data.num < rhs.m_data.num;
 	}
@@ -121,7 +124,7 @@ bool ArrayElement::operator==(const ArrayElement& rhs) const
 	case kDataType_Form:
 		return m_data.formID == rhs.m_data.formID;
 	case kDataType_String:
-		return !StrCompare(m_data.str, rhs.m_data.str);
+		return !StrCompare(m_data.StrPtr(), rhs.m_data.StrPtr());
 	case kDataType_Array:
 		return m_data.arrID == rhs.m_data.arrID;
 	default:
@@ -145,7 +148,7 @@ bool ArrayElement::Equals(const ArrayElement& rhs, bool deepCmpArr) const
 	case kDataType_Form:
 		return m_data.formID == rhs.m_data.formID;
 	case kDataType_String:
-		return !StrCompare(m_data.str, rhs.m_data.str);
+		return !StrCompare(m_data.StrPtr(), rhs.m_data.StrPtr());
 	case kDataType_Array:
 	{
 		auto const lArrPtr = g_ArrayMap.Get(m_data.arrID);
@@ -237,6 +240,7 @@ bool ArrayElement::SetFormID(UInt32 refID)
 		LambdaManager::SaveLambdaVariables(static_cast<Script*>(form));
 	}
 
+	MarkOwnerChanged();
 	return true;
 }
 
@@ -246,6 +250,7 @@ bool ArrayElement::SetString(const char* str)
 
 	m_data.dataType = kDataType_String;
 	m_data.SetStr(str);
+	MarkOwnerChanged();
 	return true;
 }
 
@@ -255,6 +260,7 @@ bool ArrayElement::SetString(std::string_view str)
 
 	m_data.dataType = kDataType_String;
 	m_data.SetStr(str);
+	MarkOwnerChanged();
 	return true;
 }
 
@@ -269,6 +275,7 @@ bool ArrayElement::SetArray(ArrayID arr)
 	else // this element is not inside any array, so it's just a temporary
 		m_data.arrID = arr;
 
+	MarkOwnerChanged();
 	return true;
 }
 
@@ -279,6 +286,7 @@ bool ArrayElement::SetNumber(double num)
 
 	m_data.dataType = kDataType_Numeric;
 	m_data.num = num;
+	MarkOwnerChanged();
 	return true;
 }
 
@@ -288,7 +296,7 @@ bool ArrayElement::Set(const ArrayElement* elem)
 	switch (elem->m_data.dataType)
 	{
 	case kDataType_String:
-		SetString(elem->m_data.str);
+		SetString(elem->m_data.GetStr());
 		break;
 	case kDataType_Array:
 		SetArray(elem->m_data.arrID);
@@ -301,6 +309,7 @@ bool ArrayElement::Set(const ArrayElement* elem)
 		break;
 	default:
 		Unset();
+		MarkOwnerChanged();
 		return false;
 	}
 
@@ -363,7 +372,7 @@ bool ArrayElement::GetBool() const
 		result = m_data.formID != 0;
 		break;
 	case kDataType_String:
-		result = m_data.str && m_data.str[0];
+		result = *m_data.GetStr() != 0;
 		break;
 	default:
 		return false;
@@ -378,13 +387,7 @@ void ArrayElement::UnsetDefault()
 		return;
 
 	if (m_data.dataType == kDataType_String)
-	{
-		if (m_data.str)
-		{
-			free(m_data.str);
-			m_data.str = nullptr;
-		}
-	}
+		m_data.FreeStr();
 	else if (m_data.dataType == kDataType_Array && m_data.owningArray)
 	{
 		g_ArrayMap.RemoveReference(&m_data.arrID, GetArrayOwningModIndex(m_data.arrID));
@@ -410,38 +413,67 @@ void ArrayElement::Unset()
 
 ArrayData::~ArrayData()
 {
-	if ((dataType == kDataType_String) && str)
-	{
-		free(str);
-		str = nullptr;
-	}
+	if (dataType == kDataType_String)
+		FreeStr();
 	dataType = kDataType_Invalid;
 }
 
 const char* ArrayData::GetStr() const
 {
-	return str ? str : "";
+	const char *result = StrPtr();
+	return result ? result : "";
 }
 
 void ArrayData::SetStr(const char* srcStr)
 {
-	str = (srcStr && *srcStr) ? CopyString(srcStr) : nullptr;
+	if (srcStr && *srcStr)
+		SetStr(std::string_view(srcStr, StrLen(srcStr)));
+	else
+	{
+		strIsInline = false;
+		str = nullptr;
+	}
 }
 
 void ArrayData::SetStr(std::string_view srcStr)
 {
-	str = (!srcStr.empty() && srcStr[0]) ? CopyString(srcStr.data(), srcStr.length()) : nullptr;
+	if (srcStr.empty() || !srcStr[0])
+	{
+		strIsInline = false;
+		str = nullptr;
+		return;
+	}
+	char *buffer = AllocStr(srcStr.length());
+	memcpy(buffer, srcStr.data(), srcStr.length());
+	buffer[srcStr.length()] = 0;
+}
+
+char* ArrayData::AllocStr(UInt32 length)
+{
+	strIsInline = length <= kMaxInlineStr;
+	if (strIsInline)
+		return inlineStr;
+	str = (char*)malloc(length + 1);
+	return str;
+}
+
+void ArrayData::FreeStr()
+{
+	if (!strIsInline)
+		free(str);
+	strIsInline = false;
+	str = nullptr;
 }
 
 ArrayData& ArrayData::operator=(const ArrayData& rhs)
 {
 	if (this != &rhs)
 	{
-		if (dataType == kDataType_String && str)
-			free(str);
+		if (dataType == kDataType_String)
+			FreeStr();
 		dataType = rhs.dataType;
 		if (dataType == kDataType_String)
-			SetStr(rhs.str);
+			SetStr(rhs.GetStr());
 		else num = rhs.num;
 	}
 	return *this;
@@ -458,7 +490,7 @@ void* ArrayData::GetAsVoidArg() const
 		return *(void**)(&res);	//conversion: *((float *)&nthArg
 	}
 	case kDataType_Form: return LookupFormByID(formID);
-	case kDataType_String: return str;
+	case kDataType_String: return StrPtr();
 	case kDataType_Array: return reinterpret_cast<void*>(arrID);
 	}
 	return nullptr;
@@ -467,7 +499,7 @@ void* ArrayData::GetAsVoidArg() const
 ArrayData::ArrayData(const ArrayData& from) : dataType(from.dataType), owningArray(from.owningArray)
 {
 	if (dataType == kDataType_String)
-		SetStr(from.str);
+		SetStr(from.GetStr());
 	else num = from.num;
 }
 
@@ -537,7 +569,7 @@ ArrayKey::ArrayKey(const ArrayKey& from)
 {
 	key.dataType = from.key.dataType;
 	if (key.dataType == kDataType_String)
-		key.SetStr(from.key.str);
+		key.SetStr(from.key.GetStr());
 	else key.num = from.key.num;
 }
 
@@ -560,7 +592,7 @@ bool ArrayKey::operator<(const ArrayKey& rhs) const
 	case kDataType_Numeric:
 		return key.num < rhs.key.num;
 	case kDataType_String:
-		return StrCompare(key.str, rhs.key.str) < 0;
+		return StrCompare(key.StrPtr(), rhs.key.StrPtr()) < 0;
 	default:
 		//_MESSAGE("Error: Invalid ArrayKey type %d", rhs.keyType);
 		return true;
@@ -580,7 +612,7 @@ bool ArrayKey::operator==(const ArrayKey& rhs) const
 	case kDataType_Numeric:
 		return key.num == rhs.key.num;
 	case kDataType_String:
-		return !StrCompare(key.str, rhs.key.str);
+		return !StrCompare(key.StrPtr(), rhs.key.StrPtr());
 	default:
 		//_MESSAGE("Error: Invalid ArrayKey type %d", rhs.keyType);
 		return true;
@@ -589,19 +621,25 @@ bool ArrayKey::operator==(const ArrayKey& rhs) const
 
 thread_local ArrayKey s_arrNumKey(kDataType_Numeric), s_arrStrKey(kDataType_String);
 
+// handed out by GetFirstElement & co. for arrays that still store plain numbers
+thread_local ArrayElement s_packedElem;
+
 ///////////////////////
 // ArrayVar
 //////////////////////
 #if _DEBUG && 0
 MemoryLeakDebugCollector<ArrayVar> s_arrayDebugCollector;
 #endif
-ArrayVar::ArrayVar(UInt32 _keyType, bool _packed, UInt8 modIndex) : m_ID(0), m_keyType(_keyType), m_bPacked(_packed),
+ArrayVar::ArrayVar(UInt32 _keyType, bool _packed, UInt8 modIndex) : m_ID(0), m_keyType(_keyType), m_bPacked(_packed), m_bNumbersOnly(false),
                                                                     m_owningModIndex(modIndex)
 {
 	if (m_keyType == kDataType_String)
 		m_elements.m_type = kContainer_StringMap;
 	else if (m_bPacked)
+	{
 		m_elements.m_type = kContainer_Array;
+		m_bNumbersOnly = true;
+	}
 	else
 		m_elements.m_type = kContainer_NumericMap;
 
@@ -618,11 +656,65 @@ ArrayVar::~ArrayVar()
 #endif
 }
 
+void ArrayVar::Unpack()
+{
+	if (!m_bNumbersOnly)
+		return;
+	m_bNumbersOnly = false;
+
+	NumberRange numbers = Numbers();
+	if (UInt32 numItems = numbers.Size())
+	{
+		auto* pArray = m_elements.getArrayPtr();
+		pArray->Resize(numItems);
+		ArrayElement* elements = pArray->Data();
+		for (UInt32 idx = 0; idx < numItems; idx++)
+		{
+			elements[idx].m_data.dataType = kDataType_Numeric;
+			elements[idx].m_data.owningArray = m_ID;
+			elements[idx].m_data.num = numbers[idx];
+		}
+	}
+	ReleaseNumbers();
+}
+
+void ArrayVar::ReleaseNumbers()
+{
+	m_numbers.Release();
+}
+
+ArrayVar::NumberVector& ArrayVar::WritableNumbers()
+{
+	g_ArrayMap.MarkChanged(m_ID);
+	return m_numbers.Writable();
+}
+
+const double* ArrayVar::GetPackedNumber(double key) const
+{
+	NumberRange numbers = Numbers();
+	int idx = key;
+	if (idx < 0)
+		idx += numbers.Size();
+	return numbers.GetPtr((UInt32)idx);
+}
+
+// not owned by any array, so writing through it can never touch reference counts
+static ArrayElement* GetPackedElement(double num)
+{
+	s_packedElem.m_data.dataType = kDataType_Numeric;
+	s_packedElem.m_data.owningArray = 0;
+	s_packedElem.m_data.num = num;
+	return &s_packedElem;
+}
+
 ArrayElement* ArrayVar::Get(const ArrayKey* key, bool bCanCreateNew)
 {
 	if (m_keyType != key->KeyType())
 		return nullptr;
 
+	Unpack();
+	if (bCanCreateNew)
+		g_ArrayMap.MarkChanged(m_ID);
 	switch (GetContainerType())
 	{
 	default:
@@ -653,14 +745,13 @@ ArrayElement* ArrayVar::Get(const ArrayKey* key, bool bCanCreateNew)
 		}
 	case kContainer_StringMap:
 		{
-			auto* pMap = m_elements.getStrMapPtr();
 			if (bCanCreateNew)
 			{
-				ArrayElement* newElem = pMap->Emplace(key->key.str);
+				ArrayElement* newElem = m_elements.emplaceStrMapElement(key->key.StrPtr());
 				newElem->m_data.owningArray = m_ID;
 				return newElem;
 			}
-			return pMap->GetPtr(key->key.str);
+			return m_elements.getStrMapElement(key->key.StrPtr());
 		}
 	}
 }
@@ -670,6 +761,9 @@ ArrayElement* ArrayVar::Get(double key, bool bCanCreateNew)
 	if (m_keyType != kDataType_Numeric)
 		return nullptr;
 
+	Unpack();
+	if (bCanCreateNew)
+		g_ArrayMap.MarkChanged(m_ID);
 	switch (GetContainerType())
 	{
 	default:
@@ -706,18 +800,20 @@ ArrayElement* ArrayVar::Get(const char* key, bool bCanCreateNew)
 	if ((m_keyType != kDataType_String) || (GetContainerType() != kContainer_StringMap))
 		return nullptr;
 
-	auto* pMap = m_elements.getStrMapPtr();
 	if (bCanCreateNew)
 	{
-		ArrayElement* newElem = pMap->Emplace(const_cast<char*>(key));
+		g_ArrayMap.MarkChanged(m_ID);
+		ArrayElement* newElem = m_elements.emplaceStrMapElement(key);
 		newElem->m_data.owningArray = m_ID;
 		return newElem;
 	}
-	return pMap->GetPtr(const_cast<char*>(key));
+	return m_elements.getStrMapElement(key);
 }
 
 bool ArrayVar::HasKey(double key)
 {
+	if (m_bNumbersOnly)
+		return GetPackedNumber(key) != nullptr;
 	return Get(key, false) != nullptr;
 }
 
@@ -728,11 +824,22 @@ bool ArrayVar::HasKey(const char* key)
 
 bool ArrayVar::HasKey(const ArrayKey* key)
 {
+	if (m_bNumbersOnly)
+		return (key->KeyType() == kDataType_Numeric) && GetPackedNumber(key->key.num);
 	return Get(key, false) != nullptr;
 }
 
 bool ArrayVar::SetElementNumber(double key, double num)
 {
+	if (m_bNumbersOnly)
+	{
+		NumberVector& numbers = WritableNumbers();
+		if (const double* pNum = GetPackedNumber(key))
+			numbers[pNum - numbers.Data()] = num;
+		else
+			numbers.Append(num);
+		return true;
+	}
 	ArrayElement* elem = Get(key, true);
 	if (!elem)
 		return false;
@@ -749,8 +856,20 @@ bool ArrayVar::SetElementNumber(const char* key, double num)
 	return true;
 }
 
+bool ArrayVar::SetElementNumber(const ArrayKey* key, double num)
+{
+	if (key->KeyType() == kDataType_Numeric)
+		return SetElementNumber(key->key.num, num);
+	return SetElementNumber(key->key.GetStr(), num);
+}
+
+// Appending to an array moves its elements and their inline strings, so a short str that may be read from another
+// element of this array is copied out before Get.
 bool ArrayVar::SetElementString(double key, const char* str)
 {
+	char buffer[ArrayData::kMaxInlineStr + 1];
+	if (str && (strnlen(str, sizeof(buffer)) < sizeof(buffer)))
+		str = strcpy(buffer, str);
 	ArrayElement* elem = Get(key, true);
 	if (!elem)
 		return false;
@@ -760,6 +879,9 @@ bool ArrayVar::SetElementString(double key, const char* str)
 
 bool ArrayVar::SetElementString(double key, std::string_view str)
 {
+	char buffer[ArrayData::kMaxInlineStr + 1];
+	if (!str.empty() && (str.size() < sizeof(buffer)))
+		str = std::string_view((const char*)memcpy(buffer, str.data(), str.size()), str.size());
 	ArrayElement* elem = Get(key, true);
 	if (!elem)
 		return false;
@@ -814,6 +936,8 @@ bool ArrayVar::SetElementArray(const char* key, ArrayID srcID)
 
 bool ArrayVar::SetElement(double key, const ArrayElement* val)
 {
+	if (m_bNumbersOnly && (val->DataType() == kDataType_Numeric))
+		return SetElementNumber(key, val->m_data.num);
 	ArrayElement* elem = Get(key, true);
 	if (!elem)
 		return false;
@@ -832,7 +956,9 @@ bool ArrayVar::SetElement(const char* key, const ArrayElement* val)
 
 bool ArrayVar::SetElement(const ArrayKey* key, const ArrayElement* val)
 {
-	ArrayElement* elem = (key->KeyType() == kDataType_Numeric) ? Get(key->key.num, true) : Get(key->key.GetStr(), true);
+	if (key->KeyType() == kDataType_Numeric)
+		return SetElement(key->key.num, val);
+	ArrayElement* elem = Get(key->key.GetStr(), true);
 	if (!elem)
 		return false;
 	elem->Set(val);
@@ -841,6 +967,8 @@ bool ArrayVar::SetElement(const ArrayKey* key, const ArrayElement* val)
 
 bool ArrayVar::SetElementFromAPI(double key, const NVSEArrayVarInterface::Element* srcElem)
 {
+	if (m_bNumbersOnly && (srcElem->type == NVSEArrayVarInterface::Element::kType_Numeric))
+		return SetElementNumber(key, srcElem->num);
 	ArrayElement* elem = Get(key, true);
 	if (!elem)
 		return false;
@@ -893,24 +1021,38 @@ bool ArrayVar::SetElementFromAPI(const char* key, const NVSEArrayVarInterface::E
 
 bool ArrayVar::GetElementNumber(const ArrayKey* key, double* out)
 {
+	if (m_bNumbersOnly)
+	{
+		const double* pNum = (key->KeyType() == kDataType_Numeric) ? GetPackedNumber(key->key.num) : nullptr;
+		if (!pNum)
+			return false;
+		*out = *pNum;
+		return true;
+	}
 	ArrayElement* elem = Get(key, false);
 	return (elem && elem->GetAsNumber(out));
 }
 
 bool ArrayVar::GetElementString(const ArrayKey* key, const char** out)
 {
+	if (m_bNumbersOnly)
+		return false;
 	ArrayElement* elem = Get(key, false);
 	return (elem && elem->GetAsString(out));
 }
 
 bool ArrayVar::GetElementFormID(const ArrayKey* key, UInt32* out)
 {
+	if (m_bNumbersOnly)
+		return false;
 	ArrayElement* elem = Get(key, false);
 	return (elem && elem->GetAsFormID(out));
 }
 
 bool ArrayVar::GetElementForm(const ArrayKey* key, TESForm** out)
 {
+	if (m_bNumbersOnly)
+		return false;
 	ArrayElement* elem = Get(key, false);
 	UInt32 refID;
 	if (elem && elem->GetAsFormID(&refID))
@@ -923,12 +1065,16 @@ bool ArrayVar::GetElementForm(const ArrayKey* key, TESForm** out)
 
 bool ArrayVar::GetElementArray(const ArrayKey* key, ArrayID* out)
 {
+	if (m_bNumbersOnly)
+		return false;
 	ArrayElement* elem = Get(key, false);
 	return (elem && elem->GetAsArray(out));
 }
 
 DataType ArrayVar::GetElementType(const ArrayKey* key)
 {
+	if (m_bNumbersOnly)
+		return HasKey(key) ? kDataType_Numeric : kDataType_Invalid;
 	ArrayElement* elem = Get(key, false);
 	return elem ? elem->DataType() : kDataType_Invalid;
 }
@@ -943,8 +1089,7 @@ const ArrayKey* ArrayVar::Find(const ArrayElement* toFind, const Slice* range)
 	default:
 	case kContainer_Array:
 		{
-			ElementVector* pArray = m_elements.getArrayPtr();
-			UInt32 arrSize = pArray->Size(), iLow, iHigh;
+			UInt32 arrSize = Size(), iLow, iHigh;
 			if (range)
 			{
 				if (range->bIsString)
@@ -961,7 +1106,20 @@ const ArrayKey* ArrayVar::Find(const ArrayElement* toFind, const Slice* range)
 				iLow = 0;
 				iHigh = arrSize - 1;
 			}
-			ArrayElement* elements = pArray->Data();
+			if (m_bNumbersOnly)
+			{
+				if (toFind->DataType() != kDataType_Numeric)
+					return nullptr;
+				const double* numbers = Numbers().Data();
+				for (int idx = iLow; idx <= iHigh; idx++)
+				{
+					if (numbers[idx] != toFind->m_data.num) continue;
+					s_arrNumKey.key.num = idx;
+					return &s_arrNumKey;
+				}
+				return nullptr;
+			}
+			ArrayElement* elements = m_elements.getArrayPtr()->Data();
 			for (int idx = iLow; idx <= iHigh; idx++)
 			{
 				if (elements[idx] != *toFind) continue;
@@ -1045,6 +1203,14 @@ bool ArrayVar::GetFirstElement(ArrayElement** outElem, const ArrayKey** outKey)
 	if (Empty())
 		return false;
 
+	if (m_bNumbersOnly)
+	{
+		s_arrNumKey.key.num = 0;
+		*outKey = &s_arrNumKey;
+		*outElem = GetPackedElement(Numbers()[0]);
+		return true;
+	}
+
 	ArrayIterator iter = m_elements.begin();
 	*outKey = iter.first();
 	*outElem = iter.second();
@@ -1056,6 +1222,15 @@ bool ArrayVar::GetLastElement(ArrayElement** outElem, const ArrayKey** outKey)
 	if (Empty())
 		return false;
 
+	if (m_bNumbersOnly)
+	{
+		UInt32 idx = Size() - 1;
+		s_arrNumKey.key.num = (int)idx;
+		*outKey = &s_arrNumKey;
+		*outElem = GetPackedElement(Numbers()[idx]);
+		return true;
+	}
+
 	ArrayIterator iter = m_elements.rbegin();
 	*outKey = iter.first();
 	*outElem = iter.second();
@@ -1067,6 +1242,17 @@ bool ArrayVar::GetNextElement(const ArrayKey* prevKey, ArrayElement** outElem, c
 	if (!prevKey || Empty())
 		return false;
 
+	if (m_bNumbersOnly)
+	{
+		UInt32 idx = (int)prevKey->key.num;
+		if ((idx >= Size()) || (++idx >= Size()))
+			return false;
+		s_arrNumKey.key.num = (int)idx;
+		*outKey = &s_arrNumKey;
+		*outElem = GetPackedElement(Numbers()[idx]);
+		return true;
+	}
+
 	ArrayIterator iter = m_elements.find(prevKey);
 	if (!iter.End())
 	{
@@ -1086,6 +1272,17 @@ bool ArrayVar::GetPrevElement(const ArrayKey* prevKey, ArrayElement** outElem, c
 	if (!prevKey || Empty())
 		return false;
 
+	if (m_bNumbersOnly)
+	{
+		UInt32 idx = (int)prevKey->key.num;
+		if ((idx >= Size()) || !idx--)
+			return false;
+		s_arrNumKey.key.num = (int)idx;
+		*outKey = &s_arrNumKey;
+		*outElem = GetPackedElement(Numbers()[idx]);
+		return true;
+	}
+
 	ArrayIterator iter = m_elements.find(prevKey);
 	if (!iter.End())
 	{
@@ -1105,6 +1302,15 @@ UInt32 ArrayVar::EraseElement(const ArrayKey* key)
 {
 	if (Empty() || (KeyType() != key->KeyType()))
 		return -1;
+	g_ArrayMap.MarkChanged(m_ID);
+	if (m_bNumbersOnly)
+	{
+		UInt32 idx = (int)key->key.num;
+		if (idx >= Size())
+			return 0;
+		WritableNumbers().RemoveNth(idx);
+		return 1;
+	}
 	return m_elements.erase(key);
 }
 
@@ -1112,13 +1318,34 @@ UInt32 ArrayVar::EraseElements(const Slice* slice)
 {
 	if (slice->bIsString || Empty())
 		return -1;
+	g_ArrayMap.MarkChanged(m_ID);
+	if (m_bNumbersOnly)
+	{
+		UInt32 arrSize = Size(), iLow = (int)slice->m_lower, iHigh = (int)slice->m_upper;
+		if (iHigh >= arrSize)
+			iHigh = arrSize - 1;
+		if ((iLow >= arrSize) || (iLow > iHigh))
+			return 0;
+		WritableNumbers().RemoveRange(iLow, iHigh - iLow + 1);
+		return iHigh - iLow + 1;
+	}
 	return m_elements.erase((int)slice->m_lower, (int)slice->m_upper);
 }
 
 UInt32 ArrayVar::EraseAllElements()
 {
+	g_ArrayMap.MarkChanged(m_ID);
+	if (m_bNumbersOnly)
+	{
+		UInt32 numErased = Size();
+		ReleaseNumbers();
+		return numErased;
+	}
 	UInt32 numErased = m_elements.size();
 	if (numErased) m_elements.clear();
+	// an emptied array can go back to storing plain numbers
+	if (GetContainerType() == kContainer_Array)
+		m_bNumbersOnly = true;
 	return numErased;
 }
 
@@ -1126,6 +1353,26 @@ bool ArrayVar::SetSize(UInt32 newSize, const ArrayElement* padWith)
 {
 	if (!m_bPacked)
 		return false;
+	g_ArrayMap.MarkChanged(m_ID);
+
+	if (m_bNumbersOnly)
+	{
+		UInt32 varSize = Size();
+		if (newSize <= varSize)
+		{
+			if (newSize < varSize)
+				WritableNumbers().Resize(newSize);
+			return true;
+		}
+		if (padWith->DataType() == kDataType_Numeric)
+		{
+			NumberVector& numbers = WritableNumbers();
+			numbers.Resize(newSize);
+			std::fill(numbers.Data() + varSize, numbers.Data() + newSize, padWith->m_data.num);
+			return true;
+		}
+		Unpack();
+	}
 
 	UInt32 varSize = m_elements.size();
 	if (varSize < newSize)
@@ -1147,6 +1394,14 @@ bool ArrayVar::Insert(UInt32 atIndex, const ArrayElement* toInsert)
 {
 	if (!m_bPacked)
 		return false;
+	g_ArrayMap.MarkChanged(m_ID);
+	if (m_bNumbersOnly)
+	{
+		if (atIndex > Size()) return false;
+		if (toInsert->DataType() == kDataType_Numeric)
+			return WritableNumbers().Insert(atIndex, toInsert->m_data.num) != nullptr;
+		Unpack();
+	}
 	auto* pVec = m_elements.getArrayPtr();
 	UInt32 varSize = pVec->Size();
 	if (atIndex > varSize) return false;
@@ -1162,16 +1417,42 @@ bool ArrayVar::Insert(UInt32 atIndex, ArrayID rangeID)
 	if (!m_bPacked || !src || !src->m_bPacked)
 		return false;
 
-	auto *pDest = m_elements.getArrayPtr(), *pSrc = src->m_elements.getArrayPtr();
-	UInt32 destSize = pDest->Size();
-	if (atIndex > destSize)
+	if (atIndex > Size())
 		return false;
 
-	UInt32 srcSize = pSrc->Size();
+	UInt32 srcSize = src->Size();
 	if (!srcSize) return true;
+	g_ArrayMap.MarkChanged(m_ID);
+
+	if (m_bNumbersOnly)
+	{
+		if (src->m_bNumbersOnly)
+		{
+			// holding the source buffer makes WritableNumbers detach from it, which also covers inserting an array into itself
+			PackedNumbers srcNumbers = src->m_numbers;
+			NumberRange srcRange = src->Numbers();
+			NumberVector& numbers = WritableNumbers();
+			numbers.InsertSize(atIndex, srcSize);
+			memcpy(numbers.Data() + atIndex, srcRange.Data(), sizeof(double) * srcSize);
+			return true;
+		}
+		Unpack();
+	}
 
+	auto* pDest = m_elements.getArrayPtr();
 	pDest->InsertSize(atIndex, srcSize);
-	ArrayElement *pDestData = pDest->Data() + atIndex, *pSrcData = pSrc->Data();
+	ArrayElement* pDestData = pDest->Data() + atIndex;
+	if (src->m_bNumbersOnly)
+	{
+		for (UInt32 idx = 0; idx < srcSize; idx++)
+		{
+			pDestData[idx].m_data.owningArray = m_ID;
+			pDestData[idx].SetNumber(src->Numbers()[idx]);
+		}
+		return true;
+	}
+
+	ArrayElement* pSrcData = src->m_elements.getArrayPtr()->Data();
 	for (UInt32 idx = 0; idx < srcSize; idx++)
 	{
 		pDestData[idx].m_data.owningArray = m_ID;
@@ -1186,6 +1467,16 @@ ArrayVar* ArrayVar::GetKeys(UInt8 modIndex)
 	ArrayVar* keysArr = g_ArrayMap.Create(kDataType_Numeric, true, modIndex);
 	double currKey = 0;
 
+	if (m_bNumbersOnly)
+	{
+		for (UInt32 idx = 0; idx < Size(); idx++)
+		{
+			keysArr->SetElementNumber(currKey, currKey);
+			currKey += 1;
+		}
+		return keysArr;
+	}
+
 	for (ArrayIterator iter = m_elements.begin(); !iter.End(); ++iter)
 	{
 		if (m_keyType == kDataType_Numeric)
@@ -1201,6 +1492,14 @@ ArrayVar* ArrayVar::GetKeys(UInt8 modIndex)
 ArrayVar* ArrayVar::Copy(UInt8 modIndex, bool bDeepCopy)
 {
 	ArrayVar* copyArr = g_ArrayMap.Create(m_keyType, m_bPacked, modIndex);
+	if (m_bNumbersOnly)
+	{
+		// numbers hold no references, so a shallow or deep copy can share them until either array writes
+		copyArr->m_numbers = m_numbers;
+		return copyArr;
+	}
+	// Other elements are copied right away: setting them is what copies strings and takes references to arrays and lambdas.
+	// Inner arrays of a deep copy that only hold numbers still share them, through their own Copy.
 	const ArrayElement* arrElem;
 	for (ArrayIterator iter = m_elements.begin(); !iter.End(); ++iter)
 	{
@@ -1241,13 +1540,18 @@ ArrayVar* ArrayVar::MakeSlice(const Slice* slice, UInt8 modIndex)
 	default:
 	case kContainer_Array:
 		{
-			ElementVector* pArray = m_elements.getArrayPtr();
-			UInt32 arrSize = pArray->Size(), iLow = (int)slice->m_lower, iHigh = (int)slice->m_upper;
+			UInt32 arrSize = Size(), iLow = (int)slice->m_lower, iHigh = (int)slice->m_upper;
 			if (iHigh >= arrSize)
 				iHigh = arrSize - 1;
 			if ((iLow >= arrSize) || (iLow > iHigh))
 				break;
-			ArrayElement* elements = pArray->Data();
+			if (m_bNumbersOnly)
+			{
+				// a view into the same buffer; writes to either array detach it like they do for copies
+				newVar->m_numbers.ShareRange(m_numbers, iLow, iHigh - iLow + 1);
+				break;
+			}
+			ArrayElement* elements = m_elements.getArrayPtr()->Data();
 			double packedIndex = 0;
 			for (int idx = iLow; idx <= iHigh; idx++)
 			{
@@ -1366,6 +1670,19 @@ void ArrayVar::Sort(ArrayVar* result, SortOrder order, SortType type, Script* co
 	// restriction: all elements of src must be of the same type
 
 	if (Empty()) return;
+	g_ArrayMap.MarkChanged(result->m_ID);
+
+	if (m_bNumbersOnly && result->m_bNumbersOnly && (type != kSortType_UserFunction) && result->Empty())
+	{
+		// InsertSorted gives no meaningful order for NaN, so leave those to the general path below
+		if (!Numbers().HasNaN())
+		{
+			PackedNumbers::AppendSorted(Numbers(), result->WritableNumbers(), order == kSort_Descending);
+			return;
+		}
+	}
+	Unpack();
+	result->Unpack();
 
 	ArrayIterator iter = m_elements.begin();
 	DataType dataType = iter.second()->DataType();
@@ -1432,6 +1749,7 @@ void ArrayVar::Dump(const std::function<void(const std::string&)>& output)
 	output(str);
 	_MESSAGE("%s", str.c_str());
 
+	Unpack();
 	for (ArrayIterator iter = m_elements.begin(); !iter.End(); ++iter)
 	{
 		char numBuf[0x50];
@@ -1526,6 +1844,7 @@ void ArrayVar::DumpToFile(const char* filePath, bool append)
 
 ArrayVarElementContainer::iterator ArrayVar::Begin()
 {
+	Unpack();
 	return m_elements.begin();
 }
 
@@ -1536,6 +1855,17 @@ std::string ArrayVar::GetStringRepresentation() const
 	case kContainer_Array:
 		{
 			std::string result = "[";
+			if (m_bNumbersOnly)
+			{
+				NumberRange numbers = Numbers();
+				for (UInt32 idx = 0; idx < numbers.Size(); idx++)
+				{
+					if (idx) result += ", ";
+					result += FormatString("%g", numbers[idx]);
+				}
+				result += "]";
+				return result;
+			}
 			auto* container = this->m_elements.getArrayPtr();
 			for (auto iter = container->Begin(); !iter.End(); ++iter)
 			{
@@ -1613,6 +1943,30 @@ bool ArrayVar::CompareArrays(ArrayVar* arr2, bool checkDeep)
 	if (this->ID() == arr2->ID())
 		return true;
 
+	if (m_bNumbersOnly || arr2->m_bNumbersOnly)
+	{
+		ArrayVar *packed = m_bNumbersOnly ? this : arr2, *other = m_bNumbersOnly ? arr2 : this;
+		if (other->m_bNumbersOnly)
+		{
+			NumberRange numbers1 = Numbers(), numbers2 = arr2->Numbers();
+			for (UInt32 idx = 0; idx < numbers1.Size(); idx++)
+				if (numbers1[idx] != numbers2[idx])
+					return false;
+			return true;
+		}
+		// the other side is a plain array or a numeric map: keys must run 0, 1, 2... and hold equal numbers
+		if (other->m_keyType != kDataType_Numeric)
+			return packed->Empty();
+		UInt32 idx = 0;
+		for (auto iter = other->m_elements.begin(); !iter.End(); ++iter, ++idx)
+		{
+			const ArrayElement* elem = iter.second();
+			if ((iter.first()->key.num != idx) || (elem->DataType() != kDataType_Numeric) || (elem->m_data.num != packed->Numbers()[idx]))
+				return false;
+		}
+		return true;
+	}
+
 	auto iter2 = arr2->m_elements.begin();
 	for (auto iter1 = this->m_elements.begin(); !iter1.End(); ++iter1, ++iter2)
 	{
@@ -1666,16 +2020,19 @@ bool ArrayVar::DeepEquals(ArrayVar* arr2)
 
 ArrayVarElementContainer* ArrayVar::GetRawContainer()
 {
+	Unpack();
 	return &m_elements;
 }
 
 ArrayVarElementContainer::iterator ArrayVar::begin()
 {
+	Unpack();
 	return m_elements.begin();
 }
 
 ArrayVarElementContainer::iterator ArrayVar::end() const
 {
+	const_cast<ArrayVar*>(this)->Unpack();
 	return m_elements.end();
 }
 
@@ -1750,6 +2107,7 @@ void ArrayVarMap::AddReference(ArrayID* ref, ArrayID toRef, UInt8 referringModIn
 	{
 		ScopedLock lock(arr->m_cs);
 		arr->m_refs.Append(referringModIndex); // record reference, increment refcount
+		MarkChanged(toRef);
 		*ref = toRef; // store ref'ed ArrayID in reference
 		MarkTemporary(toRef, false);
 	}
@@ -1763,6 +2121,7 @@ void ArrayVarMap::RemoveReference(ArrayID* ref, UInt8 referringModIndex)
 		ScopedLock lock(var->m_cs);
 		// decrement refcount
 		var->m_refs.Remove(referringModIndex);
+		MarkChanged(*ref);
 
 		// if refcount is zero, queue for deletion
 		if (var->m_refs.Empty())
@@ -1800,6 +2159,79 @@ ArrayElement* ArrayVarMap::GetElement(ArrayID id, const ArrayKey* key)
 	return arr ? arr->Get(key, false) : nullptr;
 }
 
+// Writes the ARVR record body for pVar, the record itself must already be open.
+void ArrayVarMap::WriteArrayRecord(ArrayID arrayID, ArrayVar* pVar)
+{
+	UInt32 numRefs = pVar->m_refs.Size();
+	UInt8 keyType = pVar->m_keyType;
+	const ArrayKey* pKey;
+	const ArrayElement* pElem;
+	char* str;
+	UInt16 len;
+
+	Serialization::WriteRecord8(pVar->m_owningModIndex);
+	Serialization::WriteRecord32(arrayID);
+	Serialization::WriteRecord8(keyType);
+	Serialization::WriteRecord8(pVar->m_bPacked);
+	Serialization::WriteRecord32(numRefs);
+	Serialization::WriteRecordData(pVar->m_refs.Data(), numRefs);
+
+	numRefs = pVar->Size();
+	Serialization::WriteRecord32(numRefs);
+	if (!numRefs) return;
+
+	if (pVar->m_bNumbersOnly)
+	{
+		// same records as a packed array of numeric elements: no key, type byte, value
+		const double* numbers = pVar->Numbers().Data();
+		for (UInt32 idx = 0; idx < numRefs; idx++)
+		{
+			Serialization::WriteRecord8(kDataType_Numeric);
+			Serialization::WriteRecord64(&numbers[idx]);
+		}
+		return;
+	}
+
+	for (ArrayIterator elems = pVar->m_elements.begin(); !elems.End(); ++elems)
+	{
+		pKey = elems.first();
+		pElem = elems.second();
+
+		if (keyType == kDataType_String)
+		{
+			str = pKey->key.StrPtr();
+			len = StrLen(str);
+			Serialization::WriteRecord16(len);
+			if (len) Serialization::WriteRecordData(str, len);
+		}
+		else if (!pVar->m_bPacked)
+			Serialization::WriteRecord64(&pKey->key.num);
+
+		Serialization::WriteRecord8(pElem->m_data.dataType);
+		switch (pElem->m_data.dataType)
+		{
+		case kDataType_Numeric:
+			Serialization::WriteRecord64(&pElem->m_data.num);
+			break;
+		case kDataType_String:
+			{
+				str = pElem->m_data.StrPtr();
+				len = StrLen(str);
+				Serialization::WriteRecord16(len);
+				if (len) Serialization::WriteRecordData(str, len);
+				break;
+			}
+		case kDataType_Array:
+		case kDataType_Form:
+			Serialization::WriteRecord32(pElem->m_data.formID);
+			break;
+		default:
+			_MESSAGE("Error in ArrayVarMap::Save() - unhandled element type %d. Element not saved.",
+			         pElem->m_data.dataType);
+		}
+	}
+}
+
 void ArrayVarMap::Save(NVSESerializationInterface* intfc)
 {
 	Clean();
@@ -1807,76 +2239,56 @@ void ArrayVarMap::Save(NVSESerializationInterface* intfc)
 	Serialization::OpenRecord('ARVS', kVersion);
 
 	ArrayVar* pVar;
-	UInt32 numRefs;
-	UInt8 keyType;
-	const ArrayKey* pKey;
-	const ArrayElement* pElem;
-	char* str;
-	UInt16 len;
 	for (auto iter = vars.Begin(); !iter.End(); ++iter)
 	{
 		if (IsTemporary(iter.Key()))
 			continue;
 
 		pVar = &iter.Get();
-		numRefs = pVar->m_refs.Size();
-		if (!numRefs) continue;
-		keyType = pVar->m_keyType;
+		if (pVar->m_refs.Empty()) continue;
 
 		Serialization::OpenRecord('ARVR', kVersion);
-		Serialization::WriteRecord8(pVar->m_owningModIndex);
-		Serialization::WriteRecord32(iter.Key());
-		Serialization::WriteRecord8(keyType);
-		Serialization::WriteRecord8(pVar->m_bPacked);
-		Serialization::WriteRecord32(numRefs);
-		Serialization::WriteRecordData(pVar->m_refs.Data(), numRefs);
+		WriteArrayRecord(iter.Key(), pVar);
+	}
 
-		numRefs = pVar->Size();
-		Serialization::WriteRecord32(numRefs);
-		if (!numRefs) continue;
+	Serialization::OpenRecord('ARVE', kVersion);
+}
 
-		for (ArrayIterator elems = pVar->m_elements.begin(); !elems.End(); ++elems)
-		{
-			pKey = elems.first();
-			pElem = elems.second();
+// the array if Save writes it
+ArrayVar* ArrayVarMap::GetSaved(ArrayID arrayID)
+{
+	ArrayVar* pVar = Get(arrayID);
+	if (!pVar || IsTemporary(arrayID) || pVar->m_refs.Empty())
+		return nullptr;
+	return pVar;
+}
 
-			if (keyType == kDataType_String)
-			{
-				str = pKey->key.str;
-				len = StrLen(str);
-				Serialization::WriteRecord16(len);
-				if (len) Serialization::WriteRecordData(str, len);
-			}
-			else if (!pVar->m_bPacked)
-				Serialization::WriteRecord64(&pKey->key.num);
+void ArrayVarMap::SaveChanges(NVSESerializationInterface* intfc)
+{
+	Clean();
 
-			Serialization::WriteRecord8(pElem->m_data.dataType);
-			switch (pElem->m_data.dataType)
-			{
-			case kDataType_Numeric:
-				Serialization::WriteRecord64(&pElem->m_data.num);
-				break;
-			case kDataType_String:
-				{
-					str = pElem->m_data.str;
-					len = StrLen(str);
-					Serialization::WriteRecord16(len);
-					if (len) Serialization::WriteRecordData(str, len);
-					break;
-				}
-			case kDataType_Array:
-			case kDataType_Form:
-				Serialization::WriteRecord32(pElem->m_data.formID);
-				break;
-			default:
-				_MESSAGE("Error in ArrayVarMap::Save() - unhandled element type %d. Element not saved.",
-				         pElem->m_data.dataType);
-			}
+	Vector<ArrayID> dropped;
+	ForEachChanged([&](ArrayID arrayID)
+	{
+		if (!GetSaved(arrayID))
+			dropped.Append(arrayID);
+	});
+	Serialization::OpenRecord('ARVX', kVersion);
+	Serialization::WriteRecord32(dropped.Size());
+	Serialization::WriteRecordData(dropped.Data(), dropped.Size() * sizeof(ArrayID));
+
+	ForEachChanged([&](ArrayID arrayID)
+	{
+		if (ArrayVar* pVar = GetSaved(arrayID))
+		{
+			Serialization::OpenRecord('ARVR', kVersion);
+			WriteArrayRecord(arrayID, pVar);
 		}
-	}
+	});
 
 	Serialization::OpenRecord('ARVE', kVersion);
 }
+
 #if _DEBUG
 std::set<std::string> g_modsWithCosaveVars;
 #endif
@@ -1926,6 +2338,9 @@ void ArrayVarMap::Load(NVSESerializationInterface* intfc)
 					modIndex = (tempRefID >> 24);
 
 				arrayID = Serialization::ReadRecord32();
+				// the record of a delta cosave replaces the array of its base
+				if (VarExists(arrayID))
+					DiscardLoaded(arrayID);
 				keyType = Serialization::ReadRecord8();
 				bPacked = Serialization::ReadRecord8();
 
@@ -2010,18 +2425,17 @@ void ArrayVarMap::Load(NVSESerializationInterface* intfc)
 
 				contType = newArr->GetContainerType();
 
-				ArrayElement *elements, *elem;
+				ArrayElement *elements = nullptr, *elem;
+				ElementVector* pArray;
 				ElementNumMap* pNumMap;
 				ElementStrMap* pStrMap;
 				switch (contType)
 				{
 				case kContainer_Array:
-					{
-						auto* pArray = newArr->m_elements.getArrayPtr();
-						pArray->Resize(numElements);
-						elements = pArray->Data();
-						break;
-					}
+					// read into plain number storage until an element of another type turns up
+					pArray = newArr->m_elements.getArrayPtr();
+					newArr->WritableNumbers().Resize(numElements);
+					break;
 				case kContainer_NumericMap:
 					pNumMap = newArr->m_elements.getNumMapPtr();
 					break;
@@ -2049,6 +2463,18 @@ void ArrayVarMap::Load(NVSESerializationInterface* intfc)
 					{
 					default:
 					case kContainer_Array:
+						if (newArr->m_bNumbersOnly)
+						{
+							if (elemType == kDataType_Numeric)
+							{
+								Serialization::ReadRecord64(&newArr->WritableNumbers()[i]);
+								continue;
+							}
+							newArr->WritableNumbers().Resize(i);
+							newArr->Unpack();
+							pArray->Resize(numElements);
+							elements = pArray->Data();
+						}
 						elem = &elements[i];
 						break;
 					case kContainer_NumericMap:
@@ -2072,12 +2498,15 @@ void ArrayVarMap::Load(NVSESerializationInterface* intfc)
 							strLength = Serialization::ReadRecord16();
 							if (strLength)
 							{
-								char* strVal = (char*)malloc(strLength + 1);
+								char* strVal = elem->m_data.AllocStr(strLength);
 								Serialization::ReadRecordData(strVal, strLength);
 								strVal[strLength] = 0;
-								elem->m_data.str = strVal;
 							}
-							else elem->m_data.str = nullptr;
+							else
+							{
+								elem->m_data.strIsInline = false;
+								elem->m_data.str = nullptr;
+							}
 							break;
 						}
 					case kDataType_Array:
@@ -2106,6 +2535,54 @@ void ArrayVarMap::Load(NVSESerializationInterface* intfc)
 	}
 }
 
+void ArrayVarMap::LoadChanges(NVSESerializationInterface* intfc)
+{
+	_MESSAGE("Loading changed array variables");
+
+	// read in batches, a corrupt count stops at the end of the record
+	ArrayID dropped[0x40];
+	for (UInt32 numDropped = Serialization::ReadRecord32(), numRead; numDropped; numDropped -= numRead)
+	{
+		numRead = Serialization::ReadRecordData(dropped, std::min<UInt32>(numDropped, 0x40) * sizeof(ArrayID)) / sizeof(ArrayID);
+		if (!numRead)
+			break;
+		for (UInt32 idx = 0; idx < numRead; idx++)
+			DiscardLoaded(dropped[idx]);
+	}
+
+	Load(intfc);
+
+	// IDs free for new arrays are the gaps between loaded ones, as after loading a full cosave
+	ScopedLock lock(cs);
+	availableIDs.Clear();
+	UInt32 nextID = 1;
+	for (UInt32 idx = 0; idx < usedIDs.Size(); idx++)
+	{
+		for (UInt32 usedID = usedIDs.Keys()[idx]; nextID < usedID; nextID++)
+			availableIDs.Insert(nextID);
+		nextID++;
+	}
+}
+
+// Drops an array loaded from a base file that a delta cosave replaces or no longer has. The arrays its elements refer
+// to are loaded with their references as saved, so the elements are let go of without releasing any.
+void ArrayVarMap::DiscardLoaded(ArrayID arrayID)
+{
+	ArrayVar* pVar = Get(arrayID);
+	if (!pVar)
+		return;
+	if (!pVar->m_bNumbersOnly)
+	{
+		for (ArrayIterator elems = pVar->m_elements.begin(); !elems.End(); ++elems)
+		{
+			ArrayElement* pElem = elems.second();
+			if (pElem->m_data.dataType != kDataType_String)
+				pElem->m_data.dataType = kDataType_Invalid;
+		}
+	}
+	Delete(arrayID);
+}
+
 void ArrayVarMap::Clean() // garbage collection: delete unreferenced arrays
 {
 	// ArrayVar destructor may queue more IDs for deletion if deleted array contains other arrays
@@ -2193,7 +2670,7 @@ namespace PluginAPI
 	{
 		ArrayVar* arrVar = g_ArrayMap.Get((ArrayID)arr);
 		if (arrVar && (arrVar->KeyType() == kDataType_Numeric) && arrVar->IsPacked())
-			arrVar->SetElementFromAPI((int)arrVar->m_elements.getArrayPtr()->Size(), &value);
+			arrVar->SetElementFromAPI((int)arrVar->Size(), &value);
 	}
 
 	UInt32 ArrayAPI::GetArraySize(NVSEArrayVarInterface::Array* arr)
@@ -2234,8 +2711,16 @@ namespace PluginAPI
 					data = var->Get(key.str, false);
 				break;
 			case key.kType_Numeric:
-				if (var->KeyType() == kDataType_Numeric)
-					data = var->Get(key.num, false);
+				if (var->KeyType() != kDataType_Numeric)
+					break;
+				if (var->m_bNumbersOnly)
+				{
+					const double* pNum = var->GetPackedNumber(key.num);
+					if (pNum)
+						out = *pNum;
+					return pNum != nullptr;
+				}
+				data = var->Get(key.num, false);
 				break;
 			}
 
@@ -2257,6 +2742,17 @@ namespace PluginAPI
 		{
 			UInt8 keyType = var->KeyType();
 			UInt32 i = 0;
+			if (var->m_bNumbersOnly)
+			{
+				const auto& numbers = var->Numbers();
+				for (; i < numbers.Size(); i++)
+				{
+					if (keys)
+						keys[i] = (double)i;
+					elements[i] = numbers[i];
+				}
+				return true;
+			}
 			for (ArrayIterator iter = var->m_elements.begin(); !iter.End(); ++iter)
 			{
 				if (keys)
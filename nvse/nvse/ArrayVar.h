@@ -23,6 +23,7 @@ struct ScriptToken;
 #include <vector>
 #include <map>
 #include "LambdaManager.h"
+#include "PackedNumbers.h"
 #include <string_view>
 
 // NVSE array datatype, represented by std::map<ArrayKey, ArrayElement>
@@ -57,6 +58,14 @@ Key		::= { string || double }
 			...
 	ARVE - empty chunk indicating end of variables
 
+A delta cosave (see Core_Serialization.cpp) has this in place of ARVS, on top of the arrays of its base file:
+	ARVX
+		UInt32	numDropped
+		UInt32	IDs[numDropped]	<- arrays that were in the base and are gone or no longer saved
+	[ARVR]						<- arrays created or changed since the base, replacing the base's
+		...
+	ARVE
+
 As with string variables, array vars discarded on load if owning mod no longer present in modlist
 
 */
@@ -77,9 +86,14 @@ const char* DataTypeToString(DataType dataType);
 Script::VariableType DataTypeToVarType(DataType dataType);
 DataType VarTypeToDataType(Script::VariableType variableType);
 
+// Strings of up to kMaxInlineStr characters are stored in the value itself instead of a heap copy; strIsInline tells
+// which of str / inlineStr holds it, so strings are read through GetStr() or StrPtr() rather than str.
 struct ArrayData
 {
+	static constexpr UInt32 kMaxInlineStr = 7;
+
 	DataType	dataType;
+	bool		strIsInline = false;
 	ArrayID		owningArray;
 	union
 	{
@@ -87,13 +101,24 @@ struct ArrayData
 		UInt32		formID;
 		char		*str;
 		ArrayID		arrID;
+		char		inlineStr[kMaxInlineStr + 1];
 	};
 
 	~ArrayData();
 	ArrayData() = default;
 	[[nodiscard]] const char *GetStr() const;
+	// NULL for an empty string, where GetStr() returns "". Picks inlineStr or str by masking rather than branching on
+	// strIsInline, which is unpredictable in an array mixing short and long strings.
+	[[nodiscard]] char *StrPtr() const
+	{
+		const uintptr_t inlineMask = 0 - (uintptr_t)strIsInline;
+		return (char*)(((uintptr_t)inlineStr & inlineMask) | ((uintptr_t)str & ~inlineMask));
+	}
 	void SetStr(const char *srcStr);
 	void SetStr(std::string_view srcStr);
+	// Storage for a string of length characters plus the terminator, filled by the caller.
+	char *AllocStr(UInt32 length);
+	void FreeStr();
 
 	//Casts the data in the form InternalFunctionCaller::PopulateArgs() understands.
 	[[nodiscard]] void* GetAsVoidArg() const;
@@ -107,6 +132,7 @@ struct ArrayElement
 {
 protected:
 	void UnsetDefault();	//to avoid calling virtual func in dtor.
+	void MarkOwnerChanged() const;
 public:
 	friend class ArrayVar;
 	friend class ArrayVarMap;
@@ -132,6 +158,7 @@ public:
 
 		m_data.dataType = kDataType_Form;
 		m_data.formID = form ? form->refID : 0;
+		MarkOwnerChanged();
 		return true;
 	}	//unlike SetFormID, will not store lambda info!
 	bool SetFormID(UInt32 refID);
@@ -152,7 +179,7 @@ public:
 			m_data.dataType = from.m_data.dataType;
 			m_data.owningArray = from.m_data.owningArray;
 			if (m_data.dataType == kDataType_String)
-				m_data.SetStr(from.m_data.str);
+				m_data.SetStr(from.m_data.GetStr());
 			else m_data.num = from.m_data.num;
 		}
 		return *this;
@@ -214,113 +241,39 @@ struct ArrayKey
 
 extern thread_local ArrayKey s_arrNumKey, s_arrStrKey;
 
-enum ContainerType
-{
-	kContainer_Array,
-	kContainer_NumericMap,
-	kContainer_StringMap
-};
-
-typedef Vector<ArrayElement> ElementVector;
-typedef Map<double, ArrayElement> ElementNumMap;
-typedef Map<char*, ArrayElement> ElementStrMap;
-
-class ArrayVarElementContainer
-{
-	friend class ArrayVar;
-
-	struct GenericContainer
-	{
-		void *data;
-		UInt32		 numItems;
-		UInt32		 numAlloc;
-	};
-
-	ContainerType		m_type;
-	GenericContainer	m_container;
-
-	ElementVector& AsArray() const {return *(ElementVector*)&m_container;}
-	ElementNumMap& AsNumMap() const {return *(ElementNumMap*)&m_container;}
-	ElementStrMap& AsStrMap() const {return *(ElementStrMap*)&m_container;}
-
-public:
-	ArrayVarElementContainer();
-
-	~ArrayVarElementContainer();
-
-	UInt32 size() const {return m_container.numItems;}
-
-	bool empty() const {return !m_container.numItems;}
-
-	void clear();
-
-	UInt32 erase(const ArrayKey* key);
-
-	UInt32 erase(UInt32 iLow, UInt32 iHigh);
-
-	class iterator
-	{
-		friend ArrayVarElementContainer;
-
-		struct GenericIterator
-		{
-			GenericContainer	*contObj;
-			void				*pData;
-			UInt32				index;
-		};
-
-		ContainerType	m_type;
-		GenericIterator	m_iter;
-
-		ElementVector::Iterator& AsArray() {return *(ElementVector::Iterator*)&m_iter;}
-		ElementNumMap::Iterator& AsNumMap() {return *(ElementNumMap::Iterator*)&m_iter;}
-		ElementStrMap::Iterator& AsStrMap() {return *(ElementStrMap::Iterator*)&m_iter;}
-
-	public:
-		iterator(ArrayVarElementContainer& container);
-		iterator(ArrayVarElementContainer& container, bool reverse);
-		iterator(ArrayVarElementContainer& container, const ArrayKey* key);
-		iterator(ContainerType type, const GenericIterator& iterator);
-
-		bool End() {return m_iter.index >= m_iter.contObj->numItems;}
-
-		void operator++();
-		void operator--();
-		bool operator!=(const iterator& other) const;
-		ArrayElement* operator*();
-
-		const ArrayKey* first();
-
-		ArrayElement* second();
-	};
-
-	iterator begin();
-	iterator rbegin();
-	iterator end() const;
-
-	iterator find(const ArrayKey* key) {return iterator(*this, key);}
-
-	ElementVector* getArrayPtr() const {return &AsArray();}
-	ElementNumMap* getNumMapPtr() const {return &AsNumMap();}
-	ElementStrMap* getStrMapPtr() const {return &AsStrMap();}
-};
-
-typedef ArrayVarElementContainer::iterator ArrayIterator;
+// ArrayVarElementContainer needs ArrayElement and ArrayKey complete, so it comes after them
+#include "ArrayVarElementContainer.h"
 
 class ArrayVar
 {
 	friend class ArrayVarMap;
 	friend class Matrix;
+	friend class BatchComponents;
 	friend class PluginAPI::ArrayAPI;
 
 	typedef ArrayVarElementContainer _ElementMap;
 	_ElementMap			m_elements;
+	PackedNumbers		m_numbers;	// element storage while m_bNumbersOnly is set; m_elements is empty then
 	ArrayID				m_ID;
 	UInt8				m_owningModIndex;
 	UInt8				m_keyType;
 	bool				m_bPacked;
+	bool				m_bNumbersOnly;
 	Vector<UInt8>		m_refs;		// data is modIndex of referring object; size() is number of references
 
+	// Packed arrays start out storing plain doubles in m_numbers. Storing anything else, or asking for an
+	// ArrayElement pointer into the array (Get, Begin, GetRawContainer...), moves the numbers into m_elements
+	// for good. Commands that only read or write numbers never trigger that.
+	// Copies of such arrays share m_numbers, and slices can be views into it (PackedNumbers).
+	typedef PackedNumbers::NumberVector NumberVector;
+	typedef PackedNumbers::Range NumberRange;
+
+	void Unpack();
+	void ReleaseNumbers();
+	NumberRange Numbers() const {return m_numbers.Get();}
+	NumberVector& WritableNumbers();
+	const double* GetPackedNumber(double key) const;
+
 public:
 	ICriticalSection m_cs;
 #if _DEBUG
@@ -346,8 +299,8 @@ public:
 	UInt8 KeyType() const {return m_keyType;}
 	bool IsPacked() const {return m_bPacked;}
 	UInt8 OwningModIndex() const {return m_owningModIndex;}
-	UInt32 Size() const {return m_elements.size();}
-	bool Empty() const {return m_elements.empty();}
+	UInt32 Size() const {return m_bNumbersOnly ? Numbers().Size() : m_elements.size();}
+	bool Empty() const {return !Size();}
 	ContainerType GetContainerType() const {return m_elements.m_type;}
 
 	ArrayElement* Get(const ArrayKey* key, bool bCanCreateNew);
@@ -360,6 +313,7 @@ public:
 
 	bool SetElementNumber(double key, double num);
 	bool SetElementNumber(const char* key, double num);
+	bool SetElementNumber(const ArrayKey* key, double num);
 
 	bool SetElementString(double key, const char* str);
 	bool SetElementString(const char* key, const char* str);
@@ -387,6 +341,7 @@ public:
 
 	const ArrayKey* Find(const ArrayElement* toFind, const Slice* range = NULL);
 
+	// For arrays still holding plain numbers, outElem points to a per-thread copy that is only valid until the next call.
 	bool GetFirstElement(ArrayElement** outElem, const ArrayKey** outKey);
 	bool GetLastElement(ArrayElement** outElem, const ArrayKey** outKey);
 	bool GetNextElement(const ArrayKey* prevKey, ArrayElement** outElem, const ArrayKey** outKey);
@@ -430,9 +385,14 @@ class ArrayVarMap : public VarMap<ArrayVar>
 	static const UInt32 kVersion = 2;
 
 	ArrayVar* Add(UInt32 varID, UInt32 keyType, bool packed, UInt8 modIndex, UInt32 numRefs, UInt8* refs);
+	ArrayVar* GetSaved(ArrayID arrayID);
+	static void WriteArrayRecord(ArrayID arrayID, ArrayVar* pVar);
+	void DiscardLoaded(ArrayID arrayID);
 public:
 	void Save(NVSESerializationInterface* intfc);
+	void SaveChanges(NVSESerializationInterface* intfc);	// ARVX block of a delta cosave
 	void Load(NVSESerializationInterface* intfc);
+	void LoadChanges(NVSESerializationInterface* intfc);	// from the ARVX record on
 	void Clean();
 
 	ArrayVar* Create(UInt32 keyType, bool bPacked, UInt8 modIndex);
@@ -460,6 +420,12 @@ public:
 
 extern ArrayVarMap g_ArrayMap;
 
+// Only elements stored in an array have an owner.
+inline void ArrayElement::MarkOwnerChanged() const
+{
+	g_ArrayMap.MarkChanged(m_data.owningArray);
+}
+
 UInt8 __fastcall GetArrayOwningModIndex(ArrayID arrID);
 
 namespace PluginAPI
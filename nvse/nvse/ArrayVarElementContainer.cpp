@@ -1,8 +1,134 @@
 #include "ArrayVar.h"
 
+#include <algorithm>
+#include <utility>
+
 #if RUNTIME
 
-ArrayVarElementContainer::ArrayVarElementContainer(): m_type(kContainer_Array)
+namespace
+{
+	// Layout of ElementStrMap's entries; ArrayElement is larger than 8 bytes, so Map stores it out of line.
+	struct StrMapEntry
+	{
+		char			*key;
+		ArrayElement	*value;
+	};
+	static_assert(sizeof(StrMapEntry) == sizeof(*std::declval<ElementStrMap&>().Data()));
+
+	// Folds case the same way StrCompare does, so keys that compare equal always hash equal.
+	UInt32 HashStrMapKey(const char* key)
+	{
+		UInt32 hash = 0x811C9DC5;
+		for (; *key; ++key)
+			hash = (hash ^ (UInt8)game_toupper(*(const UInt8*)key)) * 0x01000193;
+		return hash;
+	}
+
+	bool StrMapEntryLess(const StrMapEntry& lhs, const StrMapEntry& rhs)
+	{
+		return StrCompare(lhs.key, rhs.key) < 0;
+	}
+}
+
+// Open-addressing hash of a string map's keys with cached hashes. Slots point at the key strings and elements
+// owned by the map, which stay put when the map sorts or shifts its entries.
+class StrMapHashIndex
+{
+	struct Slot
+	{
+		UInt32			hash;
+		const char		*key;	// null if the slot is empty
+		ArrayElement	*value;
+	};
+
+	Slot	*m_slots = nullptr;
+	UInt32	m_mask = 0;
+	UInt32	m_numUsed = 0;
+
+	void Grow()
+	{
+		Slot *oldSlots = m_slots;
+		const UInt32 oldSize = m_slots ? m_mask + 1 : 0;
+		const UInt32 newSize = oldSize ? oldSize << 1 : 0x80;
+		m_slots = POOL_ALLOC(newSize, Slot);
+		MemZero(m_slots, newSize * sizeof(Slot));
+		m_mask = newSize - 1;
+		for (UInt32 i = 0; i < oldSize; i++)
+		{
+			if (!oldSlots[i].key) continue;
+			UInt32 idx = oldSlots[i].hash & m_mask;
+			while (m_slots[idx].key)
+				idx = (idx + 1) & m_mask;
+			m_slots[idx] = oldSlots[i];
+		}
+		if (oldSlots)
+			POOL_FREE(oldSlots, oldSize, Slot);
+	}
+
+	Slot* FindSlot(const char* key, UInt32 hash) const
+	{
+		for (UInt32 idx = hash & m_mask; ; idx = (idx + 1) & m_mask)
+		{
+			Slot *slot = m_slots + idx;
+			if (!slot->key || ((slot->hash == hash) && !StrCompare(slot->key, key)))
+				return slot;
+		}
+	}
+
+public:
+	UInt32	numSorted = 0;	// entries before this index are in key order, the rest in insertion order
+
+	StrMapHashIndex(const StrMapEntry* entries, UInt32 numEntries) : numSorted(numEntries)
+	{
+		Grow();
+		for (UInt32 i = 0; i < numEntries; i++)
+			Insert(entries[i].key, HashStrMapKey(entries[i].key), entries[i].value);
+	}
+
+	~StrMapHashIndex()
+	{
+		POOL_FREE(m_slots, m_mask + 1, Slot);
+	}
+
+	ArrayElement* Find(const char* key, UInt32 hash) const
+	{
+		return FindSlot(key, hash)->value;
+	}
+
+	// key must not be in the index yet
+	void Insert(const char* key, UInt32 hash, ArrayElement* value)
+	{
+		if ((m_numUsed + 1) * 2 > m_mask + 1)
+			Grow();
+		Slot *slot = FindSlot(key, hash);
+		slot->hash = hash;
+		slot->key = key;
+		slot->value = value;
+		m_numUsed++;
+	}
+
+	void Remove(const char* key)
+	{
+		Slot *slot = FindSlot(key, HashStrMapKey(key));
+		if (!slot->key) return;
+		m_numUsed--;
+		// backward shift deletion, so lookups never need tombstones
+		UInt32 hole = slot - m_slots;
+		for (UInt32 idx = (hole + 1) & m_mask; m_slots[idx].key; idx = (idx + 1) & m_mask)
+		{
+			const UInt32 home = m_slots[idx].hash & m_mask;
+			if (((idx - home) & m_mask) >= ((idx - hole) & m_mask))
+			{
+				m_slots[hole] = m_slots[idx];
+				hole = idx;
+			}
+		}
+		m_slots[hole].key = nullptr;
+		m_slots[hole].value = nullptr;
+	}
+};
+
+ArrayVarElementContainer::ArrayVarElementContainer(): m_type(kContainer_Array), m_strIndex(nullptr)
 {
 	m_container.data = NULL;
 	m_container.numItems = 0;
@@ -20,11 +146,65 @@ ArrayVarElementContainer::~ArrayVarElementContainer()
 			AsNumMap().~ElementNumMap();
 			break;
 		case kContainer_StringMap:
+			delete m_strIndex;
 			AsStrMap().~ElementStrMap();
 			break;
 	}
 }
 
+void ArrayVarElementContainer::SortStrMap() const
+{
+	if (!m_strIndex || (m_strIndex->numSorted == m_container.numItems))
+		return;
+	auto *entries = static_cast<StrMapEntry*>(m_container.data);
+	auto *tail = entries + m_strIndex->numSorted, *end = entries + m_container.numItems;
+	std::sort(tail, end, StrMapEntryLess);
+	std::inplace_merge(entries, tail, end, StrMapEntryLess);
+	m_strIndex->numSorted = m_container.numItems;
+}
+
+ElementStrMap* ArrayVarElementContainer::getStrMapPtr() const
+{
+	SortStrMap();
+	delete m_strIndex;
+	m_strIndex = nullptr;
+	return &AsStrMap();
+}
+
+ArrayElement* ArrayVarElementContainer::getStrMapElement(const char* key) const
+{
+	// with an index the entries may have an unsorted tail, which the map's binary search would miss
+	if (!key || (!m_strIndex && (m_container.numItems < kStrMapHashThreshold)))
+		return AsStrMap().GetPtr(const_cast<char*>(key));
+	if (!m_strIndex)
+		m_strIndex = new StrMapHashIndex(static_cast<StrMapEntry*>(m_container.data), m_container.numItems);
+	return m_strIndex->Find(key, HashStrMapKey(key));
+}
+
+ArrayElement* ArrayVarElementContainer::emplaceStrMapElement(const char* key)
+{
+	if (!key || (!m_strIndex && (m_container.numItems < kStrMapHashThreshold)))
+		return AsStrMap().Emplace(const_cast<char*>(key));
+	if (!m_strIndex)
+		m_strIndex = new StrMapHashIndex(static_cast<StrMapEntry*>(m_container.data), m_container.numItems);
+	const UInt32 hash = HashStrMapKey(key);
+	if (ArrayElement *found = m_strIndex->Find(key, hash))
+		return found;
+
+	// append without shifting the sorted entries; SortStrMap puts the key in order once something iterates
+	if (m_container.numAlloc <= m_container.numItems)
+	{
+		const UInt32 newAlloc = m_container.numAlloc << 1;
+		POOL_REALLOC(m_container.data, m_container.numAlloc, newAlloc, StrMapEntry);
+		m_container.numAlloc = newAlloc;
+	}
+	StrMapEntry *entry = static_cast<StrMapEntry*>(m_container.data) + m_container.numItems++;
+	entry->key = CopyString(key);
+	entry->value = new (ALLOC_NODE(ArrayElement)) ArrayElement();
+	m_strIndex->Insert(entry->key, hash, entry->value);
+	return entry->value;
+}
+
 void ArrayVarElementContainer::clear()
 {
 	if (empty()) return;
@@ -50,6 +230,8 @@ void ArrayVarElementContainer::clear()
 			for (auto iter = AsStrMap().Begin(); !iter.End(); ++iter)
 				iter.Get().Unset();
 			AsStrMap().Clear();
+			delete m_strIndex;
+			m_strIndex = nullptr;
 			break;
 		}
 	}
@@ -87,11 +269,24 @@ UInt32 ArrayVarElementContainer::erase(const ArrayKey *key)
 		{
 			if (key->key.dataType != kDataType_String)
 				return 0;
-			auto findKey = AsStrMap().Find(key->key.str);
+			SortStrMap();
+			auto findKey = AsStrMap().Find(key->key.StrPtr());
 			if (findKey.End())
 				return 0;
+			if (m_strIndex)
+				m_strIndex->Remove(findKey.Key());
 			findKey.Get().Unset();
 			findKey.Remove(false);
+			if (!m_strIndex)
+				return 1;
+			// the entries are all sorted still, one fewer of them; small maps go back to binary search, and the index
+			// can simply go
+			m_strIndex->numSorted = m_container.numItems;
+			if (m_container.numItems < kStrMapHashThreshold)
+			{
+				delete m_strIndex;
+				m_strIndex = nullptr;
+			}
 			return 1;
 		}
 	}
@@ -149,6 +344,7 @@ ArrayVarElementContainer::iterator::iterator(ArrayVarElementContainer& container
 			AsNumMap().Init(container.AsNumMap());
 			break;
 		case kContainer_StringMap:
+			container.SortStrMap();
 			AsStrMap().Init(container.AsStrMap());
 			break;
 	}
@@ -167,6 +363,7 @@ ArrayVarElementContainer::iterator::iterator(ArrayVarElementContainer& container
 			AsNumMap().Last(container.AsNumMap());
 			break;
 		case kContainer_StringMap:
+			container.SortStrMap();
 			AsStrMap().Last(container.AsStrMap());
 			break;
 	}
@@ -185,7 +382,8 @@ ArrayVarElementContainer::iterator::iterator(ArrayVarElementContainer& container
 			AsNumMap().Find(container.AsNumMap(), key->key.num);
 			break;
 		case kContainer_StringMap:
-			AsStrMap().Find(container.AsStrMap(), key->key.str);
+			container.SortStrMap();
+			AsStrMap().Find(container.AsStrMap(), key->key.StrPtr());
 			break;
 	}
 }
@@ -288,6 +486,7 @@ ArrayVarElementContainer::iterator ArrayVarElementContainer::end() const
 		}
 	case kContainer_StringMap:
 		{
+			SortStrMap();
 			auto iter = ElementStrMap::Iterator();
 			iter.Last(AsStrMap());
 			return iterator(m_type, *reinterpret_cast<iterator::GenericIterator*>(&iter));
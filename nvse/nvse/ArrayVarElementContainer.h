@@ -0,0 +1,113 @@
+#pragma once
+// Element storage of an ArrayVar: a Vector, a Map of numbers or a Map of strings, depending on its key type. ArrayVar.h
+// includes it once ArrayElement and ArrayKey are defined; host_bench builds it against stand-ins for those.
+
+struct ArrayElement;
+struct ArrayKey;
+
+enum ContainerType
+{
+	kContainer_Array,
+	kContainer_NumericMap,
+	kContainer_StringMap
+};
+
+typedef Vector<ArrayElement> ElementVector;
+typedef Map<double, ArrayElement> ElementNumMap;
+typedef Map<char*, ArrayElement> ElementStrMap;
+
+class StrMapHashIndex;
+
+class ArrayVarElementContainer
+{
+	friend class ArrayVar;
+
+	struct GenericContainer
+	{
+		void *data;
+		UInt32		 numItems;
+		UInt32		 numAlloc;
+	};
+
+	ContainerType		m_type;
+	GenericContainer	m_container;
+
+	// String maps that grow past kStrMapHashThreshold keys get a case-insensitive hash index for lookups.
+	// From then on new keys are appended unsorted and only merged into key order when the map is iterated.
+	mutable StrMapHashIndex*	m_strIndex;
+
+	ElementVector& AsArray() const {return *(ElementVector*)&m_container;}
+	ElementNumMap& AsNumMap() const {return *(ElementNumMap*)&m_container;}
+	ElementStrMap& AsStrMap() const {return *(ElementStrMap*)&m_container;}
+
+	void SortStrMap() const;
+
+public:
+	static constexpr UInt32 kStrMapHashThreshold = 64;
+
+	ArrayVarElementContainer();
+
+	~ArrayVarElementContainer();
+
+	UInt32 size() const {return m_container.numItems;}
+
+	bool empty() const {return !m_container.numItems;}
+
+	void clear();
+
+	UInt32 erase(const ArrayKey* key);
+
+	UInt32 erase(UInt32 iLow, UInt32 iHigh);
+
+	class iterator
+	{
+		friend ArrayVarElementContainer;
+
+		struct GenericIterator
+		{
+			GenericContainer	*contObj;
+			void				*pData;
+			UInt32				index;
+		};
+
+		ContainerType	m_type;
+		GenericIterator	m_iter;
+
+		ElementVector::Iterator& AsArray() {return *(ElementVector::Iterator*)&m_iter;}
+		ElementNumMap::Iterator& AsNumMap() {return *(ElementNumMap::Iterator*)&m_iter;}
+		ElementStrMap::Iterator& AsStrMap() {return *(ElementStrMap::Iterator*)&m_iter;}
+
+	public:
+		iterator(ArrayVarElementContainer& container);
+		iterator(ArrayVarElementContainer& container, bool reverse);
+		iterator(ArrayVarElementContainer& container, const ArrayKey* key);
+		iterator(ContainerType type, const GenericIterator& iterator);
+
+		bool End() {return m_iter.index >= m_iter.contObj->numItems;}
+
+		void operator++();
+		void operator--();
+		bool operator!=(const iterator& other) const;
+		ArrayElement* operator*();
+
+		const ArrayKey* first();
+
+		ArrayElement* second();
+	};
+
+	iterator begin();
+	iterator rbegin();
+	iterator end() const;
+
+	iterator find(const ArrayKey* key) {return iterator(*this, key);}
+
+	ElementVector* getArrayPtr() const {return &AsArray();}
+	ElementNumMap* getNumMapPtr() const {return &AsNumMap();}
+	// Sorts the map and drops its hash index, since the caller may insert or erase through the map directly.
+	ElementStrMap* getStrMapPtr() const;
+
+	ArrayElement* getStrMapElement(const char* key) const;
+	ArrayElement* emplaceStrMapElement(const char* key);
+};
+
+typedef ArrayVarElementContainer::iterator ArrayIterator;
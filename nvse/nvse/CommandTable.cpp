@@ -34,6 +34,8 @@
 #include "Commands_String.h"
 #include "Commands_Algohol.h"
 #include "Commands_Quest.h"
+#include "FormListIndex.h"
+#include "RefSpatialIndex.h"
 
 CommandTable g_consoleCommands;
 CommandTable g_scriptCommands;
@@ -2309,6 +2311,22 @@ void CommandTable::AddCommandsV6()
 	// 6.4 beta 09
 	ADD_CMD(ListGetSaveBakedObjectCount);
 	ADD_CMD(GetNumLevSaveBakedItems);
+	ADD_CMD_RET(V3NormalizeBatch, kRetnType_Array);
+	ADD_CMD_RET(V3CrossproductBatch, kRetnType_Array);
+	ADD_CMD_RET(QMultQuatVector3Batch, kRetnType_Array);
+	ADD_CMD_RET(QInterpolateBatch, kRetnType_Array);
+	ADD_CMD_RET(QFromEulerBatch, kRetnType_Array);
+	ADD_CMD_RET(QToEulerBatch, kRetnType_Array);
+	ADD_CMD(StartScriptProfiler);
+	ADD_CMD(StopScriptProfiler);
+	ADD_CMD(DumpScriptProfile);
+
+#ifdef RUNTIME
+	// invalidate GetRefs' spatial grids when vanilla commands move refs
+	RefSpatialIndex::HookMoveCommands();
+	// invalidate ListGetFormIndex/IsRefInList indices when vanilla AddFormToFormList edits a list
+	FormListIndex::HookListCommands();
+#endif
 }
 
 namespace PluginAPI
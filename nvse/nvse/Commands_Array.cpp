@@ -834,7 +834,7 @@ ArrayVar* ElementToIterator(Script* script, ArrayIterator& iter)
 	auto* arr = g_ArrayMap.Create(kDataType_String, false, script->GetModIndex());
 	const auto* key = iter.first();
 	if (key->KeyType() == kDataType_String)
-		arr->SetElementString("key", key->key.str);
+		arr->SetElementString("key", key->key.GetStr());
 	else
 		arr->SetElementNumber("key", key->key.num);
 	arr->SetElement("value", iter.second());
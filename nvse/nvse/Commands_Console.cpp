@@ -3,6 +3,7 @@
 #include "GameForms.h"
 #include "GameScript.h"
 #include "StringVar.h"
+#include "ScriptProfiler.h"
 
 bool Cmd_PrintToConsole_Execute(COMMAND_ARGS)
 {
@@ -138,3 +139,39 @@ bool Cmd_GetConsoleOutputFilename_Execute(COMMAND_ARGS)
 	return true;
 }
 
+
+bool Cmd_StartScriptProfiler_Execute(COMMAND_ARGS)
+{
+	*result = 0;
+	ScriptProfiler::Start();
+	if (IsConsoleMode())
+		Console_Print("Script profiler started");
+	return true;
+}
+
+bool Cmd_StopScriptProfiler_Execute(COMMAND_ARGS)
+{
+	*result = 0;
+	ScriptProfiler::Stop();
+	if (IsConsoleMode())
+		Console_Print("Script profiler stopped");
+	return true;
+}
+
+bool Cmd_DumpScriptProfile_Execute(COMMAND_ARGS)
+{
+	*result = 0;
+	char name[0x100]{};
+	if (!ExtractArgs(EXTRACT_ARGS, &name))
+		return true;
+
+	if (ScriptProfiler::Dump(name))
+	{
+		*result = 1;
+		if (IsConsoleMode())
+			Console_Print("Dumped script profile to ScriptProfiles/%s", name[0] ? name : "profile");
+	}
+	else if (IsConsoleMode())
+		Console_Print("DumpScriptProfile >> Failed to write the profile");
+	return true;
+}
@@ -14,3 +14,7 @@ DEFINE_CMD_ALT(GetConsoleEcho, , returns whether the engine echoes to the consol
 
 DEFINE_CMD_ALT(HasConsoleOutputFilename, HasCOF, "return if there is a Console Output Filename active", 0, 0, NULL);
 DEFINE_CMD_ALT(GetConsoleOutputFilename, GetCOF, "returns the name of the Console Output Filename", 0, 0, NULL);
+
+DEFINE_COMMAND(StartScriptProfiler, clears recorded script timings and starts recording, 0, 0, NULL);
+DEFINE_COMMAND(StopScriptProfiler, stops recording script timings, 0, 0, NULL);
+DEFINE_COMMAND(DumpScriptProfile, writes recorded script timings to ScriptProfiles/<name>.folded and .txt, 0, 1, kParams_OneOptionalString);
@@ -1,5 +1,6 @@
 #include "Commands_List.h"
 
+#include "FormListIndex.h"
 #include "FunctionScripts.h"
 #include "GameForms.h"
 #include "GameRTTI.h"
@@ -102,6 +103,7 @@ bool Cmd_ListAddForm_Execute(COMMAND_ARGS)
 	ExtractArgsEx(EXTRACT_ARGS_EX, &pListForm, &pForm, &n, &bCheckForDupes);
 	if (pListForm && pForm) {
 		auto const index = pListForm->AddAtTemp(pForm, n, bCheckForDupes);
+		FormListIndex::MarkDirty(pListForm);
 		*result = index;
 		if (IsConsoleMode()) {
 			Console_Print("Index: %d", index);
@@ -133,6 +135,7 @@ bool Cmd_ListAddReference_Execute(COMMAND_ARGS)
 		if (!pListForm || !thisObj) return true;
 
 		auto const index = pListForm->AddAtTemp(thisObj, n, bCheckForDupes);
+		FormListIndex::MarkDirty(pListForm);
 		*result = index;
 		if (IsConsoleMode()) {
 			Console_Print("Index: %d", index);
@@ -164,6 +167,7 @@ bool Cmd_ListRemoveNthForm_Execute(COMMAND_ARGS)
 	if (ExtractArgs(EXTRACT_ARGS, &pListForm, &n)) {
 		if (pListForm) {
 			TESForm* pRemoved = pListForm->RemoveNthForm(n);
+			FormListIndex::MarkDirty(pListForm);
 			if (pRemoved) {
 				*refResult = pRemoved->refID;
 			}
@@ -196,6 +200,7 @@ bool Cmd_ListReplaceNthForm_Execute(COMMAND_ARGS)
 	if (ExtractArgs(EXTRACT_ARGS, &pListForm, &pReplaceWith, &n)) {
 		if (pListForm && pReplaceWith) {
 			TESForm* pReplaced = pListForm->ReplaceNthForm(n, pReplaceWith);
+			FormListIndex::MarkDirty(pListForm);
 			if (pReplaced) {
 				*refResult = pReplaced->refID;
 			}
@@ -225,6 +230,7 @@ bool Cmd_ListRemoveForm_Execute(COMMAND_ARGS)
 	ExtractArgsEx(EXTRACT_ARGS_EX, &pListForm, &pForm);
 	if (pListForm && pForm) {
 		SInt32 index = pListForm->RemoveForm(pForm);
+		FormListIndex::MarkDirty(pListForm);
 		*result = index;
 	}
 
@@ -252,6 +258,7 @@ bool Cmd_ListReplaceForm_Execute(COMMAND_ARGS)
 	ExtractArgsEx(EXTRACT_ARGS_EX, &pListForm, &pReplaceWith, &pForm);
 	if (pListForm && pForm && pReplaceWith) {
 		SInt32 index = pListForm->ReplaceForm(pForm, pReplaceWith);
+		FormListIndex::MarkDirty(pListForm);
 		*result = index;
 	}
 #if REPORT_BAD_FORMLISTS
@@ -275,6 +282,7 @@ bool Cmd_ListClear_Execute(COMMAND_ARGS)
 	if (ExtractArgs(EXTRACT_ARGS, &pListForm)) {
 		pListForm->list.RemoveAll();
 		pListForm->numAddedObjects = 0;
+		FormListIndex::MarkDirty(pListForm);
 	}
 #if REPORT_BAD_FORMLISTS
 	} __except(EXCEPTION_EXECUTE_HANDLER)
@@ -298,7 +306,7 @@ bool Cmd_ListGetFormIndex_Eval(COMMAND_ARGS_EVAL)
 	if (arg1 && arg2) {
 		pListForm = (BGSListForm*)arg1;
 		pForm = (TESForm*)arg2;
-		SInt32 index = pListForm->GetIndexOf(pForm); 
+		SInt32 index = FormListIndex::GetIndexOf(pListForm, pForm);
 		*result = index;
 		if (IsConsoleMode()) {
 			Console_Print("Index: %d", index);
@@ -351,20 +359,20 @@ bool Cmd_IsRefInList_Eval(COMMAND_ARGS_EVAL)
 		if (arg2) {
 			auto* pForm = static_cast<TESForm*>(arg2);
 			TESObjectREFR* pObj = DYNAMIC_CAST(pForm, TESForm, TESObjectREFR);
-			index = pListForm->GetIndexOf(pForm);
+			index = FormListIndex::GetIndexOf(pListForm, pForm);
 			if (index < 0 && pObj) {
 
-				index = pListForm->GetIndexOf(GetPermanentBaseForm(pObj));
+				index = FormListIndex::GetIndexOf(pListForm, GetPermanentBaseForm(pObj));
 				if (index < 0 && pObj) {
-					index = pListForm->GetIndexOf(pObj->baseForm);
+					index = FormListIndex::GetIndexOf(pListForm, pObj->baseForm);
 				}
 
 			}
 		}
 		else if (thisObj) {
-			index = pListForm->GetIndexOf(GetPermanentBaseForm(thisObj));
+			index = FormListIndex::GetIndexOf(pListForm, GetPermanentBaseForm(thisObj));
 			if (index < 0) {
-				index = pListForm->GetIndexOf(thisObj->baseForm);
+				index = FormListIndex::GetIndexOf(pListForm, thisObj->baseForm);
 			}
 		}
 
@@ -12,6 +12,8 @@
 #include "GameProcess.h"
 #include "ArrayVar.h"
 #include "InventoryReference.h"
+#include "FormListIndex.h"
+#include "RefSpatialIndex.h"
 
 bool Cmd_GetBaseObject_Execute(COMMAND_ARGS)
 {
@@ -742,6 +744,27 @@ bool Cmd_GetNextRef_Execute(COMMAND_ARGS)
 	return true;
 }
 
+// Calls func on the refs of cell that GetRefs/GetNumRefs should test, in objectList order.
+// With a distance filter, only refs from grid buckets near distanceRef are visited (see RefSpatialIndex).
+template <typename F>
+static void ForEachCellRefToMatch(const TESObjectCELL* cell, const TESObjectREFR* distanceRef, float maxDistance, F&& func)
+{
+	if (distanceRef && maxDistance > 0)
+	{
+		thread_local Vector<TESObjectREFR*> s_candidates;
+		s_candidates.Clear();
+		if (RefSpatialIndex::GatherCandidates(cell, distanceRef, maxDistance, s_candidates))
+		{
+			for (TESObjectREFR* const refr : s_candidates)
+				func(refr);
+			return;
+		}
+	}
+	for (auto iter = cell->objectList.Begin(); !iter.End(); ++iter)
+		if (TESObjectREFR* const refr = iter.Get())
+			func(refr);
+}
+
 static bool GetNumRefs_Execute(COMMAND_ARGS, bool bUsePlayerCell = true)
 {
 	*result = 0;
@@ -789,22 +812,23 @@ static bool GetNumRefs_Execute(COMMAND_ARGS, bool bUsePlayerCell = true)
 
 	while (info.curCell)
 	{
-		const TESObjectCELL::RefList& refList = info.curCell->objectList;
-		
-		switch (formType)
+		ForEachCellRefToMatch(info.curCell, thisObj, maxDistance, [&](TESObjectREFR* const pRefr)
 		{
-		case kFormTypeFilter_AnyType:
-			*result += refList.CountIf(anyFormMatcher);
-			break;
-		case kFormTypeFilter_Actor:
-			*result += refList.CountIf(actorMatcher);
-			break;
-		case kFormTypeFilter_InventoryItem:
-			*result += refList.CountIf(itemMatcher);
-			break;
-		default:
-			*result += refList.CountIf(formTypeMatcher);
-		}
+			switch (formType)
+			{
+			case kFormTypeFilter_AnyType:
+				*result += anyFormMatcher.Accept(pRefr);
+				break;
+			case kFormTypeFilter_Actor:
+				*result += actorMatcher.Accept(pRefr);
+				break;
+			case kFormTypeFilter_InventoryItem:
+				*result += itemMatcher.Accept(pRefr);
+				break;
+			default:
+				*result += formTypeMatcher.Accept(pRefr);
+			}
+		});
 		info.NextCell();
 	}
 
@@ -871,43 +895,39 @@ bool GetRefs_Execute(COMMAND_ARGS, bool bUsePlayerCell = true)
 
 	while (info.curCell)
 	{
-		const TESObjectCELL::RefList& refList = info.curCell->objectList;
-		for (TESObjectCELL::RefList::Iterator iter = refList.Begin(); !iter.End(); ++iter)
+		ForEachCellRefToMatch(info.curCell, thisObj, maxDistance, [&](TESObjectREFR* const pRefr)
 		{
-			if (TESObjectREFR* const pRefr = iter.Get())
+			switch (formType)
 			{
-				switch (formType)
+			case kFormTypeFilter_AnyType:
+				if (anyFormMatcher.Accept(pRefr))
 				{
-				case kFormTypeFilter_AnyType:
-					if (anyFormMatcher.Accept(pRefr))
-					{
-						arr->SetElementFormID(arrIndex, pRefr->refID);
-						arrIndex += 1;
-					}
-					break;
-				case kFormTypeFilter_Actor:
-					if (actorMatcher.Accept(pRefr))
-					{
-						arr->SetElementFormID(arrIndex, pRefr->refID);
-						arrIndex += 1;
-					}
-					break;
-				case kFormTypeFilter_InventoryItem:
-					if (itemMatcher.Accept(pRefr))
-					{
-						arr->SetElementFormID(arrIndex, pRefr->refID);
-						arrIndex += 1;
-					}
-					break;
-				default:
-					if (formTypeMatcher.Accept(pRefr))
-					{
-						arr->SetElementFormID(arrIndex, pRefr->refID);
-						arrIndex += 1;
-					}
+					arr->SetElementFormID(arrIndex, pRefr->refID);
+					arrIndex += 1;
+				}
+				break;
+			case kFormTypeFilter_Actor:
+				if (actorMatcher.Accept(pRefr))
+				{
+					arr->SetElementFormID(arrIndex, pRefr->refID);
+					arrIndex += 1;
+				}
+				break;
+			case kFormTypeFilter_InventoryItem:
+				if (itemMatcher.Accept(pRefr))
+				{
+					arr->SetElementFormID(arrIndex, pRefr->refID);
+					arrIndex += 1;
+				}
+				break;
+			default:
+				if (formTypeMatcher.Accept(pRefr))
+				{
+					arr->SetElementFormID(arrIndex, pRefr->refID);
+					arrIndex += 1;
 				}
 			}
-		}
+		});
 		info.NextCell();
 	}
 
@@ -1992,6 +2012,8 @@ bool Cmd_CreateFormList_Execute(COMMAND_ARGS)
 			return true;
 		UInt32* refResult = (UInt32*)result;
 		*refResult = formList->refID;
+		// the new list may reuse the address of a deleted one
+		FormListIndex::MarkDirty(formList);
 
 		auto const numArgs = eval.NumArgs();
 		if (numArgs >= 1)
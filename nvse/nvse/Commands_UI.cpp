@@ -8,7 +8,7 @@
 #include "containers.h"
 #include "GameUI.h"
 #include "GameAPI.h"
-#include "MemoizedMap.h"
+#include "TilePathCache.h"
 #include "common/ICriticalSection.h"
 
 #define	the_DoShowLevelUpMenu	0x00784C80
@@ -22,14 +22,9 @@ enum eUICmdAction {
 	kSetFormattedString,
 };
 
-MemoizedMap<const char*, Tile::Value*> s_memoizedTileValues;
-
 Tile::Value* GetCachedComponentValue(const char* component)
 {
-	return s_memoizedTileValues.Get(component, [](const char* component)
-	{
-		return InterfaceManager::GetMenuComponentValue(component);
-	});
+	return TilePathCache::GetComponentValue(component);
 }
 
 bool GetSetUIValue_Execute(COMMAND_ARGS, eUICmdAction action)
@@ -421,10 +416,7 @@ bool Cmd_ShowLevelUpMenu_Execute(COMMAND_ARGS)
 
 Tile::Value* GetCachedComponentValueAlt(const char* component)
 {
-	return s_memoizedTileValues.Get(component, [](const char* component)
-	{
-		return InterfaceManager::GetMenuComponentValueAlt(component);
-	});
+	return TilePathCache::GetComponentValueAlt(component);
 }
 
 bool Cmd_GetUIFloatAlt_Execute(COMMAND_ARGS)
@@ -20,12 +20,36 @@ Save file format:
 		CROB				// a created base object
 			void * objectData		// recorded by TESForm::SaveForm() in mod file format
 
+Delta cosaves (iDeltaCosaveChain in nvse_config.ini):
+	A full cosave also copies its ARVS to STVE records into a base file next to the saves, and the next
+	iDeltaCosaveChain saves only write the variables changed since then. Each delta depends on the base file alone,
+	not on the saves in between, so any save of the chain loads on its own.
+	VDLT					// first record of a delta cosave
+		UInt64	baseID		// nvse_base_<baseID as 16 hex digits>.nvsb in the save folder
+	MODS
+	ARVX ... ARVE			// see ArrayVar.h
+	STVX ... STVE			// see StringVar.h
+Loading one loads the base file's records right after the mod list, then the changes on top. The chain starts over
+with a full cosave after a load or new game, when a var ID can't be tracked (see ChangedVarIDs) or when the base file
+is gone. A delta whose base file is missing or damaged loads only its own variables, with a warning: every variable
+not changed since the base file was written is lost. That makes the option risky for anyone who moves, prunes or syncs
+save folders without the .nvsb files, so it is off by default.
 
 **************************/					
 
 static ModInfo** s_ModFixupTable = NULL;
 bool LoadModList(NVSESerializationInterface* nvse);	// reads saved mod order, builds table mapping changed mod indexes
 
+UInt32 g_deltaCosaveChain = 0;
+static UInt64 s_deltaBaseID = 0;	// of the base file the next delta cosave is written against, 0 if none
+static UInt32 s_numDeltaSaves = 0;	// written against it
+
+static void ResetDeltaChain()
+{
+	s_deltaBaseID = 0;
+	s_numDeltaSaves = 0;
+}
+
 /*******************************
 *	Callbacks
 *******************************/
@@ -36,6 +60,15 @@ void Core_SaveCallback(void * reserved)
 	ModInfo** mods = dhand->modList.loadedMods;
 	UInt8 modCount = dhand->modList.loadedModCount;
 
+	// a delta is only written against a base file that is still there, otherwise the save is full and starts a new one
+	const bool bDelta = g_deltaCosaveChain && s_deltaBaseID && (s_numDeltaSaves < g_deltaCosaveChain) &&
+		g_ArrayMap.ChangesTracked() && g_StringMap.ChangesTracked() && Serialization::DeltaBaseExists(s_deltaBaseID);
+	if (bDelta)
+	{
+		intfc->OpenRecord('VDLT', 0);
+		intfc->WriteRecordData(&s_deltaBaseID, sizeof(s_deltaBaseID));
+	}
+
 	// save the mod list
 	intfc->OpenRecord('MODS', 0);
 	intfc->WriteRecordData(&modCount, sizeof(modCount));
@@ -52,9 +85,50 @@ void Core_SaveCallback(void * reserved)
 	// prevent arrays from being saved that were supposed to be deleted but are held due to potential future callbacks
 	LambdaManager::ClearSavedDeletedEventLists();
 
+	if (bDelta)
+	{
+		g_ArrayMap.SaveChanges(intfc);
+		g_StringMap.SaveChanges(intfc);
+		s_numDeltaSaves++;
+		return;
+	}
+
+	const UInt32 varsStart = Serialization::GetWriteOffset();
 	g_ArrayMap.Save(intfc);
 	g_StringMap.Save(intfc);
 
+	if (g_deltaCosaveChain)
+	{
+		ResetDeltaChain();
+		s_deltaBaseID = Serialization::SaveDeltaBase(varsStart);
+		if (s_deltaBaseID)
+		{
+			g_ArrayMap.ClearChanged();
+			g_StringMap.ClearChanged();
+		}
+	}
+}
+
+// reads the records of a delta cosave's base file
+static void LoadDeltaBaseVars()
+{
+	NVSESerializationInterface* intfc = &g_NVSESerializationInterface;
+	UInt32 type, version, length;
+
+	while (intfc->GetNextRecordInfo(&type, &version, &length))
+	{
+		switch (type)
+		{
+			case 'STVS':
+				g_StringMap.Load(intfc);
+				break;
+			case 'ARVS':
+				g_ArrayMap.Load(intfc);
+				break;
+			default:
+				break;
+		}
+	}
 }
 
 void Core_LoadCallback(void * reserved)
@@ -69,12 +143,16 @@ void Core_LoadCallback(void * reserved)
 		{
 		case 'STVS':
 		case 'STVR':
+		case 'STVD':
 		case 'STVE':
+		case 'STVX':
 		case 'ARVS':
 		case 'ARVR':
 		case 'ARVE':
+		case 'ARVX':
 		case 'CROB':
 		case 'MODS':
+		case 'VDLT':
 			Serialization::ignoreNextChunk = true;
 			break;		// processed during preload
 		default:
@@ -104,6 +182,7 @@ void Core_NewGameCallback(void * reserved)
 	g_ArrayMap.Clean();
 	g_StringMap.Clean();
 	LambdaManager::ClearSavedDeletedEventLists();
+	ResetDeltaChain();
 }
 
 void Core_PreLoadCallback(void * reserved)
@@ -133,14 +212,26 @@ void Core_PreLoadCallback(void * reserved)
 
 	g_ArrayMap.Reset();
 	g_StringMap.Reset();
+	ResetDeltaChain();
 
 	UInt32 type, version, length;
+	UInt64 deltaBaseID = 0;
 
 	while (intfc->GetNextRecordInfo(&type, &version, &length)) {
 		switch (type) {
+			case 'VDLT':
+				intfc->ReadRecordData(&deltaBaseID, sizeof(deltaBaseID));
+				break;
 			case 'MODS':
 				if (!LoadModList(intfc))
 					_MESSAGE("PRELOAD: Error occurred while loading mod list");
+				// the base file was written in the same session as the delta, with the same mod list. Without it the
+				// delta loads as a full cosave holding only the variables it has, over nothing left from a partial read
+				if (deltaBaseID && !Serialization::LoadDeltaBase(deltaBaseID, LoadDeltaBaseVars))
+				{
+					g_ArrayMap.Reset();
+					g_StringMap.Reset();
+				}
 				break;
 #ifdef _DEBUG
 			case 'CROB':
@@ -153,6 +244,12 @@ void Core_PreLoadCallback(void * reserved)
 			case 'ARVS':
 				g_ArrayMap.Load(intfc);
 				break;
+			case 'STVX':
+				g_StringMap.LoadChanges(intfc);
+				break;
+			case 'ARVX':
+				g_ArrayMap.LoadChanges(intfc);
+				break;
 			default:
 				break;
 		}
@@ -3,6 +3,7 @@
 extern UInt8 s_preloadModRefIDs[0xFF];
 extern UInt8 s_numPreloadMods;
 extern std::vector<std::string> g_modsLoaded;
+extern UInt32 g_deltaCosaveChain;	// from iDeltaCosaveChain in nvse_config.ini, 0 writes full cosaves only
 
 UInt8 ResolveModIndexForPreload(UInt8 modIndexIn);
 void Init_CoreSerialization_Callbacks();
@@ -747,6 +747,7 @@ std::unique_ptr<ScriptToken> EventCallback::Invoke(EventInfo &eventInfo, const C
 
 				// handle immediately
 				s_eventStack.Push(eventInfo.evName);
+				ScriptProfiler::Scope profilerScope(ScriptProfiler::kFrame_Event, (UInt32)eventInfo.evName);
 				auto ret = UserFunctionManager::Call(ClassicEventHandlerCaller(script.Get(), argTypes, arg0, arg1));
 				s_eventStack.Pop();
 				return ret;
@@ -14,6 +14,7 @@
 
 #include "FunctionScripts.h"
 #include "Hooks_Gameplay.h"
+#include "ScriptProfiler.h"
 #include <stdexcept>
 #include <array>
 
@@ -923,6 +924,7 @@ namespace EventManager
 
 		// handle immediately
 		s_eventStack.Push(eventInfo.evName);
+		ScriptProfiler::Scope profilerScope(ScriptProfiler::kFrame_Event, (UInt32)eventInfo.evName);
 
 		for (auto& [priority, callback] : eventInfo.callbacks)
 		{
@@ -0,0 +1,96 @@
+#include "ExtractArgsPlan.h"
+
+#include <atomic>
+
+struct ExtractArgsPlanScope::Plan
+{
+	static constexpr UInt32 kMaxRefs = 8;
+
+	struct RefLookup
+	{
+		UInt32				refIdx;
+		Script::RefVariable	*refVar;
+	};
+
+	Script				*script;
+	UInt32				refID;
+	void				*data;
+	UInt32				dataLength;
+	UInt32				numRefs;
+	const void			*refListHead;	// first node after m_listHead
+	Script::RefVariable	*firstRef;
+	const ParamInfo		*paramInfo;
+	UInt32				generation;
+	CommandInfo			*command;
+	UInt32				numLookups;
+	RefLookup			lookups[kMaxRefs];
+
+	bool Matches(const Script *scriptObj, const ParamInfo *params, UInt32 currGeneration) const
+	{
+		return (script == scriptObj) && (paramInfo == params) && (generation == currGeneration) && (refID == scriptObj->refID) &&
+			(data == scriptObj->data) && (dataLength == scriptObj->info.dataLength) && (numRefs == scriptObj->info.numRefs) &&
+			(refListHead == scriptObj->refList.m_listHead.next) && (firstRef == scriptObj->refList.m_listHead.data);
+	}
+};
+
+namespace
+{
+	constexpr UInt32 kMaxExtractArgsPlans = 0x2000;	// call sites of scripts that were since unloaded are never erased
+
+	std::atomic<UInt32> s_planGeneration = 1;
+}
+
+void ExtractArgsPlanScope::Begin(const ParamInfo* paramInfo, const UInt8* args, Script* scriptObj, UInt32 opcode)
+{
+	thread_local UnorderedMap<const UInt8*, Plan> s_plans;
+
+	// expressions below may extract the arguments of other call sites, the outer call's plan is put back at the end
+	Suspend();
+	if (!s_plannedDepth && (s_plans.Size() >= kMaxExtractArgsPlans))
+		s_plans.Clear();
+	const UInt32 generation = s_planGeneration.load(std::memory_order_relaxed);
+	Plan *plan;
+	if (s_plans.Insert(args, &plan) || !plan->Matches(scriptObj, paramInfo, generation))
+	{
+		*plan = Plan{scriptObj, scriptObj->refID, scriptObj->data, scriptObj->info.dataLength, scriptObj->info.numRefs,
+			scriptObj->refList.m_listHead.next, scriptObj->refList.m_listHead.data, paramInfo, generation,
+			g_scriptCommands.GetByOpcode(opcode), 0};
+		s_state.recording = true;
+	}
+	s_state.plan = plan;
+	m_command = plan->command;
+	m_planned = true;
+	s_plannedDepth++;
+}
+
+// A call without a plan made while a planned one is in progress must neither record into nor replay the outer plan.
+void ExtractArgsPlanScope::Suspend()
+{
+	m_outer = s_state;
+	m_restoreOuter = true;
+	s_state = State();
+}
+
+Script::RefVariable* ExtractArgsPlanScope::GetPlannedRef(Script* scriptObj, UInt32 refIdx)
+{
+	State &state = s_state;
+	Plan *plan = state.plan;
+	if (plan->script != scriptObj)
+		return scriptObj->GetRefFromRefList(refIdx);
+	if (state.recording)
+	{
+		Script::RefVariable *refVar = scriptObj->GetRefFromRefList(refIdx);
+		if (plan->numLookups < Plan::kMaxRefs)
+			plan->lookups[plan->numLookups++] = {refIdx, refVar};
+		return refVar;
+	}
+	if ((state.nextLookup < plan->numLookups) && (plan->lookups[state.nextLookup].refIdx == refIdx))
+		return plan->lookups[state.nextLookup++].refVar;
+	return scriptObj->GetRefFromRefList(refIdx);
+}
+
+void ExtractArgsPlanScope::Invalidate(const Script* script)
+{
+	if (script && script->refID && !script->IsTemporary())
+		s_planGeneration.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "CommandTable.h"
+#include "GameScript.h"
+
+// Ref list lookups made while extracting the arguments of one call site. Script::GetRefFromRefList walks the list, so
+// a command reading a ref from far down a quest script's list pays for every entry in front of it each time the line
+// runs. The first run of a call site records the index and RefVariable of each lookup, later runs are handed them back
+// in the same order, and the command being executed is kept with them. Expressions, strings and variable values are
+// still read from the bytecode and event lists on every run; only what depends on the bytecode alone is kept.
+// Plans are made for scripts with a form ID that are not temporary, have a long ref list and whose bytecode is the one
+// being read. Compiling any such script drops every plan on every thread (Invalidate bumps one global generation), so
+// each compile costs a re-recording of all call sites; the ref list head and counts they were made from are also
+// compared on every use.
+class ExtractArgsPlanScope
+{
+	struct Plan;
+
+	struct State
+	{
+		Plan	*plan;
+		UInt32	nextLookup;
+		bool	recording;
+	};
+
+	static inline thread_local State s_state = {};			// of the planned vExtractArgsEx call in progress on this thread
+	static inline thread_local UInt32 s_plannedDepth = 0;	// planned calls in progress, which hold pointers into the plan map
+
+	CommandInfo	*m_command;
+	State		m_outer;
+	bool		m_restoreOuter = false;
+	bool		m_planned = false;
+
+	void Begin(const ParamInfo* paramInfo, const UInt8* args, Script* scriptObj, UInt32 opcode);
+	void Suspend();
+
+	static Script::RefVariable* GetPlannedRef(Script* scriptObj, UInt32 refIdx);
+
+public:
+	static constexpr UInt32 kMinPlannedRefs = 32;	// finding the plan costs about as much as walking a list this long
+
+	// Set up around the extraction of the argument list starting at args, read from scriptDataIn, for the command with
+	// opcode. Calls that don't get a plan only look the command up, unless made from an expression of a planned call.
+	ExtractArgsPlanScope(const ParamInfo* paramInfo, const void* scriptDataIn, const UInt8* args, Script* scriptObj, UInt32 opcode)
+	{
+		if (scriptObj && (scriptObj->info.numRefs >= kMinPlannedRefs) && (scriptDataIn == scriptObj->data) && scriptObj->refID &&
+			!scriptObj->IsTemporary())
+			Begin(paramInfo, args, scriptObj, opcode);
+		else
+		{
+			m_command = g_scriptCommands.GetByOpcode(opcode);
+			if (s_state.plan)
+				Suspend();
+		}
+	}
+
+	~ExtractArgsPlanScope()
+	{
+		if (m_planned)
+			s_plannedDepth--;
+		if (m_restoreOuter)
+			s_state = m_outer;
+	}
+
+	CommandInfo* Command() const {return m_command;}
+
+	// Same result as scriptObj->GetRefFromRefList(refIdx); lookups for another script, or out of the recorded order,
+	// go to the list.
+	static Script::RefVariable* GetRef(Script* scriptObj, UInt32 refIdx)
+	{
+		return s_state.plan ? GetPlannedRef(scriptObj, refIdx) : scriptObj->GetRefFromRefList(refIdx);
+	}
+
+	// Called after a script is compiled; drops the plans of all scripts, not only its own, unless it is temporary or has
+	// no form ID.
+	static void Invalidate(const Script* script);
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include "containers.h"
+#include <atomic>
+
+// Per-thread cache of data derived from a form (a cell's reference grid, a form list's index), keyed by the form's
+// address. Invalidate may be called from any thread and costs one atomic increment: forms hash into a table of shared
+// version counters, and an entry is current while its counter and the global epoch still hold the values they had when
+// the entry was last fetched. Forms sharing a counter only cost each other an extra rebuild.
+template <typename T_Data, UInt32 kMaxEntries>
+class FormDerivedCache
+{
+	static constexpr UInt32 kNumVersions = 0x400;
+
+	struct Entry
+	{
+		UInt32	epoch = 0;
+		UInt32	version = 0;
+		T_Data	data;
+	};
+
+	static inline std::atomic<UInt32> s_epoch = 1;
+	static inline std::atomic<UInt32> s_versions[kNumVersions] = {};
+	static inline thread_local UnorderedMap<const void*, Entry> s_entries;
+
+	static std::atomic<UInt32>& VersionOf(const void* form) {return s_versions[HashKey<const void*>(form) & (kNumVersions - 1)];}
+
+public:
+	// Returns the calling thread's data for form, setting isCurrent to false if it is new or was invalidated since the
+	// last Get. The entry counts as current again once this returns, so the caller must bring the data up to date.
+	static T_Data& Get(const void* form, bool& isCurrent)
+	{
+		Entry* entry;
+		if (s_entries.Insert(form, &entry) && s_entries.Size() > kMaxEntries)
+		{
+			// forms come and go as the player travels; start over rather than tracking which ones were unloaded
+			s_entries.Clear();
+			s_entries.Insert(form, &entry);
+		}
+		// read before the caller rebuilds, so an invalidation made during the rebuild is still seen by the next Get
+		const UInt32 epoch = s_epoch.load(std::memory_order_acquire), version = VersionOf(form).load(std::memory_order_acquire);
+		isCurrent = entry->epoch == epoch && entry->version == version;
+		entry->epoch = epoch;
+		entry->version = version;
+		return entry->data;
+	}
+
+	static void Invalidate(const void* form) {VersionOf(form).fetch_add(1, std::memory_order_acq_rel);}
+
+	// For loads and new games, where any form may have changed or been freed.
+	static void InvalidateAll() {s_epoch.fetch_add(1, std::memory_order_acq_rel);}
+};
@@ -2,6 +2,11 @@
 #include <shared_mutex>
 #include <ranges>
 #include "SafeWrite.h"
+#if RUNTIME
+#include "FormListIndex.h"
+#include "RefSpatialIndex.h"
+#include "GameObjects.h"
+#endif
 
 namespace 
 {
@@ -123,6 +128,14 @@ bool __fastcall RemoveFromAllFormsMapHook(TESForm* form)
 	{
 		g_formExtraDataMap.erase(iter);
 	}
+#if RUNTIME
+	// a list created later may reuse the address
+	if (form->typeID == kFormType_BGSListForm)
+		FormListIndex::MarkDirty(static_cast<BGSListForm*>(form));
+	// grids hold fixed refs by address; actors and projectiles are looked up by refID, so their deletion needs nothing
+	else if (form->typeID == kFormType_TESObjectREFR)
+		RefSpatialIndex::MarkRefDirty(static_cast<TESObjectREFR*>(form));
+#endif
 	return ThisStdCall<bool>(g_removeFromAllFormMapsAddr, form);
 }
 
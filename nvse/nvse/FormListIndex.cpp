@@ -0,0 +1,110 @@
+#include "FormListIndex.h"
+
+#include "CommandTable.h"
+#include "GameAPI.h"
+#include "GameForms.h"
+
+void FormListIndex::ListIndex::Build(const BGSListForm* list)
+{
+	firstIndex.Clear();
+	forms.Clear();
+	built = true;
+	tooShort = list->Count() < kMinFormsToIndex;
+	if (tooShort)
+		return;
+
+	// walk the list exactly as GetIndexOf does so positions of null entries are counted the same way
+	SInt32 index = 0;
+	SInt32* slot;
+	for (const auto& elem : list->list)
+	{
+		if (elem && firstIndex.Insert(elem->refID, &slot))
+			*slot = index;
+		forms.Append(elem);
+		index++;
+	}
+}
+
+bool FormListIndex::ListIndex::Matches(const BGSListForm* list, SInt32 last) const
+{
+	const UInt32 numToCheck = (last >= 0) ? (last + 1) : forms.Size();
+	UInt32 pos = 0;
+	for (const auto& elem : list->list)
+	{
+		// a longer list only matters to a miss
+		if (pos == numToCheck)
+			return last >= 0;
+		if (elem != forms[pos])
+			return false;
+		pos++;
+	}
+	return pos == numToCheck;
+}
+
+SInt32 FormListIndex::GetIndexOf(const BGSListForm* list, const TESForm* form)
+{
+	if (!form)
+		return eListInvalid;
+
+	bool isCurrent;
+	ListIndex* listIndex = &Cache::Get(list, isCurrent);
+	if (!isCurrent)
+	{
+		listIndex->numQueries = 0;
+		listIndex->built = false;
+	}
+
+	// the first query since the last change walks the list; building only pays off from the second one on
+	if (!listIndex->built && ++listIndex->numQueries > 1)
+		listIndex->Build(list);
+	if (!listIndex->built || listIndex->tooShort)
+		return list->GetIndexOf(form);
+
+	const SInt32* index = listIndex->firstIndex.GetPtr(form->refID);
+	if (listIndex->Matches(list, index ? *index : eListInvalid))
+		return index ? *index : eListInvalid;
+
+	// edited without MarkDirty: reindex the list as it is now
+	listIndex->Build(list);
+	if (listIndex->tooShort)
+		return list->GetIndexOf(form);
+	index = listIndex->firstIndex.GetPtr(form->refID);
+	return index ? *index : eListInvalid;
+}
+
+void FormListIndex::MarkDirty(const BGSListForm* list)
+{
+	Cache::Invalidate(list);
+}
+
+void FormListIndex::MarkAllDirty()
+{
+	Cache::InvalidateAll();
+}
+
+namespace
+{
+	Cmd_Execute s_addFormToFormListExecute;
+
+	bool Cmd_AddFormToFormList_Hooked_Execute(COMMAND_ARGS)
+	{
+		// read the list from a copy of the offset, the vanilla command still extracts its own arguments
+		UInt32 offset = *opcodeOffsetPtr;
+		BGSListForm* list = nullptr;
+		TESForm* form = nullptr;
+		const bool hasList = ExtractArgsEx(paramInfo, scriptData, &offset, scriptObj, eventList, &list, &form) && list;
+		const bool retn = s_addFormToFormListExecute(PASS_COMMAND_ARGS);
+		if (hasList)
+			FormListIndex::MarkDirty(list);
+		return retn;
+	}
+}
+
+void FormListIndex::HookListCommands()
+{
+	CommandInfo* cmd = g_scriptCommands.GetByName("AddFormToFormList");
+	if (!cmd || !cmd->execute)
+		return;
+	s_addFormToFormListExecute = cmd->execute;
+	cmd->execute = Cmd_AddFormToFormList_Hooked_Execute;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "FormDerivedCache.h"
+
+class BGSListForm;
+class TESForm;
+
+// Lazily built refID -> index table per form list, used by ListGetFormIndex/IsRefInList instead of walking the list.
+// A list is only indexed on its second query since it last changed, so a single lookup never pays for a build.
+// The list commands, CreateFormList and the vanilla AddFormToFormList invalidate the list they edit. Edits made any
+// other way (GenericAddForm and friends, plugins writing to list->list) are caught by checking every answer against
+// the entries the index was built from, up to the answer for a hit and the whole list for a miss; the check follows
+// the list's nodes without reading the forms, which is what saves time over GetIndexOf. Results always match
+// BGSListForm::GetIndexOf.
+class FormListIndex
+{
+public:
+	static constexpr UInt32 kMinFormsToIndex = 16;	// shorter lists are cheaper to walk
+	static constexpr UInt32 kMaxCachedLists = 0x100;
+
+	// Same result as list->GetIndexOf(form); eListInvalid if form is null.
+	static SInt32 GetIndexOf(const BGSListForm* list, const TESForm* form);
+
+	// Drops the index of list on every thread.
+	static void MarkDirty(const BGSListForm* list);
+
+	// Drops every index, for game loads where lists may be freed and their addresses reused.
+	static void MarkAllDirty();
+
+	// Wraps the execute function of vanilla AddFormToFormList so it invalidates the list it adds to.
+	static void HookListCommands();
+
+private:
+	struct ListIndex
+	{
+		UInt32							numQueries = 0;
+		bool							built = false;
+		bool							tooShort = false;
+		UnorderedMap<UInt32, SInt32>	firstIndex;		// refID -> first position in the list
+		Vector<const TESForm*>			forms;			// the list's entries when built, nulls included
+
+		void Build(const BGSListForm* list);
+
+		// True if the list still holds the same entries up to position last, or the same entries exactly if last is
+		// eListInvalid: all that decides GetIndexOf's answer.
+		bool Matches(const BGSListForm* list, SInt32 last) const;
+	};
+
+	using Cache = FormDerivedCache<ListIndex, kMaxCachedLists>;
+};
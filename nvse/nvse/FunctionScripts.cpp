@@ -7,12 +7,13 @@
 #include "Hooks_Other.h"
 #include "LambdaManager.h"
 #include "ScriptAnalyzer.h"
+#include "ScriptProfiler.h"
 
 /*******************************************
 	UserFunctionManager
 *******************************************/
 
-UserFunctionManager::UserFunctionManager() : m_nestDepth(0)
+UserFunctionManager::UserFunctionManager() : m_nestDepth(0), m_lastScript(nullptr), m_lastInfo(nullptr)
 {
 	//
 }
@@ -156,7 +157,7 @@ public:
 			}
 
 			ScriptLocal* resolvedLocal; // could stay invalid if it's a stack variable, that's fine.
-			if (!param->ResolveVariable(eventList, resolvedLocal)) [[unlikely]]
+			if (!info->ResolveParam(i, eventList, resolvedLocal)) [[unlikely]]
 			{
 				ShowRuntimeError(info->GetScript(), "Could not look up argument variable for function script");
 				return false;
@@ -237,6 +238,8 @@ std::unique_ptr<ScriptToken> UserFunctionManager::Call(FunctionCaller&& caller)
 	if (!funcScript->data)
 		return nullptr;
 
+	ScriptProfiler::Scope profilerScope(ScriptProfiler::kFrame_Function, funcScript->refID);
+
 	// get function info for script
 	FunctionInfo* info = funcMan->GetFunctionInfo(funcScript);
 	if (!info)
@@ -287,8 +290,13 @@ bool UserFunctionManager::Return(ExpressionEvaluator* eval)
 
 FunctionInfo* UserFunctionManager::GetFunctionInfo(Script* funcScript)
 {
-	FunctionInfo* funcInfo = m_functionInfos.Emplace(funcScript, funcScript);
-	return (funcInfo->IsGood()) ? funcInfo : nullptr;
+	// entries are only ever removed all at once, by ClearInfos
+	if (funcScript != m_lastScript)
+	{
+		m_lastInfo = m_functionInfos.Emplace(funcScript, funcScript);
+		m_lastScript = funcScript;
+	}
+	return (m_lastInfo->IsGood()) ? m_lastInfo : nullptr;
 }
 
 UInt32 UserFunctionManager::GetFunctionParamTypes(Script* fnScript, UInt8* typesOut)
@@ -311,7 +319,10 @@ Script* UserFunctionManager::GetInvokingScript(Script* fnScript)
 
 void UserFunctionManager::ClearInfos()
 {
-	GetSingleton()->m_functionInfos.Clear();
+	UserFunctionManager* funcMan = GetSingleton();
+	funcMan->m_functionInfos.Clear();
+	funcMan->m_lastScript = nullptr;
+	funcMan->m_lastInfo = nullptr;
 }
 
 /*****************************
@@ -403,6 +414,7 @@ FunctionInfo::FunctionInfo(Script* script)
 
 	m_dParamInfo = DynamicParamInfo(params);
 	m_userFunctionParams = std::move(params);
+	m_paramLocals.resize(numParams, nullptr);
 
 	if (!m_isLambda)
 	{
@@ -456,6 +468,21 @@ UserFunctionParam* FunctionInfo::GetParam(UInt32 paramIndex)
 	return &m_userFunctionParams[paramIndex];
 }
 
+bool FunctionInfo::ResolveParam(UInt32 paramIndex, ScriptEventList* eventList, ScriptLocal*& out_resolvedLocal)
+{
+	UserFunctionParam* param = GetParam(paramIndex);
+	if (!param) [[unlikely]]
+		return false;
+	// the cached event list keeps its variables between calls, only their values are reset
+	if (!eventList || (eventList != m_eventList))
+		return param->ResolveVariable(eventList, out_resolvedLocal);
+	ScriptLocal*& local = m_paramLocals[paramIndex];
+	if (!local && !param->ResolveVariable(eventList, local)) [[unlikely]]
+		return false;
+	out_resolvedLocal = local;
+	return true;
+}
+
 UInt32 FunctionInfo::GetParamVarTypes(UInt8* out) const
 {
 	const UInt32 count = m_userFunctionParams.size();
@@ -635,7 +662,7 @@ bool InternalFunctionCaller::PopulateArgs(ScriptEventList* eventList, FunctionIn
 		}
 
 		ScriptLocal* resolvedLocal; // could stay invalid if it's a stack variable, that's fine.
-		if (!param->ResolveVariable(eventList, resolvedLocal)) [[unlikely]]
+		if (!info->ResolveParam(i, eventList, resolvedLocal)) [[unlikely]]
 		{
 			ShowRuntimeError(m_script, "Could not look up argument variable for function script");
 			return false;
@@ -736,7 +763,7 @@ bool InternalFunctionCallerAlt::PopulateArgs(ScriptEventList* eventList, Functio
 		}
 
 		ScriptLocal* resolvedLocal; // could stay invalid if it's a stack variable, that's fine.
-		if (!param->ResolveVariable(eventList, resolvedLocal)) [[unlikely]]
+		if (!info->ResolveParam(i, eventList, resolvedLocal)) [[unlikely]]
 		{
 			ShowRuntimeError(m_script, "Could not look up argument variable for function script");
 			return false;
@@ -802,7 +829,7 @@ bool ArrayElementArgFunctionCaller<T>::PopulateArgs(ScriptEventList* eventList,
 		}
 
 		ScriptLocal* resolvedLocal; // could stay invalid if it's a stack variable, that's fine.
-		if (!param->ResolveVariable(eventList, resolvedLocal)) [[unlikely]]
+		if (!info->ResolveParam(i, eventList, resolvedLocal)) [[unlikely]]
 		{
 			ShowRuntimeError(m_script, "Could not look up argument variable for function script");
 			return false;
@@ -41,6 +41,7 @@ struct FunctionInfo
 #endif
 	UInt8* m_singleLineLambdaPosition = nullptr;
 	bool				m_isLambda;
+	std::vector<ScriptLocal*> m_paramLocals;	// params' variables in m_eventList, looked up on first use
 
 	FunctionInfo() = default;
 	FunctionInfo(Script* script);
@@ -53,6 +54,8 @@ struct FunctionInfo
 	ParamInfo* Params() { return m_dParamInfo.Params(); }
 	DynamicParamInfo& ParamInfo() { return m_dParamInfo; }
 	UserFunctionParam* GetParam(UInt32 paramIndex);
+	// same as GetParam(paramIndex)->ResolveVariable, without walking m_eventList's variables again on every call
+	bool ResolveParam(UInt32 paramIndex, ScriptEventList* eventList, ScriptLocal*& out_resolvedLocal);
 	bool Execute(FunctionCaller& caller, FunctionContext* context);
 	[[nodiscard]] ScriptEventList* GetEventList() const { return m_eventList; }
 	UInt32 GetParamVarTypes(UInt8* out) const;	// returns count, if > 0 returns types as array
@@ -97,6 +100,8 @@ class UserFunctionManager
 	UInt32								m_nestDepth;
 	Stack<FunctionContext*>		m_functionStack;
 	UnorderedMap<Script*, FunctionInfo>	m_functionInfos;
+	Script*								m_lastScript;	// last GetFunctionInfo result, for loops and recursion calling one function
+	FunctionInfo*						m_lastInfo;
 
 	// these take a ptr to the function script to check that it matches executing script
 	FunctionContext* Top(Script* funcScript);
@@ -10,10 +10,12 @@
 #include "GameData.h"
 
 #if NVSE_CORE
+#include "ExtractArgsPlan.h"
 #include "ScriptAnalyzer.h"
 #include "Hooks_Script.h"
 #include "ScriptUtils.h"
 #include "Hooks_Other.h"
+#include "ScriptProfiler.h"
 #endif
 
 NiTMap<const char*, TESForm*>** g_formEditorIDsMap = reinterpret_cast<NiTMap<const char*, TESForm*>**>(0x11C54C8);
@@ -1027,7 +1029,7 @@ ScriptLocal *ExtractScriptVar(UInt8 *&scriptData, Script *scriptObj, ScriptEvent
 {
 	if (*scriptData == 'r') //reference to var in another script
 	{
-		Script::RefVariable *refVar = scriptObj->GetRefFromRefList(*(UInt16 *)(scriptData + 1));
+		Script::RefVariable *refVar = ExtractArgsPlanScope::GetRef(scriptObj, *(UInt16 *)(scriptData + 1));
 		if (!refVar)
 			return NULL;
 
@@ -1075,7 +1077,7 @@ static bool ExtractFloat(double *out, UInt8 *&scriptData, Script *scriptObj, Scr
 	}
 	if (*scriptData == 'G')
 	{
-		Script::RefVariable *globalRef = scriptObj->GetRefFromRefList(*(UInt16 *)(scriptData + 1));
+		Script::RefVariable *globalRef = ExtractArgsPlanScope::GetRef(scriptObj, *(UInt16 *)(scriptData + 1));
 		if (globalRef && globalRef->form && IS_ID(globalRef->form, TESGlobal))
 		{
 			*out = ((TESGlobal *)globalRef->form)->data;
@@ -1371,7 +1373,7 @@ static bool v_ExtractArgsEx(UInt32 numArgs, ParamInfo *paramInfo, UInt8 *&script
 			TESForm *form = NULL;
 			if (*scriptData == 'r')
 			{
-				Script::RefVariable *var = scriptObj->GetRefFromRefList(*(UInt16 *)(scriptData + 1));
+				Script::RefVariable *var = ExtractArgsPlanScope::GetRef(scriptObj, *(UInt16 *)(scriptData + 1));
 				if (var)
 				{
 					var->Resolve(eventList);
@@ -1865,12 +1867,19 @@ bool vExtractArgsEx(ParamInfo *paramInfo, void *scriptDataIn, UInt32 *scriptData
 		return false;
 
 	UInt8 *scriptData = (UInt8 *)scriptDataIn + *scriptDataOffset;
+	auto* opcodePtr = reinterpret_cast<UInt16*>(static_cast<UInt8*>(scriptDataIn) + (*scriptDataOffset - 4));
+
+	const ExtractArgsPlanScope planScope(paramInfo, scriptDataIn, scriptData, scriptObj, *opcodePtr);
+	CommandInfo *command = planScope.Command();
+
 	UInt32 numArgs = *(UInt16 *)scriptData;
 	scriptData += 2;
-	auto* opcodePtr = reinterpret_cast<UInt16*>(static_cast<UInt8*>(scriptDataIn) + (*scriptDataOffset - 4));
-	OtherHooks::GetExecutingScriptContext()->command = g_scriptCommands.GetByOpcode(*opcodePtr);
+	auto* scriptContext = OtherHooks::GetExecutingScriptContext();
+	scriptContext->command = command;
+	if (ScriptProfiler::g_enabled)
+		OtherHooks::EnterCommandFrame(*scriptContext, reinterpret_cast<UInt8*>(opcodePtr));
 #if _DEBUG
-	g_lastCommand = g_scriptCommands.GetByOpcode(*opcodePtr);
+	g_lastCommand = command;
 #endif
 
 	//DEBUG_MESSAGE("scriptData:%08x numArgs:%d paramInfo:%08x scriptObj:%08x eventList:%08x", scriptData, numArgs, paramInfo, scriptObj, eventList);
@@ -3,6 +3,7 @@
 #include "GameExtraData.h"
 #include "GameTasks.h"
 #include "GameUI.h"
+#include "InventoryItems.h"
 #include "SafeWrite.h"
 #include "NiObjects.h"
 
@@ -304,39 +305,7 @@ bool TESObjectREFR::GetInventoryItems(InventoryItemsMap &invItems)
 	ExtraContainerChanges::EntryDataList *entryList = (xChanges && xChanges->data) ? xChanges->data->objList : NULL;
 	if (!entryList) return false;
 
-	TESForm *item;
-	SInt32 contCount, countDelta;
-	ExtraContainerChanges::EntryData *entry;
-
-	for (auto contIter = container->formCountList.Begin(); !contIter.End(); ++contIter)
-	{
-		item = contIter->form;
-		if ((item->typeID == kFormType_TESLevItem) || invItems.HasKey(item))
-			continue;
-		contCount = container->GetCountForForm(item);
-		if (entry = entryList->FindForItem(item))
-		{
-			countDelta = entry->countDelta;
-			if (entry->HasExtraLeveledItem())
-				contCount = countDelta;
-			else contCount += countDelta;
-		}
-		if (contCount > 0)
-			invItems.Emplace(item, contCount, entry);
-	}
-
-	for (auto xtraIter = entryList->Begin(); !xtraIter.End(); ++xtraIter)
-	{
-		entry = xtraIter.Get();
-		item = entry->type;
-		if (invItems.HasKey(item))
-			continue;
-		countDelta = entry->countDelta;
-		if (countDelta > 0)
-			invItems.Emplace(item, countDelta, entry);
-	}
-
-	return !invItems.Empty();
+	return GetContainerItems(container, entryList, invItems);
 }
 
 ExtraDroppedItemList* TESObjectREFR::GetDroppedItems()
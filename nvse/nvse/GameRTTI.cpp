@@ -1,7 +1,68 @@
 #include "GameRTTI.h"
 
+#include <atomic>
+#include <climits>
+
 #if RUNTIME
 #include "GameRTTI_1_4_0_525.inc"
 #elif EDITOR
 #include "GameRTTI_EDITOR.inc"
 #endif
+
+namespace
+{
+	// Written under a sequence number like a seqlock: odd while a writer fills the slot, readers that see it change
+	// while reading the key treat the slot as a miss. Writers never wait, a slot already being written is left alone.
+	struct CastSlot
+	{
+		std::atomic<UInt32>			sequence;
+		std::atomic<const void*>	vtable;
+		std::atomic<const void*>	fromType;
+		std::atomic<const void*>	toType;
+		std::atomic<SInt32>			adjustment;		// result - srcObj, kCastFailed if the cast returns NULL
+	};
+
+	constexpr UInt32 kNumCastSlots = 0x400;
+	constexpr SInt32 kCastFailed = INT_MIN;
+
+	CastSlot s_castSlots[kNumCastSlots];
+
+	UInt32 GetCastSlot(const void* vtable, const void* fromType, const void* toType)
+	{
+		// vtables and type descriptors are 4-byte aligned, the low bits carry nothing
+		uintptr_t hash = ((uintptr_t)vtable >> 2) ^ ((uintptr_t)fromType >> 1) ^ ((uintptr_t)toType * 0x9E3779B1U);
+		hash ^= hash >> 13;
+		return (UInt32)hash & (kNumCastSlots - 1);
+	}
+}
+
+void* DynamicCastCache::Cast(void* srcObj, const void* fromType, const void* toType)
+{
+	if (!srcObj)
+		return nullptr;
+	const void *vtable = *(const void**)srcObj;
+	CastSlot &slot = s_castSlots[GetCastSlot(vtable, fromType, toType)];
+
+	UInt32 sequence = slot.sequence.load(std::memory_order_acquire);
+	if (!(sequence & 1) && (slot.vtable.load(std::memory_order_relaxed) == vtable) &&
+		(slot.fromType.load(std::memory_order_relaxed) == fromType) && (slot.toType.load(std::memory_order_relaxed) == toType))
+	{
+		SInt32 adjustment = slot.adjustment.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+			return (adjustment == kCastFailed) ? nullptr : (UInt8*)srcObj + adjustment;
+	}
+
+	void *result = Fallout_DynamicCast(srcObj, 0, fromType, toType, 0);
+	if (!(sequence & 1) && slot.sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_relaxed))
+	{
+		// the odd sequence has to be visible before any of the new fields
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.vtable.store(vtable, std::memory_order_relaxed);
+		slot.fromType.store(fromType, std::memory_order_relaxed);
+		slot.toType.store(toType, std::memory_order_relaxed);
+		slot.adjustment.store(result ? (SInt32)((UInt8*)result - (UInt8*)srcObj) : kCastFailed, std::memory_order_relaxed);
+		slot.sequence.store(sequence + 2, std::memory_order_release);
+	}
+	return result;
+}
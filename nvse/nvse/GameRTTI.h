@@ -3,7 +3,17 @@
 typedef void * (* _Fallout_DynamicCast)(void * srcObj, UInt32 arg1, const void * fromType, const void * toType, UInt32 arg4);
 extern const _Fallout_DynamicCast Fallout_DynamicCast;
 
-#define DYNAMIC_CAST(obj, from, to) ( ## to *) Fallout_DynamicCast((void*)(obj), 0, RTTI_ ## from, RTTI_ ## to, 0)
+// Fallout_DynamicCast with its results kept in a small lock-free table keyed by (vtable of the object, source type,
+// target type). An object's vtable pointer fixes its complete type and where the cast subobject sits in it, so the
+// pointer adjustment found for one object holds for every object with that vtable; the table only stores that adjustment
+// or the failure. Slots are direct mapped and simply overwritten by whichever key hashes to them last.
+class DynamicCastCache
+{
+public:
+	static void* Cast(void* srcObj, const void* fromType, const void* toType);
+};
+
+#define DYNAMIC_CAST(obj, from, to) ( ## to *) DynamicCastCache::Cast((void*)(obj), RTTI_ ## from, RTTI_ ## to)
 
 extern const void * RTTI_BGSDehydrationStage;
 extern const void * RTTI_BGSHungerStage;
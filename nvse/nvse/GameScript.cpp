@@ -502,7 +502,7 @@ public:
 	}
 };
 
-VariableInfo *Script::GetVariableByName(const char *varName)
+static VariableInfo *FindVariableByName(const Script::VarInfoList &varList, const char *varName)
 {
 	const auto *varIter = varList.Head();
 	while (varIter) {
@@ -516,6 +516,90 @@ VariableInfo *Script::GetVariableByName(const char *varName)
 	return NULL;
 }
 
+#if RUNTIME
+
+namespace
+{
+	// Name -> VariableInfo index over a script's varList, built on the first lookup by name. Only scripts with a form ID
+	// that are not temporary are indexed, since a freed script can't be told apart from a new one at the same address
+	// otherwise. The compiler drops a script's index when it is done with it (Script::InvalidateVariableIndex); in case
+	// the list is rebuilt somewhere else, the list head, bytecode and counts it was built from are compared on every use.
+	struct VariableIndex
+	{
+		UInt32										refID;
+		void										*data;
+		UInt32										dataLength;
+		UInt32										varCount;
+		const void									*listHead;	// first node after m_listHead
+		VariableInfo								*firstVar;
+		UnorderedMap<const char*, VariableInfo*>	vars;		// StrHashCI(name) -> first variable with that hash
+
+		bool Matches(const Script *script) const
+		{
+			return (refID == script->refID) && (data == script->data) && (dataLength == script->info.dataLength) &&
+				(varCount == script->info.varCount) && (listHead == script->varList.m_listHead.next) && (firstVar == script->varList.m_listHead.data);
+		}
+	};
+
+	constexpr UInt32 kMinIndexedVariables = 8;	// shorter lists are quicker to walk than to hash the name
+
+	PrimitiveCS s_variableIndexCS;
+	UnorderedMap<Script*, VariableIndex> s_variableIndexes;
+
+	// StrHashCI folds ASCII letters only, names with other bytes are left to StrCompare.
+	bool IsAsciiName(const char *varName)
+	{
+		for (; *varName; varName++)
+			if (*(const UInt8*)varName >= 0x80)
+				return false;
+		return true;
+	}
+
+	void BuildVariableIndex(VariableIndex &index, Script *script)
+	{
+		index.refID = script->refID;
+		index.data = script->data;
+		index.dataLength = script->info.dataLength;
+		index.varCount = script->info.varCount;
+		index.listHead = script->varList.m_listHead.next;
+		index.firstVar = script->varList.m_listHead.data;
+		index.vars.Clear();
+		for (auto iter = script->varList.Begin(); !iter.End(); ++iter)
+		{
+			VariableInfo **pVarInfo;
+			// keep the first of a repeated name, as the list walk finds that one
+			if (*iter && index.vars.Insert(iter->name.m_data, &pVarInfo))
+				*pVarInfo = *iter;
+		}
+	}
+}
+
+void Script::InvalidateVariableIndex()
+{
+	PrimitiveScopedLock lock(s_variableIndexCS);
+	s_variableIndexes.Erase(this);
+}
+
+#endif
+
+VariableInfo *Script::GetVariableByName(const char *varName)
+{
+#if RUNTIME
+	if ((info.varCount >= kMinIndexedVariables) && refID && !IsTemporary() && varName && IsAsciiName(varName))
+	{
+		PrimitiveScopedLock lock(s_variableIndexCS);
+		VariableIndex *index;
+		if (s_variableIndexes.Insert(this, &index) || !index->Matches(this))
+			BuildVariableIndex(*index, this);
+		VariableInfo *varInfo = index->vars.Get(varName);
+		// a miss is final; a hit on a different name is a hash collision, which the list walk settles
+		if (!varInfo || !StrCompare(varName, varInfo->name.m_data))
+			return varInfo;
+	}
+#endif
+	return FindVariableByName(varList, varName);
+}
+
 Script::RefVariable *Script::GetRefFromRefList(UInt32 refIdx)
 {
 	UInt32 idx = 1; // yes, really starts at 1
@@ -121,6 +121,10 @@ public:
 
 	VariableInfo *GetVariableByName(const char *varName);
 	Script::VariableType GetVariableType(VariableInfo *var);
+#if RUNTIME
+	// GetVariableByName keeps a name index for scripts with many variables; call this after varList was rebuilt.
+	void InvalidateVariableIndex();
+#endif
 
 	bool IsUserDefinedFunction() const;
 
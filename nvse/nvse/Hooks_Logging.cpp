@@ -8,6 +8,7 @@
 #include "Hooks_Gameplay.h"
 #include "Hooks_Other.h"
 #include "ScriptAnalyzer.h"
+#include "ScriptTokenCache.h"
 #include "Utilities.h"
 
 #if RUNTIME
@@ -80,19 +81,23 @@ static int ErrorLogHook(const char * fmt, const char * fmt_alt, ...)
 			{
 				const static auto noWarnModules = { "FalloutNV.esm", "DeadMoney.esm", "HonestHearts.esm", "CaravanPack.esm", "OldWorldBlues.esm", "LonesomeRoad.esm", "GunRunnersArsenal.esm", "MercenaryPack.esm", "ClassicPack.esm", "TribalPack.esm" };
 				const auto isOfficial = ra::any_of(noWarnModules, _L(const char* name, _stricmp(name, modName) == 0));
-				if (!isOfficial)
+				UInt32 numSuppressed;
+				// repeats are kept off the console and out of the log, plugins are still sent them
+				if (!isOfficial && !RuntimeErrorThrottle::Register(scriptContext->script, *scriptContext->curDataPtr, numSuppressed))
+					NotifyRuntimeError("%s", buf);
+				else if (!isOfficial)
 				{
 					ScriptParsing::ScriptIterator iter;
 					auto* lineDataStart = scriptContext->script->data + *scriptContext->curDataPtr - 4;
 					const auto defaultIter = _L(,ScriptParsing::ScriptIterator(scriptContext->script, scriptContext->script->data + *scriptContext->curDataPtr - 4));
-					// handles reference functions, no way to know if it's a coincidence that the opcode before it matches it or not so we have to parse the whole script.
+					// handles reference functions, no way to know if it's a coincidence that the opcode before it matches it or not so we have to look up the real line start.
 					if (*reinterpret_cast<UInt16*>(lineDataStart - 4) == static_cast<UInt16>(ScriptParsing::ScriptStatementCode::ReferenceFunction)
 						&& scriptContext->script->GetRefFromRefList(*reinterpret_cast<UInt16*>(lineDataStart - 2)))
 					{
-						ScriptParsing::ScriptAnalyzer analyzer(scriptContext->script);
-						const auto it = ra::find_if(analyzer.lines, _L(auto& line, line->context.refIdx && line->context.startData == lineDataStart + 4));
-						if (it != analyzer.lines.end())
-							iter = it->get()->context;
+						auto& lineIndex = ScriptTokenCacheFormExtraData::Get(scriptContext->script)->lineIndex;
+						const auto line = lineIndex.FindLine(scriptContext->script, *scriptContext->curDataPtr);
+						if (line && line->refIdx && line->dataOffset == *scriptContext->curDataPtr)
+							iter = ScriptLineIndex::GetIterator(scriptContext->script, *line);
 						else
 							iter = defaultIter();
 					}
@@ -105,7 +110,10 @@ static int ErrorLogHook(const char * fmt, const char * fmt_alt, ...)
 						const auto line = ScriptParsing::ScriptAnalyzer::ParseLine(iter);
 						if (line)
 						{
-							ShowRuntimeError(scriptContext->script, "%s\nDecompiled Line: %s", buf, line->ToString().c_str());
+							if (numSuppressed)
+								ShowRuntimeError(scriptContext->script, "%s\nDecompiled Line: %s\n(%u identical error(s) suppressed since last report)", buf, line->ToString().c_str(), numSuppressed);
+							else
+								ShowRuntimeError(scriptContext->script, "%s\nDecompiled Line: %s", buf, line->ToString().c_str());
 						}
 					}
 				}
@@ -10,21 +10,23 @@
 #include "FastStack.h"
 #include "GameTiles.h"
 #include "GameUI.h"
-#include "MemoizedMap.h"
+#include "TilePathCache.h"
+#include "RefSpatialIndex.h"
 #include "StackVariables.h"
+#include "ScriptProfiler.h"
 
 #if RUNTIME
 #include "InventoryReference.h"
 namespace OtherHooks
 {
-	const static auto ClearCachedTileMap = &MemoizedMap<const char*, Tile::Value*>::Clear;
+	const static auto InvalidateTilePaths = &TilePathCache::Invalidate;
 	thread_local FastStack<CurrentScriptContext> g_currentScriptContext;
 
 	__declspec(naked) void TilesDestroyedHook()
 	{
 		__asm
 		{
-			call ClearCachedTileMap // static function
+			call InvalidateTilePaths // static function
 			// original asm
 			pop ecx
 			mov esp, ebp
@@ -38,7 +40,7 @@ namespace OtherHooks
 		// Eddoursol reported a problem where stagnant deleted tiles got cached
 		__asm
 		{
-			call ClearCachedTileMap // static function
+			call InvalidateTilePaths // static function
 			pop ecx
 			mov esp, ebp
 			pop ebp
@@ -138,8 +140,9 @@ namespace OtherHooks
 		void __fastcall PreScriptExecute(UInt8* ebp, int spot)
 		{
 			// Saves last thisObj in effect/object scripts before they get assigned to something else with dot syntax
-			auto& [script, scriptRunner, lineNumberPtr, scriptOwnerRef, command, curData, extraData] = *g_currentScriptContext.Push();
+			auto& [script, scriptRunner, lineNumberPtr, scriptOwnerRef, command, curData, extraData, profiled, commandProfiled, profilerDepth, profiledOpcode] = *g_currentScriptContext.Push();
 			command = nullptr; // set in ExtractArgsEx
+			commandProfiled = false;
 			scriptOwnerRef = *reinterpret_cast<TESObjectREFR**>(ebp + 0xC);
 			script = *reinterpret_cast<Script**>(ebp + 0x8);
 			if (spot == 1)
@@ -156,6 +159,12 @@ namespace OtherHooks
 				curData = reinterpret_cast<UInt32*>(ebp - 0x24);
 			}
 			extraData = ScriptTokenCacheFormExtraData::Get(script);
+			profiled = ScriptProfiler::g_enabled && script;
+			if (profiled)
+			{
+				ScriptProfiler::EnterFrame(ScriptProfiler::kFrame_Script, script->refID);
+				profilerDepth = ScriptProfiler::GetDepth();
+			}
 
 			//Do other stuff
 			// if (g_threadID == -1) {
@@ -209,7 +218,14 @@ namespace OtherHooks
 		void __fastcall PostScriptExecute(Script* script)
 		{
 			if (script)
+			{
+				const auto& ctx = g_currentScriptContext.Top();
+				if (ctx.commandProfiled)
+					ScriptProfiler::LeaveFrame();
+				if (ctx.profiled)
+					ScriptProfiler::LeaveFrame();
 				g_currentScriptContext.Pop();
+			}
 		}
 
 		__declspec (naked) void Hook1()
@@ -478,6 +494,8 @@ namespace OtherHooks
 		CallDetour kRefSet3D;
 		void __fastcall OnRefSet3DHook(TESObjectREFR* apThis) noexcept {
 			ThisStdCall<void>(kRefSet3D.GetOverwrittenAddr(), apThis);
+			// covers refs spawned into a loaded cell
+			RefSpatialIndex::MarkRefDirty(apThis);
 			uint8_t* pEBP = GetParentBasePtr(_AddressOfReturnAddress());
 			NiAVObject* pNew3D = *reinterpret_cast<NiAVObject**>(pEBP + 0x8);
 			struct Set3DData {
@@ -506,6 +524,7 @@ namespace OtherHooks
 			PluginManager::Dispatch_Message(0, NVSEMessagingInterface::kMessage_OnRefAttach, pRef, sizeof(uintptr_t), nullptr);
 			DispatchEventSafe("onrefattach", pRef);
 			ThisStdCall<void>(kRefAttachToCell.GetOverwrittenAddr(), apThis);
+			RefSpatialIndex::MarkDirty(apThis);
 		}
 
 		void WriteHooks() {
@@ -548,6 +567,7 @@ namespace OtherHooks
 			const uint32_t uiPrevState = apThis->cellState;
 
 			apThis->cellState = aeState;
+			RefSpatialIndex::MarkDirty(apThis);
 
 			// NVSE plugin event
 			{
@@ -680,6 +700,24 @@ namespace OtherHooks
 		return &emptyCtx;
 	}
 
+	void EnterCommandFrame(CurrentScriptContext& ctx, const UInt8* opcodePtr)
+	{
+		if (!ctx.profiled || !ScriptProfiler::g_enabled)
+			return;
+		const UInt32 depth = ScriptProfiler::GetDepth();
+		if (ctx.commandProfiled && (depth == ctx.profilerDepth + 1))
+		{
+			if (ctx.profiledOpcode == opcodePtr)
+				return; // the same command extracting again
+			ScriptProfiler::LeaveFrame();
+		}
+		else if (ctx.commandProfiled || (depth != ctx.profilerDepth))
+			return; // extracting from within a frame, e.g. for a command an expression executes
+		ScriptProfiler::EnterFrame(ScriptProfiler::kFrame_Command, *reinterpret_cast<const UInt16*>(opcodePtr));
+		ctx.commandProfiled = true;
+		ctx.profiledOpcode = opcodePtr;
+	}
+
 	void PushScriptContext(const CurrentScriptContext& ctx)
 	{
 		g_currentScriptContext.Push(ctx);
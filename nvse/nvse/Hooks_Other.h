@@ -14,6 +14,10 @@ namespace OtherHooks
 		CommandInfo* command = nullptr;
 		UInt32* curDataPtr = nullptr;
 		ScriptTokenCacheFormExtraData* scriptExtraData = nullptr;
+		bool profiled = false; // a ScriptProfiler frame was entered for this run
+		bool commandProfiled = false; // a frame for the command the runner is executing is open on top of it
+		UInt32 profilerDepth = 0; // ScriptProfiler::GetDepth() with the script's frame open
+		const UInt8* profiledOpcode = nullptr; // in the script's data, the command that frame is for
 	};
 	void CleanUpNVSEVars(ScriptEventList* eventList);
 	void CleanUpNVSEVar(ScriptEventList* eventList, ScriptLocal* local);
@@ -25,6 +29,11 @@ namespace OtherHooks
 
 	CurrentScriptContext* GetExecutingScriptContext();
 
+	// Closes the frame of the previous command the script runner executed in ctx and opens one for the command at
+	// opcodePtr in the script's data; does nothing unless the run is profiled and the script's frame or that command
+	// frame is the innermost one. Called when a command extracts its arguments, which may happen more than once.
+	void EnterCommandFrame(CurrentScriptContext& ctx, const UInt8* opcodePtr);
+
 	void PushScriptContext(const CurrentScriptContext& ctx);
 	void PopScriptContext();
 }
@@ -10,6 +10,8 @@
 
 #if RUNTIME
 #include "EventManager.h"
+#include "FormListIndex.h"
+#include "RefSpatialIndex.h"
 
 static const UInt32 kIsStartingNewGameAddr = 0x11D8907; // credits to lStewieAl
 static bool IsStartingNewGameNormally()
@@ -103,6 +105,8 @@ static void __stdcall DoLoadGameHook(const char* saveFilePath)
 	g_gameLoaded = true;
 	g_gameStarted = true;
 	s_gameLoadedInformedScripts.Clear();
+	FormListIndex::MarkAllDirty();
+	RefSpatialIndex::MarkAllDirty();
 
 	_MESSAGE("NVSE DLL DoLoadGameHook: %s", saveFilePath);
 	Serialization::HandleLoadGame(saveFilePath);
@@ -154,6 +158,8 @@ static void NewGameHook(void)
 	ClearDelayedCalls();
 	EventManager::ClearFlushOnLoadEventHandlers();
 	TogglePlayerControlsAlt::ResetOnLoad();
+	FormListIndex::MarkAllDirty();
+	RefSpatialIndex::MarkAllDirty();
 
 	Serialization::HandleNewGame();
 }
@@ -25,6 +25,7 @@
 #include "Compiler/Passes/Compiler.h"
 #include "PluginManager.h"
 #include "ScriptDataCache.h"
+#include "ExtractArgsPlan.h"
 #include "Compiler/Passes/MatchTransformer.h"
 #include "Compiler/Passes/VariableResolution.h"
 
@@ -637,6 +638,11 @@ void PostScriptCompile()
 {
 	if (!g_currentScriptStack.empty()) // could be empty here at runtime if the ScriptBuffer or Script are nullptr.
 	{
+#if RUNTIME
+		// varList was rebuilt (or left half built on failure)
+		g_currentScriptStack.top()->InvalidateVariableIndex();
+		ExtractArgsPlanScope::Invalidate(g_currentScriptStack.top());
+#endif
 		// Replace replaced ';' chars with '#' again for saving
 		const auto scriptText = g_currentScriptStack.top()->text;
 		for (const auto value : g_currentScriptRestorePoundChar.top()) {
@@ -0,0 +1,159 @@
+#include "InternedString.h"
+
+#include <bit>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+namespace
+{
+	constexpr UInt32 kNumShards = 16;
+
+	// Four bytes at a time; MSVC's std::hash goes through strings one byte at a time.
+	UInt32 HashString(const char* str, UInt32 length)
+	{
+		UInt32 hash = length * 0x9E3779B1, word;
+		for (; length >= 4; str += 4, length -= 4)
+		{
+			memcpy(&word, str, 4);
+			hash = std::rotl(hash ^ (word * 0x85EBCA77), 13) * 5 + 0xE6546B64;
+		}
+		for (; length; str++, length--)
+			hash = std::rotl(hash ^ (*(const UInt8*)str * 0xCC9E2D51), 15) * 0x1B873593;
+		hash ^= hash >> 16;
+		hash *= 0x85EBCA6B;
+		return hash ^ (hash >> 13);
+	}
+
+	struct Key
+	{
+		std::string_view	view;
+		UInt32				hash;
+
+		bool operator==(const Key& other) const {return (hash == other.hash) && (view == other.view);}
+	};
+
+	struct KeyHash
+	{
+		size_t operator()(const Key& key) const {return key.hash;}
+	};
+
+	// Entries by their string, which the key views, split by hash so threads interning different strings rarely wait
+	// on each other. An entry whose count has dropped to 0 stays in its shard until the thread that dropped it gets the
+	// lock; it is never handed out again, a new entry takes its place instead.
+	struct Shard
+	{
+		std::mutex								lock;
+		std::unordered_map<Key, void*, KeyHash>	entries;
+	};
+
+	// never destroyed, strings held by other globals may be released after this file's globals are gone
+	Shard& GetShard(UInt32 hash)
+	{
+		static Shard *s_shards = new Shard[kNumShards];
+		return s_shards[hash >> 28];
+	}
+}
+
+thread_local InternedString InternedString::s_recent[kNumRecent];
+
+InternedString::InternedString(const char* str, UInt32 length)
+{
+	std::string_view view(str, length);
+	const UInt32 hash = HashString(str, length);
+	InternedString &recent = s_recent[hash & (kNumRecent - 1)];
+	// the slot's own reference keeps its entry alive
+	if (Entry *entry = recent.m_entry; entry && (entry->hash == hash) && (entry->View() == view))
+	{
+		entry->refCount.fetch_add(1, std::memory_order_relaxed);
+		m_entry = entry;
+		return;
+	}
+	m_entry = nullptr;
+	{
+		Shard &shard = GetShard(hash);
+		std::lock_guard lock(shard.lock);
+		if (auto iter = shard.entries.find(Key{view, hash}); iter != shard.entries.end())
+		{
+			auto *entry = (Entry*)iter->second;
+			UInt32 refCount = entry->refCount.load(std::memory_order_relaxed);
+			while (refCount)
+			{
+				if (entry->refCount.compare_exchange_weak(refCount, refCount + 1, std::memory_order_relaxed))
+				{
+					m_entry = entry;
+					break;
+				}
+			}
+			// being released; the releasing thread will find the new entry in its place and leave the table alone
+			if (!m_entry)
+				shard.entries.erase(iter);
+		}
+		if (!m_entry)
+		{
+			auto *entry = (Entry*)malloc(offsetof(Entry, data) + length + 1);
+			new (&entry->refCount) std::atomic<UInt32>(1);
+			entry->length = length;
+			entry->hash = hash;
+			memcpy(entry->data, str, length);
+			entry->data[length] = 0;
+			shard.entries.emplace(Key{entry->View(), hash}, entry);
+			m_entry = entry;
+		}
+	}
+	// outside the lock, the string it replaces may be released into the same shard
+	recent = *this;
+}
+
+InternedString& InternedString::operator=(const InternedString& other)
+{
+	if (other.m_entry)
+		other.m_entry->refCount++;
+	if (m_entry)
+		Release(m_entry);
+	m_entry = other.m_entry;
+	return *this;
+}
+
+InternedString& InternedString::operator=(InternedString&& other) noexcept
+{
+	if (this != &other)
+	{
+		if (m_entry)
+			Release(m_entry);
+		m_entry = other.m_entry;
+		other.m_entry = nullptr;
+	}
+	return *this;
+}
+
+void InternedString::Release(Entry* entry)
+{
+	if (entry->refCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		return;
+	{
+		Shard &shard = GetShard(entry->hash);
+		std::lock_guard lock(shard.lock);
+		auto iter = shard.entries.find(Key{entry->View(), entry->hash});
+		if ((iter != shard.entries.end()) && (iter->second == entry))
+			shard.entries.erase(iter);
+	}
+	free(entry);
+}
+
+void InternedString::GetUsage(UInt32* numStrings, UInt32* numBytes)
+{
+	UInt32 strings = 0, bytes = 0;
+	for (UInt32 idx = 0; idx < kNumShards; idx++)
+	{
+		Shard &shard = GetShard(idx << 28);
+		std::lock_guard lock(shard.lock);
+		// a bucket pointer, and a node per string holding the link, the key, the entry and the cached hash
+		bytes += shard.entries.bucket_count() * sizeof(void*) + shard.entries.size() * (sizeof(void*) * 3 + sizeof(Key));
+		for (const auto &[key, entry] : shard.entries)
+			bytes += offsetof(Entry, data) + key.view.size() + 1;
+		strings += shard.entries.size();
+	}
+	*numStrings = strings;
+	*numBytes = bytes;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <string_view>
+
+// Shared, immutable string storage: each distinct string is kept once, with a count of the handles using it, and
+// freed with the last of them. Equal strings always share their storage, so two handles hold equal strings exactly
+// when they point at the same storage. Handles can be created, copied and dropped on any thread.
+// Each thread also holds on to up to kNumRecent strings it interned lately, so assigning one of them again only costs a
+// hash and an increment; those strings are freed when the thread replaces them or exits.
+class InternedString
+{
+	struct Entry
+	{
+		std::atomic<UInt32>	refCount;
+		UInt32				length;
+		UInt32				hash;
+		char				data[1];	// length characters and a terminating 0
+
+		std::string_view View() const {return std::string_view(data, length);}
+	};
+
+	static constexpr UInt32 kNumRecent = 0x400;
+
+	static thread_local InternedString s_recent[kNumRecent];	// by hash
+
+	Entry	*m_entry;
+
+	static void Release(Entry* entry);
+
+public:
+	constexpr InternedString() : m_entry(nullptr) {}
+	InternedString(const char* str, UInt32 length);
+	InternedString(const InternedString& other) : m_entry(other.m_entry) {if (m_entry) m_entry->refCount++;}
+	InternedString(InternedString&& other) noexcept : m_entry(other.m_entry) {other.m_entry = nullptr;}
+	~InternedString() {if (m_entry) Release(m_entry);}
+
+	InternedString& operator=(const InternedString& other);
+	InternedString& operator=(InternedString&& other) noexcept;
+
+	bool Empty() const {return !m_entry;}
+	const char* CStr() const {return m_entry ? m_entry->data : "";}
+	UInt32 Length() const {return m_entry ? m_entry->length : 0;}
+
+	bool operator==(const InternedString& other) const {return m_entry == other.m_entry;}
+
+	// Distinct strings held and the bytes they take up, lookup tables included.
+	static void GetUsage(UInt32* numStrings, UInt32* numBytes);
+};
@@ -0,0 +1,103 @@
+#include "InventoryItems.h"
+
+namespace
+{
+	// Below this many base container entries the lookups cost less than filling the map (see nvse/host_bench, inv/).
+	constexpr UInt32 kMinMergedEntries = 24;
+
+	bool IsSmallContainer(TESContainer* container)
+	{
+		UInt32 numEntries = 0;
+		for (auto contIter = container->formCountList.Begin(); !contIter.End(); ++contIter)
+			if (++numEntries >= kMinMergedEntries)
+				return false;
+		return true;
+	}
+}
+
+bool GetContainerItems(TESContainer* container, ExtraContainerChanges::EntryDataList* entryList, InventoryItemsMap& invItems)
+{
+	TESForm *item;
+	SInt32 countDelta;
+	ExtraContainerChanges::EntryData *entry;
+
+	auto addBaseItem = [&](TESForm* baseItem, SInt32 contCount, ExtraContainerChanges::EntryData* changes)
+	{
+		if (changes)
+		{
+			countDelta = changes->countDelta;
+			if (changes->HasExtraLeveledItem())
+				contCount = countDelta;
+			else contCount += countDelta;
+		}
+		if (contCount > 0)
+			invItems.Emplace(baseItem, contCount, changes);
+	};
+
+	if (IsSmallContainer(container))
+	{
+		for (auto contIter = container->formCountList.Begin(); !contIter.End(); ++contIter)
+		{
+			item = contIter->form;
+			if ((item->typeID == kFormType_TESLevItem) || invItems.HasKey(item))
+				continue;
+			addBaseItem(item, container->GetCountForForm(item), entryList->FindForItem(item));
+		}
+	}
+	else
+	{
+		struct BaseItem
+		{
+			SInt32								count;
+			ExtraContainerChanges::EntryData	*entry;
+		};
+		// Summed base counts and first changes entry per item, so the merge below is one pass over each list
+		// rather than a GetCountForForm/FindForItem scan per item.
+		thread_local UnorderedMap<TESForm*, BaseItem> s_baseItems(0x40);
+		thread_local Vector<TESForm*> s_baseOrder(0x40);
+		s_baseItems.Clear();
+		s_baseOrder.Clear();
+
+		BaseItem *baseItem;
+		for (auto contIter = container->formCountList.Begin(); !contIter.End(); ++contIter)
+		{
+			item = contIter->form;
+			if (s_baseItems.Insert(item, &baseItem))
+			{
+				baseItem->count = contIter->count;
+				baseItem->entry = NULL;
+				s_baseOrder.Append(item);
+			}
+			else baseItem->count += contIter->count;
+		}
+
+		for (auto xtraIter = entryList->Begin(); !xtraIter.End(); ++xtraIter)
+		{
+			entry = xtraIter.Get();
+			if ((baseItem = s_baseItems.GetPtr(entry->type)) && !baseItem->entry)
+				baseItem->entry = entry;
+		}
+
+		for (auto orderIter = s_baseOrder.Begin(); !orderIter.End(); ++orderIter)
+		{
+			item = *orderIter;
+			if ((item->typeID == kFormType_TESLevItem) || invItems.HasKey(item))
+				continue;
+			baseItem = s_baseItems.GetPtr(item);
+			addBaseItem(item, baseItem->count, baseItem->entry);
+		}
+	}
+
+	for (auto xtraIter = entryList->Begin(); !xtraIter.End(); ++xtraIter)
+	{
+		entry = xtraIter.Get();
+		item = entry->type;
+		if (invItems.HasKey(item))
+			continue;
+		countDelta = entry->countDelta;
+		if (countDelta > 0)
+			invItems.Emplace(item, countDelta, entry);
+	}
+
+	return !invItems.Empty();
+}
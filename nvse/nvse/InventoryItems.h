@@ -0,0 +1,9 @@
+#pragma once
+#include "GameExtraData.h"
+
+// The items of a container reference (TESObjectREFR::GetInventoryItems): the counts of its base container summed per
+// item, with the item's first ExtraContainerChanges entry applied, in base container order, then the items only the
+// changes hold. Leveled list entries of the base container are skipped. Except for small containers each list is
+// walked once; looking every item up in the other list made enumerating a container quadratic in its size.
+// Returns false if no item ended up in invItems.
+bool GetContainerItems(TESContainer* container, ExtraContainerChanges::EntryDataList* entryList, InventoryItemsMap& invItems);
@@ -153,7 +153,7 @@ bool ArrayIterLoop::UpdateIterator(const ArrayElement* elem)
 		if (newElem)
 		{
 			if (m_curKey.KeyType() == kDataType_String)
-				newElem->SetString(m_curKey.key.str);
+				newElem->SetString(m_curKey.key.GetStr());
 			else newElem->SetNumber(m_curKey.key.num);
 		}
 		else [[unlikely]] {
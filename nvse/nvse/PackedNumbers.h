@@ -0,0 +1,136 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+
+// Element storage of a packed array holding only plain numbers (ArrayVar::m_bNumbersOnly): a double per element
+// where an ArrayElement takes 24 bytes. Copies share the numbers and a slice can be a view of a range of them; the
+// first side to write takes its own copy (Writable), so nothing written through one is seen through the others.
+// Arrays holding anything else still copy their elements right away, see ArrayVar::Copy.
+class PackedNumbers
+{
+public:
+	typedef Vector<double> NumberVector;
+
+	struct Range
+	{
+		const double	*data;
+		UInt32			size;
+
+		const double* Data() const {return data;}
+		UInt32 Size() const {return size;}
+		const double& operator[](UInt32 index) const {return data[index];}
+		const double* GetPtr(UInt32 index) const {return (index < size) ? (data + index) : nullptr;}
+		bool HasNaN() const {return std::any_of(data, data + size, [](double num) {return num != num;});}
+	};
+
+private:
+	// the numbers and the count of PackedNumbers sharing them, allocated from the pool like the vector's data
+	struct Buffer
+	{
+		std::atomic<UInt32>	refCount;
+		NumberVector		numbers;
+	};
+
+	Buffer	*m_buffer = nullptr;	// null when empty
+	UInt32	m_viewBegin = 0;		// with m_bView set, the numbers are m_viewSize of m_buffer's starting here
+	UInt32	m_viewSize = 0;
+	bool	m_bView = false;
+
+	static Buffer* NewBuffer()
+	{
+		Buffer *buffer = new (Pool_Alloc(sizeof(Buffer))) Buffer();
+		buffer->refCount.store(1, std::memory_order_relaxed);
+		return buffer;
+	}
+
+	void Share(const PackedNumbers& other)
+	{
+		Buffer *buffer = other.m_buffer;
+		if (buffer)
+			buffer->refCount++;
+		Release();
+		m_buffer = buffer;
+	}
+
+public:
+	PackedNumbers() = default;
+	PackedNumbers(const PackedNumbers& other) : m_buffer(other.m_buffer), m_viewBegin(other.m_viewBegin), m_viewSize(other.m_viewSize),
+		m_bView(other.m_bView)
+	{
+		if (m_buffer)
+			m_buffer->refCount++;
+	}
+	~PackedNumbers() {Release();}
+
+	PackedNumbers& operator=(const PackedNumbers& other)
+	{
+		if (this != &other)
+		{
+			Share(other);
+			m_viewBegin = other.m_viewBegin;
+			m_viewSize = other.m_viewSize;
+			m_bView = other.m_bView;
+		}
+		return *this;
+	}
+
+	Range Get() const
+	{
+		if (!m_buffer)
+			return {nullptr, 0};
+		if (m_bView)
+			return {m_buffer->numbers.Data() + m_viewBegin, m_viewSize};
+		return {m_buffer->numbers.Data(), m_buffer->numbers.Size()};
+	}
+
+	UInt32 Size() const {return Get().Size();}
+
+	NumberVector& Writable()
+	{
+		if (!m_buffer)
+			m_buffer = NewBuffer();
+		else if (m_bView || (m_buffer->refCount.load(std::memory_order_acquire) != 1))
+		{
+			Buffer *buffer = NewBuffer();
+			Range range = Get();
+			buffer->numbers.Concatenate(range.Data(), range.Size());
+			Release();
+			m_buffer = buffer;
+		}
+		return m_buffer->numbers;
+	}
+
+	// Becomes a view of size numbers of src, starting at its index begin.
+	void ShareRange(const PackedNumbers& src, UInt32 begin, UInt32 size)
+	{
+		const UInt32 viewBegin = (src.m_bView ? src.m_viewBegin : 0) + begin;
+		Share(src);
+		m_viewBegin = viewBegin;
+		m_viewSize = size;
+		m_bView = true;
+	}
+
+	void Release()
+	{
+		if (m_buffer && (m_buffer->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1))
+		{
+			m_buffer->~Buffer();
+			Pool_Free(m_buffer, sizeof(Buffer));
+		}
+		m_buffer = nullptr;
+		m_bView = false;
+	}
+
+	// Appends the numbers of range to out in the order inserting them one by one with InsertSorted gives: stable
+	// ascending, reversed for descending, as InsertSorted places equal values before each other when descending. That
+	// order means nothing with NaN among them, which the caller has to rule out.
+	static void AppendSorted(Range range, NumberVector& out, bool descending)
+	{
+		const UInt32 start = out.Size();
+		out.Concatenate(range.Data(), range.Size());
+		double *pBgn = out.Data() + start, *pEnd = out.Data() + out.Size();
+		std::stable_sort(pBgn, pEnd);
+		if (descending)
+			std::reverse(pBgn, pEnd);
+	}
+};
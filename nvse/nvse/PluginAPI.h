@@ -869,7 +869,7 @@ struct NVSESerializationInterface
 {
 	enum
 	{
-		kVersion = 2,
+		kVersion = 4,
 	};
 
 	typedef void (* EventCallback)(void * reserved);
@@ -911,6 +911,19 @@ struct NVSESerializationInterface
 	void	(*ReadRecord64)(void *outData);
 
 	void	(*SkipNBytes)(UInt32 byteNum);
+
+	// version 3
+	// Use instead of SetSaveCallback if the callback can run on another thread while other plugins save. When
+	// bParallelPluginSaves is set in nvse_config.ini, such callbacks run on worker threads, each writing its records
+	// into a buffer of its own; the cosave comes out exactly as if they had run one after another. The callback must
+	// not touch game objects or anything else another plugin might use while saving.
+	void	(*SetThreadSafeSaveCallback)(PluginHandle plugin, EventCallback callback);
+
+	// version 4
+	// Moves straight to the first record of this type the plugin saved, as if GetNextRecordInfo had just returned it;
+	// GetNextRecordInfo then goes on with the records saved after it. Returns false and leaves the current record alone
+	// if there is no such record.
+	bool	(*FindRecord)(UInt32 type, UInt32 * version, UInt32 * length);
 };
 
 #ifdef RUNTIME
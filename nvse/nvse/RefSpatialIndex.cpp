@@ -0,0 +1,256 @@
+#include "RefSpatialIndex.h"
+
+#include <bit>
+#include <cmath>
+#include "CommandTable.h"
+#include "GameForms.h"
+#include "GameObjects.h"
+
+bool RefSpatialIndex::IsFixed(const TESObjectREFR* refr)
+{
+	// refs of these only move when a script or plugin moves them; anything else may be pushed around by the engine
+	if (!refr->baseForm)
+		return false;
+	switch (refr->baseForm->typeID)
+	{
+	case kFormType_TESObjectSTAT:
+	case kFormType_BGSStaticCollection:
+	case kFormType_BGSMovableStatic:
+	case kFormType_TESObjectTREE:
+	case kFormType_TESGrass:
+	case kFormType_TESObjectDOOR:
+	case kFormType_TESFurniture:
+	case kFormType_BGSTerminal:
+	case kFormType_TESSound:
+	case kFormType_BGSIdleMarker:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void RefSpatialIndex::CellGrid::Build(const TESObjectCELL* cell)
+{
+	refs.Clear();
+	entries.Clear();
+	bucketed.Clear();
+	bucketStart.Clear();
+	unbucketed.Clear();
+	mobile.Clear();
+	numBucketsX = numBucketsY = 0;
+
+	float maxX = 0, maxY = 0;
+	bool hasBounds = false;
+	for (auto iter = cell->objectList.Begin(); !iter.End(); ++iter)
+	{
+		TESObjectREFR* refr = iter.Get();
+		if (!refr)
+			continue;
+		const UInt32 listIndex = refs.Size();
+		refs.Append(refr);
+		if (!IsFixed(refr))
+		{
+			mobile.Append(MobileRef{refr->refID, listIndex});
+			continue;
+		}
+		const float x = refr->posX, y = refr->posY;
+		if (!std::isfinite(x) || !std::isfinite(y))
+		{
+			unbucketed.Append(listIndex);
+			continue;
+		}
+		entries.Append(Entry{x, y, listIndex});
+		if (!hasBounds)
+		{
+			minX = maxX = x;
+			minY = maxY = y;
+			hasBounds = true;
+			continue;
+		}
+		if (x < minX) minX = x; else if (x > maxX) maxX = x;
+		if (y < minY) minY = y; else if (y > maxY) maxY = y;
+	}
+	if (!hasBounds)
+		return;
+	bucketed.Concatenate(entries.Data(), entries.Size());
+
+	// widen the buckets for sprawling cells so the bucket table stays small
+	bucketSize = kBucketSize;
+	while (true)
+	{
+		numBucketsX = (UInt32)((maxX - minX) / bucketSize) + 1;
+		numBucketsY = (UInt32)((maxY - minY) / bucketSize) + 1;
+		if (numBucketsX * numBucketsY <= kMaxBuckets)
+			break;
+		bucketSize *= 2;
+	}
+
+	// counting sort of the entries by bucket, bucketStart[i]..bucketStart[i + 1] spans bucket i
+	const UInt32 numBuckets = numBucketsX * numBucketsY;
+	bucketStart.Resize(numBuckets + 1);
+	MemZero(bucketStart.Data(), (numBuckets + 1) * sizeof(UInt32));
+	Vector<UInt32> entryBucket(entries.Size());
+	for (auto& entry : entries)
+	{
+		const UInt32 bx = (UInt32)((entry.x - minX) / bucketSize), by = (UInt32)((entry.y - minY) / bucketSize);
+		const UInt32 bucket = min(by, numBucketsY - 1) * numBucketsX + min(bx, numBucketsX - 1);
+		entryBucket.Append(bucket);
+		++bucketStart[bucket + 1];
+	}
+	for (UInt32 i = 0; i < numBuckets; i++)
+		bucketStart[i + 1] += bucketStart[i];
+
+	Vector<Entry> sorted(entries.Size());
+	sorted.Resize(entries.Size());
+	Vector<UInt32> fill(numBuckets);
+	fill.Resize(numBuckets);
+	memcpy(fill.Data(), bucketStart.Data(), numBuckets * sizeof(UInt32));
+	for (UInt32 i = 0; i < entries.Size(); i++)
+		sorted[fill[entryBucket[i]]++] = entries[i];
+	RawSwap<Vector<Entry>>(entries, sorted);
+}
+
+bool RefSpatialIndex::GatherCandidates(const TESObjectCELL* cell, const TESObjectREFR* center, float radius, Vector<TESObjectREFR*>& candidates)
+{
+	// pad the radius so float rounding in GetDistance3D can never accept a ref the buckets left out
+	const float paddedRadius = radius * 1.001f + 1.0f;
+	if (!std::isfinite(paddedRadius))
+		return false;
+
+	bool isCurrent;
+	CellGrid* grid = &Cache::Get(cell, isCurrent);
+	if (!isCurrent)
+		grid->Build(cell);
+	if (grid->refs.Size() < kMinRefsToIndex)
+		return false;
+
+	// one bit per ref in objectList order, so the candidates come out in the order a linear scan visits them and a ref
+	// is never handed out twice; a fixed center ref is found in its own bucket, a mobile one with the other mobile refs
+	thread_local Vector<UInt32> s_selected;
+	UInt32 numWords;
+	const auto select = [&](UInt32 index) {s_selected[index >> 5] |= 1U << (index & 31);};
+
+	// a fixed ref moved without invalidating the cell is still in the bucket of where it was; wherever it is now, it is
+	// handed out like a mobile ref, and the grid is rebuilt around the new positions once too many have moved
+	UInt32 numMoved;
+	for (bool rebuilt = false; ; rebuilt = true)
+	{
+		numWords = (grid->refs.Size() + 31) >> 5;
+		s_selected.Resize(numWords);
+		MemZero(s_selected.Data(), numWords * sizeof(UInt32));
+		numMoved = 0;
+		for (const Entry& entry : grid->bucketed)
+		{
+			const TESObjectREFR* refr = grid->refs[entry.listIndex];
+			if (memcmp(&refr->posX, &entry.x, sizeof(float) * 2))
+			{
+				select(entry.listIndex);
+				numMoved++;
+			}
+		}
+		if (rebuilt || (numMoved <= grid->bucketed.Size() / kMaxMovedShare))
+			break;
+		grid->Build(cell);
+	}
+	const float cx = center->posX, cy = center->posY;
+	if (grid->numBucketsX && std::isfinite(cx) && std::isfinite(cy))
+	{
+		const float loX = (cx - paddedRadius - grid->minX) / grid->bucketSize, hiX = (cx + paddedRadius - grid->minX) / grid->bucketSize;
+		const float loY = (cy - paddedRadius - grid->minY) / grid->bucketSize, hiY = (cy + paddedRadius - grid->minY) / grid->bucketSize;
+		if (hiX >= 0 && hiY >= 0 && loX < grid->numBucketsX && loY < grid->numBucketsY)
+		{
+			const UInt32 x0 = loX > 0 ? (UInt32)loX : 0, x1 = hiX < grid->numBucketsX - 1 ? (UInt32)hiX : grid->numBucketsX - 1;
+			const UInt32 y0 = loY > 0 ? (UInt32)loY : 0, y1 = hiY < grid->numBucketsY - 1 ? (UInt32)hiY : grid->numBucketsY - 1;
+			// a query covering most of the cell gains nothing over a plain scan
+			UInt32 numInRange = grid->mobile.Size() + grid->unbucketed.Size() + numMoved;
+			for (UInt32 by = y0; by <= y1; by++)
+				numInRange += grid->bucketStart[by * grid->numBucketsX + x1 + 1] - grid->bucketStart[by * grid->numBucketsX + x0];
+			if (numInRange > grid->refs.Size() / 2)
+				return false;
+			for (UInt32 by = y0; by <= y1; by++)
+			{
+				const UInt32 rowStart = by * grid->numBucketsX;
+				const UInt32 begin = grid->bucketStart[rowStart + x0], end = grid->bucketStart[rowStart + x1 + 1];
+				for (UInt32 i = begin; i < end; i++)
+				{
+					const Entry& entry = grid->entries[i];
+					if (abs(entry.x - cx) <= paddedRadius && abs(entry.y - cy) <= paddedRadius)
+						select(entry.listIndex);
+				}
+			}
+		}
+	}
+	else if (grid->mobile.Size() + grid->unbucketed.Size() + numMoved > grid->refs.Size() / 2)
+		return false;
+	for (UInt32 index : grid->unbucketed)
+		select(index);
+
+	// a mobile ref may have been deleted or have left the cell since the build; looking it up by refID first means a
+	// freed one is never dereferenced
+	for (const MobileRef& ref : grid->mobile)
+	{
+		TESForm* form = LookupFormByID(ref.refID);
+		if (form && form == grid->refs[ref.listIndex] && static_cast<TESObjectREFR*>(form)->parentCell == cell)
+			select(ref.listIndex);
+	}
+
+	for (UInt32 word = 0; word < numWords; word++)
+	{
+		for (UInt32 bits = s_selected[word]; bits; bits &= bits - 1)
+			candidates.Append(grid->refs[(word << 5) + std::countr_zero(bits)]);
+	}
+	return true;
+}
+
+void RefSpatialIndex::MarkDirty(const TESObjectCELL* cell)
+{
+	Cache::Invalidate(cell);
+}
+
+void RefSpatialIndex::MarkRefDirty(const TESObjectREFR* refr)
+{
+	if (refr && refr->parentCell)
+		Cache::Invalidate(refr->parentCell);
+}
+
+void RefSpatialIndex::MarkAllDirty()
+{
+	Cache::InvalidateAll();
+}
+
+namespace
+{
+	// commands that move thisObj, possibly to another cell, or place a new ref in its cell
+	const char* const kMoveCommandNames[] = {"SetPos", "MoveTo", "PositionCell", "PositionWorld", "PlaceAtMe", "PlaceAtMeHealthPercent", "PlaceLeveledActorAtMe"};
+	Cmd_Execute s_moveCommandExecute[std::size(kMoveCommandNames)];
+
+	template <UInt32 N>
+	bool Cmd_MoveRef_Execute(COMMAND_ARGS)
+	{
+		const TESObjectCELL* prevCell = thisObj ? thisObj->parentCell : nullptr;
+		const bool retn = s_moveCommandExecute[N](PASS_COMMAND_ARGS);
+		if (prevCell)
+			RefSpatialIndex::MarkDirty(prevCell);
+		RefSpatialIndex::MarkRefDirty(thisObj);
+		return retn;
+	}
+
+	template <UInt32... N>
+	void HookMoveCommandsImpl(std::integer_sequence<UInt32, N...>)
+	{
+		const Cmd_Execute wrappers[] = {&Cmd_MoveRef_Execute<N>...};
+		for (UInt32 i = 0; i < std::size(kMoveCommandNames); i++)
+		{
+			CommandInfo* cmd = g_scriptCommands.GetByName(kMoveCommandNames[i]);
+			if (!cmd || !cmd->execute)
+				continue;
+			s_moveCommandExecute[i] = cmd->execute;
+			cmd->execute = wrappers[i];
+		}
+	}
+}
+
+void RefSpatialIndex::HookMoveCommands()
+{
+	HookMoveCommandsImpl(std::make_integer_sequence<UInt32, std::size(kMoveCommandNames)>());
+}
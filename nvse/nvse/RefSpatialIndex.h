@@ -0,0 +1,70 @@
+#pragma once
+#include "FormDerivedCache.h"
+
+class TESObjectCELL;
+class TESObjectREFR;
+
+// Per-cell grid of reference positions, used by GetRefs/GetNumRefs to narrow radius queries down to nearby buckets.
+// Only refs of base forms the engine never moves on its own (statics, doors, furniture, trees...) are bucketed. Actors,
+// items, projectiles and other havok-driven refs move every frame, so they are kept in a side list and always handed to
+// the caller, which applies its matcher to every candidate; results match a plain scan of objectList.
+// A cell's grid is rebuilt after the cell is invalidated: when a ref is attached to it or gets or loses its 3D, when its
+// load state changes, when one of its refs is deleted, and after the vanilla commands that move or place refs. A fixed
+// ref moved by other means, such as a plugin writing its position, is caught on the next query by comparing its
+// position with the one it was bucketed at, and handed to the caller like a mobile ref until the grid is rebuilt.
+class RefSpatialIndex
+{
+public:
+	static constexpr float kBucketSize = 1024.0f;
+	static constexpr UInt32 kMaxBuckets = 0x1000;
+	static constexpr UInt32 kMinRefsToIndex = 64;	// smaller cells are cheaper to scan directly
+	static constexpr UInt32 kMaxCachedCells = 0x100;
+	static constexpr UInt32 kMaxMovedShare = 8;		// the grid is rebuilt once more than 1 in this many fixed refs moved
+
+	// Appends the references of cell that may be within radius of center to candidates, in objectList order.
+	// Returns false if the cell is too small to be worth indexing, in which case the caller should scan it directly.
+	static bool GatherCandidates(const TESObjectCELL* cell, const TESObjectREFR* center, float radius, Vector<TESObjectREFR*>& candidates);
+
+	// Drops the grid of cell on every thread.
+	static void MarkDirty(const TESObjectCELL* cell);
+
+	// Drops the grid of the cell refr is in, if any.
+	static void MarkRefDirty(const TESObjectREFR* refr);
+
+	// Drops every grid, for game loads where cells may be freed and their addresses reused.
+	static void MarkAllDirty();
+
+	// Wraps the execute functions of vanilla commands that move or place references so they invalidate cell grids.
+	static void HookMoveCommands();
+
+private:
+	struct Entry
+	{
+		float	x, y;
+		UInt32	listIndex;
+	};
+
+	struct MobileRef
+	{
+		UInt32	refID;
+		UInt32	listIndex;
+	};
+
+	struct CellGrid
+	{
+		Vector<TESObjectREFR*>	refs;			// objectList order, null entries skipped
+		Vector<Entry>			entries;		// fixed refs grouped by bucket, see bucketStart
+		Vector<Entry>			bucketed;		// the same in objectList order, to find the ones that moved since
+		Vector<UInt32>			bucketStart;	// numBucketsX * numBucketsY + 1 offsets into entries
+		Vector<UInt32>			unbucketed;		// list indices of fixed refs with non-finite positions
+		Vector<MobileRef>		mobile;			// refs the engine may move or delete at any time
+		float					minX = 0, minY = 0, bucketSize = kBucketSize;
+		UInt32					numBucketsX = 0, numBucketsY = 0;
+
+		void Build(const TESObjectCELL* cell);
+	};
+
+	using Cache = FormDerivedCache<CellGrid, kMaxCachedCells>;
+
+	static bool IsFixed(const TESObjectREFR* refr);
+};
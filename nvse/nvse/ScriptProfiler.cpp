@@ -0,0 +1,262 @@
+#include "ScriptProfiler.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <intrin.h>
+#include <map>
+#include <unordered_map>
+#include "CommandTable.h"
+#include "GameForms.h"
+#include "GameScript.h"
+#include "ScriptUtils.h"
+
+namespace ScriptProfiler
+{
+	bool g_enabled = false;
+
+	struct Node
+	{
+		UInt64	key;		// kind << 32 | id
+		UInt32	parent;		// index into ThreadBuffer::nodes, 0 is the root
+		UInt32	calls;
+		UInt64	inclusive;	// ticks
+		UInt64	exclusive;	// ticks minus those of child frames
+	};
+
+	struct OpenFrame
+	{
+		UInt32	node;
+		UInt64	start;
+		UInt64	childTicks;
+	};
+
+	// Only the owning thread adds to its buffer; the lock is there for Start and Dump running on the main thread.
+	struct ThreadBuffer
+	{
+		PrimitiveCS						cs;
+		Vector<Node>					nodes;
+		UnorderedMap<UInt64, UInt32>	children;	// parent << 40 | kind << 32 | id -> node
+		Vector<OpenFrame>				stack;
+
+		ThreadBuffer() {nodes.Append(Node{});}
+	};
+
+	static PrimitiveCS s_buffersCS;
+	static Vector<ThreadBuffer*> s_buffers;	// never freed, there are only a handful of threads running scripts
+	static thread_local ThreadBuffer* s_buffer = nullptr;
+
+	static UInt64 s_startTicks = 0, s_startQPC = 0;
+
+	static ThreadBuffer& GetThreadBuffer()
+	{
+		if (!s_buffer)
+		{
+			s_buffer = new ThreadBuffer();
+			PrimitiveScopedLock lock(s_buffersCS);
+			s_buffers.Append(s_buffer);
+		}
+		return *s_buffer;
+	}
+
+	static UInt64 MakeKey(FrameKind kind, UInt32 id)
+	{
+		return ((UInt64)kind << 32) | id;
+	}
+
+	void EnterFrame(FrameKind kind, UInt32 id)
+	{
+		ThreadBuffer& buffer = GetThreadBuffer();
+		PrimitiveScopedLock lock(buffer.cs);
+		UInt32 parent = buffer.stack.Empty() ? 0 : buffer.stack.Top().node;
+		UInt32* pNode;
+		if (buffer.children.Insert(((UInt64)parent << 40) | MakeKey(kind, id), &pNode))
+		{
+			*pNode = buffer.nodes.Size();
+			buffer.nodes.Append(Node{MakeKey(kind, id), parent, 0, 0, 0});
+		}
+		buffer.stack.Append(OpenFrame{*pNode, __rdtsc(), 0});
+	}
+
+	void LeaveFrame()
+	{
+		UInt64 now = __rdtsc();
+		ThreadBuffer& buffer = GetThreadBuffer();
+		PrimitiveScopedLock lock(buffer.cs);
+		if (buffer.stack.Empty())
+			return;
+		OpenFrame frame = buffer.stack.Top();
+		buffer.stack.Pop();
+		UInt64 elapsed = now - frame.start;
+		Node& node = buffer.nodes[frame.node];
+		node.calls++;
+		node.inclusive += elapsed;
+		node.exclusive += elapsed - std::min(elapsed, frame.childTicks);
+		if (!buffer.stack.Empty())
+			buffer.stack.Top().childTicks += elapsed;
+	}
+
+	UInt32 GetDepth()
+	{
+		return GetThreadBuffer().stack.Size();
+	}
+
+	void Start()
+	{
+		{
+			PrimitiveScopedLock lock(s_buffersCS);
+			for (ThreadBuffer* buffer : s_buffers)
+			{
+				// keep the tree, open frames still point into it
+				PrimitiveScopedLock bufferLock(buffer->cs);
+				for (Node& node : buffer->nodes)
+					node.calls = 0, node.inclusive = 0, node.exclusive = 0;
+			}
+		}
+		QueryPerformanceCounter((LARGE_INTEGER*)&s_startQPC);
+		s_startTicks = __rdtsc();
+		g_enabled = true;
+	}
+
+	void Stop()
+	{
+		g_enabled = false;
+	}
+
+	static std::string GetScriptName(UInt32 refID)
+	{
+		TESForm* form = LookupFormByRefID(refID);
+		if (form && IS_ID(form, Script))
+		{
+			auto* script = static_cast<Script*>(form);
+			if (const char* name = script->GetName(); name && *name)
+				return name;
+			if (Script* parent = GetLambdaParentScript(script))
+				if (const char* name = parent->GetName(); name && *name)
+					return std::string(name) + " (lambda)";
+		}
+		return FormatString("%08X", refID);
+	}
+
+	static std::string GetFrameName(UInt64 key)
+	{
+		UInt32 id = (UInt32)key;
+		std::string name;
+		switch ((FrameKind)(key >> 32))
+		{
+		case kFrame_Script:
+			name = "script:" + GetScriptName(id);
+			break;
+		case kFrame_Expression:
+			name = "expr:" + GetScriptName(id);
+			break;
+		case kFrame_Function:
+			name = "udf:" + GetScriptName(id);
+			break;
+		case kFrame_Event:
+			name = std::string("event:") + reinterpret_cast<const char*>(id);
+			break;
+		case kFrame_Command:
+		{
+			CommandInfo* cmdInfo = g_scriptCommands.GetByOpcode(id);
+			name = (cmdInfo && cmdInfo->longName) ? std::string("cmd:") + cmdInfo->longName : FormatString("cmd:%04X", id);
+			break;
+		}
+		default:
+			name = "?";
+			break;
+		}
+		// ';' separates frames in the collapsed stack format
+		std::replace(name.begin(), name.end(), ';', ':');
+		return name;
+	}
+
+	struct Totals
+	{
+		UInt64	calls = 0;
+		UInt64	inclusive = 0;	// only counted for the outermost frame of a recursion
+		UInt64	exclusive = 0;
+	};
+
+	bool Dump(const char* name)
+	{
+		UInt64 nowQPC, frequency;
+		QueryPerformanceCounter((LARGE_INTEGER*)&nowQPC);
+		QueryPerformanceFrequency((LARGE_INTEGER*)&frequency);
+		UInt64 elapsedTicks = __rdtsc() - s_startTicks;
+		double elapsedMicroseconds = (double)(nowQPC - s_startQPC) * 1000000.0 / (double)frequency;
+		double ticksPerMicrosecond = (elapsedMicroseconds > 0) ? (double)elapsedTicks / elapsedMicroseconds : 1.0;
+		if (ticksPerMicrosecond <= 0)
+			ticksPerMicrosecond = 1.0;
+
+		std::map<std::string, UInt64> stacks;
+		std::unordered_map<UInt64, Totals> totals;
+		std::unordered_map<UInt64, std::string> names;
+		auto getName = [&](UInt64 key) -> const std::string&
+		{
+			auto [iter, inserted] = names.try_emplace(key);
+			if (inserted)
+				iter->second = GetFrameName(key);
+			return iter->second;
+		};
+
+		Vector<ThreadBuffer*> buffers;
+		{
+			PrimitiveScopedLock lock(s_buffersCS);
+			buffers.Concatenate(s_buffers);
+		}
+		for (ThreadBuffer* buffer : buffers)
+		{
+			Vector<Node> nodes;
+			{
+				PrimitiveScopedLock lock(buffer->cs);
+				nodes.Concatenate(buffer->nodes);
+			}
+			// parents are always created before their children, so paths can be built front to back
+			std::vector<std::string> paths(nodes.Size());
+			for (UInt32 idx = 1; idx < nodes.Size(); idx++)
+			{
+				const Node& node = nodes[idx];
+				paths[idx] = node.parent ? paths[node.parent] + ';' + getName(node.key) : getName(node.key);
+				if (!node.calls)
+					continue;
+				if (node.exclusive)
+					stacks[paths[idx]] += node.exclusive;
+
+				Totals& total = totals[node.key];
+				total.calls += node.calls;
+				total.exclusive += node.exclusive;
+				bool isRecursive = false;
+				for (UInt32 parent = node.parent; parent && !isRecursive; parent = nodes[parent].parent)
+					isRecursive = nodes[parent].key == node.key;
+				if (!isRecursive)
+					total.inclusive += node.inclusive;
+			}
+		}
+
+		const char* dirName = "ScriptProfiles";
+		if (!std::filesystem::exists(dirName))
+			std::filesystem::create_directory(dirName);
+		const std::string basePath = FormatString("%s/%s", dirName, (name && *name) ? name : "profile");
+
+		std::ofstream folded(basePath + ".folded");
+		if (!folded)
+			return false;
+		for (const auto& [path, ticks] : stacks)
+			if (UInt64 microseconds = (UInt64)((double)ticks / ticksPerMicrosecond))
+				folded << path << ' ' << microseconds << '\n';
+
+		std::ofstream summary(basePath + ".txt");
+		if (!summary)
+			return false;
+		std::vector<std::pair<UInt64, Totals>> sorted(totals.begin(), totals.end());
+		std::sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {return lhs.second.exclusive > rhs.second.exclusive;});
+		summary << FormatString("%12s %14s %14s  %s\n", "calls", "inclusive ms", "exclusive ms", "frame");
+		for (const auto& [key, total] : sorted)
+		{
+			summary << FormatString("%12llu %14.3f %14.3f  %s\n", total.calls, (double)total.inclusive / ticksPerMicrosecond / 1000.0,
+				(double)total.exclusive / ticksPerMicrosecond / 1000.0, getName(key).c_str());
+		}
+		return true;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+// Optional instrumentation profiler for script execution, controlled by StartScriptProfiler, StopScriptProfiler and
+// DumpScriptProfile. Scopes around script runs, expression evaluation, UDF calls, event dispatch and command execution
+// build a call tree per thread that records calls, inclusive and exclusive time per frame.
+// While the profiler is stopped a scope costs a load and a branch.
+// Commands the game's script runner executes have no NVSE call site around them: their frame is opened when they
+// extract their arguments (OtherHooks::EnterCommandFrame, from vExtractArgsEx and ExpressionEvaluator) and closed by
+// the next such command of the run or when the script returns, so runner time up to the next command, vanilla commands
+// in between included, counts to the previous one.
+namespace ScriptProfiler
+{
+	enum FrameKind : UInt8
+	{
+		kFrame_Script = 1,	// id is the script's refID; a run of the script by the game's script runner
+		kFrame_Expression,	// id is the script's refID; ExpressionEvaluator::Evaluate
+		kFrame_Function,	// id is the UDF's refID
+		kFrame_Event,		// id is the event name (EventInfo::evName, stable for the lifetime of the game)
+		kFrame_Command,		// id is the opcode
+	};
+
+	extern bool g_enabled;
+
+	// Clears all recorded times (frames open at this point still count from their start) and starts recording.
+	void Start();
+	void Stop();
+
+	// Writes ScriptProfiles/<name>.folded, collapsed stacks weighted by exclusive microseconds for flame graph tools,
+	// and ScriptProfiles/<name>.txt, per-frame totals sorted by exclusive time.
+	bool Dump(const char* name);
+
+	void EnterFrame(FrameKind kind, UInt32 id);
+	void LeaveFrame();
+
+	// Frames open on the calling thread.
+	UInt32 GetDepth();
+
+	class Scope
+	{
+		bool	m_active;
+
+	public:
+		Scope(FrameKind kind, UInt32 id) : m_active(g_enabled)
+		{
+			if (m_active)
+				EnterFrame(kind, id);
+		}
+		~Scope()
+		{
+			if (m_active)
+				LeaveFrame();
+		}
+	};
+}
@@ -91,6 +91,64 @@ void TokenCache::MarkForClear()
 std::atomic<int> TokenCache::tlsClearAllCookie_ = 0;
 thread_local int TokenCache::tlsClearAllToken_ = 0;
 
+void ScriptLineIndex::Update(Script* script)
+{
+	// rebuilt if the script was recompiled since the index was built
+	if (data_ == script->data && dataLength_ == script->info.dataLength)
+		return;
+	lines_.Clear();
+	data_ = script->data;
+	dataLength_ = script->info.dataLength;
+	if (!data_)
+		return;
+
+	UInt32 offset = 0;
+	for (ScriptParsing::ScriptIterator iter(script); !iter.End(); ++iter)
+	{
+		const UInt32 dataOffset = iter.startData - script->data;
+		lines_.Append(Line{ offset, dataOffset, iter.opcode, iter.length, iter.refIdx });
+		offset = dataOffset + iter.length;
+	}
+}
+
+std::optional<ScriptLineIndex::Line> ScriptLineIndex::FindLine(Script* script, UInt32 offset)
+{
+	ScopedLock lock(lock_);
+	Update(script);
+	// last line starting at or before offset
+	UInt32 lBound = 0, uBound = lines_.Size();
+	while (lBound < uBound)
+	{
+		const UInt32 index = (lBound + uBound) >> 1;
+		if (lines_[index].offset <= offset)
+			lBound = index + 1;
+		else
+			uBound = index;
+	}
+	if (!lBound)
+		return std::nullopt;
+	const auto& line = lines_[lBound - 1];
+	if (offset >= line.dataOffset + line.length)
+		return std::nullopt;
+	return line;
+}
+
+ScriptParsing::ScriptIterator ScriptLineIndex::GetIterator(Script* script, const Line& line)
+{
+	return ScriptParsing::ScriptIterator(script, line.opcode, line.length, line.refIdx, script->data + line.dataOffset);
+}
+
+std::string ScriptLineIndex::GetLineText(Script* script, UInt32 offset)
+{
+	if (!script || !script->data)
+		return {};
+	const auto line = ScriptTokenCacheFormExtraData::Get(script)->lineIndex.FindLine(script, offset);
+	if (!line)
+		return {};
+	const auto parsed = ScriptParsing::ScriptAnalyzer::ParseLine(GetIterator(script, *line));
+	return parsed && !parsed->error ? parsed->ToString() : std::string();
+}
+
 ScriptTokenCacheFormExtraData::ScriptTokenCacheFormExtraData() : FormExtraData(GetName()) {
 }
 
@@ -2,7 +2,9 @@
 #include "containers.h"
 #include "ScriptTokens.h"
 #include <atomic>
+#include <optional>
 #include "FormExtraData.h"
+#include "common/ICriticalSection.h"
 
 
 struct TokenCacheEntry
@@ -43,6 +45,35 @@ public:
 	static void MarkForClear();
 };
 
+// Start offsets of every compiled statement of a script, in bytecode order.
+// Lets runtime error reporting find the line at a data offset without running a ScriptAnalyzer over the whole script.
+// Scripts can error on any thread running them, so lookups are locked and hand out a copy of the line.
+class ScriptLineIndex
+{
+public:
+	struct Line
+	{
+		UInt32	offset;		// offset of the statement header
+		UInt32	dataOffset;	// offset of the statement arguments, i.e. ScriptIterator::startData
+		UInt16	opcode;
+		UInt16	length;
+		UInt16	refIdx;
+	};
+
+	[[nodiscard]] std::optional<Line> FindLine(Script* script, UInt32 offset);
+	[[nodiscard]] static ScriptParsing::ScriptIterator GetIterator(Script* script, const Line& line);
+	// decompiled statement at an offset into script->data, empty if it cannot be found or decompiled
+	[[nodiscard]] static std::string GetLineText(Script* script, UInt32 offset);
+
+private:
+	Vector<Line> lines_;
+	const UInt8* data_ = nullptr;
+	UInt32 dataLength_ = 0;
+	ICriticalSection lock_;
+
+	void Update(Script* script);
+};
+
 class ScriptTokenCacheFormExtraData : public FormExtraData
 {
 public:
@@ -50,6 +81,7 @@ public:
 	virtual ~ScriptTokenCacheFormExtraData() override = default;
 
 	TokenCache cache;
+	ScriptLineIndex lineIndex;
 
 	static ScriptTokenCacheFormExtraData* Create();
 	static ScriptTokenCacheFormExtraData* Get(Script* script);
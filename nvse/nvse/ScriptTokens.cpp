@@ -1747,16 +1747,24 @@ bool ArrayElementToken::GetBool() const
 	if (!arr)
 		return false;
 
-	ArrayElement* elem = arr->Get(&key, false);
-	if (!elem)
+	// typed getters rather than Get(), which would unpack arrays that store plain numbers
+	switch (arr->GetElementType(&key))
+	{
+	case kDataType_Numeric:
+	{
+		double num = 0;
+		arr->GetElementNumber(&key, &num);
+		return num != 0;
+	}
+	case kDataType_Form:
+	{
+		UInt32 formID = 0;
+		arr->GetElementFormID(&key, &formID);
+		return formID != 0;
+	}
+	default:
 		return false;
-
-	if (elem->DataType() == kDataType_Numeric)
-		return elem->m_data.num != 0;
-	if (elem->DataType() == kDataType_Form)
-		return elem->m_data.formID != 0;
-
-	return false;
+	}
 }
 
 ArrayID ArrayElementToken::GetArrayID() const
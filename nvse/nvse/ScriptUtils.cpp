@@ -25,6 +25,7 @@
 #include "ScriptAnalyzer.h"
 #include "StackVariables.h"
 #include "Hooks_Other.h"
+#include "ScriptProfiler.h"
 #include "Compiler/Utils.h"
 
 std::map<std::pair<Script*, std::string>, Script::VariableType> g_variableDefinitionsMap;
@@ -38,6 +39,7 @@ SInt32 FUNCTION_CONTEXT_COUNT = 0;
 #include "GameData.h"
 #include "common/ICriticalSection.h"
 #include "ThreadLocal.h"
+#include "ScriptTokenCache.h"
 #include "PluginManager.h"
 #include "SmallObjectsAllocator.h"
 
@@ -229,14 +231,15 @@ std::unique_ptr<ScriptToken> Eval_Eq_Array(OperatorType op, ScriptToken *lh, Scr
 
 std::unique_ptr<ScriptToken> Eval_Eq_String(OperatorType op, ScriptToken *lh, ScriptToken *rh, ExpressionEvaluator *context)
 {
-	const char *lhs = lh->GetString();
-	const char *rhs = rh->GetString();
+	// string vars assigned the same interned string are equal without looking at it
+	const StringVar *lhStrVar = lh->GetStringVar(), *rhStrVar = rh->GetStringVar();
+	bool isEqual = (lhStrVar && rhStrVar && lhStrVar->SharesString(*rhStrVar)) || !StrCompare(lh->GetString(), rh->GetString());
 	switch (op)
 	{
 	case kOpType_Equals:
-		return ScriptToken::Create(!StrCompare(lhs, rhs));
+		return ScriptToken::Create(isEqual);
 	case kOpType_NotEqual:
-		return ScriptToken::Create(StrCompare(lhs, rhs) != 0);
+		return ScriptToken::Create(!isEqual);
 	default:
 		context->Error("Unhandled operator %s", OpTypeToSymbol(op));
 		return nullptr;
@@ -817,12 +820,12 @@ std::unique_ptr<ScriptToken> Eval_PlusEquals_Elem_Number(OperatorType op, Script
 	const ArrayKey *key = lh->GetArrayKey();
 	if (key)
 	{
-		ArrayElement *elem = g_ArrayMap.GetElement(lh->GetOwningArrayID(), key);
+		ArrayVar *arr = g_ArrayMap.Get(lh->GetOwningArrayID());
 		double elemVal;
-		if (elem && elem->GetAsNumber(&elemVal))
+		if (arr && arr->GetElementNumber(key, &elemVal))
 		{
 			elemVal += rh->GetNumber();
-			elem->SetNumber(elemVal);
+			arr->SetElementNumber(key, elemVal);
 			return ScriptToken::Create(elemVal);
 		}
 	}
@@ -835,12 +838,12 @@ std::unique_ptr<ScriptToken> Eval_MinusEquals_Elem_Number(OperatorType op, Scrip
 	const ArrayKey *key = lh->GetArrayKey();
 	if (key)
 	{
-		ArrayElement *elem = g_ArrayMap.GetElement(lh->GetOwningArrayID(), key);
+		ArrayVar *arr = g_ArrayMap.Get(lh->GetOwningArrayID());
 		double elemVal;
-		if (elem && elem->GetAsNumber(&elemVal))
+		if (arr && arr->GetElementNumber(key, &elemVal))
 		{
 			elemVal -= rh->GetNumber();
-			elem->SetNumber(elemVal);
+			arr->SetElementNumber(key, elemVal);
 			return ScriptToken::Create(elemVal);
 		}
 	}
@@ -853,12 +856,12 @@ std::unique_ptr<ScriptToken> Eval_TimesEquals_Elem(OperatorType op, ScriptToken
 	const ArrayKey *key = lh->GetArrayKey();
 	if (key)
 	{
-		ArrayElement *elem = g_ArrayMap.GetElement(lh->GetOwningArrayID(), key);
+		ArrayVar *arr = g_ArrayMap.Get(lh->GetOwningArrayID());
 		double elemVal;
-		if (elem && elem->GetAsNumber(&elemVal))
+		if (arr && arr->GetElementNumber(key, &elemVal))
 		{
 			elemVal *= rh->GetNumber();
-			elem->SetNumber(elemVal);
+			arr->SetElementNumber(key, elemVal);
 			return ScriptToken::Create(elemVal);
 		}
 	}
@@ -871,15 +874,15 @@ std::unique_ptr<ScriptToken> Eval_DividedEquals_Elem(OperatorType op, ScriptToke
 	const ArrayKey *key = lh->GetArrayKey();
 	if (key)
 	{
-		ArrayElement *elem = g_ArrayMap.GetElement(lh->GetOwningArrayID(), key);
+		ArrayVar *arr = g_ArrayMap.Get(lh->GetOwningArrayID());
 		double elemVal;
-		if (elem && elem->GetAsNumber(&elemVal))
+		if (arr && arr->GetElementNumber(key, &elemVal))
 		{
 			const double result = rh->GetNumber();
 			if (result != 0.0)
 			{
 				elemVal /= result;
-				elem->SetNumber(elemVal);
+				arr->SetElementNumber(key, elemVal);
 				return ScriptToken::Create(elemVal);
 			}
 			context->Error("Division by zero");
@@ -894,12 +897,12 @@ std::unique_ptr<ScriptToken> Eval_ExponentEquals_Elem(OperatorType op, ScriptTok
 	const ArrayKey *key = lh->GetArrayKey();
 	if (key)
 	{
-		ArrayElement *elem = g_ArrayMap.GetElement(lh->GetOwningArrayID(), key);
+		ArrayVar *arr = g_ArrayMap.Get(lh->GetOwningArrayID());
 		double elemVal;
-		if (elem && elem->GetAsNumber(&elemVal))
+		if (arr && arr->GetElementNumber(key, &elemVal))
 		{
 			const double result = pow(elemVal, rh->GetNumber());
-			elem->SetNumber(result);
+			arr->SetElementNumber(key, result);
 			return ScriptToken::Create(result);
 		}
 	}
@@ -912,16 +915,16 @@ std::unique_ptr<ScriptToken> Eval_HandleEquals_Elem(OperatorType op, ScriptToken
 	const ArrayKey *const key = lh->GetArrayKey();
 	if (key)
 	{
-		ArrayElement *const elem = g_ArrayMap.GetElement(lh->GetOwningArrayID(), key);
+		ArrayVar *const arr = g_ArrayMap.Get(lh->GetOwningArrayID());
 		double l;
-		if (elem && elem->GetAsNumber(&l))
+		if (arr && arr->GetElementNumber(key, &l))
 		{
 			const double r = rh->GetNumber();
 			bool hasError;
 			double const result = Apply_LeftVal_RightVal_Operator(op, l, r, context, hasError);
 			if (!hasError)
 			{
-				elem->SetNumber(result);
+				arr->SetElementNumber(key, result);
 				return ScriptToken::Create(result);
 			}
 			return nullptr;
@@ -1814,6 +1817,15 @@ void ExpressionEvaluator::PrintStackTrace()
 		sprintf_s(output, sizeof(output), "  %s @%04X script %08X", cmd ? cmd->longName : "<unknown>", eval->m_baseOffset, eval->script->refID);
 		_MESSAGE(output);
 		Console_Print(output);
+		// the frame's statement, looked up in the script's line index rather than decompiled from its tokens
+		if (eval->m_scriptData == eval->script->data)
+		{
+			if (const auto lineText = ScriptLineIndex::GetLineText(eval->script, eval->m_baseOffset); !lineText.empty())
+			{
+				_MESSAGE("    %s", lineText.c_str());
+				Console_Print_Long("    " + lineText);
+			}
+		}
 
 		eval = eval->m_parent;
 	}
@@ -3897,6 +3909,10 @@ ExpressionEvaluator::ExpressionEvaluator(COMMAND_ARGS) : m_opcodeOffsetPtr(opcod
 	m_flags.Clear();
 
 	PushOnStack();
+
+	// commands that take expressions (Let, If eval, ...) never reach vExtractArgsEx
+	if (ScriptProfiler::g_enabled)
+		OtherHooks::EnterCommandFrame(*OtherHooks::GetExecutingScriptContext(), m_scriptData + m_baseOffset);
 }
 
 ExpressionEvaluator::~ExpressionEvaluator()
@@ -3911,13 +3927,17 @@ ExpressionEvaluator::~ExpressionEvaluator()
 		delete m_args[i];
 	}
 
+	UInt32 numSuppressed = 0;
 	if (!this->errorMessages.empty())
 	{
+		const bool show = RuntimeErrorThrottle::Register(script, m_baseOffset, numSuppressed);
 		std::string error;
 		for (const auto &msg : errorMessages)
 		{
 			error += msg + '\n';
 		}
+		if (numSuppressed)
+			error += FormatString("(%u identical error(s) suppressed since last report)\n", numSuppressed);
 		error.pop_back(); // remove last "\n"
 		// include script data offset and command name/opcode
 		CommandInfo *cmd = GetCommand();
@@ -3925,9 +3945,14 @@ ExpressionEvaluator::~ExpressionEvaluator()
 		// include mod filename, save having to ask users to figure it out themselves
 		const char *modName = GetModName(script);
 
-		ShowRuntimeError(script, "%s\n    File: %s Offset: 0x%04X Command: %s", error.c_str(), modName, m_baseOffset, cmd ? cmd->longName : "<unknown>");
-		if (m_flags.IsSet(kFlag_StackTraceOnError))
-			PrintStackTrace();
+		if (show)
+		{
+			ShowRuntimeError(script, "%s\n    File: %s Offset: 0x%04X Command: %s", error.c_str(), modName, m_baseOffset, cmd ? cmd->longName : "<unknown>");
+			if (m_flags.IsSet(kFlag_StackTraceOnError))
+				PrintStackTrace();
+		}
+		else
+			NotifyRuntimeError("%s\n    File: %s Offset: 0x%04X Command: %s", error.c_str(), modName, m_baseOffset, cmd ? cmd->longName : "<unknown>");
 	}
 }
 
@@ -4783,7 +4808,11 @@ std::unique_ptr<ScriptToken> ExpressionEvaluator::ExecuteCommandToken(ScriptToke
 	CommandReturnType retnType = token->returnType;
 
 	ExpectReturnType(kRetnType_Default); // expect default return type unless called command specifies otherwise
-	const bool bExecuted = cmdInfo->execute(cmdInfo->params, m_scriptData, callingObj, contObj, script, eventList, &cmdResult, &opcodeOffset);
+	bool bExecuted;
+	{
+		ScriptProfiler::Scope profilerScope(ScriptProfiler::kFrame_Command, cmdInfo->opcode);
+		bExecuted = cmdInfo->execute(cmdInfo->params, m_scriptData, callingObj, contObj, script, eventList, &cmdResult, &opcodeOffset);
+	}
 
 	if (!bExecuted)
 	{
@@ -4998,6 +5027,7 @@ ScriptToken *ExpressionEvaluator::Evaluate()
 	if (!cachePtr)
 		return nullptr;
 	auto& cache = *cachePtr;
+	ScriptProfiler::Scope profilerScope(ScriptProfiler::kFrame_Expression, script->refID);
 #if _DEBUG && 0
 	g_curLineText = this->GetLineText(cache, nullptr);
 #endif
@@ -5095,7 +5125,8 @@ ScriptToken *ExpressionEvaluator::Evaluate()
 	if (operands.Size() != 1 || (this->HasErrors() && !m_flags.IsSet(kFlag_SuppressErrorMessages))) // should have one operand remaining - result of expression
 	{
 		auto* faultingToken = !iter.End() ? iter.Get().token : nullptr;
-		const auto currentLine = this->GetLineText(cache, faultingToken);
+		// approximating the line is expensive and the error will be swallowed anyway if it repeats every frame
+		const auto currentLine = !RuntimeErrorThrottle::IsThrottled(script, m_baseOffset) ? this->GetLineText(cache, faultingToken) : std::string();
 		if (!currentLine.empty())
 		{
 			auto* cmd = GetCommand();
@@ -5125,6 +5156,12 @@ ScriptToken *ExpressionEvaluator::Evaluate()
 
 std::string ExpressionEvaluator::GetLineText()
 {
+	// statements of the script's own data are in its line index; plugin and inline evaluators read data of their own
+	if (script && m_scriptData == script->data)
+	{
+		if (auto lineText = ScriptLineIndex::GetLineText(script, m_baseOffset); !lineText.empty())
+			return lineText;
+	}
 	ResetCursor();
 	const UInt32 numArgs = ReadByte();
 	std::string lineText;
@@ -3,6 +3,7 @@
 #include <stdexcept>
 
 #include "Core_Serialization.h"
+#include "common/IDirectoryIterator.h"
 #include "common/IFileStream.h"
 #include "PluginManager.h"
 #include "GameAPI.h"
@@ -19,62 +20,25 @@ namespace Serialization
 static UInt32	kNvseOpcodeBase = 0x1400;
 static std::string	g_savePath;
 static UInt32 g_lastLoadSize = 0x40000;
-
-// file format internals
-
-//	general format:
-//	Header			header
-//		PluginHeader	plugin[header.numPlugins]
-//			ChunkHeader		chunk[plugin.numChunks]
-//				UInt8			data[chunk.length]
-	
-struct Header
-{
-	enum
-	{
-		kSignature =		MACRO_SWAP32('NVSE'),	// endian-swapping so the order matches
-		kVersion =			1,
-
-		kVersion_Invalid =	0
-	};
-
-	UInt32	signature;
-	UInt32	formatVersion;
-	UInt16	nvseVersion;
-	UInt16	nvseMinorVersion;
-	UInt32	falloutVersion;
-	UInt32	numPlugins;
-};
-
-struct PluginHeader
-{
-	UInt32	opcodeBase;
-	UInt32	numChunks;
-	UInt32	length;		// length of following data including ChunkHeader
-};
-
-struct ChunkHeader
-{
-	UInt32	type;
-	UInt32	version;
-	UInt32	length;
-};
+bool g_parallelPluginSaves = false;
 
 SerializationTask s_serializationTask;
 
 typedef std::vector <PluginCallbacks>	PluginCallbackList;
 PluginCallbackList	s_pluginCallbacks;
 
-PluginHandle	s_currentPlugin = 0;
-
 Header			s_fileHeader = { 0 };
 
-UInt32			s_pluginHeaderOffset = 0;
-PluginHeader	s_pluginHeader = { 0 };
+// records being read, writing keeps its own state (see SavePlugins)
+constexpr UInt32	kNoLoadPlugin = 0xFFFFFFFF;
+CosaveIndex		s_cosaveIndex;
+CosaveIndex		*s_readIndex = &s_cosaveIndex;	// the one of a delta base file while LoadDeltaBase runs
+UInt32			s_loadPlugin = kNoLoadPlugin;	// in s_cosaveIndex, of the plugin whose load callback is running, or kNoLoadPlugin
+UInt32			s_nextChunk = 0;			// next one GetNextRecordInfo returns, up to s_endChunk
+UInt32			s_endChunk = 0;
 
 bool			s_chunkOpen = false;
 bool			ignoreNextChunk = false;	// if true do not complain the plugin left data behind (it ws preloaded)
-UInt32			s_chunkHeaderOffset = 0;
 ChunkHeader		s_chunkHeader = { 0 };
 
 bool			s_preloading = false;		// if true, we are reading co-save *before* savegame begins to load
@@ -127,6 +91,15 @@ void SetSaveCallback(PluginHandle plugin, NVSESerializationInterface::EventCallb
 	InternalSetSaveCallback(plugin, callback);
 }
 
+void SetThreadSafeSaveCallback(PluginHandle plugin, NVSESerializationInterface::EventCallback callback)
+{
+	ASSERT(plugin);
+	ASSERT(plugin <= g_pluginManager.GetNumPlugins());
+
+	InternalSetSaveCallback(plugin, callback);
+	s_pluginCallbacks[plugin].saveThreadSafe = true;
+}
+
 void SetLoadCallback(PluginHandle plugin, NVSESerializationInterface::EventCallback callback)
 {
 	ASSERT(plugin);
@@ -157,6 +130,7 @@ void InternalSetSaveCallback(PluginHandle plugin, NVSESerializationInterface::Ev
 		s_pluginCallbacks.resize(plugin + 1);
 
 	s_pluginCallbacks[plugin].save = callback;
+	s_pluginCallbacks[plugin].saveThreadSafe = false;
 }
 
 void InternalSetLoadCallback(PluginHandle plugin, NVSESerializationInterface::EventCallback callback)
@@ -188,35 +162,52 @@ void InternalSetPreLoadCallback(PluginHandle plugin, NVSESerializationInterface:
 
 void SerializationTask::PrepareSave()
 {
-	this->length = 0;
-	this->bufferSize = max(g_lastLoadSize, 0x40000);
-	this->bufferStart = std::make_unique<UInt8[]>(bufferSize);
-	this->bufferPtr = this->bufferStart.get();
+	Allocate(max(g_lastLoadSize, 0x40000));
 }
 
 bool SerializationTask::Save()
 {
 	if (!GetOffset()) return false;
 
-	HANDLE saveFile = CreateFile(g_savePath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	const bool saved = SaveFile(g_savePath.c_str());
+
+	Unload();
+
+	return saved;
+}
+
+bool SerializationTask::SaveFile(const char* path)
+{
+	HANDLE saveFile = CreateFile(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
 	if (saveFile == INVALID_HANDLE_VALUE)
 	{
-		_ERROR("HandleSaveGame: couldn't create save file (%s)", g_savePath.c_str());
+		_ERROR("HandleSaveGame: couldn't create save file (%s)", path);
 		return false;
 	}
-	UInt32 numBytesWritten;
+	UInt32 numBytesWritten = 0;
 	WriteFile(saveFile, bufferStart.get(), this->length, &numBytesWritten, NULL);
 	CloseHandle(saveFile);
 
-	Unload();
-
-	return true;
+	return numBytesWritten == this->length;
 }
 	
+// The cosave is read whole, once per pass, not streamed chunk by chunk: the index needs every header before a callback
+// runs, PeekRecordData and FindRecord go back over data already read, and the preload and load passes read it again.
 bool SerializationTask::Load()
 {
 	g_showFileSizeWarning = false;
-	HANDLE saveFile = CreateFile(g_savePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (!LoadFile(g_savePath.c_str()))
+		return false;
+
+	if (this->bufferSize >= 0x400000 && !g_noSaveWarnings)
+		g_showFileSizeWarning = true;
+	g_lastLoadSize = this->bufferSize;
+	return true;
+}
+
+bool SerializationTask::LoadFile(const char* path)
+{
+	HANDLE saveFile = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
 	if (saveFile == INVALID_HANDLE_VALUE)
 		return false;
 
@@ -225,12 +216,13 @@ bool SerializationTask::Load()
 	this->bufferSize = fileSize;
 	this->bufferStart = std::make_unique<UInt8[]>(bufferSize);
 	this->bufferPtr = this->bufferStart.get();
-	ReadFile(saveFile, bufferStart.get(), bufferSize, &this->length, NULL);
+	if (!ReadFile(saveFile, bufferStart.get(), bufferSize, &this->length, NULL) || (this->length != bufferSize))
+	{
+		_ERROR("SerializationTask::Load: could only read %d of %d bytes", this->length, bufferSize);
+		this->bufferSize = this->length = 0;
+	}
 	CloseHandle(saveFile);
 
-	if (this->bufferSize >= 0x400000 && !g_noSaveWarnings)
-		g_showFileSizeWarning = true;
-	g_lastLoadSize = this->bufferSize;
 	return bufferSize > 0;
 }
 
@@ -241,310 +233,56 @@ void SerializationTask::Unload()
 	this->bufferSize = 0;
 }
 
-UInt32 SerializationTask::GetOffset() const
-{
-	return (UInt32)(bufferPtr - bufferStart.get());
-}
-
-void SerializationTask::SetOffset(UInt32 offset)
-{
-	if (offset > bufferSize)
-		Resize(offset);
-	bufferPtr = bufferStart.get() + offset;
-}
-
-void SerializationTask::Skip(UInt32 size, bool read)
-{
-	if (read)
-		ValidateOffset(size);
-	else
-		CheckResize(size);
-	bufferPtr += size;
-}
-
-void SerializationTask::Write8(UInt8 inData)
-{
-	CheckResize(sizeof(UInt8));
-	*bufferPtr++ = inData;
-	length += 1;
-}
-
-void SerializationTask::Write16(UInt16 inData)
-{
-	CheckResize(sizeof(UInt16));
-	*(UInt16*)bufferPtr = inData;
-	bufferPtr += 2;
-	length += 2;
-}
-
-void SerializationTask::Write32(UInt32 inData)
-{
-	CheckResize(sizeof(UInt32));
-	*(UInt32*)bufferPtr = inData;
-	bufferPtr += 4;
-	length += 4;
-}
-
-void SerializationTask::Write64(const void *inData)
-{
-	CheckResize(sizeof(double));
-	*(double*)bufferPtr = *(double*)inData;
-	bufferPtr += 8;
-	length += 8;
-}
-
-void SerializationTask::WriteBuf(const void *inData, UInt32 size)
-{
-	CheckResize(size);
-	switch (size)
-	{
-		case 0:
-			return;
-		case 1:
-			*bufferPtr = *(UInt8*)inData;
-			break;
-		case 2:
-			*(UInt16*)bufferPtr = *(UInt16*)inData;
-			break;
-		case 3:
-		case 4:
-			*(UInt32*)bufferPtr = *(UInt32*)inData;
-			break;
-		case 8:
-			*(double*)bufferPtr = *(double*)inData;
-			break;
-		default:
-			memcpy(bufferPtr, inData, size);
-			break;
-	}
-	bufferPtr += size;
-	this->length += size;
-}
-
-void SerializationTask::Resize(UInt32 size)
-{
-	auto newLen = this->bufferSize * 2;
-	while (newLen < size)
-		newLen *= 2;
-	const auto offset = this->GetOffset();
-	auto newBuf = std::make_unique<UInt8[]>(newLen);
-	std::memcpy(newBuf.get(), this->bufferStart.get(), this->bufferSize);
-	this->bufferSize = newLen;
-	this->bufferStart = std::move(newBuf);
-	this->bufferPtr = this->bufferStart.get() + offset;
-}
-
-void SerializationTask::CheckResize(UInt32 size)
-{
-	if (GetOffset() + size > this->bufferSize)
-		Resize(size);
-}
-
-UInt8 SerializationTask::Read8()
-{
-	ValidateOffset(1);
-	UInt8 result = *bufferPtr;
-	bufferPtr++;
-	return result;
-}
-
-UInt16 SerializationTask::Read16()
-{
-	ValidateOffset(2);
-	UInt16 result = *(UInt16*)bufferPtr;
-	bufferPtr += 2;
-	return result;
-}
-
-UInt32 SerializationTask::Read32()
-{
-	ValidateOffset(4);
-	UInt32 result = *(UInt32*)bufferPtr;
-	bufferPtr += 4;
-	return result;
-}
-
-void SerializationTask::Read64(void *outData)
-{
-	ValidateOffset(8);
-	*(double*)outData = *(double*)bufferPtr;
-	bufferPtr += 8;
-}
-
-void SerializationTask::ReadBuf(void *outData, UInt32 size)
-{
-	ValidateOffset(size);
-	switch (size)
-	{
-		case 0:
-			return;
-		case 1:
-			*(UInt8*)outData = *bufferPtr;
-			break;
-		case 2:
-			*(UInt16*)outData = *(UInt16*)bufferPtr;
-			break;
-		case 3:
-		case 4:
-			*(UInt32*)outData = *(UInt32*)bufferPtr;
-			break;
-		case 8:
-			*(double*)outData = *(double*)bufferPtr;
-			break;
-		default:
-			memcpy(outData, bufferPtr, size);
-			break;
-	}
-	bufferPtr += size;
-}
-
-void SerializationTask::PeekBuf(void *outData, UInt32 size)
-{
-	ValidateOffset(size);
-	switch (size)
-	{
-		case 0:
-			return;
-		case 1:
-			*(UInt8*)outData = *bufferPtr;
-			break;
-		case 2:
-			*(UInt16*)outData = *(UInt16*)bufferPtr;
-			break;
-		case 3:
-		case 4:
-			*(UInt32*)outData = *(UInt32*)bufferPtr;
-			break;
-		default:
-			memcpy(outData, bufferPtr, size);
-			break;
-	}
-}
-
-void SerializationTask::ValidateOffset(UInt32 size) const
-{
-	if (GetOffset() + size > this->bufferSize)
-	{
-		throw std::out_of_range("");
-	}
-}
-
 //==========================================================================
 
-bool WriteRecord(UInt32 type, UInt32 version, const void * buf, UInt32 length)
-{
-	if (!OpenRecord(type, version)) return false;
-
-	return WriteRecordData(buf, length);
-}
-
-// flush a chunk header to the file if one is currently open
-static void FlushWriteChunk(void)
-{
-	if (!s_chunkOpen)
-		return;
-
-	UInt32 curOffset = s_serializationTask.GetOffset();
-	UInt32 chunkSize = curOffset - s_chunkHeaderOffset - sizeof(s_chunkHeader);
-
-	ASSERT(chunkSize < 0x80000000);	// stupidity check
-
-	s_chunkHeader.length = chunkSize;
-
-	s_serializationTask.SetOffset(s_chunkHeaderOffset);
-	s_serializationTask.WriteBuf(&s_chunkHeader, sizeof(s_chunkHeader));
-
-	s_serializationTask.SetOffset(curOffset);
-
-	s_pluginHeader.length += chunkSize + sizeof(s_chunkHeader);
-
-	s_chunkOpen = false;
-}
-
-bool OpenRecord(UInt32 type, UInt32 version)
+static void FlushReadRecord(void)
 {
-	if(!s_pluginHeader.numChunks)
+	if(s_chunkOpen)
 	{
-		ASSERT(!s_chunkOpen);
+		// the next chunk is found through the index, nothing left here needs skipping
+		if(s_chunkHeader.length && !ignoreNextChunk)
+			_WARNING("plugin didn't finish reading chunk");
 
-		s_pluginHeaderOffset = s_serializationTask.GetOffset();
-		s_serializationTask.Skip(sizeof(s_pluginHeader), false);
+		s_chunkOpen = false;
 	}
-
-	FlushWriteChunk();
-
-	s_chunkHeaderOffset = s_serializationTask.GetOffset();
-	s_serializationTask.Skip(sizeof(s_chunkHeader), false);
-
-	s_pluginHeader.numChunks++;
-
-	s_chunkHeader.type = type;
-	s_chunkHeader.version = version;
-	s_chunkHeader.length = 0;
-
-	s_chunkOpen = true;
-
-	return true;
 }
 
-bool WriteRecordData(const void * buf, UInt32 length)
+static void OpenReadRecord(UInt32 chunk, UInt32 * type, UInt32 * version, UInt32 * length)
 {
-	s_serializationTask.WriteBuf(buf, length);
+	const CosaveIndex::Chunk &indexed = s_readIndex->GetChunk(chunk);
+	s_serializationTask.SetOffset(indexed.dataOffset);
+	s_chunkHeader = {indexed.type, indexed.version, indexed.length};
+	s_nextChunk = chunk + 1;
 
-	return true;
-}
+	*type =		s_chunkHeader.type;
+	*version =	s_chunkHeader.version;
+	*length =	s_chunkHeader.length;
 
-void WriteRecord8(UInt8 inData)
-{
-	s_serializationTask.Write8(inData);
+	s_chunkOpen = true;
 }
 
-void WriteRecord16(UInt16 inData)
+bool GetNextRecordInfo(UInt32 * type, UInt32 * version, UInt32 * length)
 {
-	s_serializationTask.Write16(inData);
-}
+	FlushReadRecord();
 
-void WriteRecord32(UInt32 inData)
-{
-	s_serializationTask.Write32(inData);
-}
+	if(s_nextChunk >= s_endChunk)
+		return false;
 
-void WriteRecord64(const void *inData)
-{
-	s_serializationTask.Write64(inData);
-}
+	OpenReadRecord(s_nextChunk, type, version, length);
 
-static void FlushReadRecord(void)
-{
-	if(s_chunkOpen)
-	{
-		if(s_chunkHeader.length)
-		{
-			if (!ignoreNextChunk)
-				_WARNING("plugin didn't finish reading chunk");
-			s_serializationTask.Skip(s_chunkHeader.length, true);
-		}
-
-		s_chunkOpen = false;
-	}
+	return true;
 }
 
-bool GetNextRecordInfo(UInt32 * type, UInt32 * version, UInt32 * length)
+bool FindRecord(UInt32 type, UInt32 * version, UInt32 * length)
 {
-	FlushReadRecord();
-
-	if(!s_pluginHeader.numChunks)
+	UInt32 chunk = s_readIndex->Find(s_loadPlugin, type);
+	if(chunk == CosaveIndex::kNoChunk)
 		return false;
 
-	s_pluginHeader.numChunks--;
-
-	s_serializationTask.ReadBuf(&s_chunkHeader, sizeof(s_chunkHeader));
-
-	*type =		s_chunkHeader.type;
-	*version =	s_chunkHeader.version;
-	*length =	s_chunkHeader.length;
+	FlushReadRecord();
 
-	s_chunkOpen = true;
+	UInt32 foundType;
+	OpenReadRecord(chunk, &foundType, version, length);
 
 	return true;
 }
@@ -620,7 +358,7 @@ void SkipNBytes(UInt32 byteNum)
 	if (byteNum > s_chunkHeader.length)
 		byteNum = s_chunkHeader.length;
 
-	s_serializationTask.Skip(byteNum, false);
+	s_serializationTask.Skip(byteNum, true);
 
 	s_chunkHeader.length -= byteNum;
 }
@@ -663,6 +401,151 @@ bool ResolveRefID(UInt32 refID, UInt32 * outRefID)
 	return true;
 }
 
+//==========================================================================
+
+static UInt64 s_lastDeltaBaseID = 0;
+static UInt64 s_missingDeltaBaseID = 0;	// of the base file the cosave being loaded needed and couldn't load, shown after
+
+static std::string GetDeltaBasePath(UInt64 baseID)
+{
+	char name[0x40];
+	sprintf_s(name, "nvse_base_%016llX.nvsb", baseID);
+	return GetSavegamePath() + name;
+}
+
+// A delta cosave starts with the core plugin's 'VDLT' record, which holds the ID of its base file.
+static void DeleteUnusedDeltaBases(UInt64 keepID)
+{
+	const std::string saveDir = GetSavegamePath();
+	std::unordered_set<UInt64> usedIDs;
+	for (IDirectoryIterator iter(saveDir.c_str(), "*.nvse*"); !iter.Done(); iter.Next())
+	{
+		HANDLE file = CreateFile(iter.GetFullPath().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			continue;
+		struct
+		{
+			Header			header;
+			PluginHeader	plugin;
+			ChunkHeader		chunk;
+			UInt64			baseID;
+		} start;
+		UInt32 numRead = 0;
+		if (ReadFile(file, &start, sizeof(start), &numRead, NULL) && (numRead == sizeof(start)) &&
+			(start.header.signature == Header::kSignature) && (start.plugin.opcodeBase == kNvseOpcodeBase) &&
+			(start.chunk.type == 'VDLT'))
+			usedIDs.insert(start.baseID);
+		CloseHandle(file);
+	}
+
+	for (IDirectoryIterator iter(saveDir.c_str(), "nvse_base_*.nvsb"); !iter.Done(); iter.Next())
+	{
+		const UInt64 baseID = _strtoui64(iter.Get()->cFileName + 10, nullptr, 16);
+		if ((baseID != keepID) && !usedIDs.contains(baseID))
+		{
+			_MESSAGE("deleting unused delta cosave base %s", iter.Get()->cFileName);
+			DeleteFile(iter.GetFullPath().c_str());
+		}
+	}
+}
+
+UInt64 SaveDeltaBase(UInt32 start)
+{
+	SerializationTask base;
+	if (!CopyWrittenRecords(base, s_fileHeader, start))
+		return 0;
+
+	// IDs go by the time they were made at, bases made in the same tick still get IDs of their own
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	const UInt64 baseID = max(((UInt64)now.dwHighDateTime << 32) | now.dwLowDateTime, s_lastDeltaBaseID + 1);
+	const std::string path = GetDeltaBasePath(baseID);
+	if (!base.SaveFile(path.c_str()))
+	{
+		_ERROR("SaveDeltaBase: couldn't write %s, saving full cosaves until the next one", path.c_str());
+		DeleteFile(path.c_str());
+		return 0;
+	}
+	s_lastDeltaBaseID = baseID;
+	_MESSAGE("wrote delta cosave base %s", path.c_str());
+
+	DeleteUnusedDeltaBases(baseID);
+	return baseID;
+}
+
+bool DeltaBaseExists(UInt64 baseID)
+{
+	HANDLE file = CreateFile(GetDeltaBasePath(baseID).c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	Header header = {};
+	UInt32 numRead = 0;
+	const bool exists = ReadFile(file, &header, sizeof(header), &numRead, NULL) && (numRead == sizeof(header)) &&
+		(header.signature == Header::kSignature) && (header.numPlugins == 1);
+	CloseHandle(file);
+	return exists;
+}
+
+bool LoadDeltaBase(UInt64 baseID, void (*reader)())
+{
+	const std::string path = GetDeltaBasePath(baseID);
+	SerializationTask base;
+	if (!base.LoadFile(path.c_str()))
+	{
+		_ERROR("LoadDeltaBase: couldn't read %s, variables saved before the delta cosave are lost", path.c_str());
+		s_missingDeltaBaseID = baseID;
+		return false;
+	}
+
+	const UInt32 size = base.GetRemain();
+	Header header = {};
+	CosaveIndex index;
+	if (size >= sizeof(header))
+		base.ReadBuf(&header, sizeof(header));
+	if ((header.signature != Header::kSignature) || !index.Build(base.GetData(0), size, sizeof(header)) ||
+		(index.Plugins().Size() != 1) || (index.Plugins()[0].opcodeBase != kNvseOpcodeBase))
+	{
+		_ERROR("LoadDeltaBase: %s is corrupt, variables saved before the delta cosave are lost", path.c_str());
+		s_missingDeltaBaseID = baseID;
+		return false;
+	}
+
+	// read the base file in place of the cosave, then go on with the cosave where it was left
+	const CosaveIndex::Plugin &plugin = index.Plugins()[0];
+	const UInt32 loadPlugin = s_loadPlugin, nextChunk = s_nextChunk, endChunk = s_endChunk;
+	const ChunkHeader chunkHeader = s_chunkHeader;
+	const bool chunkOpen = s_chunkOpen, ignoreChunk = ignoreNextChunk;
+	std::swap(s_serializationTask, base);
+	s_readIndex = &index;
+	s_loadPlugin = 0;
+	s_nextChunk = plugin.firstChunk;
+	s_endChunk = plugin.firstChunk + plugin.numChunks;
+	s_chunkOpen = false;
+
+	bool loaded = true;
+	try
+	{
+		reader();
+	}
+	catch (...)
+	{
+		_ERROR("LoadDeltaBase: exception while reading %s", path.c_str());
+		loaded = false;
+	}
+
+	std::swap(s_serializationTask, base);
+	if (!loaded)
+		s_missingDeltaBaseID = baseID;
+	s_readIndex = &s_cosaveIndex;
+	s_loadPlugin = loadPlugin;
+	s_nextChunk = nextChunk;
+	s_endChunk = endChunk;
+	s_chunkHeader = chunkHeader;
+	s_chunkOpen = chunkOpen;
+	ignoreNextChunk = ignoreChunk;
+	return loaded;
+}
+
 const char * GetSavePath()
 {
 	return g_savePath.c_str();
@@ -694,44 +577,22 @@ void HandleSaveGame(const char * path)
 
 		// iterate through plugins
 		_MESSAGE("saving %d plugins to %s", s_pluginCallbacks.size(), g_savePath.c_str());
+		std::vector<PluginSave> plugins;
 		for (UInt32 i = 0; i < s_pluginCallbacks.size(); i++)
 		{
 			if(s_pluginCallbacks[i].save)
 			{
-				// set up header info
-				s_currentPlugin = i;
-
-				s_pluginHeader.opcodeBase = i ? g_pluginManager.GetBaseOpcode(i - 1) : kNvseOpcodeBase;
-				s_pluginHeader.numChunks = 0;
-				s_pluginHeader.length = 0;
-
-				if(!s_pluginHeader.opcodeBase)
+				UInt32 opcodeBase = i ? g_pluginManager.GetBaseOpcode(i - 1) : kNvseOpcodeBase;
+				if(!opcodeBase)
 				{
 					_ERROR("HandleSaveGame: plugin with default opcode base registered for serialization");
 					continue;
 				}
 
-				s_chunkOpen = false;
-
-				// call the plugin
-				s_pluginCallbacks[i].save(NULL);
-
-				// flush the remaining chunk data
-				FlushWriteChunk();
-
-				if(s_pluginHeader.numChunks)
-				{
-					UInt32 curOffset = s_serializationTask.GetOffset();
-
-					s_serializationTask.SetOffset(s_pluginHeaderOffset);
-					s_serializationTask.WriteBuf(&s_pluginHeader, sizeof(s_pluginHeader));
-
-					s_serializationTask.SetOffset(curOffset);
-
-					s_fileHeader.numPlugins++;
-				}
+				plugins.push_back({opcodeBase, s_pluginCallbacks[i].save, s_pluginCallbacks[i].saveThreadSafe});
 			}
 		}
+		s_fileHeader.numPlugins = SavePlugins(s_serializationTask, plugins, g_parallelPluginSaves);
 
 		// write header
 		s_serializationTask.SetOffset(0);
@@ -777,6 +638,15 @@ void ShowCosaveWarning()
 	DisplayMessage(msg.c_str());
 }
 
+static void ShowDeltaBaseWarning()
+{
+	char msg[0x200];
+	sprintf_s(msg, "NVSE: This save was made with iDeltaCosaveChain and its base file nvse_base_%016llX.nvsb is missing or "
+		"damaged. Only the array and string variables changed since that file was written have been loaded; scripts may "
+		"not work as expected. The next save is written in full.", s_missingDeltaBaseID);
+	DisplayMessage(msg);
+}
+
 void HandleLoadGame(const char * path, NVSESerializationInterface::EventCallback PluginCallbacks::* callback)
 {
 	// pass file path to plugins registered as listeners
@@ -831,31 +701,36 @@ void HandleLoadGame(const char * path, NVSESerializationInterface::EventCallback
 			
 		// no older versions to handle
 
+		// check every length before any plugin sees its data
+		UInt32 errorOffset;
+		if (!s_cosaveIndex.Build(s_serializationTask.GetData(0), s_serializationTask.GetRemain() + sizeof(header), sizeof(header), &errorOffset))
+		{
+			_ERROR("HandleLoadGame: cosave is corrupt or truncated (bad plugin data at %08X), not loading it", errorOffset);
+			throw std::out_of_range("");
+		}
+
 		// reset flags
 		for (PluginCallbackList::iterator iter = s_pluginCallbacks.begin(); iter != s_pluginCallbacks.end(); ++iter)
 			iter->hadData = false;
 			
 		NVSESerializationInterface::EventCallback curCallback = NULL;
 		// iterate through plugin data chunks
-		while (s_serializationTask.GetRemain() >= sizeof(PluginHeader))
+		const auto &indexedPlugins = s_cosaveIndex.Plugins();
+		for (UInt32 plugin = 0; plugin < indexedPlugins.Size(); plugin++)
 		{
-			s_serializationTask.ReadBuf(&s_pluginHeader, sizeof(s_pluginHeader));
-			if (!s_pluginHeader.length)
-			{
-				_WARNING("cosave header has size 0");
-				break;
-			}
-
-			UInt32 pluginChunkStart = s_serializationTask.GetOffset();
+			const CosaveIndex::Plugin &indexed = indexedPlugins[plugin];
 
 			// find the corresponding plugin
-			UInt32 pluginIdx = (s_pluginHeader.opcodeBase == kNvseOpcodeBase) ? 0 : g_pluginManager.LookupHandleFromBaseOpcode(s_pluginHeader.opcodeBase);
+			UInt32 pluginIdx = (indexed.opcodeBase == kNvseOpcodeBase) ? 0 : g_pluginManager.LookupHandleFromBaseOpcode(indexed.opcodeBase);
 			if (pluginIdx != kPluginHandle_Invalid)
 			{
 				s_pluginCallbacks[pluginIdx].hadData = true;
 
 				if (s_pluginCallbacks[pluginIdx].*callback)
 				{
+					s_loadPlugin = plugin;
+					s_nextChunk = indexed.firstChunk;
+					s_endChunk = indexed.firstChunk + indexed.numChunks;
 					s_chunkOpen = false;
 					curCallback = s_pluginCallbacks[pluginIdx].*callback;
 					curCallback((void*)path);
@@ -864,23 +739,12 @@ void HandleLoadGame(const char * path, NVSESerializationInterface::EventCallback
 				{
 					// ### wtf?
 					_WARNING("plugin has data in save file but no handler");
-
-					s_serializationTask.Skip(s_pluginHeader.length, true);
 				}
 			}
 			else
 			{
 				// ### TODO: save the data temporarily?
 				_WARNING("data in save file for plugin, but plugin isn't loaded");
-
-				s_serializationTask.Skip(s_pluginHeader.length, true);
-			}
-
-			UInt32 expectedOffset = pluginChunkStart + s_pluginHeader.length;
-			if (s_serializationTask.GetOffset() != expectedOffset)
-			{
-				_WARNING("plugin did not read all of its data (at %016I64X expected %016I64X)", s_serializationTask.GetOffset(), expectedOffset);
-				s_serializationTask.SetOffset(expectedOffset);
 			}
 		}
 
@@ -889,7 +753,8 @@ void HandleLoadGame(const char * path, NVSESerializationInterface::EventCallback
 		{
 			if (!iter->hadData && (*iter).*callback)
 			{
-				s_pluginHeader.numChunks = 0;
+				s_loadPlugin = kNoLoadPlugin;
+				s_nextChunk = s_endChunk = 0;
 				s_chunkOpen = false;
 				curCallback = (*iter).*callback;
 				curCallback(NULL);
@@ -905,6 +770,10 @@ void HandleLoadGame(const char * path, NVSESerializationInterface::EventCallback
 			HandleNewGame();
 		}
 	}
+	s_cosaveIndex.Clear();
+	s_loadPlugin = kNoLoadPlugin;
+	s_nextChunk = s_endChunk = 0;
+	s_chunkOpen = false;
 	s_serializationTask.Unload();
 	
 	if (g_showFileSizeWarning && !g_cosaveWarning.modIndices.empty() && !g_cosaveWarning.modIndices.contains(0)) // can't suggest disabling FalloutNV.esm
@@ -913,6 +782,12 @@ void HandleLoadGame(const char * path, NVSESerializationInterface::EventCallback
 	}
 	g_cosaveWarning.modIndices.clear();
 	g_showFileSizeWarning = false;
+
+	if (s_missingDeltaBaseID)
+	{
+		ShowDeltaBaseWarning();
+		s_missingDeltaBaseID = 0;
+	}
 }
 
 void GetSaveName(std::string *saveName, const char * path)
@@ -1007,4 +882,8 @@ NVSESerializationInterface	g_NVSESerializationInterface =
 	Serialization::ReadRecord64,
 
 	Serialization::SkipNBytes,
+
+	Serialization::SetThreadSafeSaveCallback,
+
+	Serialization::FindRecord,
 };
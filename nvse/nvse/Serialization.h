@@ -2,7 +2,9 @@
 
 #include <memory>
 #include <unordered_set>
+#include <vector>
 
+#include "containers.h"
 #include "PluginAPI.h"
 
 extern NVSESerializationInterface	g_NVSESerializationInterface;
@@ -31,10 +33,16 @@ public:
 	void PrepareSave();
 	bool Save();
 	bool Load();
+	bool SaveFile(const char* path);	// writes what was written so far to path
+	bool LoadFile(const char* path);	// reads all of path into the buffer
 	void Unload();
 
+	// Replaces the buffer with an empty one of size bytes, ready for writing.
+	void Allocate(UInt32 size);
+
 	UInt32 GetOffset() const;
 	void SetOffset(UInt32 offset);
+	const UInt8* GetData(UInt32 offset) const {return bufferStart.get() + offset;}
 
 	void Skip(UInt32 size, bool read);
 
@@ -58,10 +66,89 @@ public:
 	void ValidateOffset(UInt32 size) const;
 };
 
+//	general format:
+//	Header			header
+//		PluginHeader	plugin[header.numPlugins]
+//			ChunkHeader		chunk[plugin.numChunks]
+//				UInt8			data[chunk.length]
+
+struct Header
+{
+	enum
+	{
+		kSignature =		MACRO_SWAP32('NVSE'),	// endian-swapping so the order matches
+		kVersion =			1,
+
+		kVersion_Invalid =	0
+	};
+
+	UInt32	signature;
+	UInt32	formatVersion;
+	UInt16	nvseVersion;
+	UInt16	nvseMinorVersion;
+	UInt32	falloutVersion;
+	UInt32	numPlugins;
+};
+
+struct PluginHeader
+{
+	UInt32	opcodeBase;
+	UInt32	numChunks;
+	UInt32	length;		// length of following data including ChunkHeader
+};
+
+struct ChunkHeader
+{
+	UInt32	type;
+	UInt32	version;
+	UInt32	length;
+};
+
+// Where each plugin's records are in a loaded cosave, built in one pass over the headers before any load callback runs.
+// Every plugin and chunk length is checked against the data first, so a corrupt or truncated cosave is turned down as a
+// whole instead of plugins being handed whatever its lengths point at.
+class CosaveIndex
+{
+public:
+	static constexpr UInt32 kNoChunk = 0xFFFFFFFF;
+
+	struct Chunk
+	{
+		UInt32	type;
+		UInt32	version;
+		UInt32	dataOffset;
+		UInt32	length;
+	};
+
+	struct Plugin
+	{
+		UInt32	opcodeBase;
+		UInt32	firstChunk;
+		UInt32	numChunks;
+	};
+
+	// Indexes the plugin data from offset start to the end of data, stopping at a plugin header of length 0 like the
+	// reader always did. False if any header doesn't fit or a plugin's chunks don't add up to its length; the index is
+	// left empty and *errorOffset is where the bad header starts.
+	bool Build(const UInt8* data, UInt32 size, UInt32 start, UInt32* errorOffset = nullptr);
+	void Clear();
+
+	const Vector<Plugin>& Plugins() const {return m_plugins;}
+	const Chunk& GetChunk(UInt32 chunk) const {return m_chunks[chunk];}
+
+	// First chunk of this type in the plugin's records, kNoChunk if there is none.
+	UInt32 Find(UInt32 plugin, UInt32 type) const;
+
+private:
+	Vector<Plugin>					m_plugins;
+	Vector<Chunk>					m_chunks;
+	UnorderedMap<UInt64, UInt32>	m_firstOfType;	// plugin << 32 | type -> chunk
+};
+
 struct PluginCallbacks
 {
 	PluginCallbacks()
-		:save(NULL), load(NULL), newGame(NULL), preLoad(NULL) { }
+		:save(NULL), load(NULL), newGame(NULL), preLoad(NULL), saveThreadSafe(false) { }
 
 	NVSESerializationInterface::EventCallback	save;
 	NVSESerializationInterface::EventCallback	load;
@@ -69,10 +156,28 @@ struct PluginCallbacks
 	NVSESerializationInterface::EventCallback	preLoad;
 	
 	bool	hadData;
+	bool	saveThreadSafe;	// registered with SetThreadSafeSaveCallback
+};
+
+struct PluginSave
+{
+	UInt32										opcodeBase;
+	NVSESerializationInterface::EventCallback	callback;
+	bool										threadSafe;
 };
 
+// Runs the save callbacks in order, each plugin's header and records following the previous plugin's in task.
+// With parallel set, the thread-safe callbacks run on worker threads while the others run here, each writing into a
+// buffer of its own that is copied into task where its records would have gone; task ends up byte for byte the same.
+// Returns the number of plugins that wrote any records.
+UInt32	SavePlugins(SerializationTask& task, const std::vector<PluginSave>& plugins, bool parallel);
+
+// set from bParallelPluginSaves in nvse_config.ini
+extern bool	g_parallelPluginSaves;
+
 // plugin API
 void	SetSaveCallback(PluginHandle plugin, NVSESerializationInterface::EventCallback callback);
+void	SetThreadSafeSaveCallback(PluginHandle plugin, NVSESerializationInterface::EventCallback callback);
 void	SetLoadCallback(PluginHandle plugin, NVSESerializationInterface::EventCallback callback);
 void	SetNewGameCallback(PluginHandle plugin, NVSESerializationInterface::EventCallback callback);
 void	SetPreLoadCallback(PluginHandle plugin, NVSESerializationInterface::EventCallback callback);
@@ -86,7 +191,25 @@ void	WriteRecord16(UInt16 inData);
 void	WriteRecord32(UInt32 inData);
 void	WriteRecord64(const void *inData);
 
+// Offset of the next byte written by the running save callback.
+UInt32	GetWriteOffset();
+
+// Copies the records the running save callback wrote from offset start on into out, as a cosave of its own with the
+// header and a single plugin. start must be where one of its records begins, GetWriteOffset taken before opening it.
+// The open record is closed, the callback has to open another before writing more.
+bool	CopyWrittenRecords(SerializationTask& out, const Header& header, UInt32 start);
+
+// Base files of delta cosaves (see Core_Serialization.cpp). SaveDeltaBase writes the core records from start on to a
+// new base file next to the saves and returns its ID, 0 if it couldn't; base files no cosave refers to are deleted
+// then. LoadDeltaBase has reader go through the records of base file baseID with the usual read functions, in the
+// middle of the core plugin's preload callback; false if the file is missing or corrupt, in which case a warning is
+// shown once the load is done. DeltaBaseExists only checks that base file baseID is there with a cosave header.
+UInt64	SaveDeltaBase(UInt32 start);
+bool	LoadDeltaBase(UInt64 baseID, void (*reader)());
+bool	DeltaBaseExists(UInt64 baseID);
+
 bool	GetNextRecordInfo(UInt32 * type, UInt32 * version, UInt32 * length);
+bool	FindRecord(UInt32 type, UInt32 * version, UInt32 * length);
 UInt32	ReadRecordData(void * buf, UInt32 length);
 
 UInt8	ReadRecord8();
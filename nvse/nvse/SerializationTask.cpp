@@ -0,0 +1,496 @@
+#include "Serialization.h"
+
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <utility>
+
+// Buffer handling of SerializationTask and the writing of plugin records, kept apart from the file I/O in
+// Serialization.cpp so that they build without the game or Windows (see nvse/host_bench).
+namespace Serialization
+{
+
+namespace
+{
+	// Records of the plugin whose save callback is running on this thread.
+	struct RecordWriter
+	{
+		SerializationTask	&task;
+		UInt32				pluginHeaderOffset = 0;
+		PluginHeader		pluginHeader = {};
+		bool				chunkOpen = false;
+		UInt32				chunkHeaderOffset = 0;
+		ChunkHeader			chunkHeader = {};
+
+		RecordWriter(SerializationTask& _task) : task(_task) {}
+
+		void FlushChunk();
+		bool SavePlugin(const PluginSave& plugin);
+	};
+
+	thread_local RecordWriter *s_recordWriter = nullptr;
+
+	// The write interface only works inside a plugin's save callback. A plugin calling it anywhere else gets an error
+	// in the log and its data is dropped.
+	RecordWriter* GetRecordWriter(const char *caller)
+	{
+		if (!s_recordWriter)
+			_ERROR("Serialization::%s called outside of a plugin save callback, data is discarded", caller);
+		return s_recordWriter;
+	}
+}
+
+void SerializationTask::Allocate(UInt32 size)
+{
+	this->length = 0;
+	this->bufferSize = size;
+	this->bufferStart = std::make_unique<UInt8[]>(bufferSize);
+	this->bufferPtr = this->bufferStart.get();
+}
+
+UInt32 SerializationTask::GetOffset() const
+{
+	return (UInt32)(bufferPtr - bufferStart.get());
+}
+
+void SerializationTask::SetOffset(UInt32 offset)
+{
+	if (offset > bufferSize)
+		Resize(offset);
+	bufferPtr = bufferStart.get() + offset;
+}
+
+void SerializationTask::Skip(UInt32 size, bool read)
+{
+	if (read)
+		ValidateOffset(size);
+	else
+		CheckResize(size);
+	bufferPtr += size;
+}
+
+void SerializationTask::Write8(UInt8 inData)
+{
+	CheckResize(sizeof(UInt8));
+	*bufferPtr++ = inData;
+	length += 1;
+}
+
+void SerializationTask::Write16(UInt16 inData)
+{
+	CheckResize(sizeof(UInt16));
+	*(UInt16*)bufferPtr = inData;
+	bufferPtr += 2;
+	length += 2;
+}
+
+void SerializationTask::Write32(UInt32 inData)
+{
+	CheckResize(sizeof(UInt32));
+	*(UInt32*)bufferPtr = inData;
+	bufferPtr += 4;
+	length += 4;
+}
+
+void SerializationTask::Write64(const void *inData)
+{
+	CheckResize(sizeof(double));
+	*(double*)bufferPtr = *(double*)inData;
+	bufferPtr += 8;
+	length += 8;
+}
+
+void SerializationTask::WriteBuf(const void *inData, UInt32 size)
+{
+	CheckResize(size);
+	switch (size)
+	{
+		case 0:
+			return;
+		case 1:
+			*bufferPtr = *(UInt8*)inData;
+			break;
+		case 2:
+			*(UInt16*)bufferPtr = *(UInt16*)inData;
+			break;
+		case 4:
+			*(UInt32*)bufferPtr = *(UInt32*)inData;
+			break;
+		case 8:
+			*(double*)bufferPtr = *(double*)inData;
+			break;
+		default:
+			memcpy(bufferPtr, inData, size);
+			break;
+	}
+	bufferPtr += size;
+	this->length += size;
+}
+
+void SerializationTask::Resize(UInt32 size)
+{
+	if (size > 0x80000000)
+		throw std::length_error("");
+	auto newLen = this->bufferSize ? this->bufferSize * 2 : 0x1000;
+	while (newLen < size)
+		newLen *= 2;
+	const auto offset = this->GetOffset();
+	auto newBuf = std::make_unique<UInt8[]>(newLen);
+	std::memcpy(newBuf.get(), this->bufferStart.get(), this->bufferSize);
+	this->bufferSize = newLen;
+	this->bufferStart = std::move(newBuf);
+	this->bufferPtr = this->bufferStart.get() + offset;
+}
+
+void SerializationTask::CheckResize(UInt32 size)
+{
+	if (GetOffset() + size > this->bufferSize)
+		Resize(GetOffset() + size);
+}
+
+UInt8 SerializationTask::Read8()
+{
+	ValidateOffset(1);
+	UInt8 result = *bufferPtr;
+	bufferPtr++;
+	return result;
+}
+
+UInt16 SerializationTask::Read16()
+{
+	ValidateOffset(2);
+	UInt16 result = *(UInt16*)bufferPtr;
+	bufferPtr += 2;
+	return result;
+}
+
+UInt32 SerializationTask::Read32()
+{
+	ValidateOffset(4);
+	UInt32 result = *(UInt32*)bufferPtr;
+	bufferPtr += 4;
+	return result;
+}
+
+void SerializationTask::Read64(void *outData)
+{
+	ValidateOffset(8);
+	*(double*)outData = *(double*)bufferPtr;
+	bufferPtr += 8;
+}
+
+void SerializationTask::ReadBuf(void *outData, UInt32 size)
+{
+	ValidateOffset(size);
+	switch (size)
+	{
+		case 0:
+			return;
+		case 1:
+			*(UInt8*)outData = *bufferPtr;
+			break;
+		case 2:
+			*(UInt16*)outData = *(UInt16*)bufferPtr;
+			break;
+		case 4:
+			*(UInt32*)outData = *(UInt32*)bufferPtr;
+			break;
+		case 8:
+			*(double*)outData = *(double*)bufferPtr;
+			break;
+		default:
+			memcpy(outData, bufferPtr, size);
+			break;
+	}
+	bufferPtr += size;
+}
+
+void SerializationTask::PeekBuf(void *outData, UInt32 size)
+{
+	ValidateOffset(size);
+	switch (size)
+	{
+		case 0:
+			return;
+		case 1:
+			*(UInt8*)outData = *bufferPtr;
+			break;
+		case 2:
+			*(UInt16*)outData = *(UInt16*)bufferPtr;
+			break;
+		case 4:
+			*(UInt32*)outData = *(UInt32*)bufferPtr;
+			break;
+		default:
+			memcpy(outData, bufferPtr, size);
+			break;
+	}
+}
+
+void SerializationTask::ValidateOffset(UInt32 size) const
+{
+	// compared this way round, a size read from a corrupt file can't wrap the sum
+	if ((GetOffset() > this->bufferSize) || (size > this->bufferSize - GetOffset()))
+	{
+		throw std::out_of_range("");
+	}
+}
+
+//==========================================================================
+
+bool CosaveIndex::Build(const UInt8* data, UInt32 size, UInt32 start, UInt32* errorOffset)
+{
+	Clear();
+	UInt32 offset = start;
+	while ((offset <= size) && (size - offset >= sizeof(PluginHeader)))
+	{
+		PluginHeader pluginHeader;
+		memcpy(&pluginHeader, data + offset, sizeof(pluginHeader));
+		if (!pluginHeader.length)
+			break;
+		UInt32 pluginStart = offset;
+		offset += sizeof(pluginHeader);
+		UInt32 remain = pluginHeader.length;
+		UInt32 plugin = m_plugins.Size();
+		UInt32 numChunks = 0;
+		if (remain <= size - offset)
+		{
+			// a chunk header or data running past the plugin's length leaves remain short of 0
+			while (remain && (numChunks < pluginHeader.numChunks) && (remain >= sizeof(ChunkHeader)))
+			{
+				ChunkHeader chunkHeader;
+				memcpy(&chunkHeader, data + offset, sizeof(chunkHeader));
+				offset += sizeof(chunkHeader);
+				remain -= sizeof(chunkHeader);
+				if (chunkHeader.length > remain)
+					break;
+				UInt32 *pFirst;
+				if (m_firstOfType.Insert(((UInt64)plugin << 32) | chunkHeader.type, &pFirst))
+					*pFirst = m_chunks.Size();
+				m_chunks.Append(Chunk{chunkHeader.type, chunkHeader.version, offset, chunkHeader.length});
+				offset += chunkHeader.length;
+				remain -= chunkHeader.length;
+				numChunks++;
+			}
+		}
+		if (remain || (numChunks != pluginHeader.numChunks))
+		{
+			Clear();
+			if (errorOffset)
+				*errorOffset = pluginStart;
+			return false;
+		}
+		m_plugins.Append(Plugin{pluginHeader.opcodeBase, m_chunks.Size() - numChunks, numChunks});
+	}
+	return true;
+}
+
+void CosaveIndex::Clear()
+{
+	m_plugins.Clear();
+	m_chunks.Clear();
+	m_firstOfType.Clear();
+}
+
+UInt32 CosaveIndex::Find(UInt32 plugin, UInt32 type) const
+{
+	const UInt32 *pFirst = m_firstOfType.GetPtr(((UInt64)plugin << 32) | type);
+	return pFirst ? *pFirst : kNoChunk;
+}
+
+//==========================================================================
+
+// flush a chunk header to the file if one is currently open
+void RecordWriter::FlushChunk()
+{
+	if (!chunkOpen)
+		return;
+
+	UInt32 curOffset = task.GetOffset();
+	UInt32 chunkSize = curOffset - chunkHeaderOffset - sizeof(chunkHeader);
+
+	ASSERT(chunkSize < 0x80000000);	// stupidity check
+
+	chunkHeader.length = chunkSize;
+
+	task.SetOffset(chunkHeaderOffset);
+	task.WriteBuf(&chunkHeader, sizeof(chunkHeader));
+
+	task.SetOffset(curOffset);
+
+	pluginHeader.length += chunkSize + sizeof(chunkHeader);
+
+	chunkOpen = false;
+}
+
+// Nothing is written for a plugin without records, otherwise its header goes in front of them once the callback is done.
+bool RecordWriter::SavePlugin(const PluginSave& plugin)
+{
+	pluginHeader.opcodeBase = plugin.opcodeBase;
+	pluginHeader.numChunks = 0;
+	pluginHeader.length = 0;
+
+	chunkOpen = false;
+
+	// call the plugin
+	RecordWriter *prevWriter = std::exchange(s_recordWriter, this);
+	plugin.callback(NULL);
+	s_recordWriter = prevWriter;
+
+	// flush the remaining chunk data
+	FlushChunk();
+
+	if (!pluginHeader.numChunks)
+		return false;
+
+	UInt32 curOffset = task.GetOffset();
+
+	task.SetOffset(pluginHeaderOffset);
+	task.WriteBuf(&pluginHeader, sizeof(pluginHeader));
+
+	task.SetOffset(curOffset);
+	return true;
+}
+
+// A plugin's records only depend on offsets relative to its own header, so writing them into a buffer that starts
+// with that header and copying it over gives the same bytes as writing them in place.
+UInt32 SavePlugins(SerializationTask& task, const std::vector<PluginSave>& plugins, bool parallel)
+{
+	UInt32 numSaved = 0;
+	std::vector<SerializationTask> buffers(plugins.size());
+	std::vector<std::future<bool>> workers(plugins.size());
+	if (parallel)
+	{
+		for (UInt32 i = 0; i < plugins.size(); i++)
+		{
+			if (!plugins[i].threadSafe)
+				continue;
+			buffers[i].Allocate(0x1000);
+			workers[i] = std::async(std::launch::async, [&plugin = plugins[i], &buffer = buffers[i]]
+			{
+				return RecordWriter(buffer).SavePlugin(plugin);
+			});
+		}
+	}
+
+	for (UInt32 i = 0; i < plugins.size(); i++)
+	{
+		if (workers[i].valid())
+		{
+			// rethrows whatever the callback threw
+			if (workers[i].get())
+			{
+				task.WriteBuf(buffers[i].GetData(0), buffers[i].GetOffset());
+				numSaved++;
+			}
+		}
+		else if (RecordWriter(task).SavePlugin(plugins[i]))
+			numSaved++;
+	}
+	return numSaved;
+}
+
+bool CopyWrittenRecords(SerializationTask& out, const Header& header, UInt32 start)
+{
+	RecordWriter *writer = GetRecordWriter("CopyWrittenRecords");
+	if (!writer)
+		return false;
+	writer->FlushChunk();
+
+	SerializationTask &task = writer->task;
+	const UInt32 end = task.GetOffset();
+	PluginHeader pluginHeader = {writer->pluginHeader.opcodeBase, 0, end - start};
+	for (UInt32 offset = start; offset < end; pluginHeader.numChunks++)
+	{
+		ChunkHeader chunkHeader;
+		memcpy(&chunkHeader, task.GetData(offset), sizeof(chunkHeader));
+		offset += sizeof(chunkHeader) + chunkHeader.length;
+	}
+
+	Header fileHeader = header;
+	fileHeader.numPlugins = 1;
+	out.Allocate(sizeof(fileHeader) + sizeof(pluginHeader) + pluginHeader.length);
+	out.WriteBuf(&fileHeader, sizeof(fileHeader));
+	out.WriteBuf(&pluginHeader, sizeof(pluginHeader));
+	out.WriteBuf(task.GetData(start), pluginHeader.length);
+	return true;
+}
+
+bool WriteRecord(UInt32 type, UInt32 version, const void * buf, UInt32 length)
+{
+	if (!OpenRecord(type, version)) return false;
+
+	return WriteRecordData(buf, length);
+}
+
+bool OpenRecord(UInt32 type, UInt32 version)
+{
+	RecordWriter *pWriter = GetRecordWriter("OpenRecord");
+	if (!pWriter)
+		return false;
+	RecordWriter &writer = *pWriter;
+	if(!writer.pluginHeader.numChunks)
+	{
+		ASSERT(!writer.chunkOpen);
+
+		writer.pluginHeaderOffset = writer.task.GetOffset();
+		writer.task.Skip(sizeof(writer.pluginHeader), false);
+	}
+
+	writer.FlushChunk();
+
+	writer.chunkHeaderOffset = writer.task.GetOffset();
+	writer.task.Skip(sizeof(writer.chunkHeader), false);
+
+	writer.pluginHeader.numChunks++;
+
+	writer.chunkHeader.type = type;
+	writer.chunkHeader.version = version;
+	writer.chunkHeader.length = 0;
+
+	writer.chunkOpen = true;
+
+	return true;
+}
+
+bool WriteRecordData(const void * buf, UInt32 length)
+{
+	RecordWriter *writer = GetRecordWriter("WriteRecordData");
+	if (!writer)
+		return false;
+	writer->task.WriteBuf(buf, length);
+
+	return true;
+}
+
+void WriteRecord8(UInt8 inData)
+{
+	if (RecordWriter *writer = GetRecordWriter("WriteRecord8"))
+		writer->task.Write8(inData);
+}
+
+void WriteRecord16(UInt16 inData)
+{
+	if (RecordWriter *writer = GetRecordWriter("WriteRecord16"))
+		writer->task.Write16(inData);
+}
+
+void WriteRecord32(UInt32 inData)
+{
+	if (RecordWriter *writer = GetRecordWriter("WriteRecord32"))
+		writer->task.Write32(inData);
+}
+
+void WriteRecord64(const void *inData)
+{
+	if (RecordWriter *writer = GetRecordWriter("WriteRecord64"))
+		writer->task.Write64(inData);
+}
+
+UInt32 GetWriteOffset()
+{
+	RecordWriter *writer = GetRecordWriter("GetWriteOffset");
+	return writer ? writer->task.GetOffset() : 0;
+}
+
+}
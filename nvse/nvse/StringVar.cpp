@@ -8,16 +8,20 @@
 #include "GameData.h"
 #include "GameApi.h"
 #include <set>
+#include <string_view>
+#include <unordered_map>
 
 #include "Core_Serialization.h"
+#include "SubStringSearcher.h"
 
 StringVar::StringVar(const char* in_data, UInt8 modIndex)
 {
-	data = in_data;
 	owningModIndex = modIndex;
+	Assign(in_data, strlen(in_data));
 }
 
 StringVar::StringVar(StringVar&& other) noexcept: data(std::move(other.data)),
+                                                  interned(std::move(other.interned)),
                                                   owningModIndex(other.owningModIndex)
 {
 }
@@ -62,51 +66,101 @@ void StringVarMap::MarkTemporary(UInt32 varID, bool bTemporary)
 
 const char* StringVar::GetCString()
 {
-	return data.c_str();
+	return interned.Empty() ? data.c_str() : interned.CStr();
+}
+
+// The function result string is assigned for nearly every string a command returns and is moved out of right after,
+// interning it would only cost time.
+void StringVar::Assign(const char* newString, UInt32 length)
+{
+	MarkChanged();
+	if ((length > kMaxInlineLength) && !isFunctionResultCache)
+	{
+		interned = InternedString(newString, length);
+		if (data.capacity() > kMaxInlineLength)
+			data = std::string();
+		else
+			data.clear();
+	}
+	else
+	{
+		data.assign(newString, length);
+		interned = InternedString();
+	}
+}
+
+// Called for every change made in place; callers of StringRef() are taken to change the string too.
+std::string& StringVar::Detach()
+{
+	MarkChanged();
+	if (!interned.Empty())
+	{
+		data.assign(interned.CStr(), interned.Length());
+		interned = InternedString();
+	}
+	return data;
+}
+
+void StringVar::MarkChanged()
+{
+	g_StringMap.MarkChanged(id);
+}
+
+void StringVar::Intern()
+{
+	if (interned.Empty() && (data.length() > kMaxInlineLength) && !isFunctionResultCache)
+	{
+		interned = InternedString(data.data(), data.length());
+		data = std::string();
+	}
 }
 
 void StringVar::Set(const char* newString)
 {
-	data = newString;
+	Assign(newString, strlen(newString));
 }
 
 void StringVar::Set(StringVar&& other)
 {
-	data = std::move(other.StringRef());
+	MarkChanged();
+	if (!other.interned.Empty())
+	{
+		interned = std::move(other.interned);
+		data.clear();
+	}
+	else
+	{
+		data = std::move(other.data);
+		interned = InternedString();
+		Intern();
+	}
 }
 
 SInt32 StringVar::Compare(char* rhs, bool caseSensitive)
 {
-	return caseSensitive ? strcmp(rhs, data.c_str()) : StrCompare(rhs, data.c_str());
+	return caseSensitive ? strcmp(rhs, GetCString()) : StrCompare(rhs, GetCString());
 }
 
 void StringVar::Insert(const char* subString, UInt32 insertionPos)
 {
 	if (insertionPos < GetLength())
-		data.insert(insertionPos, subString);
+		Detach().insert(insertionPos, subString);
 	else if (insertionPos == GetLength())
-		data.append(subString);
+		Detach().append(subString);
 }
 
-#pragma warning(disable : 4996)	// disable checked iterator warning for std::transform with char*
-UInt32 StringVar::Find(char* subString, UInt32 startPos, UInt32 numChars, bool bCaseSensitive)
+UInt32 StringVar::Find(const char* subString, UInt32 startPos, UInt32 numChars, bool bCaseSensitive)
 {
 	UInt32 pos = -1;
 
-	if (numChars + startPos >= GetLength())
-		numChars = GetLength() - startPos;
-
-	if (startPos < GetLength())
+	// compared against the remaining length, as numChars + startPos can wrap around for huge numChars
+	const UInt32 length = GetLength();
+	if (startPos < length)
 	{
-		std::string source = data.substr(startPos, numChars);
-		if (!bCaseSensitive)
-		{
-			std::transform(source.begin(), source.end(), source.begin(), game_tolower);
-			std::transform(subString, subString + strlen(subString), subString, game_tolower);
-		}
-
-		 //pos = data.substr(startPos, numChars).find(subString);	//returns -1 if not found
-		pos = source.find(subString);
+		if (numChars >= length - startPos)
+			numChars = length - startPos;
+		const SubStringSearcher searcher(subString, strlen(subString), bCaseSensitive);
+		pos = searcher.Find(GetCString() + startPos, numChars);
 		if (pos != -1)
 			pos += startPos;
 	}
@@ -114,40 +168,20 @@ UInt32 StringVar::Find(char* subString, UInt32 startPos, UInt32 numChars, bool b
 	return pos;
 }
 
-UInt32 StringVar::Count(char* subString, UInt32 startPos, UInt32 numChars, bool bCaseSensitive)
+UInt32 StringVar::Count(const char* subString, UInt32 startPos, UInt32 numChars, bool bCaseSensitive)
 {
-	if (numChars + startPos >= GetLength())
-		numChars = GetLength() - startPos;
-
-	if (startPos >= GetLength())
-		return 0;
-
-	std::string source = data.substr(startPos, numChars);	//only count occurences beginning before endPos
-	UInt32 subStringLen = strlen(subString);
-	if (!subStringLen)
+	const UInt32 length = GetLength();
+	if (startPos >= length)
 		return 0;
+	if (numChars >= length - startPos)
+		numChars = length - startPos;
 
-	if (!bCaseSensitive)
-	{
-		std::transform(source.begin(), source.end(), source.begin(), game_tolower);
-		std::transform(subString, subString + strlen(subString), subString, game_tolower);
-	}
-
-	UInt32 strIdx = 0;
-	UInt32 count = 0;
-	while (strIdx < GetLength() && ((strIdx = source.find(subString, strIdx)) != -1))
-	{
-		count++;
-		strIdx += subStringLen;
-	}
-
-	return count;
+	return SubStringSearcher(subString, strlen(subString), bCaseSensitive).Count(GetCString() + startPos, numChars);
 }
-#pragma warning(default : 4996)
 
 UInt32 StringVar::GetLength()
 {
-	return data.length();
+	return interned.Empty() ? data.length() : interned.Length();
 }
 
 UInt32 StringVar::Replace(const char* toReplace, const char* replaceWith, UInt32 startPos, UInt32 numChars, bool bCaseSensitive, UInt32 numToReplace)
@@ -155,79 +189,40 @@ UInt32 StringVar::Replace(const char* toReplace, const char* replaceWith, UInt32
 	// calc length of substring
 	if (startPos >= GetLength())
 		return 0;
-	else if (numChars + startPos > GetLength())
+	else if (numChars >= GetLength() - startPos)
 		numChars = GetLength() - startPos;
 
-	UInt32 numReplaced = 0;
-	UInt32 replacementLen = strlen(replaceWith);
-	UInt32 toReplaceLen = strlen(toReplace);
-
-	// create substring
-	std::string srcStr = data.substr(startPos, numChars);
-
-	// remove substring from original string
-	data.erase(startPos, numChars);
-
-	UInt32 strIdx = 0;
-	while (numReplaced < numToReplace)// && (strIdx = srcStr.find(toReplace, strIdx)) != -1)
+	const SubStringSearcher searcher(toReplace, strlen(toReplace), bCaseSensitive);
+	std::string result;
+	const UInt32 numReplaced = searcher.Replace({GetCString(), GetLength()}, startPos, numChars, replaceWith, numToReplace, result);
+	if (numReplaced)
 	{
-		if (bCaseSensitive)
-		{
-			strIdx = srcStr.find(toReplace, strIdx);
-			if (strIdx == -1)
-				break;
-		}
-		else
-		{
-			std::string strToReplace = toReplace;
-			std::string::iterator iter = std::search(srcStr.begin() + strIdx, srcStr.end(), strToReplace.begin(), strToReplace.end(), ci_equal);
-			if (iter != srcStr.end())
-				strIdx = iter - srcStr.begin();
-			else
-				break;
-		}
-
-		numReplaced++;
-		srcStr.erase(strIdx, toReplaceLen);
-		if (strIdx == srcStr.length())
-		{
-			srcStr.append(replaceWith);
-			break;						// reached end of string so all done
-		}
-		else
-		{
-			srcStr.insert(strIdx, replaceWith);
-			strIdx += replacementLen;
-		}
+		data = std::move(result);
+		interned = InternedString();
+		MarkChanged();
 	}
 
-	// paste altered string back into original string
-	if (startPos == GetLength())
-		data.append(srcStr);
-	else
-		data.insert(startPos, srcStr);
-
 	return numReplaced;
 }
 
 void StringVar::Erase(UInt32 startPos, UInt32 numChars)
 {
-	if (numChars + startPos >= GetLength())
-		numChars = GetLength() - startPos;
-
-	if (startPos < GetLength())
-		data.erase(startPos, numChars);
+	const UInt32 length = GetLength();
+	if (startPos >= length)
+		return;
+	if (numChars >= length - startPos)
+		numChars = length - startPos;
+	Detach().erase(startPos, numChars);
 }
 
 std::string StringVar::SubString(UInt32 startPos, UInt32 numChars)
 {
-	if (numChars + startPos >= GetLength())
-		numChars = GetLength() - startPos;
-
-	if (startPos < GetLength())
-		return data.substr(startPos, numChars);
-	else
+	const UInt32 length = GetLength();
+	if (startPos >= length)
 		return "";
+	if (numChars >= length - startPos)
+		numChars = length - startPos;
+	return std::string(GetCString() + startPos, numChars);
 }
 
 UInt8 StringVar::GetOwningModIndex()
@@ -255,31 +250,64 @@ UInt32 StringVar::GetCharType(char ch)
 // Trims whitespace at beginning and end of string
 void StringVar::Trim()
 {
+	std::string &str = Detach();
+
 	// ltrim
-	data.erase(data.begin(), ra::find_if(data, [](unsigned char ch) {
+	str.erase(str.begin(), ra::find_if(str, [](unsigned char ch) {
 		return !std::isspace(ch);
 	}));
 
 	// rtrim
-	data.erase(std::find_if(data.rbegin(), data.rend(), [](unsigned char ch) {
+	str.erase(std::find_if(str.rbegin(), str.rend(), [](unsigned char ch) {
 		return !std::isspace(ch);
-	}).base(), data.end());
+	}).base(), str.end());
 }
 
 char StringVar::At(UInt32 charPos)
 {
 	if (charPos < GetLength())
-		return data[charPos];
+		return GetCString()[charPos];
 	else
 		return -1;
 }
 
+bool StringVarMap::g_sharedStringRecords = false;
+
 void StringVarMap::Save(NVSESerializationInterface* intfc)
 {
 	Clean();
 
 	Serialization::OpenRecord('STVS', 0);
 
+	if (!g_sharedStringRecords)
+	{
+		for (auto iter = vars.Begin(); !iter.End(); ++iter)
+		{
+			if (IsTemporary(iter.Key()))	// don't save temp strings
+				continue;
+			StringVar* var = &iter.Get();
+			if (var->GetOwningModIndex() == 0xFF)
+				continue; // do not save function result cache
+			Serialization::OpenRecord('STVR', 0);
+			Serialization::WriteRecord8(var->GetOwningModIndex());
+			Serialization::WriteRecord32(iter.Key());
+			UInt16 len = var->GetLength();
+			Serialization::WriteRecord16(len);
+			Serialization::WriteRecordData(var->GetCString(), len);
+		}
+		Serialization::OpenRecord('STVE', 0);
+		return;
+	}
+
+	// variables holding the same string are written together, with the string once
+	struct SavedString
+	{
+		const char						*data;
+		UInt16							length;
+		std::vector<std::pair<UInt8, UInt32>>	holders;	// mod index and ID of each variable
+	};
+	std::vector<SavedString> savedStrings;
+	std::unordered_map<std::string_view, UInt32> savedIndices;
 	for (auto iter = vars.Begin(); !iter.End(); ++iter)
 	{
 		if (IsTemporary(iter.Key()))	// don't save temp strings
@@ -287,17 +315,79 @@ void StringVarMap::Save(NVSESerializationInterface* intfc)
 		StringVar* var = &iter.Get();
 		if (var->GetOwningModIndex() == 0xFF)
 			continue; // do not save function result cache
-		Serialization::OpenRecord('STVR', 0);
-		Serialization::WriteRecord8(var->GetOwningModIndex());
-		Serialization::WriteRecord32(iter.Key());
 		UInt16 len = var->GetLength();
-		Serialization::WriteRecord16(len);
-		Serialization::WriteRecordData(var->GetCString(), len);
+		auto [indexIter, inserted] = savedIndices.try_emplace(std::string_view(var->GetCString(), len), savedStrings.size());
+		if (inserted)
+			savedStrings.push_back(SavedString{var->GetCString(), len});
+		savedStrings[indexIter->second].holders.emplace_back(var->GetOwningModIndex(), iter.Key());
+	}
+
+	for (const SavedString& saved : savedStrings)
+	{
+		if (saved.holders.size() == 1)
+		{
+			Serialization::OpenRecord('STVR', 0);
+			Serialization::WriteRecord8(saved.holders[0].first);
+			Serialization::WriteRecord32(saved.holders[0].second);
+			Serialization::WriteRecord16(saved.length);
+			Serialization::WriteRecordData(saved.data, saved.length);
+		}
+		else
+		{
+			Serialization::OpenRecord('STVD', 0);
+			Serialization::WriteRecord16(saved.length);
+			Serialization::WriteRecordData(saved.data, saved.length);
+			Serialization::WriteRecord32(saved.holders.size());
+			for (const auto& [modIndex, stringID] : saved.holders)
+			{
+				Serialization::WriteRecord8(modIndex);
+				Serialization::WriteRecord32(stringID);
+			}
+		}
 	}
 
 	Serialization::OpenRecord('STVE', 0);
 }
 
+// the string if Save writes it
+StringVar* StringVarMap::GetSaved(UInt32 stringID)
+{
+	StringVar* var = Get(stringID);
+	if (!var || IsTemporary(stringID) || (var->GetOwningModIndex() == 0xFF))
+		return nullptr;
+	return var;
+}
+
+void StringVarMap::SaveChanges(NVSESerializationInterface* intfc)
+{
+	Clean();
+
+	Vector<UInt32> dropped;
+	ForEachChanged([&](UInt32 stringID)
+	{
+		if (!GetSaved(stringID))
+			dropped.Append(stringID);
+	});
+	Serialization::OpenRecord('STVX', 0);
+	Serialization::WriteRecord32(dropped.Size());
+	Serialization::WriteRecordData(dropped.Data(), dropped.Size() * sizeof(UInt32));
+
+	ForEachChanged([&](UInt32 stringID)
+	{
+		if (StringVar* var = GetSaved(stringID))
+		{
+			Serialization::OpenRecord('STVR', 0);
+			Serialization::WriteRecord8(var->GetOwningModIndex());
+			Serialization::WriteRecord32(stringID);
+			UInt16 len = var->GetLength();
+			Serialization::WriteRecord16(len);
+			Serialization::WriteRecordData(var->GetCString(), len);
+		}
+	});
+
+	Serialization::OpenRecord('STVE', 0);
+}
+
 #if _DEBUG
 extern std::set<std::string> g_modsWithCosaveVars;
 #endif
@@ -305,10 +395,10 @@ extern std::set<std::string> g_modsWithCosaveVars;
 void StringVarMap::Load(NVSESerializationInterface* intfc)
 {
 	_MESSAGE("Loading strings");
-	UInt32 type, length, version, stringID, tempRefID;
+	UInt32 type, length, version, stringID, numVars;
 	UInt16 strLength;
 	UInt8 modIndex;
-	char buffer[kMaxMessageLength];
+	std::string buffer;
 
 	Clean();
 
@@ -319,6 +409,38 @@ void StringVarMap::Load(NVSESerializationInterface* intfc)
 													// obviously a few mods may require more than this without it being a problem
 	Set<UInt8> exceededMods;
 
+	auto loadVar = [&](UInt8 modIndex, UInt32 stringID)
+	{
+		// the record of a delta cosave replaces the string of its base
+		if (VarExists(stringID))
+			Delete(stringID);
+#if _DEBUG
+		g_modsWithCosaveVars.insert(g_modsLoaded.at(modIndex));
+		modVarCounts[modIndex] += 1;
+		if (modVarCounts[modIndex] == varCountThreshold) {
+			exceededMods.Insert(modIndex);
+			g_cosaveWarning.modIndices.insert(modIndex);
+		}
+#endif
+		UInt32 tempRefID;
+		if (!Serialization::ResolveRefID(modIndex << 24, &tempRefID) || modIndex == 0xFF)
+		{
+			// owning mod is no longer loaded so discard
+			return;
+		}
+		modIndex = tempRefID >> 24;
+
+		// variables read from the same STVD record share the interned string
+		Insert(stringID, buffer.c_str(), modIndex)->id = stringID;
+#if !_DEBUG
+		modVarCounts[modIndex] += 1;
+		if (modVarCounts[modIndex] == varCountThreshold) {
+			exceededMods.Insert(modIndex);
+			g_cosaveWarning.modIndices.insert(modIndex);
+		}
+#endif
+	};
+
 	bool bContinue = true;
 	while (bContinue && Serialization::GetNextRecordInfo(&type, &version, &length))
 	{
@@ -338,36 +460,26 @@ void StringVarMap::Load(NVSESerializationInterface* intfc)
 			break;
 		case 'STVR':
 			modIndex = Serialization::ReadRecord8();
-#if _DEBUG
-			g_modsWithCosaveVars.insert(g_modsLoaded.at(modIndex));
-			modVarCounts[modIndex] += 1;
-			if (modVarCounts[modIndex] == varCountThreshold) {
-				exceededMods.Insert(modIndex);
-				g_cosaveWarning.modIndices.insert(modIndex);
-			}
-#endif
-			if (!Serialization::ResolveRefID(modIndex << 24, &tempRefID) || modIndex == 0xFF)
-			{
-				// owning mod is no longer loaded so discard
-				continue;
-			}
-			modIndex = tempRefID >> 24;
-
 			stringID = Serialization::ReadRecord32();
 			strLength = Serialization::ReadRecord16();
-			
-			Serialization::ReadRecordData(buffer, strLength);
-			buffer[strLength] = 0;
+			buffer.resize(strLength);
+			buffer.resize(Serialization::ReadRecordData(buffer.data(), strLength));
 
-			Insert(stringID, buffer, modIndex);
-#if !_DEBUG
-			modVarCounts[modIndex] += 1;
-			if (modVarCounts[modIndex] == varCountThreshold) {
-				exceededMods.Insert(modIndex);
-				g_cosaveWarning.modIndices.insert(modIndex);
+			loadVar(modIndex, stringID);
+			break;
+		case 'STVD':
+			strLength = Serialization::ReadRecord16();
+			buffer.resize(strLength);
+			buffer.resize(Serialization::ReadRecordData(buffer.data(), strLength));
+
+			// each variable takes 5 bytes, a corrupt count can't run on past the record
+			numVars = std::min<UInt32>(Serialization::ReadRecord32(), (length - std::min<UInt32>(length, 6 + buffer.size())) / 5);
+			for (; numVars; numVars--)
+			{
+				modIndex = Serialization::ReadRecord8();
+				stringID = Serialization::ReadRecord32();
+				loadVar(modIndex, stringID);
 			}
-#endif
-					
 			break;
 		default:
 			_MESSAGE("Error loading string map: unhandled chunk type %d", type);
@@ -376,6 +488,28 @@ void StringVarMap::Load(NVSESerializationInterface* intfc)
 	}
 }
 
+void StringVarMap::LoadChanges(NVSESerializationInterface* intfc)
+{
+	_MESSAGE("Loading changed strings");
+
+	// read in batches, a corrupt count stops at the end of the record
+	UInt32 dropped[0x40];
+	for (UInt32 numDropped = Serialization::ReadRecord32(), numRead; numDropped; numDropped -= numRead)
+	{
+		numRead = Serialization::ReadRecordData(dropped, std::min<UInt32>(numDropped, 0x40) * sizeof(UInt32)) / sizeof(UInt32);
+		if (!numRead)
+			break;
+		for (UInt32 idx = 0; idx < numRead; idx++)
+			Delete(dropped[idx]);
+	}
+
+	Load(intfc);
+
+	// loading a full cosave doesn't hand out the gaps between string IDs either
+	ScopedLock lock(cs);
+	availableIDs.Clear();
+}
+
 UInt32	StringVarMap::Add(UInt8 varModIndex, const char* data, bool bTemp, StringVar** svOut)
 {
 	ScopedLock lock(cs);
@@ -387,6 +521,7 @@ UInt32	StringVarMap::Add(UInt8 varModIndex, const char* data, bool bTemp, String
 		DebugBreak(); // trying to add existing var id
 #endif
 	auto* sv = Insert(varID, data, varModIndex);
+	sv->id = varID;
 	if (svOut)
 		*svOut = sv;
 	if (bTemp)
@@ -405,6 +540,8 @@ UInt32 StringVarMap::Add(StringVar&& moveVar, bool bTemp, StringVar** svOut)
 		DebugBreak();
 #endif
 	auto* sv = Insert(varID, std::move(moveVar));
+	sv->id = varID;
+	sv->Intern();
 	if (svOut)
 		*svOut = sv;
 	if (bTemp)
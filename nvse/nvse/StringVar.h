@@ -1,6 +1,7 @@
 #pragma once
 #include "Serialization.h"
 #include "GameAPI.h"
+#include "InternedString.h"
 #include "VarMap.h"
 
 // String changes layout:
@@ -11,16 +12,41 @@
 //			UInt32 stringID
 //			UInt16 length
 //			char data[length]
-//		[STVR]
+//		STVD - a string held by several variables, written once; only with bSharedStringRecords (versions before this record drop them)
+//			UInt16 length
+//			char data[length]
+//			UInt32 numVars
+//			{ UInt8 modIndex, UInt32 stringID }[numVars]
+//		[STVR or STVD]
 //		...
 //	STVE - empty chunk indicating end of strings block
 //
+// A delta cosave (see Core_Serialization.cpp) has this in place of STVS, on top of the strings of its base file:
+//	STVX
+//		UInt32 numDropped
+//		UInt32 stringIDs[numDropped] - strings that were in the base and are gone or no longer saved
+//	[STVR] - strings created or changed since the base, replacing the base's
+//	...
+//	STVE
+//
 // Strings are discarded on load if the mod which created them is no longer present.
 
 class StringVar
 {
-	std::string data;
-	UInt8		owningModIndex;
+	// Strings that don't fit std::string's inline buffer are interned when assigned, so variables holding the same
+	// value share one copy of it; the first change made in place gives the variable its own copy again.
+	static constexpr UInt32 kMaxInlineLength = 15;
+
+	std::string		data;		// the string unless it is interned
+	InternedString	interned;
+	UInt8			owningModIndex;
+	UInt32			id = 0;		// in g_StringMap, 0 until added to it
+
+	void		Assign(const char* newString, UInt32 length);
+	std::string&	Detach();
+	void		MarkChanged();
+
+	friend class StringVarMap;
 public:
 	bool		isFunctionResultCache = false;
 #if _DEBUG
@@ -42,7 +68,9 @@ public:
 	{
 		if (this == &other)
 			return *this;
+		MarkChanged();
 		data = std::move(other.data);
+		interned = std::move(other.interned);
 		owningModIndex = other.owningModIndex;
 		return *this;
 	}
@@ -52,21 +80,26 @@ public:
 	void        Set(StringVar&& other);
 	SInt32		Compare(char* rhs, bool caseSensitive);
 	void		Insert(const char* subString, UInt32 insertionPos);
-	UInt32		Find(char* subString, UInt32 startPos, UInt32 numChars, bool bCaseSensitive = false);	//returns position of substring
-	UInt32		Count(char* subString, UInt32 startPos, UInt32 numChars, bool bCaseSensitive = false);
+	UInt32		Find(const char* subString, UInt32 startPos, UInt32 numChars, bool bCaseSensitive = false);	//returns position of substring
+	UInt32		Count(const char* subString, UInt32 startPos, UInt32 numChars, bool bCaseSensitive = false);
 	UInt32		Replace(const char* toReplace, const char* replaceWith, UInt32 startPos, UInt32 numChars, bool bCaseSensitive, UInt32 numToReplace = -1);	//returns num replaced
 	void		Erase(UInt32 startPos, UInt32 numChars);
 	std::string	SubString(UInt32 startPos, UInt32 numChars);
 	char		At(UInt32 charPos);
 	static UInt32	GetCharType(char ch);
 	void Trim();
-	void SetOwningModIndex(UInt8 modIdx) { this->owningModIndex = modIdx; }
+	void SetOwningModIndex(UInt8 modIdx) { this->owningModIndex = modIdx; MarkChanged(); }
 
-	std::string String()					{	return data;	}
-	std::string& StringRef() {return data;}
+	std::string String()					{	return std::string(GetCString(), GetLength());	}
+	std::string& StringRef() {return Detach();}
 	const char*	GetCString();
 	UInt32		GetLength();
 	UInt8		GetOwningModIndex();	
+
+	// Shares the string in other from an assignment; the two are equal then, and nothing needs to be compared.
+	bool		SharesString(const StringVar& other) const {return !interned.Empty() && (interned == other.interned);}
+	// Interns the string if it was built in place, for variables that keep it.
+	void		Intern();
 };
 
 enum {
@@ -79,9 +112,17 @@ enum {
 
 class StringVarMap : public VarMap<StringVar>
 {
+	StringVar* GetSaved(UInt32 stringID);
 public:
+	// Saves write a string held by several variables once, in an STVD record listing them, instead of one STVR record
+	// per variable. Builds from before STVD drop those variables on load, so this is off by default.
+	// Set from bSharedStringRecords in nvse_config.ini.
+	static bool g_sharedStringRecords;
+
 	void Save(NVSESerializationInterface* intfc);
+	void SaveChanges(NVSESerializationInterface* intfc);	// STVX block of a delta cosave
 	void Load(NVSESerializationInterface* intfc);
+	void LoadChanges(NVSESerializationInterface* intfc);	// from the STVX record on
 	void Clean();
 	void Reset();
 	UInt32 Add(UInt8 varModIndex, const char* data, bool bTemp = false, StringVar** svOut = nullptr);
@@ -94,7 +135,7 @@ public:
 extern StringVarMap g_StringMap;
 
 bool AssignToStringVar(COMMAND_ARGS, const char* newValue);
-bool IsFunctionResultCacheString(UInt32 strId);
+bool IsFunctionResultCacheString(UInt32 strId);
 bool AssignToStringVarLong(COMMAND_ARGS, const char* newValue);	// Increase the call count in the stack
 
 namespace PluginAPI
@@ -0,0 +1,155 @@
+#pragma once
+#include <array>
+#include <emmintrin.h>
+#include <string>
+#include <string_view>
+#include "Utilities.h"
+
+// Searches ranges of a string in place, for StringVar's Find, Count and Replace. Candidates are found 16 positions at
+// a time by comparing the first and last characters of the needle (SSE2), then verified; the case-insensitive search
+// compares both case variants.
+class SubStringSearcher
+{
+	const char		*m_needle;
+	UInt32			m_needleLen;
+	const UInt8		*m_lower;		// null for a case-sensitive search
+	bool			m_useSIMD = true;
+	__m128i			m_first[2], m_last[2];
+
+	// game_tolower for every byte, so case-insensitive matching needs neither copies nor calls per character
+	static const UInt8* GetLowerCaseTable()
+	{
+		static const auto s_table = []
+		{
+			std::array<UInt8, 256> table{};
+			for (UInt32 i = 0; i < 256; i++)
+				table[i] = game_tolower(i);
+			return table;
+		}();
+		return s_table.data();
+	}
+
+	// Bytes that fold to the same character as ch; false if there are more than two.
+	bool GetVariants(UInt8 ch, __m128i* variants) const
+	{
+		UInt8 found[2] = {ch, ch};
+		if (m_lower)
+		{
+			UInt32 numFound = 0;
+			for (UInt32 i = 0; i < 256; i++)
+			{
+				if (m_lower[i] != m_lower[ch])
+					continue;
+				if (numFound == 2)
+					return false;
+				found[numFound++] = i;
+			}
+			if (numFound == 1)
+				found[1] = found[0];
+		}
+		variants[0] = _mm_set1_epi8(found[0]);
+		variants[1] = _mm_set1_epi8(found[1]);
+		return true;
+	}
+
+	bool MatchesAt(const char* hay) const
+	{
+		if (!m_lower)
+			return !memcmp(hay, m_needle, m_needleLen);
+		for (UInt32 i = 0; i < m_needleLen; i++)
+		{
+			if (m_lower[(UInt8)hay[i]] != m_lower[(UInt8)m_needle[i]])
+				return false;
+		}
+		return true;
+	}
+
+public:
+	SubStringSearcher(const char* needle, UInt32 needleLen, bool bCaseSensitive) :
+		m_needle(needle), m_needleLen(needleLen), m_lower(bCaseSensitive ? nullptr : GetLowerCaseTable())
+	{
+		if (needleLen)
+			m_useSIMD = GetVariants(needle[0], m_first) && GetVariants(needle[needleLen - 1], m_last);
+	}
+
+	// Returns the offset of the first occurrence lying entirely within hay[0, hayLen), or -1.
+	UInt32 Find(const char* hay, UInt32 hayLen) const
+	{
+		if (!m_needleLen)
+			return 0;
+		if (m_needleLen > hayLen)
+			return -1;
+		const UInt32 numPositions = hayLen - m_needleLen + 1;
+		UInt32 pos = 0;
+		if (m_useSIMD)
+		{
+			for (; pos + 16 <= numPositions; pos += 16)
+			{
+				const __m128i blockFirst = _mm_loadu_si128((const __m128i*)(hay + pos));
+				const __m128i blockLast = _mm_loadu_si128((const __m128i*)(hay + pos + m_needleLen - 1));
+				const __m128i eqFirst = _mm_or_si128(_mm_cmpeq_epi8(blockFirst, m_first[0]), _mm_cmpeq_epi8(blockFirst, m_first[1]));
+				const __m128i eqLast = _mm_or_si128(_mm_cmpeq_epi8(blockLast, m_last[0]), _mm_cmpeq_epi8(blockLast, m_last[1]));
+				unsigned long mask = _mm_movemask_epi8(_mm_and_si128(eqFirst, eqLast)), bit;
+				while (_BitScanForward(&bit, mask))
+				{
+					if (MatchesAt(hay + pos + bit))
+						return pos + bit;
+					mask &= mask - 1;
+				}
+			}
+		}
+		for (; pos < numPositions; pos++)
+		{
+			if (MatchesAt(hay + pos))
+				return pos;
+		}
+		return -1;
+	}
+
+	// Number of non-overlapping occurrences lying entirely within hay[0, hayLen); 0 for an empty needle.
+	UInt32 Count(const char* hay, UInt32 hayLen) const
+	{
+		if (!m_needleLen)
+			return 0;
+		UInt32 strIdx = 0, count = 0;
+		while (strIdx < hayLen)
+		{
+			const UInt32 found = Find(hay + strIdx, hayLen - strIdx);
+			if (found == -1)
+				break;
+			count++;
+			strIdx += found + m_needleLen;
+		}
+		return count;
+	}
+
+	// Copies str to result with the first numToReplace occurrences lying within str[startPos, startPos + numChars)
+	// replaced by replaceWith. Returns how many were replaced; result is left alone if none were.
+	UInt32 Replace(std::string_view str, UInt32 startPos, UInt32 numChars, std::string_view replaceWith, UInt32 numToReplace, std::string& result) const
+	{
+		if (!m_needleLen || !numToReplace)
+			return 0;
+		const char* source = str.data() + startPos;
+		UInt32 found = Find(source, numChars);
+		if (found == -1)
+			return 0;
+
+		// build the result in one pass, copying the text between matches once
+		result.clear();
+		result.reserve(str.size());
+		result.append(str.data(), startPos);
+		UInt32 strIdx = 0, numReplaced = 0;
+		do
+		{
+			result.append(source + strIdx, found);
+			result.append(replaceWith);
+			strIdx += found + m_needleLen;
+			if (++numReplaced >= numToReplace)
+				break;
+			found = Find(source + strIdx, numChars - strIdx);
+		}
+		while (found != -1);
+		result.append(source + strIdx, str.size() - startPos - strIdx);
+		return numReplaced;
+	}
+};
@@ -0,0 +1,156 @@
+#include "TilePathCache.h"
+
+#include "GameAPI.h"
+#include "GameUI.h"
+
+std::atomic<UInt32> TilePathCache::s_generation = 1;
+thread_local TilePathCache::Trie TilePathCache::s_trie(false);
+thread_local TilePathCache::Trie TilePathCache::s_trieAlt(true);
+
+Tile::Value* TilePathCache::GetComponentValue(const char* componentPath)
+{
+	return s_trie.Get(componentPath);
+}
+
+Tile::Value* TilePathCache::GetComponentValueAlt(const char* componentPath)
+{
+	return s_trieAlt.Get(componentPath);
+}
+
+void TilePathCache::Invalidate()
+{
+	++s_generation;
+}
+
+UInt32 TilePathCache::Trie::GetNode(UInt32 parent, const char* segment)
+{
+	UInt32 *pIndex;
+	if (m_children.Insert(((UInt64)parent << 32) | StrHashCI(segment), &pIndex))
+	{
+		*pIndex = m_nodes.Size();
+		UInt32 length = StrLen(segment);
+		bool isPlain = !strchr(segment, ':') && (*segment != '*');
+		m_nodes.Append(Node{parent, 0, nullptr, CopyString(segment, length), length, isPlain});
+	}
+	return *pIndex;
+}
+
+// Splits componentPath into trie nodes the same way GetMenuByPath and GetComponent / GetComponentValueAlt do.
+void TilePathCache::Trie::Build(const char* componentPath, Path& path)
+{
+	path = Path{kNoNode, kNoNode, 0, 0, nullptr};
+	char buffer[kMaxMessageLength];
+	UInt32 length = StrLen(componentPath);
+	if (length >= kMaxMessageLength)
+		return;
+	memcpy(buffer, componentPath, length + 1);
+
+	char *slashPos = SlashPos(buffer);
+	if (!slashPos)
+		return;
+	*slashPos = 0;
+	UInt32 node = GetNode(kNoNode, buffer);
+	char *segment = slashPos + 1;
+	while (slashPos = SlashPos(segment))
+	{
+		*slashPos = 0;
+		node = GetNode(node, segment);
+		segment = slashPos + 1;
+	}
+	if (!*segment)
+		return;
+	path.node = node;
+	path.traitID = TraitNameToID(segment);
+	if (!m_alt)
+		path.shadow = GetNode(node, segment);
+}
+
+// Whether node's cached tile is still the child GetChild / GetChildAlt would return for its segment, i.e. it is in the
+// parent's live child list, still has the segment's name and no sibling in front of it has the same name. The cached
+// tile may have been destroyed, so it is only read once found in the live list; its address may since have been
+// reused by another tile, hence the name check.
+bool TilePathCache::Trie::IsFirstMatch(Tile* parentTile, const Node& node)
+{
+	auto isSameName = [&](Tile* child)
+	{
+		return (child->name.m_dataLen == node.length) && !StrCompare(child->name.m_data, node.segment);
+	};
+	if (m_alt)
+	{
+		for (auto iter = ((DList<Tile>*)&parentTile->childList)->Head(); iter; iter = iter->next)
+		{
+			if (!iter->data)
+				continue;
+			if (iter->data == node.tile)
+				return isSameName(iter->data);
+			if (isSameName(iter->data))
+				return false;
+		}
+	}
+	else
+	{
+		for (tList<Tile::ChildNode>::Iterator iter = parentTile->childList.Begin(); !iter.End(); ++iter)
+		{
+			if (!*iter || !iter->child)
+				continue;
+			if (iter->child == node.tile)
+				return isSameName(iter->child);
+			if (isSameName(iter->child))
+				return false;
+		}
+	}
+	return false;
+}
+
+Tile* TilePathCache::Trie::Resolve(UInt32 index, UInt32 generation)
+{
+	Node &node = m_nodes[index];
+	if (node.generation == generation)
+		return node.tile;
+	if (node.parent == kNoNode)
+	{
+		// the menu array is read directly, a menu closed and opened again is picked up here
+		const char *slashPos;
+		node.tile = InterfaceManager::GetMenuByPath(node.segment, &slashPos);
+	}
+	else if (Tile *parentTile = Resolve(node.parent, generation))
+	{
+		if (!node.tile || !node.isPlain || !IsFirstMatch(parentTile, node))
+			node.tile = m_alt ? parentTile->GetChildAlt(node.segment) : parentTile->GetChild(node.segment);
+	}
+	else
+		node.tile = nullptr;
+	node.generation = generation;
+	return node.tile;
+}
+
+void TilePathCache::Trie::Reset()
+{
+	for (Node &node : m_nodes)
+		free(node.segment);
+	m_nodes.Clear();
+	m_children.Clear();
+	m_paths.Clear();
+}
+
+Tile::Value* TilePathCache::Trie::Get(const char* componentPath)
+{
+	if (m_nodes.Size() >= kMaxNodes)
+		Reset();
+	UInt32 generation = s_generation;
+	Path *path;
+	if (m_paths.Insert(const_cast<char*>(componentPath), &path))
+		Build(componentPath, *path);
+	if (path->node == kNoNode)
+		return nullptr;
+	// missing values are looked up again on every call like before, a trait can be added to a tile that already exists
+	if ((path->generation != generation) || !path->value)
+	{
+		Tile::Value *value = nullptr;
+		if (Tile *tile = Resolve(path->node, generation); tile && ((path->shadow == kNoNode) || !Resolve(path->shadow, generation)))
+			value = tile->GetValue(path->traitID);
+		path->value = value;
+		path->generation = generation;
+	}
+	return path->value;
+}
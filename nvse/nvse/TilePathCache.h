@@ -0,0 +1,67 @@
+#pragma once
+#include "containers.h"
+#include "GameTiles.h"
+#include <atomic>
+
+// Resolves "MenuName/tile/.../trait" component paths for the UI commands.
+// Resolved tiles are kept in a per-thread trie with one node per (parent node, path segment), shared by every path
+// running through it. Creating or destroying tiles only advances the generation; the hooks don't know which tile
+// changed, so a node from an older generation is checked against its parent's live child list the next time it is used
+// and only resolved again if its tile is no longer the one the segment names. Subtrees that were not touched keep their
+// tiles, and a node is checked at most once per generation however many cached paths go through it.
+class TilePathCache
+{
+public:
+	// Same results as InterfaceManager::GetMenuComponentValue / GetMenuComponentValueAlt.
+	static Tile::Value* GetComponentValue(const char* componentPath);
+	static Tile::Value* GetComponentValueAlt(const char* componentPath);
+
+	// Called from the tile creation and destruction hooks; cached tiles are checked again on their next use.
+	static void Invalidate();
+
+private:
+	static constexpr UInt32 kNoNode = 0xFFFFFFFF;
+	static constexpr UInt32 kMaxNodes = 0x4000;	// paths built from changing indices could otherwise grow the trie forever
+
+	struct Node
+	{
+		UInt32	parent;			// kNoNode for a menu's root tile
+		UInt32	generation;		// s_generation when tile was last resolved or checked, 0 if never
+		Tile	*tile;			// NULL if nothing matched
+		char	*segment;		// menu name for root nodes, otherwise the child name as written in the path
+		UInt32	length;
+		bool	isPlain;		// no index or wildcard, so the first child with this name is the match
+	};
+
+	struct Path
+	{
+		UInt32		node;		// tile holding the trait, kNoNode if the path can never resolve
+		UInt32		shadow;		// GetComponent returns a child named like the trait instead of the trait; kNoNode for Alt
+		UInt32		traitID;
+		UInt32		generation;
+		Tile::Value	*value;
+	};
+
+	class Trie
+	{
+		bool							m_alt;		// children are walked like GetChildAlt instead of GetChild
+		Vector<Node>					m_nodes;
+		UnorderedMap<UInt64, UInt32>	m_children;	// parent << 32 | StrHashCI(segment) -> node
+		UnorderedMap<char*, Path>		m_paths;
+
+		UInt32 GetNode(UInt32 parent, const char* segment);
+		void Build(const char* componentPath, Path& path);
+		bool IsFirstMatch(Tile* parentTile, const Node& node);
+		Tile* Resolve(UInt32 index, UInt32 generation);
+		void Reset();
+
+	public:
+		Trie(bool alt) : m_alt(alt) {}
+		~Trie() {Reset();}
+
+		Tile::Value* Get(const char* componentPath);
+	};
+
+	static std::atomic<UInt32> s_generation;
+	static thread_local Trie s_trie, s_trieAlt;
+};
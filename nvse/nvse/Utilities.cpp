@@ -984,6 +984,17 @@ void vShowRuntimeError(Script* script, const char* fmt, va_list args)
 	PluginManager::Dispatch_Message(0, NVSEMessagingInterface::kMessage_RuntimeScriptError, errorMsg, 4, NULL);
 }
 
+void NotifyRuntimeError(const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	char errorMsg[0x800];
+	vsprintf_s(errorMsg, sizeof(errorMsg), fmt, args);
+	va_end(args);
+
+	PluginManager::Dispatch_Message(0, NVSEMessagingInterface::kMessage_RuntimeScriptError, errorMsg, 4, NULL);
+}
+
 void ShowRuntimeError(Script* script, const char* fmt, ...)
 {
 	va_list args;
@@ -993,6 +1004,52 @@ void ShowRuntimeError(Script* script, const char* fmt, ...)
 
 	va_end(args);
 }
+
+namespace RuntimeErrorThrottle
+{
+	struct Entry
+	{
+		UInt32 lastReportTime;
+		UInt32 numSuppressed;
+	};
+
+	constexpr UInt32 kMaxEntries = 0x1000;
+	thread_local UnorderedMap<UInt64, Entry> s_reportedErrors;
+
+	// keyed by the script itself, scripts that are not forms (refID 0) must not share one key space
+	UInt64 MakeKey(Script* script, UInt32 offset)
+	{
+		return (static_cast<UInt64>(reinterpret_cast<uintptr_t>(script)) << 32) | offset;
+	}
+
+	bool IsThrottled(Script* script, UInt32 offset)
+	{
+		const auto* entry = s_reportedErrors.GetPtr(MakeKey(script, offset));
+		return entry && GetTickCount() - entry->lastReportTime < kRepeatIntervalMS;
+	}
+
+	bool Register(Script* script, UInt32 offset, UInt32& numSuppressed)
+	{
+		const auto now = GetTickCount();
+		if (s_reportedErrors.Size() >= kMaxEntries)
+			s_reportedErrors.Clear();
+		Entry* entry;
+		if (s_reportedErrors.Insert(MakeKey(script, offset), &entry))
+		{
+			*entry = { now, 0 };
+			numSuppressed = 0;
+			return true;
+		}
+		if (now - entry->lastReportTime < kRepeatIntervalMS)
+		{
+			++entry->numSuppressed;
+			return false;
+		}
+		numSuppressed = entry->numSuppressed;
+		*entry = { now, 0 };
+		return true;
+	}
+}
 #endif
 #endif
 
@@ -225,6 +225,23 @@ const char* GetModName(TESForm* form, bool useOverridingIndex = false);
 
 void vShowRuntimeError(Script* script, const char* fmt, va_list args);
 void ShowRuntimeError(Script* script, const char* fmt, ...);
+// Sends a runtime error to plugins (kMessage_RuntimeScriptError) without printing or logging it
+void NotifyRuntimeError(const char* fmt, ...);
+
+// Scripts that error every frame would otherwise rebuild and print the same message every frame.
+// An error at a given script offset is printed and logged the first time, then at most once per kRepeatIntervalMS.
+// Plugins are sent every error; the repeats in between reach them through NotifyRuntimeError, without the script line
+// approximation that is skipped for them.
+namespace RuntimeErrorThrottle
+{
+	constexpr UInt32 kRepeatIntervalMS = 5000;
+
+	// true if an error at this location was reported recently, so building its message can be skipped
+	bool IsThrottled(Script* script, UInt32 offset);
+	// records an error at this location; returns false if it should not be shown.
+	// numSuppressed receives the number of identical errors swallowed since the last one shown.
+	bool Register(Script* script, UInt32 offset, UInt32& numSuppressed);
+}
 
 #endif
 
@@ -18,6 +18,81 @@ struct _VarIDs : Set<UInt32>
 	UInt32 LastKey() {return Keys()[numKeys - 1];}
 };
 
+// A byte per var ID, set when the var is created, deleted, made temporary or not, or changed in a way that shows in
+// its cosave record, and cleared when a full cosave is written; delta cosaves only write these vars (see
+// Core_Serialization.cpp). Pages are only ever added, by VarMap::Insert under its lock, so marking a var that exists
+// takes no lock and can't touch freed memory.
+class ChangedVarIDs
+{
+	static constexpr UInt32 kPageShift = 12, kPageSize = 1 << kPageShift, kNumPages = 0x1000;
+
+	UInt8	*pages[kNumPages] = {};
+	bool	untracked = false;	// a var got an ID past the last page, only a full cosave has it then
+
+public:
+	ChangedVarIDs() = default;
+	ChangedVarIDs(const ChangedVarIDs&) = delete;
+	ChangedVarIDs& operator=(const ChangedVarIDs&) = delete;
+	~ChangedVarIDs()
+	{
+		for (UInt8 *page : pages)
+			free(page);
+	}
+
+	void Add(UInt32 varID)
+	{
+		const UInt32 pageIdx = varID >> kPageShift;
+		if (pageIdx >= kNumPages)
+		{
+			untracked = true;
+			return;
+		}
+		if (!pages[pageIdx])
+			pages[pageIdx] = (UInt8*)calloc(kPageSize, 1);
+		pages[pageIdx][varID & (kPageSize - 1)] = 1;
+	}
+
+	void Mark(UInt32 varID)
+	{
+		const UInt32 pageIdx = varID >> kPageShift;
+		if (pageIdx < kNumPages)
+			if (UInt8 *page = pages[pageIdx])
+				page[varID & (kPageSize - 1)] = 1;
+	}
+
+	bool Untracked() const {return untracked;}
+
+	void Clear()
+	{
+		for (UInt8 *page : pages)
+			if (page)
+				memset(page, 0, kPageSize);
+		untracked = false;
+	}
+
+	// Calls func(varID) for each marked ID, in ascending order. ID 0, which no var has, is skipped.
+	template <typename F>
+	void ForEach(F&& func) const
+	{
+		for (UInt32 pageIdx = 0; pageIdx < kNumPages; pageIdx++)
+		{
+			const UInt8 *page = pages[pageIdx];
+			if (!page)
+				continue;
+			for (UInt32 offset = 0; offset < kPageSize; offset += 8)
+			{
+				UInt64 bytes;
+				memcpy(&bytes, page + offset, 8);
+				if (!bytes)
+					continue;
+				for (UInt32 idx = offset; idx < offset + 8; idx++)
+					if (page[idx] && (pageIdx || idx))
+						func((pageIdx << kPageShift) | idx);
+			}
+		}
+	}
+};
+
 template <class Var>
 class VarMap
 {
@@ -74,6 +149,7 @@ protected:
 	_VarIDs				availableIDs;	// IDs < greatest used ID available as IDs for new vars
 	VarCache			cache;
 	ICriticalSection	cs;				// trying to avoid what looks like concurrency issues
+	ChangedVarIDs		changedIDs;
 
 	void SetIDAvailable(UInt32 id)
 	{
@@ -127,6 +203,7 @@ public:
 	{
 		ScopedLock lock(cs);
 		usedIDs.Insert(varID);
+		changedIDs.Add(varID);
 		Var* var = vars.Emplace(varID, std::forward<Args>(args)...);
 		return var;
 	}
@@ -138,6 +215,7 @@ public:
 		vars.Erase(varID);
 		usedIDs.Erase(varID);
 		tempIDs.Erase(varID);
+		changedIDs.Mark(varID);
 		SetIDAvailable(varID);
 	}
 
@@ -163,11 +241,13 @@ public:
 		usedIDs.Clear();
 		tempIDs.Clear();
 		availableIDs.Clear();
+		changedIDs.Clear();
 	}
 
 	void MarkTemporary(UInt32 varID, bool bTemporary)
 	{
 		ScopedLock lock(cs);
+		changedIDs.Mark(varID);
 		if (bTemporary)
 		{
 			tempIDs.Insert(varID);
@@ -183,4 +263,23 @@ public:
 		ScopedLock lock(cs);
 		return tempIDs.HasKey(varID);
 	}
+
+	// for changes made to a var in place, see ChangedVarIDs
+	void MarkChanged(UInt32 varID) {changedIDs.Mark(varID);}
+
+	// False if some var can't be told apart as changed or not, a delta cosave would miss it.
+	bool ChangesTracked() const {return !changedIDs.Untracked();}
+
+	void ClearChanged()
+	{
+		ScopedLock lock(cs);
+		changedIDs.Clear();
+	}
+
+	template <typename F>
+	void ForEachChanged(F&& func)
+	{
+		ScopedLock lock(cs);
+		changedIDs.ForEach(std::forward<F>(func));
+	}
 };
\ No newline at end of file
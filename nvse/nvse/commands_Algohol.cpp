@@ -3,6 +3,8 @@
 #include "nvse/GameAPI.h"
 #include "nvse/GameForms.h"
 #include "nvse/GameObjects.h"
+#include "nvse/ArrayVar.h"
+#include "nvse/ScriptUtils.h"
 
 #include "commands_algohol.h"
 #include "algohol/algMath.h"
@@ -406,3 +408,197 @@ bool Cmd_QToEulerEx_Execute( COMMAND_ARGS )
 	}
 	return true;
 }
+
+
+///////////////////////////////////////////
+///			Batch commands
+///////////////////////////////////////////
+
+// Packed script array of interleaved components, deinterleaved into one float array per component
+class BatchComponents
+{
+	std::vector<float>	m_data;
+	UInt32				m_count = 0;
+	UInt32				m_stride = 0;
+
+public:
+	bool Read( ArrayVar *arr, UInt32 stride )
+	{
+		if ( !arr || arr->GetContainerType() != kContainer_Array || arr->Size() % stride )
+			return false;
+		Resize( arr->Size() / stride, stride );
+		// packed number storage is read as is, going through the element container would unpack the array for good;
+		// either way the array is walked once in order, each element going to its component
+		float *components[4];
+		for ( UInt32 c = 0; c < stride; c++ )
+			components[c] = Component( c );
+		if ( arr->m_bNumbersOnly )
+		{
+			const double *numbers = arr->Numbers().Data();
+			for ( UInt32 i = 0; i < m_count; i++, numbers += stride )
+			{
+				for ( UInt32 c = 0; c < stride; c++ )
+					components[c][i] = numbers[c];
+			}
+			return true;
+		}
+		const ArrayElement *elements = arr->GetRawContainer()->getArrayPtr()->Data();
+		for ( UInt32 i = 0; i < m_count; i++, elements += stride )
+		{
+			for ( UInt32 c = 0; c < stride; c++ )
+			{
+				const ArrayData &data = elements[c].m_data;
+				if ( data.dataType != kDataType_Numeric )
+					return false;
+				components[c][i] = data.num;
+			}
+		}
+		return true;
+	}
+
+	void Resize( UInt32 count, UInt32 stride )
+	{
+		m_count = count;
+		m_stride = stride;
+		m_data.resize( count * stride );
+	}
+
+	// a new packed array holds only numbers, so the components go straight into its number storage
+	ArrayVar *Write( Script *scriptObj ) const
+	{
+		ArrayVar *arr = g_ArrayMap.Create( kDataType_Numeric, true, scriptObj->GetModIndex() );
+		ArrayVar::NumberVector &numbers = arr->WritableNumbers();
+		numbers.Resize( m_count * m_stride );
+		const float *components[4];
+		for ( UInt32 c = 0; c < m_stride; c++ )
+			components[c] = m_data.data() + c * m_count;
+		double *out = numbers.Data();
+		for ( UInt32 i = 0; i < m_count; i++, out += m_stride )
+		{
+			for ( UInt32 c = 0; c < m_stride; c++ )
+				out[c] = components[c][i];
+		}
+		return arr;
+	}
+
+	float *Component( UInt32 idx ) { return m_data.data() + idx * m_count; }
+	UInt32 Count() const { return m_count; }
+};
+
+static bool ReadBatchArg( ExpressionEvaluator &eval, UInt32 argIdx, UInt32 stride, BatchComponents &out )
+{
+	if ( out.Read( eval.Arg( argIdx )->GetArrayVar(), stride ) )
+		return true;
+	eval.Error( "Argument %d must be an array of numbers whose size is a multiple of %d", argIdx + 1, stride );
+	return false;
+}
+
+bool Cmd_V3NormalizeBatch_Execute( COMMAND_ARGS )
+{
+	*result = 0;
+	ExpressionEvaluator eval( PASS_COMMAND_ARGS );
+	BatchComponents v;
+	if ( !eval.ExtractArgs() || !ReadBatchArg( eval, 0, 3, v ) )
+		return true;
+
+	V3NormalizeBatch( v.Component( 0 ), v.Component( 1 ), v.Component( 2 ), v.Count() );
+	*result = v.Write( scriptObj )->ID();
+	return true;
+}
+
+bool Cmd_V3CrossproductBatch_Execute( COMMAND_ARGS )
+{
+	*result = 0;
+	ExpressionEvaluator eval( PASS_COMMAND_ARGS );
+	BatchComponents a, b;
+	if ( !eval.ExtractArgs() || !ReadBatchArg( eval, 0, 3, a ) || !ReadBatchArg( eval, 1, 3, b ) )
+		return true;
+	if ( a.Count() != b.Count() )
+	{
+		eval.Error( "Both arrays must hold the same number of vectors" );
+		return true;
+	}
+
+	V3CrossproductBatch( a.Component( 0 ), a.Component( 1 ), a.Component( 2 ),
+						 b.Component( 0 ), b.Component( 1 ), b.Component( 2 ),
+						 a.Component( 0 ), a.Component( 1 ), a.Component( 2 ), a.Count() );
+	*result = a.Write( scriptObj )->ID();
+	return true;
+}
+
+bool Cmd_QMultQuatVector3Batch_Execute( COMMAND_ARGS )
+{
+	*result = 0;
+	ExpressionEvaluator eval( PASS_COMMAND_ARGS );
+	BatchComponents q, v;
+	if ( !eval.ExtractArgs() || !ReadBatchArg( eval, 0, 4, q ) || !ReadBatchArg( eval, 1, 3, v ) )
+		return true;
+	if ( q.Count() != 1 && q.Count() != v.Count() )
+	{
+		eval.Error( "Quaternion array must hold either one quaternion or one per vector" );
+		return true;
+	}
+
+	QMultQuatVector3Batch( q.Component( 0 ), q.Component( 1 ), q.Component( 2 ), q.Component( 3 ), q.Count() != 1,
+						   v.Component( 0 ), v.Component( 1 ), v.Component( 2 ),
+						   v.Component( 0 ), v.Component( 1 ), v.Component( 2 ), v.Count() );
+	*result = v.Write( scriptObj )->ID();
+	return true;
+}
+
+bool Cmd_QInterpolateBatch_Execute( COMMAND_ARGS )
+{
+	*result = 0;
+	ExpressionEvaluator eval( PASS_COMMAND_ARGS );
+	BatchComponents q1, q2;
+	if ( !eval.ExtractArgs() || !ReadBatchArg( eval, 0, 4, q1 ) || !ReadBatchArg( eval, 1, 4, q2 ) )
+		return true;
+	if ( q1.Count() != q2.Count() )
+	{
+		eval.Error( "Both arrays must hold the same number of quaternions" );
+		return true;
+	}
+	const float t = eval.Arg( 2 )->GetNumber();
+	const int slerpFlag = eval.NumArgs() > 3 ? static_cast<int>( eval.Arg( 3 )->GetNumber() ) : 0;
+
+	const float *from[4] = { q1.Component( 0 ), q1.Component( 1 ), q1.Component( 2 ), q1.Component( 3 ) };
+	const float *to[4] = { q2.Component( 0 ), q2.Component( 1 ), q2.Component( 2 ), q2.Component( 3 ) };
+	float *out[4] = { q1.Component( 0 ), q1.Component( 1 ), q1.Component( 2 ), q1.Component( 3 ) };
+	QInterpolateBatch( from, to, t, slerpFlag, out, q1.Count() );
+	*result = q1.Write( scriptObj )->ID();
+	return true;
+}
+
+bool Cmd_QFromEulerBatch_Execute( COMMAND_ARGS )
+{
+	*result = 0;
+	ExpressionEvaluator eval( PASS_COMMAND_ARGS );
+	BatchComponents e, q;
+	if ( !eval.ExtractArgs() || !ReadBatchArg( eval, 0, 3, e ) )
+		return true;
+	const int actorFlag = eval.NumArgs() > 1 ? static_cast<int>( eval.Arg( 1 )->GetNumber() ) : 0;
+
+	q.Resize( e.Count(), 4 );
+	const float *in[3] = { e.Component( 0 ), e.Component( 1 ), e.Component( 2 ) };
+	float *out[4] = { q.Component( 0 ), q.Component( 1 ), q.Component( 2 ), q.Component( 3 ) };
+	QFromEulerBatch( in, actorFlag, out, e.Count() );
+	*result = q.Write( scriptObj )->ID();
+	return true;
+}
+
+bool Cmd_QToEulerBatch_Execute( COMMAND_ARGS )
+{
+	*result = 0;
+	ExpressionEvaluator eval( PASS_COMMAND_ARGS );
+	BatchComponents q, e;
+	if ( !eval.ExtractArgs() || !ReadBatchArg( eval, 0, 4, q ) )
+		return true;
+	const int actorFlag = eval.NumArgs() > 1 ? static_cast<int>( eval.Arg( 1 )->GetNumber() ) : 0;
+
+	e.Resize( q.Count(), 3 );
+	const float *in[4] = { q.Component( 0 ), q.Component( 1 ), q.Component( 2 ), q.Component( 3 ) };
+	float *out[3] = { e.Component( 0 ), e.Component( 1 ), e.Component( 2 ) };
+	QToEulerBatch( in, actorFlag, out, q.Count() );
+	*result = e.Write( scriptObj )->ID();
+	return true;
+}
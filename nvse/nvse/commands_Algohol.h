@@ -1,6 +1,7 @@
 #pragma once
 
 #include "nvse/CommandTable.h"
+#include "nvse/ScriptUtils.h"
 #include "algohol/paramTypes.h"
 
 DEFINE_CMD_ALT(V3Length, v3len, returns length of given vector3, 0, 3, kParams_Vector3Floats);
@@ -25,3 +26,38 @@ DEFINE_CMD_ALT(QMultQuatQuatEx, QMultQEx, Multiplies two quaternions, 0, 12, kPa
 DEFINE_CMD_ALT(QMultQuatVector3Ex, QMultV3Ex, Multiplies vector3 by quaternion, 0, 10, kParams_ThreeScriptVars_SevenFloats);
 DEFINE_CMD_ALT(QInterpolateEx, QIntEx, Interpolates between two quaternions, 0, 14, kParams_FourScriptVars_NineFloats_OneOptionalInt);
 DEFINE_CMD_ALT(QToEulerEx, QToEEx, Converts quaternion to euler angles, 0, 8, kParams_ThreeScriptVars_FourFloats_OneOptionalInt);
+
+
+// Batch variants take packed arrays of interleaved components, e.g. [x0, y0, z0, x1, y1, z1, ...] for vectors
+// or [w0, x0, y0, z0, w1, ...] for quaternions, and return a new array in the same layout.
+static ParamInfo kNVSEParams_AlgoholOneArray[] =
+{
+	{	"components",	kNVSEParamType_Array,	0	},
+};
+
+static ParamInfo kNVSEParams_AlgoholTwoArrays[] =
+{
+	{	"components",	kNVSEParamType_Array,	0	},
+	{	"components",	kNVSEParamType_Array,	0	},
+};
+
+static ParamInfo kNVSEParams_AlgoholOneArray_OneOptionalInt[] =
+{
+	{	"components",	kNVSEParamType_Array,	0	},
+	{	"flag",			kNVSEParamType_Number,	1	},
+};
+
+static ParamInfo kNVSEParams_AlgoholTwoArrays_OneFloat_OneOptionalInt[] =
+{
+	{	"components",	kNVSEParamType_Array,	0	},
+	{	"components",	kNVSEParamType_Array,	0	},
+	{	"t",			kNVSEParamType_Number,	0	},
+	{	"flag",			kNVSEParamType_Number,	1	},
+};
+
+DEFINE_CMD_ALT_EXP(V3NormalizeBatch, V3NormBatch, "Returns an array of the normalized vector3s in the passed array", false, kNVSEParams_AlgoholOneArray);
+DEFINE_CMD_ALT_EXP(V3CrossproductBatch, V3CrossBatch, "Returns an array of the crossproducts of each pair of vector3s in the passed arrays", false, kNVSEParams_AlgoholTwoArrays);
+DEFINE_CMD_ALT_EXP(QMultQuatVector3Batch, QMultV3Batch, "Multiplies each vector3 in the second array by the matching quaternion in the first array, or by the same quaternion if the first array holds only one", false, kNVSEParams_AlgoholTwoArrays);
+DEFINE_CMD_ALT_EXP(QInterpolateBatch, QIntBatch, "Interpolates between each pair of quaternions in the passed arrays; optional flag indicates spherical linear interpolation", false, kNVSEParams_AlgoholTwoArrays_OneFloat_OneOptionalInt);
+DEFINE_CMD_ALT_EXP(QFromEulerBatch, QFromEBatch, "Converts an array of euler angles to quaternions; optional flag indicates if the angles came from an actor", false, kNVSEParams_AlgoholOneArray_OneOptionalInt);
+DEFINE_CMD_ALT_EXP(QToEulerBatch, QToEBatch, "Converts an array of quaternions to euler angles; optional flag indicates the output will be used for rotating an actor", false, kNVSEParams_AlgoholOneArray_OneOptionalInt);
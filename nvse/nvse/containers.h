@@ -843,7 +843,7 @@ public:
 		{
 			--table->numEntries;
 			pEntry->Clear();
-			UInt32 size = (UInt32)table->End() - (UInt32)pEntry;
+			UInt32 size = (UInt32)((UInt8*)table->End() - (UInt8*)pEntry);
 			if (size) memmove(pEntry, pEntry + 1, size);
 			if (frwrd)
 			{
@@ -1015,7 +1015,7 @@ public:
 		{
 			--table->numKeys;
 			pKey->Clear();
-			UInt32 size = (UInt32)table->End() - (UInt32)pKey;
+			UInt32 size = (UInt32)((UInt8*)table->End() - (UInt8*)pKey);
 			if (size) memmove(pKey, pKey + 1, size);
 			if (frwrd)
 			{
@@ -1901,9 +1901,9 @@ public:
 		}
 		else if (numAlloc < newCount)
 		{
-			newCount = AlignNumAlloc<T_Data>(newCount);
-			POOL_REALLOC(data, numAlloc, newCount, T_Data);
-			numAlloc = newCount;
+			UInt32 newAlloc = AlignNumAlloc<T_Data>(newCount);
+			POOL_REALLOC(data, numAlloc, newAlloc, T_Data);
+			numAlloc = newAlloc;
 		}
 		memmove(data + numItems, source.data, sizeof(T_Data) * source.numItems);
 		numItems = newCount;
@@ -1921,9 +1921,9 @@ public:
 		}
 		else if (numAlloc < newCount)
 		{
-			newCount = AlignNumAlloc<T_Data>(newCount);
-			POOL_REALLOC(data, numAlloc, newCount, T_Data);
-			numAlloc = newCount;
+			UInt32 newAlloc = AlignNumAlloc<T_Data>(newCount);
+			POOL_REALLOC(data, numAlloc, newAlloc, T_Data);
+			numAlloc = newAlloc;
 		}
 		memcpy(data + numItems, srcData, sizeof(T_Data) * srcSize);
 		numItems = newCount;
@@ -1984,7 +1984,7 @@ public:
 				if (*pData != item) continue;
 				numItems--;
 				pData->~T_Data();
-				UInt32 size = (UInt32)End() - (UInt32)pData;
+				UInt32 size = (UInt32)((UInt8*)End() - (UInt8*)pData);
 				if (size) memmove(pData, pData + 1, size);
 				return true;
 			}
@@ -2006,7 +2006,7 @@ public:
 				if (!finder(*pData)) continue;
 				numItems--;
 				pData->~T_Data();
-				size = (UInt32)End() - (UInt32)pData;
+				size = (UInt32)((UInt8*)End() - (UInt8*)pData);
 				if (size) memmove(pData, pData + 1, size);
 				removed++;
 			}
@@ -2028,7 +2028,7 @@ public:
 			++pData;
 		}
 		while (pData != pEnd);
-		UInt32 size = (UInt32)End() - (UInt32)pData;
+		UInt32 size = (UInt32)((UInt8*)End() - (UInt8*)pData);
 		if (size) memmove(pBgn, pData, size);
 		numItems -= count;
 	}
@@ -2047,9 +2047,9 @@ public:
 			}
 			else if (numAlloc < newSize)
 			{
-				newSize = AlignNumAlloc<T_Data>(newSize);
-				POOL_REALLOC(data, numAlloc, newSize, T_Data);
-				numAlloc = newSize;
+				UInt32 newAlloc = AlignNumAlloc<T_Data>(newSize);
+				POOL_REALLOC(data, numAlloc, newAlloc, T_Data);
+				numAlloc = newAlloc;
 			}
 			pData = data + numItems;
 			pEnd = data + newSize;
@@ -2296,7 +2296,7 @@ public:
 		{
 			--contObj->numItems;
 			pData->~T_Data();
-			UInt32 size = (UInt32)contObj->End() - (UInt32)pData;
+			UInt32 size = (UInt32)((UInt8*)contObj->End() - (UInt8*)pData);
 			if (size) memmove(pData, pData + 1, size);
 			if (frwrd)
 			{
@@ -18,6 +18,9 @@
 #include "EventManager.h"
 #include "FormExtraData.h"
 #include "ScriptDataCache.h"
+#include "ArrayVar.h"
+#include "StringVar.h"
+#include "Core_Serialization.h"
 
 #if RUNTIME
 IDebugLog	gLog("nvse.log");
@@ -107,6 +110,16 @@ void NVSE_Initialize(void)
 		UInt32 noScriptRunnerCache = 0;
 		if (GetNVSEConfigOption_UInt32("RELEASE", "bNoScriptRunnerCaching", &noScriptRunnerCache) && noScriptRunnerCache)
 			ScriptDataCache::g_enabled = false;
+
+		GetNVSEConfigOption_UInt32("RELEASE", "iDeltaCosaveChain", &g_deltaCosaveChain);
+
+		UInt32 parallelPluginSaves = 0;
+		if (GetNVSEConfigOption_UInt32("RELEASE", "bParallelPluginSaves", &parallelPluginSaves) && parallelPluginSaves)
+			Serialization::g_parallelPluginSaves = true;
+
+		UInt32 sharedStringRecords = 0;
+		if (GetNVSEConfigOption_UInt32("RELEASE", "bSharedStringRecords", &sharedStringRecords) && sharedStringRecords)
+			StringVarMap::g_sharedStringRecords = true;
 			
 
 		_MESSAGE("NVSE runtime: initialize (version = %d.%d.%d %08X %08X%08X)",
@@ -153,6 +166,10 @@ void NVSE_Initialize(void)
 
 		gLog.SetLogLevel((IDebugLog::LogLevel)logLevel);
 
+		UInt32 asyncLogging = 0;
+		if (GetNVSEConfigOption_UInt32("LOGGING", "bAsyncLogging", &asyncLogging) && asyncLogging)
+			gLog.SetAsync(true);
+
 		MersenneTwister::init_genrand(GetTickCount());
 
 		// Set default context in order to allocate memory in game's default heap instead of static heap. (Static heap is non-freeable.)
@@ -52,6 +52,25 @@ bAllowScriptsToCrash = 1
 ; *Default value = 0
 bNoSaveWarnings = 0
 
+; If non-zero, after each full save this many saves only write the array and string variables that changed since it.
+; Each full save also writes its variables to an nvse_base_*.nvsb file in the save folder, which the saves after it
+; need; keep these files with the saves. Unused ones are deleted automatically.
+; RISKY: a save whose .nvsb file is missing or damaged loads only the variables changed since it, with a warning,
+; and the rest are lost. Don't enable this if save folders are moved, pruned or synced without the .nvsb files.
+; Saves made this way lose their variables when loaded by an xNVSE version from before this option.
+; *Default value = 0 (off)
+iDeltaCosaveChain = 0
+
+; If non-zero (true), the save callbacks of plugins that registered them as thread-safe run on worker threads while saving.
+; The cosave is the same either way.
+; *Default value = 0 (off)
+bParallelPluginSaves = 0
+
+; If non-zero (true), a string held by several string variables is written to the cosave once instead of once per variable.
+; Saves made this way lose those string variables when loaded by an xNVSE version from before this option.
+; *Default value = 0 (off)
+bSharedStringRecords = 0
+
 ; If non-zero (true), in-game script compilation errors will always be printed to console.
 ; By default, they are only printed if the console is already open.
 ; HIGHLY RECOMMENDED for debugging Script Runner files.